@@ -0,0 +1,726 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <glibmm.h>
+#include <algorithm>  // std::max, std::upper_bound
+#include <array>
+#include <cerrno>
+#include <cstring>  // std::memcmp
+#include <iterator>  // std::prev
+#include <limits>
+
+#ifndef _WIN32
+	#include <fcntl.h>  // ::open
+	#include <sys/mman.h>  // mmap
+	#include <sys/stat.h>  // fstat
+	#include <unistd.h>  // ::close
+#endif
+
+#include "hz/debug.h"
+#include "hz/string_algo.h"  // string_split
+#include "attribute_history.h"
+
+
+
+namespace {
+
+	/// Sample file header, the last character is the format version
+	constexpr std::array<unsigned char, 8> data_file_header = {'G', 'S', 'C', 'H', 'I', 'S', 'T', '1'};
+
+	/// Keyframe record tag
+	constexpr unsigned char keyframe_tag = 'K';
+
+	/// Delta record tag
+	constexpr unsigned char delta_tag = 'D';
+
+	/// Size of an index entry
+	constexpr std::size_t index_entry_size = 16;
+
+	/// Maximum size of the series names file
+	constexpr std::uintmax_t max_series_file_size = 16 * 1024 * 1024;
+
+
+	/// Get the sample file of a history
+	hz::fs::path get_data_file(const hz::fs::path& file_base)
+	{
+		hz::fs::path file = file_base;
+		file += ".gshist";
+		return file;
+	}
+
+
+	/// Get the index file of a history
+	hz::fs::path get_index_file(const hz::fs::path& file_base)
+	{
+		hz::fs::path file = file_base;
+		file += ".gshidx";
+		return file;
+	}
+
+
+	/// Get the series names file of a history
+	hz::fs::path get_series_file(const hz::fs::path& file_base)
+	{
+		hz::fs::path file = file_base;
+		file += ".gshser";
+		return file;
+	}
+
+
+	/// Map a signed value to unsigned, so that small negative values stay small
+	std::uint64_t zigzag_encode(std::int64_t value)
+	{
+		return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+	}
+
+
+	/// Reverse zigzag_encode()
+	std::int64_t zigzag_decode(std::uint64_t value)
+	{
+		return static_cast<std::int64_t>((value >> 1) ^ (~(value & 1) + 1));
+	}
+
+
+	/// Append a LEB128 varint
+	void write_varint(std::string& out, std::uint64_t value)
+	{
+		while (value >= 0x80) {
+			out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<char>(value));
+	}
+
+
+	/// Read a LEB128 varint, advancing \c pos.
+	/// \return false if the data ends prematurely or the value is too large.
+	bool read_varint(const unsigned char*& pos, const unsigned char* end, std::uint64_t& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			if (pos == end) {
+				return false;
+			}
+			const unsigned char byte = *(pos++);
+			value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+
+	/// Encode an index entry (little-endian time and offset)
+	std::string encode_index_entry(std::int64_t time, std::uint64_t offset)
+	{
+		std::string entry;
+		for (const std::uint64_t value : {static_cast<std::uint64_t>(time), offset}) {
+			for (int i = 0; i < 8; ++i) {
+				entry.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+			}
+		}
+		return entry;
+	}
+
+
+	/// Decode a little-endian 64-bit value
+	std::uint64_t decode_uint64(const unsigned char* data)
+	{
+		std::uint64_t value = 0;
+		for (int i = 7; i >= 0; --i) {
+			value = (value << 8) | data[i];
+		}
+		return value;
+	}
+
+
+	/// Append data to a file, creating it if needed
+	std::error_code append_to_file(const hz::fs::path& file, const std::string& data)
+	{
+		std::FILE* f = hz::fs_platform_fopen(file, "ab");
+		if (!f) {
+			return {errno, std::system_category()};
+		}
+		if (std::fwrite(data.data(), data.size(), 1, f) != 1) {
+			auto ec = std::error_code(errno, std::system_category());
+			std::fclose(f);  // don't check anything, it's too late
+			return ec;
+		}
+		if (std::fclose(f) != 0) {
+			return {errno, std::system_category()};
+		}
+		return {};
+	}
+
+}
+
+
+
+AttributeHistorySample AttributeHistorySample::create(const StoragePropertyRepository& repository, std::chrono::sys_seconds time)
+{
+	AttributeHistorySample sample;
+	sample.time = time;
+
+	for (const auto& p : repository.get_properties()) {
+		if (p.is_value_type<AtaStorageAttribute>()) {
+			// Attribute IDs are more stable than names, which depend on the drive database.
+			const auto& attribute = p.get_value<AtaStorageAttribute>();
+			const std::string key = "ata_attribute/" + std::to_string(attribute.id);
+			if (attribute.value.has_value()) {
+				sample.values.emplace_back(key + "/value", attribute.value.value());
+			}
+			sample.values.emplace_back(key + "/raw", attribute.raw_value_int);
+
+		} else if (p.is_value_type<AtaStorageStatistic>()) {
+			const auto& statistic = p.get_value<AtaStorageStatistic>();
+			if (!statistic.is_header) {
+				sample.values.emplace_back("ata_statistic/" + std::to_string(statistic.page)
+						+ "/" + std::to_string(statistic.offset), statistic.value_int);
+			}
+
+		} else if (p.is_value_type<std::int64_t>()
+				&& (p.section == StoragePropertySection::NvmeAttributes
+				|| p.generic_name == "temperature/current" || p.generic_name == "ata_sct_status/temperature/current")) {
+			sample.values.emplace_back(p.generic_name, p.get_value<std::int64_t>());
+		}
+	}
+
+	return sample;
+}
+
+
+
+hz::fs::path attribute_history_get_file_base(const hz::fs::path& dir,
+		const std::string& model, const std::string& serial, const std::string& device)
+{
+	const std::string id = serial.empty() ? device : (model + "_" + serial);
+	return dir / hz::fs_path_from_string(hz::fs_filename_make_safe(id));
+}
+
+
+
+AttributeHistoryReader::AttributeHistoryReader() = default;
+
+
+
+AttributeHistoryReader::~AttributeHistoryReader()
+{
+	close();
+}
+
+
+
+hz::ExpectedVoid<AttributeHistoryError> AttributeHistoryReader::open(const hz::fs::path& file_base)
+{
+	close();
+	std::error_code ec;
+
+	// Series names. An incomplete last line is a torn write.
+	if (const auto series_file = get_series_file(file_base); hz::fs::exists(series_file, ec)) {
+		std::string contents;
+		if (auto read_ec = hz::fs_file_get_contents(series_file, contents, max_series_file_size)) {
+			return hz::Unexpected(AttributeHistoryError::ReadError,
+					Glib::ustring::compose(_("Cannot read file \"%1\": %2"), hz::fs_path_to_string(series_file), read_ec.message()));
+		}
+		contents.erase(contents.find_last_of('\n') == std::string::npos ? 0 : contents.find_last_of('\n'));
+		if (!contents.empty()) {
+			hz::string_split(contents, '\n', series_names_, false);
+		}
+		for (std::size_t i = 0; i < series_names_.size(); ++i) {
+			series_ids_.emplace(series_names_[i], i);
+		}
+	}
+
+	// Samples
+	const auto data_file = get_data_file(file_base);
+	if (hz::fs::exists(data_file, ec)) {
+#ifndef _WIN32
+		const int fd = ::open(data_file.c_str(), O_RDONLY);
+		struct stat st = {};
+		if (fd == -1 || ::fstat(fd, &st) != 0) {
+			const int error_number = errno;
+			if (fd != -1) {
+				::close(fd);
+			}
+			return hz::Unexpected(AttributeHistoryError::OpenError,
+					Glib::ustring::compose(_("Cannot open file \"%1\": %2"), hz::fs_path_to_string(data_file),
+					std::error_code(error_number, std::system_category()).message()));
+		}
+		if (st.st_size > 0) {
+			void* mapped = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapped != MAP_FAILED) {
+				data_ = static_cast<const unsigned char*>(mapped);
+				data_size_ = static_cast<std::uint64_t>(st.st_size);
+			}
+		}
+		::close(fd);
+		if (st.st_size > 0 && !data_) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Cannot map \"" << hz::fs_path_to_string(data_file) << "\", reading it instead.\n");
+		}
+#endif
+		if (!data_) {
+			if (auto read_ec = hz::fs_file_get_contents(data_file, data_buffer_, std::numeric_limits<std::uintmax_t>::max())) {
+				return hz::Unexpected(AttributeHistoryError::ReadError,
+						Glib::ustring::compose(_("Cannot read file \"%1\": %2"), hz::fs_path_to_string(data_file), read_ec.message()));
+			}
+			data_ = reinterpret_cast<const unsigned char*>(data_buffer_.data());
+			data_size_ = data_buffer_.size();
+		}
+	}
+
+	// A torn header is the same as no file at all
+	if (data_size_ >= data_file_header.size()
+			&& std::memcmp(data_, data_file_header.data(), data_file_header.size()) != 0) {
+		close();
+		return hz::Unexpected(AttributeHistoryError::FormatError,
+				Glib::ustring::compose(_("File \"%1\" is not a supported history file."), hz::fs_path_to_string(data_file)));
+	}
+	if (data_size_ < data_file_header.size()) {
+		return {};
+	}
+
+	// Index. Only the sorted entries pointing to keyframes are used.
+	if (const auto index_file = get_index_file(file_base); hz::fs::exists(index_file, ec)) {
+		std::string contents;
+		if (auto read_ec = hz::fs_file_get_contents(index_file, contents, std::numeric_limits<std::uintmax_t>::max())) {
+			return hz::Unexpected(AttributeHistoryError::ReadError,
+					Glib::ustring::compose(_("Cannot read file \"%1\": %2"), hz::fs_path_to_string(index_file), read_ec.message()));
+		}
+		const auto* entry_data = reinterpret_cast<const unsigned char*>(contents.data());
+		for (std::size_t pos = 0; pos + index_entry_size <= contents.size(); pos += index_entry_size) {
+			const auto time = static_cast<std::int64_t>(decode_uint64(entry_data + pos));
+			const std::uint64_t offset = decode_uint64(entry_data + pos + 8);
+			if (offset < data_file_header.size() || offset >= data_size_ || data_[offset] != keyframe_tag
+					|| (!index_.empty() && (time < index_.back().first || offset <= index_.back().second))) {
+				break;
+			}
+			index_.emplace_back(time, offset);
+		}
+	}
+
+	// Find the end of the last complete record
+	std::optional<std::int64_t> last_time;
+	valid_data_size_ = decode(index_.empty() ? data_file_header.size() : index_.back().second, data_size_,
+			[&last_time](std::int64_t time, [[maybe_unused]] const auto& values) {
+				last_time = time;
+				return true;
+			});
+	while (!index_.empty() && index_.back().second >= valid_data_size_) {
+		index_.pop_back();
+	}
+	if (valid_data_size_ < data_size_) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Ignoring " << (data_size_ - valid_data_size_)
+				<< " bytes of incomplete data at the end of \"" << hz::fs_path_to_string(data_file) << "\".\n");
+	}
+
+	if (last_time.has_value()) {
+		std::int64_t first_time = last_time.value();
+		decode(data_file_header.size(), valid_data_size_, [&first_time](std::int64_t time, [[maybe_unused]] const auto& values) {
+			first_time = time;
+			return false;
+		});
+		time_range_ = {first_time, last_time.value()};
+	}
+
+	return {};
+}
+
+
+
+const std::vector<std::string>& AttributeHistoryReader::get_series_names() const
+{
+	return series_names_;
+}
+
+
+
+std::optional<std::size_t> AttributeHistoryReader::get_series_id(const std::string& name) const
+{
+	if (auto iter = series_ids_.find(name); iter != series_ids_.end()) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+
+
+std::optional<std::pair<std::chrono::sys_seconds, std::chrono::sys_seconds>> AttributeHistoryReader::get_time_range() const
+{
+	if (!time_range_.has_value()) {
+		return std::nullopt;
+	}
+	return std::pair {std::chrono::sys_seconds(std::chrono::seconds(time_range_->first)),
+			std::chrono::sys_seconds(std::chrono::seconds(time_range_->second))};
+}
+
+
+
+void AttributeHistoryReader::read_range(std::chrono::sys_seconds from, std::chrono::sys_seconds to, const SampleCallback& callback) const
+{
+	if (valid_data_size_ == 0 || from > to) {
+		return;
+	}
+
+	// Start from the last keyframe at or before "from"
+	std::uint64_t offset = data_file_header.size();
+	const auto next_keyframe = std::upper_bound(index_.begin(), index_.end(), from.time_since_epoch().count(),
+			[](std::int64_t time, const std::pair<std::int64_t, std::uint64_t>& entry) {
+				return time < entry.first;
+			});
+	if (next_keyframe != index_.begin()) {
+		offset = std::prev(next_keyframe)->second;
+	}
+
+	decode(offset, valid_data_size_, [&](std::int64_t time, const std::vector<std::optional<std::int64_t>>& values) {
+		if (time > to.time_since_epoch().count()) {
+			return false;
+		}
+		if (time >= from.time_since_epoch().count()) {
+			callback(std::chrono::sys_seconds(std::chrono::seconds(time)), values);
+		}
+		return true;
+	});
+}
+
+
+
+std::vector<std::pair<std::chrono::sys_seconds, std::int64_t>> AttributeHistoryReader::read_series(const std::string& name,
+		std::chrono::sys_seconds from, std::chrono::sys_seconds to) const
+{
+	std::vector<std::pair<std::chrono::sys_seconds, std::int64_t>> result;
+	const auto id = get_series_id(name);
+	if (!id.has_value()) {
+		return result;
+	}
+	read_range(from, to, [&result, &id](std::chrono::sys_seconds time, const std::vector<std::optional<std::int64_t>>& values) {
+		if (id.value() < values.size() && values[id.value()].has_value()) {
+			result.emplace_back(time, values[id.value()].value());
+		}
+	});
+	return result;
+}
+
+
+
+std::uint64_t AttributeHistoryReader::get_valid_data_size() const
+{
+	return valid_data_size_;
+}
+
+
+
+const std::vector<std::pair<std::int64_t, std::uint64_t>>& AttributeHistoryReader::get_index() const
+{
+	return index_;
+}
+
+
+
+void AttributeHistoryReader::close()
+{
+#ifndef _WIN32
+	if (data_ && data_buffer_.empty()) {
+		::munmap(const_cast<unsigned char*>(data_), static_cast<std::size_t>(data_size_));
+	}
+#endif
+	data_ = nullptr;
+	data_size_ = 0;
+	data_buffer_.clear();
+	valid_data_size_ = 0;
+	series_names_.clear();
+	series_ids_.clear();
+	index_.clear();
+	time_range_.reset();
+}
+
+
+
+std::uint64_t AttributeHistoryReader::decode(std::uint64_t offset, std::uint64_t end,
+		const std::function<bool(std::int64_t time, const std::vector<std::optional<std::int64_t>>& values)>& callback) const
+{
+	std::vector<std::optional<std::int64_t>> values(series_names_.size());
+	std::int64_t time = 0;
+	std::int64_t time_delta = 0;
+	bool have_keyframe = false;
+
+	while (offset < end) {
+		const unsigned char* pos = data_ + offset;
+		const unsigned char* const data_end = data_ + end;
+
+		const unsigned char tag = *(pos++);
+		std::uint64_t payload_size = 0;
+		if ((tag != keyframe_tag && tag != delta_tag) || !read_varint(pos, data_end, payload_size)
+				|| payload_size > static_cast<std::uint64_t>(data_end - pos)) {
+			break;
+		}
+		const unsigned char* const payload_end = pos + payload_size;
+
+		const bool keyframe = (tag == keyframe_tag);
+		if (!keyframe && !have_keyframe && offset == data_file_header.size()) {
+			break;  // the writer always starts with a keyframe
+		}
+		if (keyframe) {
+			std::fill(values.begin(), values.end(), std::nullopt);
+			time = 0;
+			time_delta = 0;
+			have_keyframe = true;
+		}
+
+		std::uint64_t time_value = 0, count = 0;
+		if (!read_varint(pos, payload_end, time_value) || !read_varint(pos, payload_end, count)) {
+			break;
+		}
+
+		// Decode into a copy, so that a corrupt record doesn't affect the state
+		auto new_values = values;
+		bool valid = true;
+		std::uint64_t id = 0;
+		for (std::uint64_t i = 0; i < count && valid; ++i) {
+			std::uint64_t id_delta = 0, value_delta = 0;
+			valid = read_varint(pos, payload_end, id_delta) && read_varint(pos, payload_end, value_delta);
+			id = (i == 0 ? id_delta : id + id_delta);
+			valid = valid && id < new_values.size();
+			if (valid) {
+				// Unsigned arithmetic, so that the deltas of extreme values wrap around correctly
+				const auto base = static_cast<std::uint64_t>(new_values[id].value_or(0));
+				new_values[id] = static_cast<std::int64_t>(base + static_cast<std::uint64_t>(zigzag_decode(value_delta)));
+			}
+		}
+		if (!valid || pos != payload_end) {
+			break;
+		}
+
+		time_delta += zigzag_decode(time_value);
+		time += time_delta;
+		if (keyframe) {
+			time_delta = 0;
+		}
+		values = std::move(new_values);
+		offset = static_cast<std::uint64_t>(payload_end - data_);
+
+		if (!callback(time, values)) {
+			break;
+		}
+	}
+
+	return offset;
+}
+
+
+
+AttributeHistoryWriter::~AttributeHistoryWriter()
+{
+	close();
+}
+
+
+
+hz::ExpectedVoid<AttributeHistoryError> AttributeHistoryWriter::open(const hz::fs::path& file_base)
+{
+	close();
+
+	AttributeHistoryReader reader;
+	if (auto open_status = reader.open(file_base); !open_status) {
+		return open_status;
+	}
+
+	std::error_code ec;
+	const auto data_file = get_data_file(file_base);
+	const auto index_file = get_index_file(file_base);
+	const auto series_file = get_series_file(file_base);
+
+	// Remove the incomplete writes
+	if (hz::fs::exists(series_file, ec)) {
+		std::string contents;
+		if (!hz::fs_file_get_contents(series_file, contents, max_series_file_size)) {
+			const auto complete_size = (contents.find_last_of('\n') == std::string::npos ? 0 : contents.find_last_of('\n') + 1);
+			if (complete_size != contents.size()) {
+				hz::fs::resize_file(series_file, complete_size, ec);
+			}
+		}
+	}
+	if (reader.get_valid_data_size() == 0) {
+		if (auto write_ec = hz::fs_file_put_contents(data_file,
+				std::string_view(reinterpret_cast<const char*>(data_file_header.data()), data_file_header.size()))) {
+			return hz::Unexpected(AttributeHistoryError::WriteError,
+					Glib::ustring::compose(_("Cannot write file \"%1\": %2"), hz::fs_path_to_string(data_file), write_ec.message()));
+		}
+		data_size_ = data_file_header.size();
+	} else {
+		data_size_ = reader.get_valid_data_size();
+		if (hz::fs::file_size(data_file, ec) != data_size_) {
+			hz::fs::resize_file(data_file, data_size_, ec);
+		}
+	}
+	if (ec) {
+		return hz::Unexpected(AttributeHistoryError::WriteError,
+				Glib::ustring::compose(_("Cannot write file \"%1\": %2"), hz::fs_path_to_string(data_file), ec.message()));
+	}
+	if (hz::fs::exists(index_file, ec)) {
+		hz::fs::resize_file(index_file, reader.get_index().size() * index_entry_size, ec);
+	}
+
+	// Restore the state, so that the unchanged values are not recorded again
+	for (std::size_t i = 0; i < reader.get_series_names().size(); ++i) {
+		series_ids_.emplace(reader.get_series_names()[i], i);
+	}
+	values_.resize(reader.get_series_names().size());
+	if (auto time_range = reader.get_time_range()) {
+		const auto from = (reader.get_index().empty() ? time_range->first
+				: std::chrono::sys_seconds(std::chrono::seconds(reader.get_index().back().first)));
+		reader.read_range(from, time_range->second,
+				[this](std::chrono::sys_seconds time, const std::vector<std::optional<std::int64_t>>& values) {
+					values_ = values;
+					last_time_ = time.time_since_epoch().count();
+				});
+	}
+
+	data_file_ = hz::fs_platform_fopen(data_file, "ab");
+	if (!data_file_) {
+		return hz::Unexpected(AttributeHistoryError::OpenError,
+				Glib::ustring::compose(_("Cannot open file \"%1\": %2"), hz::fs_path_to_string(data_file),
+				std::error_code(errno, std::system_category()).message()));
+	}
+
+	file_base_ = file_base;
+	keyframe_needed_ = true;  // the state is not known to the reader at the end of the file
+	return {};
+}
+
+
+
+hz::ExpectedVoid<AttributeHistoryError> AttributeHistoryWriter::append(const AttributeHistorySample& sample)
+{
+	if (!data_file_) {
+		return hz::Unexpected(AttributeHistoryError::WriteError, _("History file is not open."));
+	}
+
+	// Register the new series before they are used in the sample file
+	std::string new_names;
+	std::vector<std::pair<std::size_t, std::int64_t>> sample_values;
+	sample_values.reserve(sample.values.size());
+	std::size_t next_id = values_.size();
+	std::unordered_map<std::string, std::size_t> new_ids;
+	for (const auto& [name, value] : sample.values) {
+		auto iter = series_ids_.find(name);
+		if (iter == series_ids_.end()) {
+			iter = new_ids.find(name);
+			if (iter == new_ids.end()) {
+				iter = new_ids.emplace(name, next_id++).first;
+				new_names += hz::string_replace_copy(name, '\n', ' ') + "\n";
+			}
+		}
+		sample_values.emplace_back(iter->second, value);
+	}
+	if (!new_names.empty()) {
+		if (auto ec = append_to_file(get_series_file(file_base_), new_names)) {
+			return hz::Unexpected(AttributeHistoryError::WriteError,
+					Glib::ustring::compose(_("Cannot write file \"%1\": %2"), hz::fs_path_to_string(get_series_file(file_base_)), ec.message()));
+		}
+		series_ids_.merge(new_ids);
+		values_.resize(next_id);
+	}
+
+	const std::int64_t time = std::max(static_cast<std::int64_t>(sample.time.time_since_epoch().count()),
+			last_time_.value_or(std::numeric_limits<std::int64_t>::min()));
+	const bool keyframe = keyframe_needed_ || records_since_keyframe_ + 1 >= keyframe_interval;
+
+	auto new_values = values_;
+	for (const auto& [id, value] : sample_values) {
+		new_values[id] = value;
+	}
+
+	// Keyframes contain all the values, delta records only the changed ones.
+	std::vector<std::pair<std::size_t, std::int64_t>> changes;
+	for (std::size_t id = 0; id < new_values.size(); ++id) {
+		if (new_values[id].has_value() && (keyframe || new_values[id] != values_[id])) {
+			const std::int64_t base = (keyframe ? 0 : values_[id].value_or(0));
+			changes.emplace_back(id, static_cast<std::int64_t>(
+					static_cast<std::uint64_t>(new_values[id].value()) - static_cast<std::uint64_t>(base)));
+		}
+	}
+
+	const std::int64_t time_delta = (keyframe ? time : (time - last_time_.value_or(0)));
+	std::string payload;
+	write_varint(payload, zigzag_encode(keyframe ? time : (time_delta - last_time_delta_)));
+	write_varint(payload, changes.size());
+	std::size_t last_id = 0;
+	for (const auto& [id, value_delta] : changes) {
+		write_varint(payload, id - last_id);
+		write_varint(payload, zigzag_encode(value_delta));
+		last_id = id;
+	}
+
+	std::string record(1, static_cast<char>(keyframe ? keyframe_tag : delta_tag));
+	write_varint(record, payload.size());
+	record += payload;
+
+	const std::uint64_t record_offset = data_size_;
+	if (auto write_status = write_data(record); !write_status) {
+		return write_status;
+	}
+
+	values_ = std::move(new_values);
+	last_time_ = time;
+	last_time_delta_ = (keyframe ? 0 : time_delta);
+	records_since_keyframe_ = (keyframe ? 0 : records_since_keyframe_ + 1);
+	keyframe_needed_ = false;
+
+	// A missing index entry only makes reading slower, the keyframe is still decoded.
+	if (keyframe) {
+		if (auto ec = append_to_file(get_index_file(file_base_), encode_index_entry(time, record_offset))) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Cannot write the history index of \""
+					<< hz::fs_path_to_string(file_base_) << "\": " << ec.message() << "\n");
+		}
+	}
+
+	return {};
+}
+
+
+
+void AttributeHistoryWriter::close()
+{
+	if (data_file_) {
+		std::fclose(data_file_);
+		data_file_ = nullptr;
+	}
+	data_size_ = 0;
+	series_ids_.clear();
+	values_.clear();
+	last_time_.reset();
+	last_time_delta_ = 0;
+	records_since_keyframe_ = 0;
+	keyframe_needed_ = true;
+}
+
+
+
+hz::ExpectedVoid<AttributeHistoryError> AttributeHistoryWriter::write_data(const std::string& data)
+{
+	if (std::fwrite(data.data(), data.size(), 1, data_file_) != 1 || std::fflush(data_file_) != 0) {
+		const auto ec = std::error_code(errno, std::system_category());
+		// The next open() will remove the partial record
+		close();
+		return hz::Unexpected(AttributeHistoryError::WriteError,
+				Glib::ustring::compose(_("Cannot write file \"%1\": %2"), hz::fs_path_to_string(get_data_file(file_base_)), ec.message()));
+	}
+	data_size_ += data.size();
+	return {};
+}
+
+
+
+
+
+
+/// @}
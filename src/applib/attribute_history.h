@@ -0,0 +1,224 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef ATTRIBUTE_HISTORY_H
+#define ATTRIBUTE_HISTORY_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "hz/error_container.h"
+#include "hz/fs.h"
+#include "storage_property_repository.h"
+
+
+
+/*
+Attribute history is stored in three append-only files per drive:
+
+<base>.gshist - Samples. An 8-byte header followed by records, each being
+	a tag byte, a varint payload size, and the payload. Each sample records only
+	the series which changed since the previous one, as (series id delta, value delta)
+	varint pairs, with the time stored as a delta of the previous time delta
+	(0 for regularly spaced samples). A keyframe record ('K') resets the state and contains
+	all the series with absolute values; other records ('D') are deltas.
+<base>.gshidx - Index. A fixed-size entry (time, offset) for each keyframe, so that
+	a time range can be found with a binary search.
+<base>.gshser - Series names, one per line. The line number is the series id.
+
+A torn write (e.g. on power loss) leaves an incomplete record at the end, which is
+ignored by the reader and removed by the writer.
+*/
+
+
+
+/// Attribute history errors
+enum class AttributeHistoryError {
+	OpenError,  ///< Cannot open or create a file
+	ReadError,  ///< Cannot read a file
+	WriteError,  ///< Cannot write to a file
+	FormatError,  ///< Not a history file, or an unsupported version
+};
+
+
+
+/// A set of values of a drive at some point in time
+struct AttributeHistorySample {
+	std::chrono::sys_seconds time;  ///< Sample time
+	std::vector<std::pair<std::string, std::int64_t>> values;  ///< Series name and value
+
+	/// Create a sample from the recordable properties: ATA attributes (normalized and raw values),
+	/// ATA statistics, NVMe health log counters and temperatures.
+	[[nodiscard]] static AttributeHistorySample create(const StoragePropertyRepository& repository, std::chrono::sys_seconds time);
+};
+
+
+
+/// Get the base path of the history files of a drive.
+/// The drive is identified by its model and serial number, so the history stays with the drive
+/// if the device name changes.
+[[nodiscard]] hz::fs::path attribute_history_get_file_base(const hz::fs::path& dir,
+		const std::string& model, const std::string& serial, const std::string& device);
+
+
+
+/// Reads attribute history. The sample file is memory-mapped, and the index
+/// is used to skip to the requested time range, so reading a range of a large file is fast.
+/// The files are read as they were at open(); reopen to see the new samples.
+class AttributeHistoryReader {
+	public:
+
+		/// Receives the values of all series at a sample time. The vector is indexed by series id,
+		/// std::nullopt means the series has no value yet.
+		using SampleCallback = std::function<void(std::chrono::sys_seconds time,
+				const std::vector<std::optional<std::int64_t>>& values)>;
+
+
+		/// Constructor
+		AttributeHistoryReader();
+
+		/// Destructor
+		~AttributeHistoryReader();
+
+		/// Deleted
+		AttributeHistoryReader(const AttributeHistoryReader& other) = delete;
+
+		/// Deleted
+		AttributeHistoryReader& operator=(const AttributeHistoryReader& other) = delete;
+
+
+		/// Open the history files. Missing files are treated as an empty history.
+		[[nodiscard]] hz::ExpectedVoid<AttributeHistoryError> open(const hz::fs::path& file_base);
+
+
+		/// Get all the series names, indexed by series id
+		[[nodiscard]] const std::vector<std::string>& get_series_names() const;
+
+
+		/// Get the id of a series
+		[[nodiscard]] std::optional<std::size_t> get_series_id(const std::string& name) const;
+
+
+		/// Get the time of the first and the last samples.
+		/// \return std::nullopt if there are no samples.
+		[[nodiscard]] std::optional<std::pair<std::chrono::sys_seconds, std::chrono::sys_seconds>> get_time_range() const;
+
+
+		/// Call \c callback for each sample in [from, to], in chronological order
+		void read_range(std::chrono::sys_seconds from, std::chrono::sys_seconds to, const SampleCallback& callback) const;
+
+
+		/// Get the values of a series in [from, to]. Samples where the series has no value are skipped.
+		[[nodiscard]] std::vector<std::pair<std::chrono::sys_seconds, std::int64_t>> read_series(const std::string& name,
+				std::chrono::sys_seconds from, std::chrono::sys_seconds to) const;
+
+
+		/// Get the size of the decodable part of the sample file. Anything after it is an incomplete write.
+		[[nodiscard]] std::uint64_t get_valid_data_size() const;
+
+
+		/// Get the index entries which point to valid keyframes: time and sample file offset
+		[[nodiscard]] const std::vector<std::pair<std::int64_t, std::uint64_t>>& get_index() const;
+
+
+	private:
+
+		/// Close the mapping
+		void close();
+
+		/// Decode records from \c offset until \c end or until the callback returns false.
+		/// \return Offset after the last complete record.
+		std::uint64_t decode(std::uint64_t offset, std::uint64_t end,
+				const std::function<bool(std::int64_t time, const std::vector<std::optional<std::int64_t>>& values)>& callback) const;
+
+
+		std::vector<std::string> series_names_;  ///< Series names, indexed by id
+		std::unordered_map<std::string, std::size_t> series_ids_;  ///< Series name to id
+
+		const unsigned char* data_ = nullptr;  ///< Mapped sample file
+		std::uint64_t data_size_ = 0;  ///< Size of mapped sample file
+		std::string data_buffer_;  ///< Sample file contents, if it cannot be memory-mapped
+		std::uint64_t valid_data_size_ = 0;  ///< Size of the decodable part of the sample file
+
+		std::vector<std::pair<std::int64_t, std::uint64_t>> index_;  ///< Keyframe times and offsets
+
+		std::optional<std::pair<std::int64_t, std::int64_t>> time_range_;  ///< Time of the first and the last samples
+
+};
+
+
+
+/// Appends samples to attribute history. Samples with a time earlier than the previous
+/// sample are recorded with the previous time, so that the index stays sorted.
+class AttributeHistoryWriter {
+	public:
+
+		/// Number of records between keyframes
+		static constexpr int keyframe_interval = 256;
+
+
+		/// Constructor
+		AttributeHistoryWriter() = default;
+
+		/// Destructor
+		~AttributeHistoryWriter();
+
+		/// Deleted
+		AttributeHistoryWriter(const AttributeHistoryWriter& other) = delete;
+
+		/// Deleted
+		AttributeHistoryWriter& operator=(const AttributeHistoryWriter& other) = delete;
+
+
+		/// Open or create the history files, removing any incomplete writes at their ends.
+		[[nodiscard]] hz::ExpectedVoid<AttributeHistoryError> open(const hz::fs::path& file_base);
+
+
+		/// Append a sample. Only the values which changed since the previous sample are stored.
+		[[nodiscard]] hz::ExpectedVoid<AttributeHistoryError> append(const AttributeHistorySample& sample);
+
+
+		/// Close the files
+		void close();
+
+
+	private:
+
+		/// Write to the sample file and flush
+		[[nodiscard]] hz::ExpectedVoid<AttributeHistoryError> write_data(const std::string& data);
+
+
+		hz::fs::path file_base_;  ///< Base path of the files
+		std::FILE* data_file_ = nullptr;  ///< Sample file, open for appending
+		std::uint64_t data_size_ = 0;  ///< Size of the sample file
+
+		std::unordered_map<std::string, std::size_t> series_ids_;  ///< Series name to id
+		std::vector<std::optional<std::int64_t>> values_;  ///< Last value of each series, indexed by id
+
+		std::optional<std::int64_t> last_time_;  ///< Time of the last sample
+		std::int64_t last_time_delta_ = 0;  ///< Time between the last two samples
+		int records_since_keyframe_ = 0;  ///< Number of records after the last keyframe
+		bool keyframe_needed_ = true;  ///< If true, the next record is a keyframe
+
+};
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,343 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>  // std::max, std::min
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "fmt/format.h"
+
+#include "attribute_trend.h"
+
+
+
+namespace {
+
+
+	/// Seconds per day, for slope units
+	constexpr double seconds_per_day = 24. * 60. * 60.;
+
+	/// Minimum time span of samples for rate-based predictions, to avoid acting on noise
+	constexpr std::chrono::days min_prediction_span(7);
+
+	/// If a prediction is closer than this, it's an alert
+	constexpr double alert_days = 30.;
+
+	/// If a prediction is closer than this, it's a warning
+	constexpr double warning_days = 180.;
+
+	/// Error count growth rate per day which is an alert
+	constexpr double error_count_alert_rate = 1.;
+
+	/// Temperature series, by priority. Only the first one present in a sample is tracked,
+	/// so that NVMe drives are not judged by ATA limits.
+	constexpr std::array<std::pair<const char*, std::int64_t>, 3> temperature_limits = {{
+		{"nvme_smart_health_information_log/temperature", 70},
+		{"ata_sct_status/temperature/current", 55},
+		{"temperature/current", 55},
+	}};
+
+	/// Number of excursions which is a warning
+	constexpr int excursion_warning_count = 10;
+
+	/// Total time above the limit which is a warning
+	constexpr std::chrono::hours excursion_warning_time(24);
+
+
+	/// Check if the raw value of an ATA attribute is a count of errors
+	bool is_error_count_attribute(std::int32_t id)
+	{
+		switch (id) {
+			case 5:  // Reallocated Sector Count
+			case 187:  // Reported Uncorrectable
+			case 196:  // Reallocation Event Count
+			case 197:  // Current Pending Sector Count
+			case 198:  // Offline Uncorrectable
+				return true;
+			default:
+				return false;
+		}
+	}
+
+
+	/// Warning level of a prediction, in days
+	WarningLevel get_prediction_warning_level(double days)
+	{
+		if (days < alert_days) {
+			return WarningLevel::Alert;
+		}
+		if (days < warning_days) {
+			return WarningLevel::Warning;
+		}
+		return WarningLevel::None;
+	}
+
+
+	/// Raise the warning level of a property and add the reason
+	void escalate_warning(StorageProperty& p, WarningLevel level, const std::string& reason)
+	{
+		p.warning_level = std::max(p.warning_level, level);
+		if (p.warning_reason.empty()) {
+			p.warning_reason = reason;
+		} else {
+			p.warning_reason += "\n" + reason;
+		}
+	}
+
+
+	/// Format a number of days for warning reasons
+	std::string format_days(double days)
+	{
+		return fmt::format("{:.0f}", std::max(days, 0.));
+	}
+
+
+}
+
+
+
+void AttributeTrendStats::add(std::chrono::sys_seconds time, std::int64_t value, std::chrono::seconds time_constant)
+{
+	if (sample_count == 0) {
+		first_time = time;
+		last_time = time;
+		first_value = value;
+		min_value = value;
+		max_value = value;
+	}
+
+	// Move the origin to the new sample and decay the old weights
+	const double d = static_cast<double>(std::max(time - last_time, std::chrono::sys_seconds::duration::zero()).count()) / seconds_per_day;
+	const double decay = std::exp(-d * seconds_per_day / static_cast<double>(std::max(time_constant.count(), std::int64_t(1))));
+
+	sum_wxx = decay * (sum_wxx - 2. * d * sum_wx + d * d * sum_w);
+	sum_wxv = decay * (sum_wxv - d * sum_wv);
+	sum_wx = decay * (sum_wx - d * sum_w);
+	sum_wv = decay * sum_wv;
+	sum_w = decay * sum_w;
+
+	// The new sample is at x = 0
+	const double v = static_cast<double>(value) - static_cast<double>(first_value);
+	sum_w += 1.;
+	sum_wv += v;
+
+	++sample_count;
+	last_time = std::max(last_time, time);
+	last_value = value;
+	min_value = std::min(min_value, value);
+	max_value = std::max(max_value, value);
+}
+
+
+
+std::optional<double> AttributeTrendStats::get_slope_per_day() const
+{
+	const double denominator = sum_w * sum_wxx - sum_wx * sum_wx;
+	// Tiny denominators come from samples at (almost) the same time, or from rounding.
+	if (sample_count < 2 || !(denominator > 1e-9 * sum_w * sum_w)) {
+		return std::nullopt;
+	}
+	return (sum_w * sum_wxv - sum_wx * sum_wv) / denominator;
+}
+
+
+
+std::chrono::seconds AttributeTrendStats::get_time_span() const
+{
+	return last_time - first_time;
+}
+
+
+
+AttributeTrendTracker::AttributeTrendTracker(std::chrono::seconds time_constant)
+		: time_constant_(time_constant)
+{ }
+
+
+
+std::shared_ptr<AttributeTrendTracker> AttributeTrendTracker::create(const hz::fs::path& history_dir,
+		const std::string& model, const std::string& serial, const std::string& device)
+{
+	auto tracker = std::make_shared<AttributeTrendTracker>();
+	if (!history_dir.empty()) {
+		AttributeHistoryReader reader;
+		if (reader.open(attribute_history_get_file_base(history_dir, model, serial, device))) {
+			tracker->add_history(reader);
+		}
+	}
+	return tracker;
+}
+
+
+
+void AttributeTrendTracker::add_sample(const AttributeHistorySample& sample)
+{
+	const auto time = last_time_.has_value() ? std::max(sample.time, last_time_.value()) : sample.time;
+
+	for (const auto& [name, value] : sample.values) {
+		stats_[name].add(time, value, time_constant_);
+	}
+
+	for (const auto& [name, limit] : temperature_limits) {
+		auto iter = std::find_if(sample.values.begin(), sample.values.end(),
+				[n = name](const auto& v) { return v.first == n; });
+		if (iter == sample.values.end()) {
+			continue;
+		}
+		auto& excursions = excursions_[name];
+		if (iter->second > limit) {
+			if (!excursions.above) {
+				++excursions.count;
+			} else if (last_time_.has_value()) {
+				excursions.time_above += time - last_time_.value();
+			}
+			excursions.above = true;
+		} else {
+			excursions.above = false;
+		}
+		excursions.max_temperature = std::max(excursions.max_temperature, iter->second);
+		break;
+	}
+
+	last_time_ = time;
+}
+
+
+
+void AttributeTrendTracker::add_history(const AttributeHistoryReader& reader)
+{
+	const auto from = last_time_.has_value() ? last_time_.value() + std::chrono::seconds(1)
+			: std::chrono::sys_seconds(std::chrono::seconds(std::numeric_limits<std::int64_t>::min() / 2));
+	const auto to = std::chrono::sys_seconds(std::chrono::seconds(std::numeric_limits<std::int64_t>::max() / 2));
+	const auto& names = reader.get_series_names();
+
+	AttributeHistorySample sample;
+	reader.read_range(from, to, [&](std::chrono::sys_seconds time, const std::vector<std::optional<std::int64_t>>& values) {
+		sample.time = time;
+		sample.values.clear();
+		for (std::size_t id = 0; id < values.size() && id < names.size(); ++id) {
+			if (values[id].has_value()) {
+				sample.values.emplace_back(names[id], values[id].value());
+			}
+		}
+		add_sample(sample);
+	});
+}
+
+
+
+const AttributeTrendStats* AttributeTrendTracker::get_stats(const std::string& series_name) const
+{
+	auto iter = stats_.find(series_name);
+	return iter == stats_.end() ? nullptr : &iter->second;
+}
+
+
+
+const AttributeTrendExcursions* AttributeTrendTracker::get_excursions(const std::string& series_name) const
+{
+	auto iter = excursions_.find(series_name);
+	return iter == excursions_.end() ? nullptr : &iter->second;
+}
+
+
+
+std::optional<std::chrono::sys_seconds> AttributeTrendTracker::get_last_time() const
+{
+	return last_time_;
+}
+
+
+
+void AttributeTrendTracker::apply_warnings(StoragePropertyRepository& repository) const
+{
+	repository.modify_properties([this](StorageProperty& p) {
+		apply_property_warnings(p);
+	});
+}
+
+
+
+void AttributeTrendTracker::apply_property_warnings(StorageProperty& p) const
+{
+	if (p.is_value_type<AtaStorageAttribute>()) {
+		const auto& attribute = p.get_value<AtaStorageAttribute>();
+		const std::string key = "ata_attribute/" + std::to_string(attribute.id);
+
+		// Growing error counts
+		if (is_error_count_attribute(attribute.id)) {
+			if (const auto* stats = get_stats(key + "/raw"); stats && stats->last_value > stats->first_value) {
+				const auto slope = stats->get_slope_per_day();
+				const bool fast = slope.has_value() && slope.value() >= error_count_alert_rate
+						&& stats->get_time_span() >= std::chrono::days(1);
+				escalate_warning(p, fast ? WarningLevel::Alert : WarningLevel::Warning,
+						fmt::format("The raw value increased by {} in the last {} days{}.",
+								stats->last_value - stats->first_value,
+								format_days(static_cast<double>(stats->get_time_span().count()) / seconds_per_day),
+								fast ? fmt::format(", recently by {:.1f} per day", slope.value()) : std::string()));
+			}
+		}
+
+		// Normalized value approaching the threshold
+		if (attribute.value.has_value() && attribute.threshold.has_value() && attribute.threshold.value() > 0
+				&& attribute.value.value() > attribute.threshold.value()) {
+			const auto* stats = get_stats(key + "/value");
+			const auto slope = stats ? stats->get_slope_per_day() : std::nullopt;
+			if (stats && slope.has_value() && slope.value() < 0. && stats->last_value < stats->first_value
+					&& stats->get_time_span() >= min_prediction_span) {
+				const double days = static_cast<double>(attribute.value.value() - attribute.threshold.value()) / -slope.value();
+				if (const auto level = get_prediction_warning_level(days); level != WarningLevel::None) {
+					escalate_warning(p, level, fmt::format("At the current rate, the normalized value will reach "
+							"the threshold in about {} days.", format_days(days)));
+				}
+			}
+		}
+		return;
+	}
+
+	if (!p.is_value_type<std::int64_t>()) {
+		return;
+	}
+
+	if (p.generic_name == "nvme_smart_health_information_log/media_errors") {
+		if (const auto* stats = get_stats(p.generic_name); stats && stats->last_value > stats->first_value) {
+			escalate_warning(p, WarningLevel::Warning, fmt::format("The number of media errors increased by {} in the last {} days.",
+					stats->last_value - stats->first_value,
+					format_days(static_cast<double>(stats->get_time_span().count()) / seconds_per_day)));
+		}
+
+	} else if (p.generic_name == "nvme_smart_health_information_log/percentage_used") {
+		const auto* stats = get_stats(p.generic_name);
+		const auto slope = stats ? stats->get_slope_per_day() : std::nullopt;
+		const auto used = p.get_value<std::int64_t>();
+		if (stats && slope.has_value() && slope.value() > 0. && used < 100
+				&& stats->get_time_span() >= min_prediction_span) {
+			const double days = static_cast<double>(100 - used) / slope.value();
+			if (const auto level = get_prediction_warning_level(days); level != WarningLevel::None) {
+				escalate_warning(p, level, fmt::format("At the current rate, the drive will reach its rated endurance "
+						"in about {} days.", format_days(days)));
+			}
+		}
+
+	} else if (const auto* excursions = get_excursions(p.generic_name); excursions && excursions->count > 0) {
+		const bool frequent = excursions->count >= excursion_warning_count
+				|| excursions->time_above >= excursion_warning_time;
+		escalate_warning(p, frequent ? WarningLevel::Warning : WarningLevel::Notice,
+				fmt::format("The temperature exceeded the recommended limit {} times, reaching {} degrees Celsius.",
+						excursions->count, excursions->max_temperature));
+	}
+}
+
+
+
+
+/// @}
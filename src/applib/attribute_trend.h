@@ -0,0 +1,136 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef ATTRIBUTE_TREND_H
+#define ATTRIBUTE_TREND_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "attribute_history.h"
+#include "storage_property_repository.h"
+
+
+
+/// Rolling statistics of a series. Each sample is added in O(1).
+/// The slope is an exponentially weighted least-squares fit, so that recent
+/// samples matter more and the old ones need not be kept.
+struct AttributeTrendStats {
+
+	/// Add a sample. Samples earlier than the last one are treated as having its time.
+	/// \param time_constant Age at which the weight of a sample drops to 1/e
+	void add(std::chrono::sys_seconds time, std::int64_t value, std::chrono::seconds time_constant);
+
+	/// Get the slope of the weighted fit, in units per day.
+	/// \return std::nullopt if the samples don't span any time.
+	[[nodiscard]] std::optional<double> get_slope_per_day() const;
+
+	/// Get the time between the first and the last samples
+	[[nodiscard]] std::chrono::seconds get_time_span() const;
+
+
+	std::int64_t sample_count = 0;  ///< Number of samples
+	std::chrono::sys_seconds first_time;  ///< Time of the first sample
+	std::chrono::sys_seconds last_time;  ///< Time of the last sample
+	std::int64_t first_value = 0;  ///< Value of the first sample
+	std::int64_t last_value = 0;  ///< Value of the last sample
+	std::int64_t min_value = 0;  ///< Smallest value
+	std::int64_t max_value = 0;  ///< Largest value
+
+	// Weighted sums of the fit. The time (x, in days) is relative to the last sample,
+	// and the value (v) is relative to the first one, to keep the precision.
+	double sum_w = 0.;  ///< Sum of weights
+	double sum_wx = 0.;  ///< Sum of w*x
+	double sum_wxx = 0.;  ///< Sum of w*x*x
+	double sum_wv = 0.;  ///< Sum of w*v
+	double sum_wxv = 0.;  ///< Sum of w*x*v
+};
+
+
+
+/// Temperature excursion statistics
+struct AttributeTrendExcursions {
+	int count = 0;  ///< Number of times the temperature rose above the limit
+	std::chrono::seconds time_above;  ///< Approximate total time spent above the limit
+	std::int64_t max_temperature = 0;  ///< Highest temperature seen
+	bool above = false;  ///< True if the last sample was above the limit
+};
+
+
+
+/// Tracks the trends of drive attributes and predicts failures from them.
+/// Samples are added as they are fetched (optionally bootstrapped once from attribute history),
+/// so no history has to be re-read on refresh.
+class AttributeTrendTracker {
+	public:
+
+		/// Constructor
+		/// \param time_constant Age at which the weight of a sample in the slope estimate drops to 1/e
+		explicit AttributeTrendTracker(std::chrono::seconds time_constant = std::chrono::days(30));
+
+
+		/// Create a tracker for a drive, bootstrapped from its attribute history in \c history_dir
+		/// (see attribute_history_get_file_base()). If \c history_dir is empty, or there is no
+		/// history for the drive, the tracker starts empty.
+		[[nodiscard]] static std::shared_ptr<AttributeTrendTracker> create(const hz::fs::path& history_dir,
+				const std::string& model, const std::string& serial, const std::string& device);
+
+
+		/// Add a sample
+		void add_sample(const AttributeHistorySample& sample);
+
+
+		/// Add all the samples of a history which are newer than the last added sample
+		void add_history(const AttributeHistoryReader& reader);
+
+
+		/// Get the statistics of a series (see AttributeHistorySample for the names)
+		[[nodiscard]] const AttributeTrendStats* get_stats(const std::string& series_name) const;
+
+
+		/// Get the temperature excursion statistics of a temperature series
+		[[nodiscard]] const AttributeTrendExcursions* get_excursions(const std::string& series_name) const;
+
+
+		/// Get the time of the last added sample
+		[[nodiscard]] std::optional<std::chrono::sys_seconds> get_last_time() const;
+
+
+		/// Raise the warning levels of properties with worrying trends: growing error counts,
+		/// wear-out or normalized values approaching their thresholds, and temperature excursions.
+		/// Warning levels are never lowered; trend descriptions are added to the warning reasons.
+		void apply_warnings(StoragePropertyRepository& repository) const;
+
+
+	private:
+
+		/// Apply warnings to a single property
+		void apply_property_warnings(StorageProperty& p) const;
+
+
+		std::chrono::seconds time_constant_;  ///< Weight time constant
+
+		std::unordered_map<std::string, AttributeTrendStats> stats_;  ///< Series statistics
+		std::unordered_map<std::string, AttributeTrendExcursions> excursions_;  ///< Temperature series excursions
+
+		std::optional<std::chrono::sys_seconds> last_time_;  ///< Time of the last added sample
+
+};
+
+
+
+#endif
+
+/// @}
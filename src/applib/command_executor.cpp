@@ -72,6 +72,7 @@ std::vector<std::string> CommandExecutor::get_command_args() const
 bool CommandExecutor::execute()
 {
 	set_error_msg("");  // clear old error if present
+	exit_status_ = 0;
 
 	const bool slot_connected = !(signal_execute_tick().slots().begin() == signal_execute_tick().slots().end());
 
@@ -140,6 +141,14 @@ bool CommandExecutor::execute()
 
 	// command exited, do a cleanup.
 	cmdex_.stopped_cleanup();
+
+	// A non-zero exit status is reported as an error. The error may not be
+	// the last one, so look it up before import_error() clears them.
+	for (const auto& e : cmdex_.get_errors()) {
+		if (e->get_type() == "exit") {
+			[[maybe_unused]] const bool status = e->get_code(exit_status_);
+		}
+	}
 	import_error();  // get error from cmdex and display warnings if needed
 
 	// emit this for execution loggers
@@ -224,6 +233,13 @@ void CommandExecutor::set_exit_status_translator(AsyncCommandExecutor::exit_stat
 
 
 
+int CommandExecutor::get_exit_status() const
+{
+	return exit_status_;
+}
+
+
+
 std::string CommandExecutor::get_error_msg(bool with_header) const
 {
 	if (with_header)
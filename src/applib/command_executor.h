@@ -136,15 +136,21 @@ class CommandExecutor : public sigc::trackable {
 		void set_buffer_sizes(gsize stdout_buffer_size = 0, gsize stderr_buffer_size = 0);
 
 		/// See AsyncCommandExecutor::get_stdout_str() for details.
-		[[nodiscard]] std::string get_stdout_str(bool clear_existing = false);
+		/// Virtual, so that the executors which don't run anything (e.g. CommandExecutorReplay) can provide the output.
+		[[nodiscard]] virtual std::string get_stdout_str(bool clear_existing = false);
 
 		/// See AsyncCommandExecutor::get_stderr_str() for details.
-		[[nodiscard]] std::string get_stderr_str(bool clear_existing = false);
+		[[nodiscard]] virtual std::string get_stderr_str(bool clear_existing = false);
 
 		/// See AsyncCommandExecutor::set_exit_status_translator() for details.
 		void set_exit_status_translator(AsyncCommandExecutor::exit_status_translator_func_t func);
 
 
+		/// Get the exit status of the last executed command. This is 0 if the command
+		/// exited with 0, was killed by a signal, or couldn't be executed.
+		[[nodiscard]] virtual int get_exit_status() const;
+
+
 		/// Get command execution error message. If \c with_header
 		/// is true, a header set using set_error_header() will be displayed first.
 		[[nodiscard]] std::string get_error_msg(bool with_header = false) const;
@@ -219,6 +225,7 @@ class CommandExecutor : public sigc::trackable {
 
 		std::chrono::milliseconds forced_kill_timeout_msec_ = std::chrono::seconds(3);  // 3 sec by default. Kill timeout in ms.
 
+		int exit_status_ = 0;  ///< Exit status of the last executed command
 		std::string error_msg_;  ///< Execution error message
 		std::string error_header_;  ///< The error message may have this prepended to it.
 
@@ -0,0 +1,102 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>  // std::all_of, std::find, std::find_if
+
+#include "hz/debug.h"
+#include "command_executor_replay.h"
+
+
+
+void CommandExecutorReplay::add_output(const std::vector<std::string>& args, std::string output, int exit_status)
+{
+	auto iter = std::find_if(entries_.begin(), entries_.end(),
+			[&args](const Entry& entry) { return entry.args == args; });
+	if (iter == entries_.end()) {
+		iter = entries_.insert(entries_.end(), Entry {args, {}});
+	}
+	iter->outputs.push_back(Output {std::move(output), exit_status});
+}
+
+
+
+const std::vector<std::vector<std::string>>& CommandExecutorReplay::get_executed_args() const
+{
+	return executed_args_;
+}
+
+
+
+bool CommandExecutorReplay::execute()
+{
+	set_error_msg("");  // clear old error if present
+	stdout_str_.clear();
+	exit_status_ = 0;
+
+	const std::vector<std::string> command_args = get_command_args();
+	executed_args_.push_back(command_args);
+
+	auto iter = std::find_if(entries_.begin(), entries_.end(), [&command_args](const Entry& entry) {
+		return std::all_of(entry.args.begin(), entry.args.end(), [&command_args](const std::string& arg) {
+			return std::find(command_args.begin(), command_args.end(), arg) != command_args.end();
+		});
+	});
+
+	if (iter == entries_.end() || iter->outputs.empty()) {
+		debug_out_warn("app", DBG_FUNC_MSG << "No recorded output for command \"" << get_command_name() << "\".\n");
+		set_error_msg("No recorded output for this command.");
+
+	} else {
+		stdout_str_ = iter->outputs.front().output;
+		exit_status_ = iter->outputs.front().exit_status;
+		if (iter->outputs.size() > 1) {
+			iter->outputs.pop_front();
+		}
+	}
+
+	// emit this for execution loggers
+	cmdex_sync_signal_execute_finish().emit(CommandExecutorResult(get_command_name(),
+			command_args, stdout_str_, std::string(), get_error_msg()));
+
+	return get_error_msg().empty();
+}
+
+
+
+std::string CommandExecutorReplay::get_stdout_str(bool clear_existing)
+{
+	std::string ret = stdout_str_;
+	if (clear_existing) {
+		stdout_str_.clear();
+	}
+	return ret;
+}
+
+
+
+std::string CommandExecutorReplay::get_stderr_str([[maybe_unused]] bool clear_existing)
+{
+	return {};
+}
+
+
+
+int CommandExecutorReplay::get_exit_status() const
+{
+	return exit_status_;
+}
+
+
+
+
+
+
+/// @}
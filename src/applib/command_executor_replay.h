@@ -0,0 +1,81 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef COMMAND_EXECUTOR_REPLAY_H
+#define COMMAND_EXECUTOR_REPLAY_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "command_executor.h"
+
+
+
+/// Command executor which doesn't execute anything, but replays previously
+/// recorded outputs instead. This allows running the code which executes smartctl
+/// (e.g. self-tests) without the drives being present.
+class CommandExecutorReplay : public CommandExecutor {
+	public:
+
+		/// Add an output for the commands whose arguments contain all of \c args
+		/// (e.g. {"--test=short", "/dev/sda"}). The outputs added for the same \c args
+		/// are replayed in order, and the last one is repeated. If several entries match
+		/// a command, the one added first is used. \c exit_status is reported by
+		/// get_exit_status() when the output is replayed.
+		void add_output(const std::vector<std::string>& args, std::string output, int exit_status = 0);
+
+
+		/// Get the arguments of all the executed commands, in order
+		[[nodiscard]] const std::vector<std::vector<std::string>>& get_executed_args() const;
+
+
+		// Reimplemented from CommandExecutor
+		bool execute() override;
+
+
+		// Reimplemented from CommandExecutor
+		[[nodiscard]] std::string get_stdout_str(bool clear_existing = false) override;
+
+
+		// Reimplemented from CommandExecutor
+		[[nodiscard]] std::string get_stderr_str(bool clear_existing = false) override;
+
+		// Reimplemented from CommandExecutor
+		[[nodiscard]] int get_exit_status() const override;
+
+
+	private:
+
+		/// Recorded output of a command
+		struct Output {
+			std::string output;  ///< Stdout data
+			int exit_status = 0;  ///< Exit status
+		};
+
+		/// Recorded outputs of matching commands
+		struct Entry {
+			std::vector<std::string> args;  ///< Arguments the command must contain
+			std::deque<Output> outputs;  ///< Outputs to replay
+		};
+
+		std::vector<Entry> entries_;  ///< Recorded outputs
+		std::vector<std::vector<std::string>> executed_args_;  ///< Arguments of the executed commands
+		std::string stdout_str_;  ///< Output of the last executed command
+		int exit_status_ = 0;  ///< Exit status of the last executed command
+
+};
+
+
+
+#endif
+
+/// @}
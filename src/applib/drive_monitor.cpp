@@ -0,0 +1,293 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <glibmm.h>
+#include <algorithm>  // std::clamp, std::max, std::min
+
+#include "nlohmann/json.hpp"
+
+#include "hz/debug.h"
+#include "drive_monitor.h"
+#include "attribute_trend.h"
+#include "storage_property.h"
+
+
+
+namespace {
+
+	/// Get a storable name of a warning level
+	const char* get_warning_level_storable_name(WarningLevel level)
+	{
+		switch (level) {
+			case WarningLevel::None: return "none";
+			case WarningLevel::Notice: return "notice";
+			case WarningLevel::Warning: return "warning";
+			case WarningLevel::Alert: return "alert";
+		}
+		return "none";
+	}
+
+
+	/// Check if the drive type is known, so that the full data can be fetched
+	bool has_known_type(const StorageDevice& drive)
+	{
+		return drive.get_detected_type() != StorageDeviceDetectedType::Unknown
+				&& drive.get_detected_type() != StorageDeviceDetectedType::NeedsExplicitType;
+	}
+
+}
+
+
+
+std::string DriveMonitorRecord::to_json_line() const
+{
+	nlohmann::json root;
+	root["time"] = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+	root["device"] = device;
+	root["model"] = model;
+	root["serial"] = serial;
+	root["health_passed"] = (health_passed.has_value() ? nlohmann::json(health_passed.value()) : nlohmann::json());
+	root["max_warning_level"] = get_warning_level_storable_name(max_warning_level);
+
+	nlohmann::json warnings_node = nlohmann::json::array();
+	for (const auto& warning : warnings) {
+		warnings_node.push_back({
+			{"name", warning.generic_name},
+			{"displayable_name", warning.displayable_name},
+			{"value", warning.value},
+			{"level", get_warning_level_storable_name(warning.level)},
+			{"reason", warning.reason},
+		});
+	}
+	root["warnings"] = std::move(warnings_node);
+
+	if (in_standby) {
+		root["in_standby"] = true;
+	}
+	if (data_time.has_value()) {
+		root["data_time"] = std::chrono::duration_cast<std::chrono::seconds>(data_time->time_since_epoch()).count();
+	}
+
+	if (!error_message.empty()) {
+		root["error"] = error_message;
+	}
+
+	// smartctl output may contain invalid UTF-8 (e.g. in model names), don't throw on it.
+	return root.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+
+
+DriveMonitor::DriveMonitor(std::chrono::seconds interval, double jitter, std::uint32_t seed,
+		ExecutorFactory executor_factory)
+		: interval_(std::max(interval, std::chrono::seconds(1))), jitter_(std::clamp(jitter, 0., 1.)),
+		random_engine_(seed), executor_factory_(std::move(executor_factory))
+{ }
+
+
+
+void DriveMonitor::add_drive(StorageDevicePtr drive, Clock::time_point now)
+{
+	if (!drive || drive->get_is_virtual()) {
+		return;
+	}
+
+	// Spread the first polls over the jitter range
+	std::uniform_real_distribution<double> distribution(0., jitter_);
+	const auto delay = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(interval_) * distribution(random_engine_));
+
+	entries_.push_back(Entry {std::move(drive), now + delay, nullptr});
+}
+
+
+
+void DriveMonitor::set_history_dir(hz::fs::path dir)
+{
+	history_dir_ = std::move(dir);
+	for (auto& entry : entries_) {
+		entry.history.reset();
+	}
+}
+
+
+
+void DriveMonitor::set_allow_wakeup(bool allow_wakeup)
+{
+	allow_wakeup_ = allow_wakeup;
+}
+
+
+
+void DriveMonitor::set_full_fetch_interval(std::chrono::seconds interval)
+{
+	full_fetch_interval_ = interval;
+}
+
+
+
+std::size_t DriveMonitor::get_drive_count() const
+{
+	return entries_.size();
+}
+
+
+
+std::optional<DriveMonitor::Clock::time_point> DriveMonitor::get_next_poll_time() const
+{
+	std::optional<Clock::time_point> next_time;
+	for (const auto& entry : entries_) {
+		next_time = std::min(next_time.value_or(Clock::time_point::max()), entry.next_poll_time);
+	}
+	return next_time;
+}
+
+
+
+int DriveMonitor::poll_due(Clock::time_point now, const RecordSink& sink)
+{
+	int polled = 0;
+	for (auto& entry : entries_) {
+		if (entry.next_poll_time > now) {
+			continue;
+		}
+
+		auto ex = executor_factory_ ? executor_factory_() : nullptr;  // nullptr means default executor
+
+		// The type may be unknown if the basic data couldn't be fetched during detection.
+		hz::ExpectedVoid<StorageDeviceError> fetch_status;
+		if (!has_known_type(*entry.drive)) {
+			fetch_status = entry.drive->fetch_basic_data_and_parse(ex, allow_wakeup_);
+			if (fetch_status && !has_known_type(*entry.drive)) {
+				fetch_status = hz::Unexpected(StorageDeviceError::CommandUnknownError,
+						_("Cannot detect the drive type. Please specify it in the device options."));
+			}
+		}
+		if (fetch_status && !entry.drive->get_attribute_trend_tracker()) {
+			// Needs the model and serial number from the basic data.
+			entry.drive->set_attribute_trend_tracker(AttributeTrendTracker::create(history_dir_,
+					entry.drive->get_model_name(), entry.drive->get_serial_number(), entry.drive->get_device()));
+		}
+		if (fetch_status) {
+			// Pulse is upgraded to Full if there is no full data yet.
+			const auto full_data_time = entry.drive->get_full_data_time();
+			const bool full_due = !full_data_time.has_value()
+					|| std::chrono::system_clock::now() - full_data_time.value() >= full_fetch_interval_;
+			fetch_status = entry.drive->fetch_data_and_parse(
+					full_due ? StorageDeviceFetchTier::Full : StorageDeviceFetchTier::Pulse, ex, allow_wakeup_);
+		}
+		if (!fetch_status && fetch_status.error().data() != StorageDeviceError::InStandby) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Cannot fetch data of " << entry.drive->get_device_with_type()
+					<< ": " << fetch_status.error().message() << "\n");
+		}
+
+		if (fetch_status && !history_dir_.empty()) {
+			record_history(entry);
+		}
+
+		if (sink) {
+			sink(create_record(*entry.drive, fetch_status));
+		}
+
+		// The properties are kept for the record, but the output is not needed anymore.
+		entry.drive->clear_outputs();
+
+		// Count from the scheduled time, so that the polls don't drift.
+		entry.next_poll_time = std::max(entry.next_poll_time + get_jittered_interval(), now);
+		++polled;
+	}
+	return polled;
+}
+
+
+
+DriveMonitorRecord DriveMonitor::create_record(const StorageDevice& drive,
+		const hz::ExpectedVoid<StorageDeviceError>& fetch_status)
+{
+	DriveMonitorRecord record;
+	record.time = std::chrono::system_clock::now();
+	record.device = drive.get_device_with_type();
+	record.model = drive.get_model_name();
+	record.serial = drive.get_serial_number();
+
+	if (!fetch_status) {
+		if (fetch_status.error().data() != StorageDeviceError::InStandby) {
+			record.error_message = fetch_status.error().message();
+			return record;
+		}
+		record.in_standby = true;
+	}
+	record.data_time = drive.get_last_data_time();
+
+	const StorageProperty health = drive.get_health_property();
+	if (!health.empty() && health.is_value_type<bool>()) {
+		record.health_passed = health.get_value<bool>();
+	}
+
+	for (const auto& p : drive.get_property_repository().get_properties()) {
+		if (p.warning_level == WarningLevel::None) {
+			continue;
+		}
+		record.max_warning_level = std::max(record.max_warning_level, p.warning_level);
+		record.warnings.push_back(DriveMonitorWarning {
+			p.generic_name,
+			p.displayable_name,
+			p.format_value(),
+			p.warning_level,
+			p.warning_reason,
+		});
+	}
+
+	return record;
+}
+
+
+
+DriveMonitor::Clock::duration DriveMonitor::get_jittered_interval()
+{
+	std::uniform_real_distribution<double> distribution(1. - jitter_, 1. + jitter_);
+	return std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(interval_) * distribution(random_engine_));
+}
+
+
+
+
+void DriveMonitor::record_history(Entry& entry)
+{
+	if (!entry.history) {
+		auto history = std::make_unique<AttributeHistoryWriter>();
+		const auto file_base = attribute_history_get_file_base(history_dir_,
+				entry.drive->get_model_name(), entry.drive->get_serial_number(), entry.drive->get_device());
+		if (auto open_status = history->open(file_base); !open_status) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Cannot open the history of " << entry.drive->get_device_with_type()
+					<< ": " << open_status.error().message() << "\n");
+			return;
+		}
+		entry.history = std::move(history);
+	}
+
+	// Stale values kept from a full fetch are not recorded again on lower-tier polls
+	const auto sample = AttributeHistorySample::create(entry.drive->get_fetched_property_repository(),
+			std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now()));
+	if (auto append_status = entry.history->append(sample); !append_status) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot record the history of " << entry.drive->get_device_with_type()
+				<< ": " << append_status.error().message() << "\n");
+		entry.history.reset();  // reopen on the next poll, removing any partial write
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,161 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef DRIVE_MONITOR_H
+#define DRIVE_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "attribute_history.h"
+#include "command_executor.h"
+#include "storage_device.h"
+#include "warning_level.h"
+
+
+
+/// A property with a warning, as reported by DriveMonitor
+struct DriveMonitorWarning {
+	std::string generic_name;  ///< Generic (internal) property name
+	std::string displayable_name;  ///< Readable property name
+	std::string value;  ///< Formatted property value
+	WarningLevel level = WarningLevel::None;  ///< Warning severity
+	std::string reason;  ///< Warning reason
+};
+
+
+
+/// Result of polling a drive
+struct DriveMonitorRecord {
+	std::chrono::system_clock::time_point time;  ///< Poll time
+	std::string device;  ///< Device, with type argument if any
+	std::string model;  ///< Model name
+	std::string serial;  ///< Serial number
+	std::optional<bool> health_passed;  ///< Overall health self-assessment, if reported
+	WarningLevel max_warning_level = WarningLevel::None;  ///< Maximum warning level of all properties
+	std::vector<DriveMonitorWarning> warnings;  ///< Properties with warnings
+	bool in_standby = false;  ///< The drive was in a low-power mode and was not woken up. The data is from data_time, if any.
+	std::optional<std::chrono::system_clock::time_point> data_time;  ///< Time the most recent reported data was fetched
+	std::string error_message;  ///< Error message if the data could not be fetched
+
+	/// Format the record as a single-line JSON object
+	[[nodiscard]] std::string to_json_line() const;
+};
+
+
+
+/// Periodically polls drives, without any GUI. Each drive is polled at its own
+/// time, with the interval randomly varied by a jitter fraction, so that the polls of many
+/// drives (and of many machines started at the same time) don't line up.
+/// The properties are processed by StoragePropertyProcessor, so the records contain
+/// the same warnings as the GUI shows.
+class DriveMonitor {
+	public:
+
+		/// Clock used for scheduling
+		using Clock = std::chrono::steady_clock;
+
+		/// Creates an executor for each smartctl command
+		using ExecutorFactory = std::function<std::shared_ptr<CommandExecutor>()>;
+
+		/// Receives the poll results
+		using RecordSink = std::function<void(const DriveMonitorRecord& record)>;
+
+
+		/// Constructor.
+		/// \param interval Average interval between polls of a drive
+		/// \param jitter Maximum relative deviation of each interval, 0 - 1
+		/// \param seed Seed for the jitter
+		/// \param executor_factory Creates executors for smartctl commands. If empty, the default executor is used.
+		DriveMonitor(std::chrono::seconds interval, double jitter, std::uint32_t seed,
+				ExecutorFactory executor_factory = nullptr);
+
+
+		/// Add a drive. The first poll is scheduled randomly within the jitter of the interval after \c now.
+		void add_drive(StorageDevicePtr drive, Clock::time_point now);
+
+
+		/// Record the attribute history of each drive in \c dir. Empty disables the recording.
+		/// The attribute trends of each drive are bootstrapped from its history in this directory.
+		void set_history_dir(hz::fs::path dir);
+
+
+		/// Set whether the drives in standby or sleep mode are woken up by the polls.
+		/// By default they are not, and the records contain the last fetched data instead.
+		void set_allow_wakeup(bool allow_wakeup);
+
+
+		/// Set the interval of full data fetches. The polls in between fetch only the health and
+		/// the attributes (StorageDeviceFetchTier::Pulse). The default is one day.
+		void set_full_fetch_interval(std::chrono::seconds interval);
+
+
+		/// Get the number of monitored drives
+		[[nodiscard]] std::size_t get_drive_count() const;
+
+
+		/// Get the time of the next poll.
+		/// \return std::nullopt if there are no drives.
+		[[nodiscard]] std::optional<Clock::time_point> get_next_poll_time() const;
+
+
+		/// Poll the drives which are due at \c now, passing the results to \c sink,
+		/// and schedule their next polls.
+		/// \return Number of polled drives
+		int poll_due(Clock::time_point now, const RecordSink& sink);
+
+
+		/// Create a record from the current drive properties, or from a fetch error.
+		/// If the drive is in standby, the last fetched properties are used.
+		[[nodiscard]] static DriveMonitorRecord create_record(const StorageDevice& drive,
+				const hz::ExpectedVoid<StorageDeviceError>& fetch_status);
+
+
+	private:
+
+		/// A monitored drive
+		struct Entry {
+			StorageDevicePtr drive;  ///< Drive
+			Clock::time_point next_poll_time;  ///< Time of the next poll
+			std::unique_ptr<AttributeHistoryWriter> history;  ///< History of the drive, open after the first successful poll
+		};
+
+
+		/// Get the interval until the next poll, with jitter applied
+		[[nodiscard]] Clock::duration get_jittered_interval();
+
+		/// Append the current properties of a drive to its history
+		void record_history(Entry& entry);
+
+
+		std::chrono::seconds interval_;  ///< Average interval between polls
+		double jitter_ = 0.;  ///< Maximum relative deviation of the interval
+		std::mt19937 random_engine_;  ///< Jitter random number generator
+		ExecutorFactory executor_factory_;  ///< Executor factory, may be empty
+		hz::fs::path history_dir_;  ///< Attribute history directory, may be empty
+		bool allow_wakeup_ = false;  ///< Wake up the drives in low-power modes
+		std::chrono::seconds full_fetch_interval_ = std::chrono::hours(24);  ///< Interval of full data fetches
+
+		std::vector<Entry> entries_;  ///< Monitored drives
+
+};
+
+
+
+#endif
+
+/// @}
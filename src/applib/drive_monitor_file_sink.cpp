@@ -0,0 +1,81 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include "hz/debug.h"
+#include "drive_monitor_file_sink.h"
+
+
+
+DriveMonitorFileSink::DriveMonitorFileSink(hz::fs::path file, std::uintmax_t max_size)
+		: file_(std::move(file)), max_size_(max_size)
+{ }
+
+
+
+std::error_code DriveMonitorFileSink::write(const DriveMonitorRecord& record)
+{
+	if (file_.empty()) {
+		return std::make_error_code(std::errc::invalid_argument);
+	}
+
+	const std::string line = record.to_json_line() + "\n";
+
+	if (max_size_ > 0) {
+		std::error_code ec;
+		const std::uintmax_t size = hz::fs::file_size(file_, ec);
+		if (!ec && size + line.size() > max_size_) {
+			hz::fs::rename(file_, get_rotated_file(), ec);
+			if (ec) {
+				// Keep writing to the same file, it's better than losing the records.
+				debug_out_warn("app", DBG_FUNC_MSG << "Cannot rotate " << hz::fs_path_to_string(file_)
+						<< ": " << ec.message() << "\n");
+			}
+		}
+	}
+
+	std::FILE* f = hz::fs_platform_fopen(file_, "ab");
+	if (!f) {
+		return {errno, std::system_category()};
+	}
+
+	if (std::fwrite(line.data(), line.size(), 1, f) != 1) {
+		auto ec = std::error_code(errno, std::system_category());
+		std::fclose(f);  // don't check anything, it's too late
+		return ec;
+	}
+
+	if (std::fclose(f) != 0) {
+		return {errno, std::system_category()};
+	}
+
+	return {};
+}
+
+
+
+hz::fs::path DriveMonitorFileSink::get_rotated_file() const
+{
+	hz::fs::path rotated = file_;
+	rotated += ".1";
+	return rotated;
+}
+
+
+
+
+
+
+/// @}
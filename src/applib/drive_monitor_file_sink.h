@@ -0,0 +1,56 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef DRIVE_MONITOR_FILE_SINK_H
+#define DRIVE_MONITOR_FILE_SINK_H
+
+#include <cstdint>
+#include <system_error>
+
+#include "hz/fs.h"
+#include "drive_monitor.h"
+
+
+
+/// Appends DriveMonitor records to a file, one JSON object per line.
+/// The file is opened only for the duration of each write, so it can be removed or
+/// rotated externally at any time. When it grows beyond the maximum size, it is renamed
+/// to "<file>.1" (replacing the previous one), so the disk usage is bounded.
+class DriveMonitorFileSink {
+	public:
+
+		/// Constructor.
+		/// \param file Output file
+		/// \param max_size Maximum file size in bytes before rotation. 0 means unlimited.
+		DriveMonitorFileSink(hz::fs::path file, std::uintmax_t max_size);
+
+
+		/// Append a record to the file, rotating it first if needed.
+		/// \return Empty (zero) error code on success.
+		std::error_code write(const DriveMonitorRecord& record);
+
+
+		/// Get the file of the rotated-out records
+		[[nodiscard]] hz::fs::path get_rotated_file() const;
+
+
+	private:
+
+		hz::fs::path file_;  ///< Output file
+		std::uintmax_t max_size_ = 0;  ///< Maximum file size
+
+};
+
+
+
+#endif
+
+/// @}
@@ -48,7 +48,14 @@ inline void init_default_settings()
 
 	rconfig::set_default_data("system/smartctl_options", "");  // default options on ALL commands
 	rconfig::set_default_data("system/smartctl_device_options", "");  // dev1:val1;dev2:val2;... format, each bin2ascii-encoded.
+	rconfig::set_default_data("system/smartctl_version_cache", rconfig::json::array());  // "smartctl -V" results, keyed by binary path, inode, mtime and size.
+	rconfig::set_default_data("system/skip_unsupported_logs", true);  // Don't request the logs which a drive model didn't support before
+	rconfig::set_default_data("system/log_support_cache", rconfig::json::array());  // Unsupported logs, keyed by drive model and firmware.
+	rconfig::set_default_data("system/log_support_reprobe_days", 30);  // Request the unsupported logs again after this many days
 	rconfig::set_default_data("system/startup_manual_devices", "");  // Auto-add devices on startup
+	rconfig::set_default_data("system/warning_rules", rconfig::json::array());  // User warning rules, see StoragePropertyUserWarningRule.
+	rconfig::set_default_data("system/self_test_max_per_controller", 2);  // Maximum number of concurrent self-tests on one controller when testing several drives
+	rconfig::set_default_data("system/attribute_history_dir", "");  // Attribute history is recorded here by gsmartcontrol-monitor. Empty disables it.
 
 	rconfig::set_default_data("system/linux_udev_byid_path", "/dev/disk/by-id");  // linux hard disk device links here
 	rconfig::set_default_data("system/linux_proc_partitions_path", "/proc/partitions");  // file in linux /proc/partitions format
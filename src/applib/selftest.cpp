@@ -25,10 +25,12 @@ Copyright:
 #include "fmt/format.h"
 #include "smartctl_parser_types.h"
 #include "smartctl_parser.h"
+#include "smartctl_parse_cache.h"
 #include "storage_device_detected_type.h"
 #include "storage_property.h"
 #include "smartctl_text_ata_parser.h"
 #include "selftest.h"
+#include "selftest_status_probe.h"
 #include "storage_property_descr.h"
 #include "smartctl_version_parser.h"
 #include "app_regex.h"
@@ -89,15 +91,15 @@ std::chrono::seconds SelfTest::get_remaining_seconds() const
 {
 	using namespace std::literals;
 
-	const std::chrono::seconds total = get_min_duration_seconds();
-	if (total <= 0s)
+	if (!poll_scheduler_.has_value() || status_ != SelfTestStatus::InProgress)
+		return -1s;  // n/a
+
+	const auto completion = poll_scheduler_->get_estimated_completion();
+	if (!completion.has_value())
 		return -1s;  // unknown
 
-	const double gran = (double(total.count()) / 9.);  // seconds per 10%
-	// since remaining_percent_ may be manually set to 100, we limit from the above.
-	const double rem_seconds_at_last_change = std::min(double(total.count()), gran * remaining_percent_ / 10.);
-	const double rem = rem_seconds_at_last_change - timer_.elapsed();
-	return std::chrono::seconds(std::max(int64_t(0), (int64_t)std::round(rem)));  // don't return negative values.
+	const std::chrono::duration<double> rem = completion.value() - SelfTestPollScheduler::Clock::now();
+	return std::chrono::seconds(std::max(int64_t(0), (int64_t)std::round(rem.count())));  // don't return negative values.
 }
 
 
@@ -147,11 +149,11 @@ std::chrono::seconds SelfTest::get_min_duration_seconds() const
 		case TestType::Conveyance: prop_name = "ata_smart_data/self_test/polling_minutes/conveyance"; break;
 	}
 
-	const StorageProperty p = drive_->get_property_repository().lookup_property(prop_name,
+	const StorageProperty* p = drive_->get_property_repository().find_property(prop_name,
 			StoragePropertySection::Capabilities);
 
 	// p stores it as uint64_t
-	return (total_duration_ = (p.empty() ? 0s : p.get_value<std::chrono::seconds>()));
+	return (total_duration_ = (!p ? 0s : p->get_value<std::chrono::seconds>()));
 }
 
 
@@ -170,8 +172,8 @@ bool SelfTest::is_supported() const
 			case TestType::LongTest:
 			{
 				// Both short and long should be supported if the drive has a self-test log
-				const StorageProperty p = drive_->get_property_repository().lookup_property("nvme_self_test_log/_exists");
-				return (!p.empty() && p.get_value<bool>());
+				const StorageProperty* p = drive_->get_property_repository().find_property("nvme_self_test_log/_exists");
+				return (p && p->get_value<bool>());
 			}
 		}
 
@@ -195,8 +197,8 @@ bool SelfTest::is_supported() const
 				break;
 		}
 
-		const StorageProperty p = drive_->get_property_repository().lookup_property(prop_name);
-		return (!p.empty() && p.get_value<bool>());
+		const StorageProperty* p = drive_->get_property_repository().find_property(prop_name);
+		return (p && p->get_value<bool>());
 	}
 
 	return false;
@@ -263,12 +265,10 @@ hz::ExpectedVoid<SelfTestExecutionError> SelfTest::start(const std::shared_ptr<C
 	status_ = SelfTestStatus::InProgress;
 
 	remaining_percent_ = 100;
-	// set to 90 to avoid the 100->90 timer reset. this way we won't be looking at
-	// "remaining 60sec" on 60sec test twice (5 seconds apart). Since the test starts
-	// at 90% anyway, it's a good thing.
-	last_seen_percent_ = 90;
-	poll_in_seconds_ = std::chrono::seconds(5);  // first update() in 5 seconds
-	timer_.start();
+	// The scheduler learns the actual progress rate from update() results, starting
+	// from the duration advertised by the drive.
+	poll_scheduler_.emplace(get_min_duration_seconds(), SelfTestPollScheduler::Clock::now());
+	poll_in_seconds_ = poll_scheduler_->get_poll_delay();  // first update() in a few seconds
 
 	drive_->set_test_is_active(true);
 
@@ -326,9 +326,8 @@ hz::ExpectedVoid<SelfTestExecutionError> SelfTest::force_stop(const std::shared_
 	if (status_ == SelfTestStatus::InProgress) {  // update() couldn't do its job
 		status_ = SelfTestStatus::ManuallyAborted;
 		remaining_percent_ = -1;
-		last_seen_percent_ = -1;
 		poll_in_seconds_ = std::chrono::seconds(-1);
-		timer_.stop();
+		poll_scheduler_.reset();
 		drive_->set_test_is_active(false);
 	}
 
@@ -376,153 +375,54 @@ hz::ExpectedVoid<SelfTestExecutionError> SelfTest::update(const std::shared_ptr<
 	}
 
 
-	std::shared_ptr<SmartctlParser> parser = SmartctlParser::create(parser_type, parser_format);
-	DBG_ASSERT_RETURN(parser, hz::Unexpected(SelfTestExecutionError::ParseError, _("Cannot create parser.")));
-
-	auto parse_status = parser->parse(output);
-	if (!parse_status) {
-		return hz::Unexpected(SelfTestExecutionError::ParseError,
-				fmt::format(fmt::runtime(_("Cannot parse smartctl output: {}")), parse_status.error().message()));
-	}
-	const auto property_repo = StoragePropertyProcessor::process_properties(
-			parser->get_property_repository(), drive_->get_detected_type());
-
-
-	if (drive_->get_detected_type() == StorageDeviceDetectedType::Nvme) {
-
-		const StorageProperty current_operation = property_repo.lookup_property("nvme_self_test_log/current_self_test_operation/value/_decoded");
-
-		// If no test is active, the property may be absent, or set to None.
-		if (!current_operation.empty()
-				&& current_operation.get_value<std::string>() != NvmeSelfTestCurrentOperationTypeExt::get_storable_name(NvmeSelfTestCurrentOperationType::None)) {
-			status_ = SelfTestStatus::InProgress;
-
-			auto remaining_percent = property_repo.lookup_property("nvme_self_test_log/current_self_test_completion_percent");
-			if (!remaining_percent.empty()) {
-				remaining_percent_ = static_cast<int8_t>(100 - remaining_percent.get_value<int64_t>());
-			}
-		} else {  // no test is active
-			// The first self-test table entry is the latest.
-			std::optional<NvmeStorageSelftestEntry> entry;
-			for (const auto& e : property_repo.get_properties()) {
-				if (e.is_value_type<NvmeStorageSelftestEntry>() && e.get_value<NvmeStorageSelftestEntry>().test_num == 1) {
-					entry = e.get_value<NvmeStorageSelftestEntry>();
-				}
-			}
-			if (!entry) {
-				return hz::Unexpected(SelfTestExecutionError::ReportUnsupported, _("The drive doesn't report the test status."));
-			}
-
-			switch (entry->result) {
-				case NvmeSelfTestResultType::Unknown:
-					status_ = SelfTestStatus::Unknown;
-					break;
-				case NvmeSelfTestResultType::CompletedNoError:
-					status_ = SelfTestStatus::CompletedNoError;
-					break;
-				case NvmeSelfTestResultType::AbortedSelfTestCommand:
-					status_ = SelfTestStatus::ManuallyAborted;
-					break;
-				case NvmeSelfTestResultType::AbortedControllerReset:
-				case NvmeSelfTestResultType::AbortedNamespaceRemoved:
-				case NvmeSelfTestResultType::AbortedFormatNvmCommand:
-				case NvmeSelfTestResultType::AbortedUnknownReason:
-				case NvmeSelfTestResultType::AbortedSanitizeOperation:
-					status_ = SelfTestStatus::Interrupted;
-					break;
-				case NvmeSelfTestResultType::FatalOrUnknownTestError:
-				case NvmeSelfTestResultType::CompletedUnknownFailedSegment:
-				case NvmeSelfTestResultType::CompletedFailedSegments:
-					status_ = SelfTestStatus::CompletedWithError;
-					break;
-			}
+	// Read just the status, without creating the properties and setting their descriptions and warnings.
+	std::optional<SelfTestStatusReport> report;
+	if (parser_format == SmartctlOutputFormat::Json) {
+		auto probe_status = SelfTestStatusProbe::probe_json(drive_->get_detected_type(), output);
+		if (!probe_status) {
+			return hz::Unexpected(SelfTestExecutionError::ParseError,
+					fmt::format(fmt::runtime(_("Cannot parse smartctl output: {}")), probe_status.error().message()));
 		}
+		report = probe_status.value();
+	}
 
-	} else {
-		// ATA:
-		// Note: Since the self-test log is sometimes late
-		// and in undetermined order (sorting by hours is too rough),
-		// we use the "self-test status" capability.
-		StorageProperty p;
-		for (const auto& e : property_repo.get_properties()) {
-			if (!e.is_value_type<AtaStorageSelftestEntry>() || e.get_value<AtaStorageSelftestEntry>().test_num != 0
-					|| e.generic_name != "ata_smart_data/self_test/status/_merged")
-				continue;
-			p = e;
+	// Text output has to be parsed fully. If the status is not in JSON output, parse it fully as well,
+	// so that the parser reports any errors the same way as when the drive is loaded.
+	if (!report.has_value()) {
+		// The output is often identical between polls, so use the cache.
+		auto parse_status = SmartctlParseCache::parse(parser_type, parser_format, output);
+		if (!parse_status) {
+			return hz::Unexpected(SelfTestExecutionError::ParseError,
+					fmt::format(fmt::runtime(_("Cannot parse smartctl output: {}")), parse_status.error().message()));
 		}
-		if (p.empty()) {
+		report = SelfTestStatusProbe::from_properties(drive_->get_detected_type(), *parse_status.value());
+		if (!report.has_value()) {
 			return hz::Unexpected(SelfTestExecutionError::ReportUnsupported, _("The drive doesn't report the test status."));
 		}
+	}
 
-		switch (p.get_value<AtaStorageSelftestEntry>().status) {
-			case AtaStorageSelftestEntry::Status::InProgress:
-				status_ = SelfTestStatus::InProgress;
-				break;
-			case AtaStorageSelftestEntry::Status::Unknown:
-				status_ = SelfTestStatus::Unknown;
-				break;
-			case AtaStorageSelftestEntry::Status::Reserved:
-				status_ = SelfTestStatus::Reserved;
-				break;
-			case AtaStorageSelftestEntry::Status::CompletedNoError:
-				status_ = SelfTestStatus::CompletedNoError;
-				break;
-			case AtaStorageSelftestEntry::Status::AbortedByHost:
-				status_ = SelfTestStatus::ManuallyAborted;
-				break;
-			case AtaStorageSelftestEntry::Status::Interrupted:
-				status_ = SelfTestStatus::Interrupted;
-				break;
-			case AtaStorageSelftestEntry::Status::FatalOrUnknown:
-			case AtaStorageSelftestEntry::Status::ComplUnknownFailure:
-			case AtaStorageSelftestEntry::Status::ComplElectricalFailure:
-			case AtaStorageSelftestEntry::Status::ComplServoFailure:
-			case AtaStorageSelftestEntry::Status::ComplReadFailure:
-			case AtaStorageSelftestEntry::Status::ComplHandlingDamage:
-				status_ = SelfTestStatus::CompletedWithError;
-				break;
-		}
-
-		if (status_ == SelfTestStatus::InProgress) {
-			remaining_percent_ = p.get_value<AtaStorageSelftestEntry>().remaining_percent;
-		}
+	status_ = report->status;
+	if (report->remaining_percent.has_value()) {
+		remaining_percent_ = report->remaining_percent.value();
 	}
 
-	// Note that the test needs 90% to complete, not 100. It starts at 90%
-	// and reaches 00% on completion. That's 9 pieces.
 	if (status_ == SelfTestStatus::InProgress) {
-		if (remaining_percent_ != last_seen_percent_) {
-			last_seen_percent_ = remaining_percent_;
-			timer_.start();  // restart the timer
+		const auto now = SelfTestPollScheduler::Clock::now();
+		if (!poll_scheduler_.has_value()) {  // not started by us
+			poll_scheduler_.emplace(get_min_duration_seconds(), now);
 		}
+		poll_scheduler_->add_sample(now, remaining_percent_);
+		poll_in_seconds_ = poll_scheduler_->get_poll_delay();
 
-		const std::chrono::seconds total = get_min_duration_seconds();
-
-		if (total <= 0s) {  // unknown
-			poll_in_seconds_ = 15s;  // just a guess, quick enough for nvme
-
-		} else {
-			// seconds per 10%. use double, because e.g. 60sec test gives silly values with int.
-			const double gran = (double(total.count()) / 9.);
-
-			// Add 1/10 for disk load delays, etc. Limit to 15sec, in case of very quick tests.
-			poll_in_seconds_ = std::chrono::seconds(std::max(int64_t(15), int64_t((gran / 3.) + (gran / 10.))));
-
-			// for long tests we don't want to make the user wait too much, so
-			// we need to poll more frequently by the end, in case it's completed.
-			if (type_ == TestType::LongTest && remaining_percent_ == 10)
-				poll_in_seconds_ = std::chrono::seconds(std::max(int64_t(1*60), int64_t(gran / 10.)));  // that's 2 min for 180min extended test
-
-			debug_out_dump("app", DBG_FUNC_MSG << "total: " << total.count() << ", gran: " << gran
-					<< ", poll in: " << poll_in_seconds_.count() << ", remaining secs: " << get_remaining_seconds().count()
-					<< ", remaining %: " << int(remaining_percent_) << ", last seen %: " << int(last_seen_percent_) << ".\n");
-		}
+		const auto seconds_per_percent = poll_scheduler_->get_seconds_per_percent();
+		debug_out_dump("app", DBG_FUNC_MSG << "seconds per 1%: " << (seconds_per_percent.has_value() ? seconds_per_percent.value() : -1.)
+				<< ", poll in: " << poll_in_seconds_.count() << ", remaining secs: " << get_remaining_seconds().count()
+				<< ", remaining %: " << int(remaining_percent_) << ".\n");
 
 	} else {
 		remaining_percent_ = -1;
-		last_seen_percent_ = -1;
 		poll_in_seconds_ = -1s;
-		timer_.stop();
+		poll_scheduler_.reset();
 	}
 
 	drive_->set_test_is_active(status_ == SelfTestStatus::InProgress);
@@ -17,10 +17,12 @@ Copyright:
 #include <string>
 #include <cstdint>
 #include <chrono>
+#include <optional>
 #include <unordered_map>
 
 #include "storage_device.h"
 #include "command_executor.h"
+#include "selftest_poll_scheduler.h"
 #include "hz/error_container.h"
 
 
@@ -138,8 +140,9 @@ class SelfTest {
 		[[nodiscard]] SelfTestStatus get_status() const;
 
 
-		/// Get the number of seconds after which the caller should call update().
-		/// Returns -1 if the test is not running.
+		/// Get the number of seconds after which the caller should call update(), counted
+		/// from the last update() (or start()). The polls are rare in the middle of a long test,
+		/// and more frequent near its expected completion. Returns -1 if the test is not running.
 		[[nodiscard]] std::chrono::seconds get_poll_in_seconds() const;
 
 
@@ -175,11 +178,10 @@ class SelfTest {
 		// status variables:
 		SelfTestStatus status_ = SelfTestStatus::Unknown;  ///< Current status of the test as reported by the drive
 		int8_t remaining_percent_ = -1;  ///< Remaining %. 0 means unknown, -1 means N/A. This is set to 100 on start.
-		int8_t last_seen_percent_ = -1;  ///< Last reported %, to detect changes in percentage (needed for timer update).
 		mutable std::chrono::seconds total_duration_ = std::chrono::seconds(-1);  ///< Total duration needed for the test, as reported by the drive. Constant. This variable acts as a cache.
 		std::chrono::seconds poll_in_seconds_ = std::chrono::seconds(-1);  ///< The user is asked to poll after this much seconds have passed.
 
-		Glib::Timer timer_;  ///< Counts time since the last percent change
+		std::optional<SelfTestPollScheduler> poll_scheduler_;  ///< Learns the progress rate and schedules polls while the test is running
 
 };
 
@@ -0,0 +1,288 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>  // std::any_of, std::count_if, std::min
+
+#include "fmt/format.h"
+
+#include "build_config.h"
+#include "hz/debug.h"
+#include "hz/fs.h"
+#include "app_regex.h"
+#include "selftest_orchestrator.h"
+
+
+
+SelfTestOrchestrator::SelfTestOrchestrator(SelfTest::TestType type, int max_tests_per_controller,
+		ExecutorFactory executor_factory, ControllerKeyFunc controller_key_func)
+		: type_(type), max_tests_per_controller_(std::max(1, max_tests_per_controller)),
+		executor_factory_(std::move(executor_factory)), controller_key_func_(std::move(controller_key_func))
+{
+	if (!controller_key_func_) {
+		controller_key_func_ = &SelfTestOrchestrator::get_default_controller_key;
+	}
+}
+
+
+
+std::string SelfTestOrchestrator::get_default_controller_key(const StorageDevice& drive)
+{
+	const std::string device = drive.get_device();
+
+	// Drives behind a RAID controller share its device: "-d megaraid,N", "-d areca,N/E", "-d 3ware,N", ...
+	const std::string type_arg = drive.get_type_argument();
+	if (const auto comma_pos = type_arg.find(','); comma_pos != std::string::npos) {
+		return device + "," + type_arg.substr(0, comma_pos);
+	}
+
+	// The sysfs path of a block device goes through all the PCI devices up to it,
+	// e.g. /sys/devices/pci0000:00/0000:00:17.0/ata3/host2/target2:0:0/2:0:0:0/block/sda.
+	// The last one is the host adapter (or the NVMe controller itself).
+	if (BuildEnv::is_kernel_linux() && device.starts_with("/dev/")) {
+		std::error_code ec;
+		const hz::fs::path sys_path = hz::fs::canonical(hz::fs::path("/sys/class/block") / hz::fs_path_from_string(device.substr(5)), ec);
+		if (!ec) {
+			std::string pci_function;
+			for (const auto& component : sys_path) {
+				if (app_regex_partial_match("/^[0-9a-f]{4}:[0-9a-f]{2}:[0-9a-f]{2}\\.[0-7]$/i", component.string())) {
+					pci_function = component.string();
+				}
+			}
+			if (!pci_function.empty()) {
+				return "pci:" + pci_function;
+			}
+		}
+	}
+
+	return device;
+}
+
+
+
+void SelfTestOrchestrator::add_drive(const StorageDevicePtr& drive)
+{
+	if (!drive || is_drive_active(drive)) {
+		return;
+	}
+
+	Job job;
+	job.result.drive = drive;
+	job.result.controller_key = controller_key_func_(*drive);
+
+	if (drive->get_is_virtual()) {
+		job.result.state = DriveState::Skipped;
+		job.result.error_message = _("Cannot execute smartctl on a virtual device.");
+
+	} else if (drive->get_test_is_active()) {
+		job.result.state = DriveState::Skipped;
+		job.result.error_message = _("A test is already running on this drive.");
+
+	} else if (!SelfTest(drive, type_).is_supported()) {
+		job.result.state = DriveState::Skipped;
+		job.result.error_message = fmt::format(fmt::runtime(_("{} is unsupported by this drive.")),
+				SelfTest::get_test_displayable_name(type_));
+	}
+
+	debug_out_info("app", DBG_FUNC_MSG << "Adding drive " << drive->get_device_with_type()
+			<< " on controller \"" << job.result.controller_key << "\""
+			<< (job.result.state == DriveState::Skipped ? ", skipped: " + job.result.error_message : std::string()) << ".\n");
+
+	jobs_.push_back(std::move(job));
+}
+
+
+
+SelfTest::TestType SelfTestOrchestrator::get_test_type() const
+{
+	return type_;
+}
+
+
+
+void SelfTestOrchestrator::tick(Clock::time_point now)
+{
+	// Poll first, so that the finished tests free their slots.
+	for (auto& job : jobs_) {
+		if (job.result.state == DriveState::Running && job.next_poll_time <= now) {
+			update_job(job, now);
+		}
+	}
+
+	// Start in the order of addition. A failed start frees the slot for the next drive.
+	for (auto& job : jobs_) {
+		if (job.result.state == DriveState::Queued
+				&& get_running_count(job.result.controller_key) < max_tests_per_controller_) {
+			start_job(job, now);
+		}
+	}
+}
+
+
+
+std::optional<SelfTestOrchestrator::Clock::time_point> SelfTestOrchestrator::get_next_tick_time() const
+{
+	std::optional<Clock::time_point> next_time;
+	for (const auto& job : jobs_) {
+		if (job.result.state == DriveState::Running) {
+			next_time = std::min(next_time.value_or(Clock::time_point::max()), job.next_poll_time);
+
+		} else if (job.result.state == DriveState::Queued
+				&& get_running_count(job.result.controller_key) < max_tests_per_controller_) {
+			return Clock::time_point();  // can be started right away (tick() wasn't called yet)
+		}
+	}
+	return next_time;
+}
+
+
+
+void SelfTestOrchestrator::abort()
+{
+	for (auto& job : jobs_) {
+		if (job.result.state == DriveState::Queued) {
+			job.result.state = DriveState::Cancelled;
+
+		} else if (job.result.state == DriveState::Running) {
+			auto stop_status = job.test->force_stop(create_executor());
+			job.result.status = job.test->get_status();
+			if (!stop_status) {
+				job.result.error_message = stop_status.error().message();
+			}
+			job.result.state = (job.test->is_active() ? DriveState::Failed : DriveState::Finished);
+		}
+	}
+}
+
+
+
+bool SelfTestOrchestrator::is_active() const
+{
+	return std::any_of(jobs_.cbegin(), jobs_.cend(), [](const Job& job) {
+		return job.result.state == DriveState::Queued || job.result.state == DriveState::Running;
+	});
+}
+
+
+
+bool SelfTestOrchestrator::is_drive_active(const StorageDevicePtr& drive) const
+{
+	return std::any_of(jobs_.cbegin(), jobs_.cend(), [&drive](const Job& job) {
+		return job.result.drive == drive
+				&& (job.result.state == DriveState::Queued || job.result.state == DriveState::Running);
+	});
+}
+
+
+
+std::vector<SelfTestOrchestrator::DriveResult> SelfTestOrchestrator::get_results() const
+{
+	std::vector<DriveResult> results;
+	results.reserve(jobs_.size());
+	for (const auto& job : jobs_) {
+		results.push_back(job.result);
+	}
+	return results;
+}
+
+
+
+SelfTestOrchestrator::Summary SelfTestOrchestrator::get_summary() const
+{
+	Summary summary;
+	for (const auto& job : jobs_) {
+		switch (job.result.state) {
+			case DriveState::Queued: ++summary.queued; break;
+			case DriveState::Running: ++summary.running; break;
+			case DriveState::Failed: ++summary.errors; break;
+			case DriveState::Skipped:
+			case DriveState::Cancelled: ++summary.skipped; break;
+			case DriveState::Finished:
+				if (job.result.status == SelfTestStatus::CompletedNoError) {
+					++summary.passed;
+				} else if (get_self_test_status_severity(job.result.status) == SelfTestStatusSeverity::Error) {
+					++summary.failed;
+				} else {
+					++summary.warnings;
+				}
+				break;
+		}
+	}
+	return summary;
+}
+
+
+
+std::shared_ptr<CommandExecutor> SelfTestOrchestrator::create_executor() const
+{
+	return executor_factory_ ? executor_factory_() : nullptr;  // nullptr means default executor
+}
+
+
+
+int SelfTestOrchestrator::get_running_count(const std::string& controller_key) const
+{
+	return static_cast<int>(std::count_if(jobs_.cbegin(), jobs_.cend(), [&controller_key](const Job& job) {
+		return job.result.state == DriveState::Running && job.result.controller_key == controller_key;
+	}));
+}
+
+
+
+void SelfTestOrchestrator::start_job(Job& job, Clock::time_point now)
+{
+	job.test = std::make_shared<SelfTest>(job.result.drive, type_);
+
+	auto start_status = job.test->start(create_executor());
+	if (!start_status) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot start the test on " << job.result.drive->get_device_with_type()
+				<< ": " << start_status.error().message() << "\n");
+		job.result.state = DriveState::Failed;
+		job.result.error_message = start_status.error().message();
+		return;
+	}
+
+	job.result.state = DriveState::Running;
+	job.result.status = job.test->get_status();
+	job.next_poll_time = now + job.test->get_poll_in_seconds();
+}
+
+
+
+void SelfTestOrchestrator::update_job(Job& job, Clock::time_point now)
+{
+	auto ex = create_executor();
+	auto update_status = job.test->update(ex);
+	job.result.status = job.test->get_status();
+
+	if (!update_status) {
+		// Same as the info window - we can't monitor it, so abort it.
+		debug_out_warn("app", DBG_FUNC_MSG << "Cannot update the test on " << job.result.drive->get_device_with_type()
+				<< ": " << update_status.error().message() << "\n");
+		[[maybe_unused]] auto stop_status = job.test->force_stop(ex);
+		job.result.state = DriveState::Failed;
+		job.result.error_message = update_status.error().message();
+		return;
+	}
+
+	if (!job.test->is_active()) {
+		job.result.state = DriveState::Finished;
+		return;
+	}
+
+	job.next_poll_time = now + job.test->get_poll_in_seconds();
+}
+
+
+
+
+
+
+/// @}
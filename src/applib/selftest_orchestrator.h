@@ -0,0 +1,171 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SELFTEST_ORCHESTRATOR_H
+#define SELFTEST_ORCHESTRATOR_H
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "command_executor.h"
+#include "selftest.h"
+#include "selftest_poll_scheduler.h"
+#include "storage_device.h"
+
+
+
+/// Runs a self-test on several drives at once.
+/// The tests are started in the order the drives were added, with at most
+/// a specified number of tests running on each controller (HBA) at a time, so that
+/// a shared backplane is not saturated. All the running tests are polled from tick(),
+/// which the caller should call at get_next_tick_time().
+class SelfTestOrchestrator {
+	public:
+
+		/// Clock used for polling
+		using Clock = SelfTestPollScheduler::Clock;
+
+		/// Creates an executor for each smartctl command
+		using ExecutorFactory = std::function<std::shared_ptr<CommandExecutor>()>;
+
+		/// Returns a key which is the same for the drives on the same controller
+		using ControllerKeyFunc = std::function<std::string(const StorageDevice& drive)>;
+
+
+		/// State of the test on a drive
+		enum class DriveState {
+			Queued,  ///< Waiting for a free slot on its controller
+			Running,  ///< The test is running
+			Finished,  ///< The test finished, the status has the result
+			Failed,  ///< The test could not be started or monitored, see the error message
+			Skipped,  ///< The drive is virtual, busy, or doesn't support the test
+			Cancelled,  ///< The run was aborted before the test was started
+		};
+
+
+		/// The test on one drive
+		struct DriveResult {
+			StorageDevicePtr drive;  ///< Drive
+			std::string controller_key;  ///< Controller of the drive
+			DriveState state = DriveState::Queued;  ///< State of the test
+			SelfTestStatus status = SelfTestStatus::Unknown;  ///< Last status reported by the drive
+			std::string error_message;  ///< Error message, if the test failed or was skipped
+		};
+
+
+		/// Number of drives in each state. Finished tests are counted by their status severity.
+		struct Summary {
+			int queued = 0;  ///< Waiting for a free slot
+			int running = 0;  ///< Running
+			int passed = 0;  ///< Completed successfully
+			int warnings = 0;  ///< Finished with a warning (aborted or interrupted), or with an unknown status
+			int failed = 0;  ///< Finished with errors
+			int errors = 0;  ///< Failed to start or monitor
+			int skipped = 0;  ///< Skipped or cancelled
+		};
+
+
+		/// Constructor.
+		/// \param type Test type to run on all drives
+		/// \param max_tests_per_controller Maximum number of tests running on one controller at a time
+		/// \param executor_factory Creates executors for smartctl commands. If empty, the default executor is used.
+		/// \param controller_key_func Groups the drives by controller. If empty, get_default_controller_key() is used.
+		SelfTestOrchestrator(SelfTest::TestType type, int max_tests_per_controller,
+				ExecutorFactory executor_factory = nullptr, ControllerKeyFunc controller_key_func = nullptr);
+
+
+		/// Get a key which is the same for the drives on the same controller.
+		/// Drives behind a RAID controller (e.g. "-d megaraid,N") share the controller device.
+		/// On Linux, other drives are grouped by the PCI function of their host adapter.
+		/// If nothing is known, each drive is assumed to have a controller of its own.
+		[[nodiscard]] static std::string get_default_controller_key(const StorageDevice& drive);
+
+
+		/// Add a drive to test. Drives which can't be tested are added in Skipped state.
+		/// Adding a drive twice has no effect.
+		void add_drive(const StorageDevicePtr& drive);
+
+
+		/// Get the test type
+		[[nodiscard]] SelfTest::TestType get_test_type() const;
+
+
+		/// Start the queued tests for which there is a free slot, and poll the running
+		/// tests which are due at \c now.
+		void tick(Clock::time_point now);
+
+
+		/// Get the time at which tick() should be called next. A time in the past means
+		/// that tick() should be called right away.
+		/// \return std::nullopt if all the tests are done.
+		[[nodiscard]] std::optional<Clock::time_point> get_next_tick_time() const;
+
+
+		/// Abort all the running tests and cancel the queued ones.
+		void abort();
+
+
+		/// Check if any test is running or queued
+		[[nodiscard]] bool is_active() const;
+
+
+		/// Check if the drive has a running or queued test in this run
+		[[nodiscard]] bool is_drive_active(const StorageDevicePtr& drive) const;
+
+
+		/// Get the tests on all drives, in the order the drives were added
+		[[nodiscard]] std::vector<DriveResult> get_results() const;
+
+
+		/// Get the number of drives in each state
+		[[nodiscard]] Summary get_summary() const;
+
+
+	private:
+
+		/// A test on one drive
+		struct Job {
+			DriveResult result;  ///< Drive and test state
+			std::shared_ptr<SelfTest> test;  ///< Running or finished test
+			Clock::time_point next_poll_time;  ///< Time of the next update(), if running
+		};
+
+
+		/// Create an executor for a smartctl command
+		[[nodiscard]] std::shared_ptr<CommandExecutor> create_executor() const;
+
+		/// Get the number of running tests on a controller
+		[[nodiscard]] int get_running_count(const std::string& controller_key) const;
+
+		/// Start the test of a queued job
+		void start_job(Job& job, Clock::time_point now);
+
+		/// Poll the running test of a job
+		void update_job(Job& job, Clock::time_point now);
+
+
+		SelfTest::TestType type_ = SelfTest::TestType::ShortTest;  ///< Test type
+		int max_tests_per_controller_ = 1;  ///< Maximum number of tests running on one controller
+		ExecutorFactory executor_factory_;  ///< Executor factory, may be empty
+		ControllerKeyFunc controller_key_func_;  ///< Groups the drives by controller
+
+		std::vector<Job> jobs_;  ///< Tests, in the order the drives were added
+
+};
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,108 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>  // std::max, std::clamp
+
+#include "selftest_poll_scheduler.h"
+
+
+
+SelfTestPollScheduler::SelfTestPollScheduler(std::chrono::seconds advertised_duration, Clock::time_point start_time)
+		: advertised_duration_(std::max(advertised_duration, std::chrono::seconds(0))), last_sample_time_(start_time)
+{
+	if (advertised_duration_ > std::chrono::seconds(0)) {
+		anchor_ = PercentPoint {start_time, advertised_start_percent};
+	}
+}
+
+
+
+void SelfTestPollScheduler::add_sample(Clock::time_point time, int8_t remaining_percent)
+{
+	const Clock::time_point prev_sample_time = last_sample_time_;
+	last_sample_time_ = time;
+	has_samples_ = true;
+
+	if (remaining_percent >= 0) {
+		if (!anchor_.has_value()) {
+			anchor_ = PercentPoint {time, remaining_percent};
+
+		} else if (remaining_percent < (last_change_.has_value() ? last_change_->percent : anchor_->percent)) {
+			// The percentage changed somewhere between the two polls
+			last_change_ = PercentPoint {prev_sample_time + (time - prev_sample_time) / 2, remaining_percent};
+			uncertain_polls_ = 0;
+			return;
+		}
+	}
+
+	// No new information. Back off if we don't know when the test will complete.
+	const auto completion = get_estimated_completion();
+	if (!completion.has_value() || time >= completion.value()) {
+		++uncertain_polls_;
+	}
+}
+
+
+
+std::optional<double> SelfTestPollScheduler::get_seconds_per_percent() const
+{
+	if (anchor_.has_value() && last_change_.has_value() && anchor_->percent > last_change_->percent) {
+		const std::chrono::duration<double> span = last_change_->time - anchor_->time;
+		if (span.count() > 0.) {
+			return span.count() / (anchor_->percent - last_change_->percent);
+		}
+	}
+	if (advertised_duration_ > std::chrono::seconds(0)) {
+		return double(advertised_duration_.count()) / advertised_start_percent;
+	}
+	return std::nullopt;
+}
+
+
+
+std::optional<SelfTestPollScheduler::Clock::time_point> SelfTestPollScheduler::get_estimated_completion() const
+{
+	const auto seconds_per_percent = get_seconds_per_percent();
+	const std::optional<PercentPoint>& ref = (last_change_.has_value() ? last_change_ : anchor_);
+	if (!seconds_per_percent.has_value() || !ref.has_value()) {
+		return std::nullopt;
+	}
+	const std::chrono::duration<double> remaining(ref->percent * seconds_per_percent.value());
+	return ref->time + std::chrono::duration_cast<Clock::duration>(remaining);
+}
+
+
+
+std::chrono::seconds SelfTestPollScheduler::get_poll_delay() const
+{
+	if (!has_samples_) {
+		return first_poll_delay;
+	}
+
+	// Poll halfway to the expected completion, so that the polls become more frequent
+	// as it approaches.
+	const auto completion = get_estimated_completion();
+	if (completion.has_value() && completion.value() > last_sample_time_) {
+		const auto delay = std::chrono::duration_cast<std::chrono::seconds>((completion.value() - last_sample_time_) / 2);
+		return std::clamp(delay, min_poll_delay, max_poll_delay);
+	}
+
+	// The rate is unknown, or the test is late. Back off exponentially.
+	const auto delay = min_poll_delay * (int64_t(1) << std::min(uncertain_polls_, 8));
+	return std::min(delay, max_uncertain_poll_delay);
+}
+
+
+
+
+
+
+/// @}
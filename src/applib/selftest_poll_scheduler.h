@@ -0,0 +1,100 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SELFTEST_POLL_SCHEDULER_H
+#define SELFTEST_POLL_SCHEDULER_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+
+
+/// Decides when to poll a running self-test.
+/// The progress rate of the drive is learned from the remaining percentages reported
+/// by successive polls, using the test duration advertised by the drive until the
+/// percentage changes. The polls are rare while the completion is far away, and
+/// become more frequent as the expected completion approaches.
+class SelfTestPollScheduler {
+	public:
+
+		/// Clock used for samples
+		using Clock = std::chrono::steady_clock;
+
+		/// Delay of the first poll after the test is started
+		static constexpr std::chrono::seconds first_poll_delay {5};
+
+		/// Minimum delay between polls
+		static constexpr std::chrono::seconds min_poll_delay {15};
+
+		/// Maximum delay between polls, so that an interrupted test is noticed
+		static constexpr std::chrono::seconds max_poll_delay {60 * 60};
+
+		/// Maximum delay between polls while the progress rate is unknown,
+		/// or when the test takes longer than expected.
+		static constexpr std::chrono::seconds max_uncertain_poll_delay {5 * 60};
+
+		/// Remaining percentage at the start of a test with advertised duration.
+		/// ATA tests start at 90% and reach 0% on completion.
+		static constexpr int8_t advertised_start_percent = 90;
+
+
+		/// Constructor.
+		/// \param advertised_duration Test duration advertised by the drive (e.g. "polling_minutes"),
+		/// 0 or negative if unknown.
+		/// \param start_time Time the test was started at
+		SelfTestPollScheduler(std::chrono::seconds advertised_duration, Clock::time_point start_time);
+
+
+		/// Add the remaining percentage reported by a poll at \c time. -1 means unknown.
+		void add_sample(Clock::time_point time, int8_t remaining_percent);
+
+
+		/// Get the estimated number of seconds the drive needs for 1%.
+		/// \return std::nullopt if unknown.
+		[[nodiscard]] std::optional<double> get_seconds_per_percent() const;
+
+
+		/// Get the estimated completion time.
+		/// \return std::nullopt if unknown.
+		[[nodiscard]] std::optional<Clock::time_point> get_estimated_completion() const;
+
+
+		/// Get the delay of the next poll, counted from the last sample (or from the start).
+		[[nodiscard]] std::chrono::seconds get_poll_delay() const;
+
+
+	private:
+
+		/// A remaining percentage, with the time it was first seen at
+		struct PercentPoint {
+			Clock::time_point time;  ///< Time
+			int8_t percent = -1;  ///< Remaining percentage
+		};
+
+
+		std::chrono::seconds advertised_duration_ {0};  ///< Advertised test duration, 0 if unknown
+
+		Clock::time_point last_sample_time_;  ///< Time of the last sample, or start time
+		bool has_samples_ = false;  ///< True if at least one sample was added
+
+		std::optional<PercentPoint> anchor_;  ///< First known percentage
+		std::optional<PercentPoint> last_change_;  ///< Last change of the percentage after the anchor
+
+		int uncertain_polls_ = 0;  ///< Number of polls without new information since the last change or the expected completion
+
+};
+
+
+
+#endif
+
+/// @}
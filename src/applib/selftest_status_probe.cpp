@@ -0,0 +1,226 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+#include "selftest_status_probe.h"
+#include "smartctl_json_parser_helpers.h"
+#include "storage_property.h"
+
+
+
+namespace {
+
+	/// Get self-test status from the ATA self-test execution status
+	SelfTestStatus get_ata_selftest_status(AtaStorageSelftestEntry::Status status)
+	{
+		switch (status) {
+			case AtaStorageSelftestEntry::Status::InProgress:
+				return SelfTestStatus::InProgress;
+			case AtaStorageSelftestEntry::Status::Unknown:
+				return SelfTestStatus::Unknown;
+			case AtaStorageSelftestEntry::Status::Reserved:
+				return SelfTestStatus::Reserved;
+			case AtaStorageSelftestEntry::Status::CompletedNoError:
+				return SelfTestStatus::CompletedNoError;
+			case AtaStorageSelftestEntry::Status::AbortedByHost:
+				return SelfTestStatus::ManuallyAborted;
+			case AtaStorageSelftestEntry::Status::Interrupted:
+				return SelfTestStatus::Interrupted;
+			case AtaStorageSelftestEntry::Status::FatalOrUnknown:
+			case AtaStorageSelftestEntry::Status::ComplUnknownFailure:
+			case AtaStorageSelftestEntry::Status::ComplElectricalFailure:
+			case AtaStorageSelftestEntry::Status::ComplServoFailure:
+			case AtaStorageSelftestEntry::Status::ComplReadFailure:
+			case AtaStorageSelftestEntry::Status::ComplHandlingDamage:
+				return SelfTestStatus::CompletedWithError;
+		}
+		return SelfTestStatus::Unknown;
+	}
+
+
+
+	/// Get self-test status from the result of the latest NVMe self-test log entry
+	SelfTestStatus get_nvme_selftest_status(NvmeSelfTestResultType result)
+	{
+		switch (result) {
+			case NvmeSelfTestResultType::Unknown:
+				return SelfTestStatus::Unknown;
+			case NvmeSelfTestResultType::CompletedNoError:
+				return SelfTestStatus::CompletedNoError;
+			case NvmeSelfTestResultType::AbortedSelfTestCommand:
+				return SelfTestStatus::ManuallyAborted;
+			case NvmeSelfTestResultType::AbortedControllerReset:
+			case NvmeSelfTestResultType::AbortedNamespaceRemoved:
+			case NvmeSelfTestResultType::AbortedFormatNvmCommand:
+			case NvmeSelfTestResultType::AbortedUnknownReason:
+			case NvmeSelfTestResultType::AbortedSanitizeOperation:
+				return SelfTestStatus::Interrupted;
+			case NvmeSelfTestResultType::FatalOrUnknownTestError:
+			case NvmeSelfTestResultType::CompletedUnknownFailedSegment:
+			case NvmeSelfTestResultType::CompletedFailedSegments:
+				return SelfTestStatus::CompletedWithError;
+		}
+		return SelfTestStatus::Unknown;
+	}
+
+
+}
+
+
+
+hz::ExpectedValue<std::optional<SelfTestStatusReport>, SmartctlParserError> SelfTestStatusProbe::probe_json(
+		StorageDeviceDetectedType detected_type, std::string_view output)
+{
+	using namespace SmartctlJsonParserHelpers;
+
+	if (hz::string_trim_copy(output).empty()) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Empty string passed as an argument. Returning.\n");
+		return hz::Unexpected(SmartctlParserError::EmptyInput, "Smartctl data is empty.");
+	}
+
+	const bool is_nvme = (detected_type == StorageDeviceDetectedType::Nvme);
+
+	// Keep only the top-level keys we need; the rest (including the original text output)
+	// is discarded while parsing.
+	const auto key_filter = [is_nvme](int depth, nlohmann::json::parse_event_t event, nlohmann::json& parsed)
+	{
+		if (depth != 1 || event != nlohmann::json::parse_event_t::key) {
+			return true;
+		}
+		const auto& key = parsed.get_ref<const std::string&>();
+		return key == "smartctl" || key == (is_nvme ? "nvme_self_test_log" : "ata_smart_data");
+	};
+
+	nlohmann::json json_root_node;
+	try {
+		json_root_node = nlohmann::json::parse(output, key_filter);
+	} catch (const nlohmann::json::parse_error& e) {
+		debug_out_warn("app", DBG_FUNC_MSG << "Error parsing smartctl output as JSON: " << e.what() << "\n");
+		return hz::Unexpected(SmartctlParserError::SyntaxError, std::string("Invalid JSON data: ") + e.what());
+	}
+
+	StorageProperty merged_version_property, full_version_property;
+	auto version_parse_status = parse_version(json_root_node, merged_version_property, full_version_property);
+	if (!version_parse_status) {
+		return hz::UnexpectedFrom(version_parse_status);
+	}
+
+	SelfTestStatusReport report;
+
+	if (is_nvme) {
+		// If no test is active, the current operation may be absent, or set to None (0).
+		// Unknown operations mean that some test is active.
+		auto operation_val = get_node_data<uint8_t>(json_root_node, "nvme_self_test_log/current_self_test_operation/value");
+		if (operation_val.has_value() && operation_val.value() != 0x0) {
+			report.status = SelfTestStatus::InProgress;
+			if (auto percent_val = get_node_data<uint8_t>(json_root_node, "nvme_self_test_log/current_self_test_completion_percent"); percent_val.has_value()) {
+				report.remaining_percent = static_cast<int8_t>(100 - percent_val.value());
+			}
+			return report;
+		}
+
+		// The first self-test table entry is the latest.
+		auto table_node = get_node(json_root_node, "nvme_self_test_log/table");
+		if (!table_node.has_value() || !table_node.value().is_array() || table_node.value().empty()) {
+			return std::nullopt;
+		}
+		const nlohmann::json& latest_entry = table_node.value().front();
+		NvmeSelfTestResultType result = NvmeSelfTestResultType::Unknown;
+		if (auto result_val = get_node_data<int32_t>(latest_entry, "self_test_result/value"); result_val.has_value()) {
+			result = decode_nvme_selftest_result(result_val.value());
+		}
+		report.status = get_nvme_selftest_status(result);
+		return report;
+	}
+
+	// ATA
+	auto status_val = get_node_data<uint8_t>(json_root_node, "ata_smart_data/self_test/status/value");
+	if (!status_val.has_value()) {
+		return std::nullopt;
+	}
+	report.status = get_ata_selftest_status(decode_ata_selftest_status(status_val.value()));
+	if (report.status == SelfTestStatus::InProgress) {
+		// Present only when extended self-test log is supported
+		report.remaining_percent = get_node_data<int8_t>(json_root_node, "ata_smart_data/self_test/status/remaining_percent").value_or(-1);
+	}
+	return report;
+}
+
+
+
+std::optional<SelfTestStatusReport> SelfTestStatusProbe::from_properties(
+		StorageDeviceDetectedType detected_type, const StoragePropertyRepository& property_repo)
+{
+	SelfTestStatusReport report;
+
+	if (detected_type == StorageDeviceDetectedType::Nvme) {
+		const StorageProperty* current_operation = property_repo.find_property("nvme_self_test_log/current_self_test_operation/value/_decoded");
+
+		// If no test is active, the property may be absent, or set to None.
+		if (current_operation
+				&& current_operation->get_value<std::string>() != NvmeSelfTestCurrentOperationTypeExt::get_storable_name(NvmeSelfTestCurrentOperationType::None)) {
+			report.status = SelfTestStatus::InProgress;
+
+			const StorageProperty* completion_percent = property_repo.find_property("nvme_self_test_log/current_self_test_completion_percent");
+			if (completion_percent) {
+				report.remaining_percent = static_cast<int8_t>(100 - completion_percent->get_value<int64_t>());
+			}
+			return report;
+		}
+
+		// The first self-test table entry is the latest.
+		const StorageProperty* latest_entry = nullptr;
+		for (const auto& e : property_repo.get_properties()) {
+			if (e.is_value_type<NvmeStorageSelftestEntry>() && e.get_value<NvmeStorageSelftestEntry>().test_num == 1) {
+				latest_entry = &e;
+			}
+		}
+		if (!latest_entry) {
+			return std::nullopt;
+		}
+		report.status = get_nvme_selftest_status(latest_entry->get_value<NvmeStorageSelftestEntry>().result);
+		return report;
+	}
+
+	// ATA:
+	// Note: Since the self-test log is sometimes late
+	// and in undetermined order (sorting by hours is too rough),
+	// we use the "self-test status" capability.
+	const StorageProperty* status_property = nullptr;
+	for (const auto& e : property_repo.get_properties()) {
+		if (e.is_value_type<AtaStorageSelftestEntry>() && e.get_value<AtaStorageSelftestEntry>().test_num == 0
+				&& e.generic_name == "ata_smart_data/self_test/status/_merged") {
+			status_property = &e;
+		}
+	}
+	if (!status_property) {
+		return std::nullopt;
+	}
+
+	const auto& entry = status_property->get_value<AtaStorageSelftestEntry>();
+	report.status = get_ata_selftest_status(entry.status);
+	if (report.status == SelfTestStatus::InProgress) {
+		report.remaining_percent = entry.remaining_percent;
+	}
+	return report;
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,70 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SELFTEST_STATUS_PROBE_H
+#define SELFTEST_STATUS_PROBE_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "hz/error_container.h"
+#include "selftest.h"
+#include "smartctl_parser_types.h"
+#include "storage_device_detected_type.h"
+#include "storage_property_repository.h"
+
+
+
+/// Self-test state, as reported by the drive
+struct SelfTestStatusReport {
+	SelfTestStatus status = SelfTestStatus::Unknown;  ///< Test status
+
+	/// Remaining percentage (-1 if unknown). If not set, the drive didn't report it
+	/// in this output, and the previously reported value should be kept.
+	std::optional<int8_t> remaining_percent;
+
+	/// Compare the reports
+	bool operator==(const SelfTestStatusReport& other) const = default;
+};
+
+
+
+/// Reads the self-test state from the output of "smartctl --capabilities --log=selftest".
+/// SelfTest::update() calls this every few seconds while a test is running, so only the
+/// needed data is extracted, without creating properties and without setting their
+/// descriptions and warnings.
+class SelfTestStatusProbe {
+	public:
+
+		/// Get the self-test state from JSON output.
+		/// Only the needed JSON keys are kept while parsing; the version is checked the same way
+		/// as by the JSON parsers.
+		/// \return std::nullopt if the output doesn't contain the status, or SmartctlParserError
+		/// if the output is not valid.
+		[[nodiscard]] static hz::ExpectedValue<std::optional<SelfTestStatusReport>, SmartctlParserError> probe_json(
+				StorageDeviceDetectedType detected_type, std::string_view output);
+
+
+		/// Get the self-test state from the properties returned by a parser.
+		/// This is used for text output, which has to be parsed fully.
+		/// \return std::nullopt if the properties don't contain the status.
+		[[nodiscard]] static std::optional<SelfTestStatusReport> from_properties(
+				StorageDeviceDetectedType detected_type, const StoragePropertyRepository& property_repo);
+
+};
+
+
+
+
+#endif
+
+/// @}
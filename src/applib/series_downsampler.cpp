@@ -0,0 +1,259 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>  // std::lower_bound, std::upper_bound, std::min, std::max
+#include <cmath>
+
+#include "series_downsampler.h"
+
+
+
+SeriesDownsampler::SeriesDownsampler(std::vector<SeriesPoint> points)
+		: points_(std::move(points))
+{
+	// Each level merges pairs of buckets of the previous one, until a single bucket is left.
+	std::size_t prev_size = points_.size();
+	while (prev_size > 1) {
+		const std::size_t level = levels_.size();  // level of the previous buckets, 0 being the points
+		std::vector<Bucket> buckets((prev_size + 1) / 2);
+		for (std::size_t i = 0; i < buckets.size(); ++i) {
+			Bucket bucket = get_bucket(level, 2 * i);
+			if (2 * i + 1 < prev_size) {
+				const Bucket other = get_bucket(level, 2 * i + 1);
+				if (points_[other.min_index].y < points_[bucket.min_index].y) {
+					bucket.min_index = other.min_index;
+				}
+				if (points_[other.max_index].y > points_[bucket.max_index].y) {
+					bucket.max_index = other.max_index;
+				}
+			}
+			buckets[i] = bucket;
+		}
+		prev_size = buckets.size();
+		levels_.push_back(std::move(buckets));
+	}
+}
+
+
+
+std::size_t SeriesDownsampler::size() const
+{
+	return points_.size();
+}
+
+
+
+bool SeriesDownsampler::empty() const
+{
+	return points_.empty();
+}
+
+
+
+const std::vector<SeriesPoint>& SeriesDownsampler::get_points() const
+{
+	return points_;
+}
+
+
+
+std::optional<std::pair<double, double>> SeriesDownsampler::get_x_range() const
+{
+	if (points_.empty()) {
+		return std::nullopt;
+	}
+	return std::pair {points_.front().x, points_.back().x};
+}
+
+
+
+std::optional<std::pair<double, double>> SeriesDownsampler::get_y_range(double x_from, double x_to) const
+{
+	const auto [begin, end] = get_index_range(x_from, x_to);
+	const auto bucket = get_range_bucket(begin, end);
+	if (!bucket.has_value()) {
+		return std::nullopt;
+	}
+	return std::pair {points_[bucket->min_index].y, points_[bucket->max_index].y};
+}
+
+
+
+std::vector<SeriesPoint> SeriesDownsampler::get_line(double x_from, double x_to, std::size_t max_points) const
+{
+	max_points = std::max<std::size_t>(max_points, 3);
+
+	auto [begin, end] = get_index_range(x_from, x_to);
+	begin = (begin > 0 ? begin - 1 : begin);
+	end = std::min(end + 1, points_.size());
+	if (begin >= end) {
+		return {};
+	}
+	if (end - begin <= max_points) {
+		return {points_.begin() + static_cast<std::ptrdiff_t>(begin), points_.begin() + static_cast<std::ptrdiff_t>(end)};
+	}
+
+	// Find the smallest level giving at most 4 candidate points per output point (2 per bucket).
+	std::size_t level = 1;
+	while (level < levels_.size() && ((end - begin) >> level) + 1 > 2 * max_points) {
+		++level;
+	}
+
+	// The edge buckets may stick out of the range a little; that part is clipped when drawing.
+	std::vector<SeriesPoint> candidates;
+	candidates.reserve(4 * max_points + 4);
+	for (std::size_t i = begin >> level; i <= (end - 1) >> level; ++i) {
+		const Bucket bucket = get_bucket(level, i);
+		const std::size_t first = std::min(bucket.min_index, bucket.max_index);
+		const std::size_t second = std::max(bucket.min_index, bucket.max_index);
+		candidates.push_back(points_[first]);
+		if (second != first) {
+			candidates.push_back(points_[second]);
+		}
+	}
+
+	return series_downsample_lttb(candidates, max_points);
+}
+
+
+
+std::vector<std::optional<std::pair<double, double>>> SeriesDownsampler::get_envelope(double x_from, double x_to, std::size_t columns) const
+{
+	std::vector<std::optional<std::pair<double, double>>> envelope(columns);
+	if (columns == 0 || points_.empty() || !(x_to > x_from)) {
+		return envelope;
+	}
+
+	const double column_width = (x_to - x_from) / static_cast<double>(columns);
+	auto point_less = [](const SeriesPoint& p, double x) { return p.x < x; };
+	auto column_begin = static_cast<std::size_t>(std::lower_bound(points_.begin(), points_.end(), x_from, point_less) - points_.begin());
+
+	for (std::size_t column = 0; column < columns; ++column) {
+		std::size_t column_end = 0;
+		if (column + 1 == columns) {
+			column_end = get_index_range(x_from, x_to).second;
+		} else {
+			const double column_x_to = x_from + column_width * static_cast<double>(column + 1);
+			column_end = static_cast<std::size_t>(std::lower_bound(points_.begin(), points_.end(), column_x_to, point_less) - points_.begin());
+		}
+		if (const auto bucket = get_range_bucket(column_begin, column_end); bucket.has_value()) {
+			envelope[column] = std::pair {points_[bucket->min_index].y, points_[bucket->max_index].y};
+		}
+		column_begin = std::max(column_begin, column_end);
+	}
+
+	return envelope;
+}
+
+
+
+SeriesDownsampler::Bucket SeriesDownsampler::get_bucket(std::size_t level, std::size_t index) const
+{
+	if (level == 0) {
+		return {index, index};
+	}
+	return levels_[level - 1][index];
+}
+
+
+
+std::optional<SeriesDownsampler::Bucket> SeriesDownsampler::get_range_bucket(std::size_t begin, std::size_t end) const
+{
+	// Cover the range with the largest aligned buckets, like in a segment tree.
+	std::optional<Bucket> result;
+	while (begin < end) {
+		std::size_t level = 0;
+		while (level < levels_.size()
+				&& (begin & ((std::size_t(2) << level) - 1)) == 0
+				&& begin + (std::size_t(2) << level) <= end) {
+			++level;
+		}
+		const Bucket bucket = get_bucket(level, begin >> level);
+		if (!result.has_value()) {
+			result = bucket;
+		} else {
+			if (points_[bucket.min_index].y < points_[result->min_index].y) {
+				result->min_index = bucket.min_index;
+			}
+			if (points_[bucket.max_index].y > points_[result->max_index].y) {
+				result->max_index = bucket.max_index;
+			}
+		}
+		begin += std::size_t(1) << level;
+	}
+	return result;
+}
+
+
+
+std::pair<std::size_t, std::size_t> SeriesDownsampler::get_index_range(double x_from, double x_to) const
+{
+	auto begin = std::lower_bound(points_.begin(), points_.end(), x_from,
+			[](const SeriesPoint& p, double x) { return p.x < x; });
+	auto end = std::upper_bound(begin, points_.end(), x_to,
+			[](double x, const SeriesPoint& p) { return x < p.x; });
+	return {static_cast<std::size_t>(begin - points_.begin()), static_cast<std::size_t>(end - points_.begin())};
+}
+
+
+
+std::vector<SeriesPoint> series_downsample_lttb(const std::vector<SeriesPoint>& points, std::size_t threshold)
+{
+	const std::size_t size = points.size();
+	if (threshold >= size || threshold < 3) {
+		return points;
+	}
+
+	std::vector<SeriesPoint> result;
+	result.reserve(threshold);
+	result.push_back(points.front());
+
+	// The points between the first and the last ones are split into (threshold - 2) buckets.
+	// From each bucket, the point forming the largest triangle with the previously selected
+	// point and the average of the next bucket is selected.
+	const double bucket_size = static_cast<double>(size - 2) / static_cast<double>(threshold - 2);
+	std::size_t selected = 0;
+	for (std::size_t i = 0; i < threshold - 2; ++i) {
+		const auto range_begin = static_cast<std::size_t>(std::floor(static_cast<double>(i) * bucket_size)) + 1;
+		const auto range_end = std::min(static_cast<std::size_t>(std::floor(static_cast<double>(i + 1) * bucket_size)) + 1, size - 1);
+
+		const std::size_t next_begin = range_end;
+		const auto next_end = std::max(std::min(static_cast<std::size_t>(std::floor(static_cast<double>(i + 2) * bucket_size)) + 1, size),
+				next_begin + 1);
+		double avg_x = 0., avg_y = 0.;
+		for (std::size_t j = next_begin; j < next_end; ++j) {
+			avg_x += points[j].x;
+			avg_y += points[j].y;
+		}
+		avg_x /= static_cast<double>(next_end - next_begin);
+		avg_y /= static_cast<double>(next_end - next_begin);
+
+		const SeriesPoint& a = points[selected];
+		double max_area = -1.;
+		std::size_t max_index = range_begin;
+		for (std::size_t j = range_begin; j < range_end; ++j) {
+			const double area = std::abs((a.x - avg_x) * (points[j].y - a.y) - (a.x - points[j].x) * (avg_y - a.y));
+			if (area > max_area) {
+				max_area = area;
+				max_index = j;
+			}
+		}
+		result.push_back(points[max_index]);
+		selected = max_index;
+	}
+
+	result.push_back(points.back());
+	return result;
+}
+
+
+
+/// @}
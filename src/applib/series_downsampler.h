@@ -0,0 +1,107 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SERIES_DOWNSAMPLER_H
+#define SERIES_DOWNSAMPLER_H
+
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+
+/// A point of a series
+struct SeriesPoint {
+	double x = 0.;  ///< Position, e.g. time
+	double y = 0.;  ///< Value
+};
+
+
+
+/// Downsamples a series for drawing. A min/max pyramid is built once per series,
+/// after which each query costs about as much as the number of output points
+/// (i.e. the width of the drawing in pixels), regardless of the size of the series.
+class SeriesDownsampler {
+	public:
+
+		/// Constructor
+		SeriesDownsampler() = default;
+
+		/// Constructor. Builds the pyramid in O(n).
+		/// \param points Points, sorted by x.
+		explicit SeriesDownsampler(std::vector<SeriesPoint> points);
+
+
+		/// Get the number of points
+		[[nodiscard]] std::size_t size() const;
+
+		/// Check if there are no points
+		[[nodiscard]] bool empty() const;
+
+		/// Get the points
+		[[nodiscard]] const std::vector<SeriesPoint>& get_points() const;
+
+
+		/// Get the x of the first and the last points
+		[[nodiscard]] std::optional<std::pair<double, double>> get_x_range() const;
+
+
+		/// Get the smallest and the largest y in [x_from, x_to]
+		[[nodiscard]] std::optional<std::pair<double, double>> get_y_range(double x_from, double x_to) const;
+
+
+		/// Get a polyline of at most \c max_points points (at least 3) which looks like the series in [x_from, x_to].
+		/// The extremes of the pyramid level closest to the requested resolution are reduced
+		/// with Largest-Triangle-Three-Buckets, so that spikes are preserved.
+		/// The points just outside the range are included, so that the line reaches the edges.
+		[[nodiscard]] std::vector<SeriesPoint> get_line(double x_from, double x_to, std::size_t max_points) const;
+
+
+		/// Split [x_from, x_to] into \c columns equal parts and get the smallest and the largest y in each.
+		/// Columns without points are std::nullopt.
+		[[nodiscard]] std::vector<std::optional<std::pair<double, double>>> get_envelope(double x_from, double x_to, std::size_t columns) const;
+
+
+	private:
+
+		/// Indices of the smallest and the largest points of a pyramid bucket
+		struct Bucket {
+			std::size_t min_index = 0;  ///< Index of the point with the smallest y
+			std::size_t max_index = 0;  ///< Index of the point with the largest y
+		};
+
+		/// Get a bucket of 2^level points, starting at point index << level
+		[[nodiscard]] Bucket get_bucket(std::size_t level, std::size_t index) const;
+
+		/// Get the bucket covering the points in [begin, end)
+		[[nodiscard]] std::optional<Bucket> get_range_bucket(std::size_t begin, std::size_t end) const;
+
+		/// Get the index range of the points in [x_from, x_to]
+		[[nodiscard]] std::pair<std::size_t, std::size_t> get_index_range(double x_from, double x_to) const;
+
+
+		std::vector<SeriesPoint> points_;  ///< Points, sorted by x
+		std::vector<std::vector<Bucket>> levels_;  ///< Pyramid. Level k (starting from 0) has buckets of 2^(k+1) points.
+
+};
+
+
+
+/// Reduce a polyline to \c threshold points using the Largest-Triangle-Three-Buckets algorithm.
+/// The first and the last points are always kept.
+[[nodiscard]] std::vector<SeriesPoint> series_downsample_lttb(const std::vector<SeriesPoint>& points, std::size_t threshold);
+
+
+
+#endif
+
+/// @}
@@ -355,6 +355,17 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_info(
 			},
 
 			{"local_time/asctime", _("Scanned on"), string_formatter()},
+			{"local_time/time_t", _("Scanned on"),
+				[](const nlohmann::json& root_node, const std::string& key, const std::string& displayable_name)
+						-> hz::ExpectedValue<StorageProperty, SmartctlParserError>
+				{
+					auto p = integer_formatter<int64_t>()(root_node, key, displayable_name);
+					if (p.has_value()) {
+						p->show_in_ui = false;  // the time of the SCT temperature history; asctime is shown instead
+					}
+					return p;
+				}
+			},
 
 			{"smart_support/available", _("SMART Supported"), bool_formatter(_("Yes"), _("No"))},
 			{"smart_support/enabled", _("SMART Enabled"), bool_formatter(_("Yes"), _("No"))},
@@ -546,21 +557,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_capab
 
 					auto value_val = get_node_data<uint8_t>(root_node, "ata_smart_data/self_test/status/value");
 					if (value_val.has_value()) {
-						switch (value_val.value() >> 4) {
-							// Data from smartmontools/ataprint.cpp
-							case 0x0: status = AtaStorageSelftestEntry::Status::CompletedNoError; break;
-							case 0x1: status = AtaStorageSelftestEntry::Status::AbortedByHost; break;
-							case 0x2: status = AtaStorageSelftestEntry::Status::Interrupted; break;
-							case 0x3: status = AtaStorageSelftestEntry::Status::FatalOrUnknown; break;
-							case 0x4: status = AtaStorageSelftestEntry::Status::ComplUnknownFailure; break;
-							case 0x5: status = AtaStorageSelftestEntry::Status::ComplElectricalFailure; break;
-							case 0x6: status = AtaStorageSelftestEntry::Status::ComplServoFailure; break;
-							case 0x7: status = AtaStorageSelftestEntry::Status::ComplReadFailure; break;
-							case 0x8: status = AtaStorageSelftestEntry::Status::ComplHandlingDamage; break;
-							// Special case
-							case 0xf: status = AtaStorageSelftestEntry::Status::InProgress; break;
-							default: status = AtaStorageSelftestEntry::Status::Reserved; break;
-						}
+						status = decode_ata_selftest_status(value_val.value());
 
 						AtaStorageSelftestEntry sse;
 						sse.test_num = 0;  // capability uses 0
@@ -575,7 +572,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_capab
 
 						StorageProperty p;
 						p.set_name(key, displayable_name);
-						p.value = sse;
+						p.set_value(sse);
 						return p;
 					}
 
@@ -736,7 +733,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_attri
 			StorageProperty p;
 			p.set_name(reported_name, reported_name, reported_name);  // The description database will correct this.
 			p.section = StoragePropertySection::AtaAttributes;
-			p.value = a;
+			p.set_value(a);
 			add_property(p);
 
 			section_properties_found = true;
@@ -889,7 +886,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_error
 			std::string disp_name = fmt::format("Error {}", block.error_num);
 			p.set_name(gen_name, disp_name, gen_name);
 			p.section = StoragePropertySection::AtaErrorLog;
-			p.value = block;
+			p.set_value(block);
 			add_property(p);
 		}
 
@@ -1002,7 +999,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_selft
 			std::string disp_name = fmt::format("Self-test entry {}", entry.test_num);
 			p.set_name(gen_name, disp_name);
 			p.section = StoragePropertySection::SelftestLog;
-			p.value = entry;
+			p.set_value(entry);
 			add_property(p);
 
 			++entry_num;
@@ -1292,7 +1289,26 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_sctte
 		section_properties_found = true;
 	}
 
-	// TODO Temperature log graph
+	// Temperature history table, for the graph. The entries are in chronological order.
+	const std::string history_table_key = "ata_sct_temperature_history/table";
+	if (auto history_table_node = get_node(json_root_node, history_table_key);
+			history_table_node.has_value() && history_table_node.value().is_array()) {
+		AtaStorageTemperatureHistory history;
+		history.logging_interval_minutes = get_node_data<int64_t>(json_root_node,
+				"ata_sct_temperature_history/logging_interval_minutes").value_or(0);
+		history.temperatures.reserve(history_table_node.value().size());
+		for (const auto& table_entry : history_table_node.value()) {
+			history.temperatures.push_back(table_entry.is_number_integer()
+					? std::optional<int64_t>(table_entry.get<int64_t>()) : std::nullopt);
+		}
+
+		StorageProperty p;
+		p.set_name(history_table_key, _("Temperature history"));
+		p.section = StoragePropertySection::TemperatureLog;
+		p.set_value(std::move(history));
+		p.show_in_ui = false;  // shown as a graph
+		add_property(p);
+	}
 
 	if (!section_properties_found) {
 		return hz::Unexpected(SmartctlParserError::NoSection,
@@ -1368,7 +1384,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_devst
 				const std::string disp_name = gen_name;  // TODO: Translate
 				page_prop.set_name(gen_name, disp_name);
 				page_prop.section = StoragePropertySection::Statistics;
-				page_prop.value = page_stat;
+				page_prop.set_value(page_stat);
 			}
 			add_property(page_prop);
 
@@ -1388,7 +1404,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonAtaParser::parse_section_devst
 					const std::string gen_name = get_node_data<std::string>(table_entry, "name").value_or(std::string());
 					p.set_name(gen_name, gen_name, gen_name);  // The description database will correct this.
 					p.section = StoragePropertySection::Statistics;
-					p.value = s;
+					p.set_value(s);
 					add_property(p);
 				}
 			}
@@ -474,20 +474,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonNvmeParser::parse_section_self
 
 			NvmeSelfTestResultType test_result = NvmeSelfTestResultType::Unknown;
 			if (get_node_exists(table_entry, "self_test_result/value").value_or(false)) {
-				const int32_t type_value = get_node_data<int32_t>(table_entry, "self_test_result/value").value_or(int(NvmeSelfTestType::Unknown));
-				switch(type_value) {
-					case 0x0: test_result = NvmeSelfTestResultType::CompletedNoError; break;
-					case 0x1: test_result = NvmeSelfTestResultType::AbortedSelfTestCommand; break;
-					case 0x2: test_result = NvmeSelfTestResultType::AbortedControllerReset; break;
-					case 0x3: test_result = NvmeSelfTestResultType::AbortedNamespaceRemoved; break;
-					case 0x4: test_result = NvmeSelfTestResultType::AbortedFormatNvmCommand; break;
-					case 0x5: test_result = NvmeSelfTestResultType::FatalOrUnknownTestError; break;
-					case 0x6: test_result = NvmeSelfTestResultType::CompletedUnknownFailedSegment; break;
-					case 0x7: test_result = NvmeSelfTestResultType::CompletedFailedSegments; break;
-					case 0x8: test_result = NvmeSelfTestResultType::AbortedUnknownReason; break;
-					case 0x9: test_result = NvmeSelfTestResultType::AbortedSanitizeOperation; break;
-					default: break;  // Unknown
-				}
+				test_result = decode_nvme_selftest_result(get_node_data<int32_t>(table_entry, "self_test_result/value").value_or(-1));
 			}
 
 			entry.type = test_type;
@@ -502,7 +489,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlJsonNvmeParser::parse_section_self
 			std::string disp_name = fmt::format("Self-test entry {}", entry.test_num);
 			p.set_name(gen_name, disp_name);
 			p.section = StoragePropertySection::SelftestLog;
-			p.value = entry;
+			p.set_value(entry);
 			add_property(p);
 
 			++entry_num;
@@ -13,6 +13,7 @@ Copyright:
 #define SMARTCTL_JSON_PARSER_HELPERS_H
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <string>
 #include <string_view>
@@ -322,6 +323,49 @@ auto custom_string_formatter(std::function<std::string(Type value)> formatter)
 
 
 
+/// Decode the ATA self-test execution status value ("ata_smart_data/self_test/status/value")
+[[nodiscard]] inline AtaStorageSelftestEntry::Status decode_ata_selftest_status(uint8_t value)
+{
+	switch (value >> 4) {
+		// Data from smartmontools/ataprint.cpp
+		case 0x0: return AtaStorageSelftestEntry::Status::CompletedNoError;
+		case 0x1: return AtaStorageSelftestEntry::Status::AbortedByHost;
+		case 0x2: return AtaStorageSelftestEntry::Status::Interrupted;
+		case 0x3: return AtaStorageSelftestEntry::Status::FatalOrUnknown;
+		case 0x4: return AtaStorageSelftestEntry::Status::ComplUnknownFailure;
+		case 0x5: return AtaStorageSelftestEntry::Status::ComplElectricalFailure;
+		case 0x6: return AtaStorageSelftestEntry::Status::ComplServoFailure;
+		case 0x7: return AtaStorageSelftestEntry::Status::ComplReadFailure;
+		case 0x8: return AtaStorageSelftestEntry::Status::ComplHandlingDamage;
+		// Special case
+		case 0xf: return AtaStorageSelftestEntry::Status::InProgress;
+		default: return AtaStorageSelftestEntry::Status::Reserved;
+	}
+}
+
+
+
+/// Decode the NVMe self-test result value ("self_test_result/value" of a self-test log entry)
+[[nodiscard]] inline NvmeSelfTestResultType decode_nvme_selftest_result(int32_t value)
+{
+	switch (value) {
+		case 0x0: return NvmeSelfTestResultType::CompletedNoError;
+		case 0x1: return NvmeSelfTestResultType::AbortedSelfTestCommand;
+		case 0x2: return NvmeSelfTestResultType::AbortedControllerReset;
+		case 0x3: return NvmeSelfTestResultType::AbortedNamespaceRemoved;
+		case 0x4: return NvmeSelfTestResultType::AbortedFormatNvmCommand;
+		case 0x5: return NvmeSelfTestResultType::FatalOrUnknownTestError;
+		case 0x6: return NvmeSelfTestResultType::CompletedUnknownFailedSegment;
+		case 0x7: return NvmeSelfTestResultType::CompletedFailedSegments;
+		case 0x8: return NvmeSelfTestResultType::AbortedUnknownReason;
+		case 0x9: return NvmeSelfTestResultType::AbortedSanitizeOperation;
+		default: return NvmeSelfTestResultType::Unknown;
+	}
+}
+
+
+
+
 }  // namespace SmartctlJsonParserHelpers
 
 
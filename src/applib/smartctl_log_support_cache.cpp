@@ -0,0 +1,174 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <algorithm>
+#include <cstdint>
+
+#include "smartctl_log_support_cache.h"
+#include "app_regex.h"
+#include "rconfig/rconfig.h"
+#include "hz/debug.h"
+
+
+
+namespace {
+
+	/// Config path of the cache
+	constexpr const char* cache_config_path = "system/log_support_cache";
+
+	/// Keep at most this many drive models in cache
+	constexpr std::size_t max_cache_entries = 64;
+
+
+	/// A log which is not supported by many drives
+	struct OptionalLog {
+		const char* option;  ///< smartctl option
+		StoragePropertySection section;  ///< Section of its properties
+		const char* unsupported_pattern;  ///< Perl-style regex, matches smartctl output if unsupported
+	};
+
+
+	/// Logs which are requested by the full fetch, but rejected by many drives.
+	/// The patterns are the same as in SmartctlTextAtaParser.
+	constexpr OptionalLog optional_logs[] = {
+		{"--log=scttemp", StoragePropertySection::TemperatureLog,
+				"/^(SCT Commands not supported)|(SCT Data Table command not supported)/mi"},
+		{"--log=scterc", StoragePropertySection::ErcLog,
+				"/^(SCT Commands not supported)|(SCT Error Recovery Control command not supported)/mi"},
+		{"--log=devstat", StoragePropertySection::Statistics,
+				"/^Device Statistics \\([^)]+\\) not supported/mi"},
+		{"--log=sataphy", StoragePropertySection::PhyLog,
+				"/^SATA Phy Event Counters (\\(GP Log 0x11\\)|with [0-9-]+ sectors) not supported/mi"},
+	};
+
+
+	/// Get the cache entries from config. Invalid entries are skipped.
+	std::vector<rconfig::json> get_cache_entries()
+	{
+		std::vector<rconfig::json> entries;
+		const auto cache = rconfig::get_data<rconfig::json>(cache_config_path);
+		if (!cache.is_array())
+			return entries;
+
+		for (const auto& entry : cache) {
+			if (entry.is_object() && entry.contains("model") && entry.contains("firmware")
+					&& entry.contains("probe_time") && entry.contains("unsupported")) {
+				entries.push_back(entry);
+			}
+		}
+		return entries;
+	}
+
+
+	/// Check whether a cache entry is for a drive model and firmware
+	bool cache_entry_matches(const rconfig::json& entry, const std::string& model, const std::string& firmware)
+	{
+		try {
+			return entry.at("model").get<std::string>() == model && entry.at("firmware").get<std::string>() == firmware;
+		}
+		catch (rconfig::json::exception& e) {  // invalid types in user config
+			return false;
+		}
+	}
+
+}
+
+
+
+std::vector<std::string> smartctl_log_support_find_unsupported(const std::vector<std::string>& requested_options,
+		const StoragePropertyRepository& repository, const std::string& smartctl_output)
+{
+	std::vector<std::string> unsupported;
+	for (const auto& log : optional_logs) {
+		if (std::find(requested_options.begin(), requested_options.end(), log.option) == requested_options.end()) {
+			continue;
+		}
+		// Note: This match works even with JSON (the text output is included in --json=o).
+		if (!repository.has_properties_for_section(log.section)
+				|| app_regex_partial_match(log.unsupported_pattern, smartctl_output)) {
+			unsupported.emplace_back(log.option);
+		}
+	}
+	return unsupported;
+}
+
+
+
+std::optional<std::vector<std::string>> smartctl_log_support_cache_lookup(const std::string& model,
+		const std::string& firmware, std::chrono::system_clock::time_point now)
+{
+	if (model.empty() || !rconfig::get_data<bool>("system/skip_unsupported_logs"))
+		return std::nullopt;
+
+	const auto reprobe_interval = std::chrono::hours(24) * std::max(rconfig::get_data<int>("system/log_support_reprobe_days"), 0);
+
+	for (const auto& entry : get_cache_entries()) {
+		if (cache_entry_matches(entry, model, firmware)) {
+			try {
+				const auto probe_time = std::chrono::system_clock::time_point(
+						std::chrono::seconds(entry.at("probe_time").get<std::int64_t>()));
+				if (now < probe_time || now - probe_time >= reprobe_interval) {
+					debug_out_info("app", DBG_FUNC_MSG << "Log support of \"" << model << "\" needs to be probed again.\n");
+					return std::nullopt;
+				}
+				return entry.at("unsupported").get<std::vector<std::string>>();
+			}
+			catch (rconfig::json::exception& e) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Invalid log support cache entry: " << e.what() << "\n");
+			}
+			break;
+		}
+	}
+	return std::nullopt;
+}
+
+
+
+void smartctl_log_support_cache_store(const std::string& model, const std::string& firmware,
+		const std::vector<std::string>& unsupported_options, std::chrono::system_clock::time_point now)
+{
+	if (model.empty() || !rconfig::get_data<bool>("system/skip_unsupported_logs"))
+		return;
+
+	auto entries = get_cache_entries();
+
+	// Remove the old entry for this model, it's outdated.
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&model, &firmware](const rconfig::json& entry) {
+		return cache_entry_matches(entry, model, firmware);
+	}), entries.end());
+
+	// The most recent entry goes first
+	entries.insert(entries.begin(), rconfig::json {
+		{"model", model},
+		{"firmware", firmware},
+		{"probe_time", std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count()},
+		{"unsupported", unsupported_options},
+	});
+	if (entries.size() > max_cache_entries) {
+		entries.resize(max_cache_entries);
+	}
+
+	rconfig::set_data(cache_config_path, rconfig::json(entries));
+}
+
+
+
+void smartctl_log_support_cache_clear()
+{
+	rconfig::unset_data(cache_config_path);
+}
+
+
+
+
+
+
+/// @}
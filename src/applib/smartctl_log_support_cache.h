@@ -0,0 +1,53 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SMARTCTL_LOG_SUPPORT_CACHE_H
+#define SMARTCTL_LOG_SUPPORT_CACHE_H
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "storage_property_repository.h"
+
+
+
+/// Find the optional logs (e.g. "--log=scttemp") of \c requested_options which were reported
+/// as unsupported in \c smartctl_output, or which have no properties in \c repository.
+/// Only the logs which are not supported by many drives are considered, see the implementation.
+[[nodiscard]] std::vector<std::string> smartctl_log_support_find_unsupported(const std::vector<std::string>& requested_options,
+		const StoragePropertyRepository& repository, const std::string& smartctl_output);
+
+
+/// Look up the log options unsupported by a drive model and firmware in the cache
+/// (stored in config, so it persists across runs).
+/// \return std::nullopt if the model is not in cache, if it's time to probe its logs again,
+/// or if the cache is disabled in config.
+[[nodiscard]] std::optional<std::vector<std::string>> smartctl_log_support_cache_lookup(const std::string& model,
+		const std::string& firmware, std::chrono::system_clock::time_point now);
+
+
+/// Store the log options unsupported by a drive model and firmware, replacing any previous entry for it.
+void smartctl_log_support_cache_store(const std::string& model, const std::string& firmware,
+		const std::vector<std::string>& unsupported_options, std::chrono::system_clock::time_point now);
+
+
+/// Remove all the entries from the cache
+void smartctl_log_support_cache_clear();
+
+
+
+
+
+#endif
+
+/// @}
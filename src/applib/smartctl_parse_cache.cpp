@@ -0,0 +1,344 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include "smartctl_parse_cache.h"
+
+#include <glibmm.h>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "hz/debug.h"
+#include "hz/string_algo.h"
+#include "hz/string_num.h"
+#include "smartctl_parser.h"
+#include "storage_property_descr.h"
+#include "warning_colors.h"
+
+
+
+namespace {
+
+	/// Everything the processed properties depend on, besides the parsed ones: the detected type,
+	/// the user warning rules and the dark mode of warning reasons.
+	using ProcessKey = std::tuple<StorageDeviceDetectedType, std::shared_ptr<const StoragePropertyUserRules>, bool>;
+
+
+	/// Time of the smartctl run, as printed in its output
+	struct OutputTime {
+		std::string asctime;  ///< "Local Time is:" value, or local_time/asctime in JSON
+		std::string time_t_str;  ///< local_time/time_t in JSON
+
+		bool operator==(const OutputTime& other) const = default;
+	};
+
+
+	/// Remove the time of the smartctl run from the output, so that the outputs of
+	/// an unchanged drive compare equal. The removed time is stored in \c time.
+	std::string strip_output_time(SmartctlOutputFormat format, std::string_view output, OutputTime& time)
+	{
+		std::string stripped(output);
+
+		if (format == SmartctlOutputFormat::Json) {
+			// "local_time": {"time_t": 1700000000, "asctime": "Tue Nov 14 22:13:20 2023 UTC"}
+			const auto object_pos = stripped.find("\"local_time\"");
+			const auto object_end = stripped.find('}', object_pos);
+			if (object_pos != std::string::npos && object_end != std::string::npos) {
+				if (const auto key_pos = stripped.find("\"asctime\"", object_pos); key_pos < object_end) {
+					const auto begin = stripped.find('"', stripped.find(':', key_pos));
+					const auto end = stripped.find('"', begin + 1);
+					if (begin < object_end && end < object_end) {
+						time.asctime = stripped.substr(begin + 1, end - begin - 1);
+					}
+				}
+				if (const auto key_pos = stripped.find("\"time_t\"", object_pos); key_pos < object_end) {
+					const auto begin = stripped.find_first_of("-0123456789", key_pos + 8);
+					const auto end = stripped.find_first_not_of("-0123456789", begin);
+					if (begin < object_end && end <= object_end) {
+						time.time_t_str = stripped.substr(begin, end - begin);
+						stripped.erase(begin, end - begin);
+					}
+				}
+			}
+		} else {
+			const std::string_view label = "Local Time is:";
+			if (const auto label_pos = stripped.find(label); label_pos != std::string::npos) {
+				const auto begin = stripped.find_first_not_of(" \t", label_pos + label.size());
+				if (begin != std::string::npos) {
+					const auto end = stripped.find_first_of("\r\n", begin);
+					time.asctime = hz::string_trim_copy(stripped.substr(begin, end - begin));
+				}
+			}
+		}
+
+		// The text output embedded in JSON, and smartctl/output of text output, contain it too.
+		if (!time.asctime.empty()) {
+			hz::string_replace(stripped, time.asctime, std::string());
+		}
+		return stripped;
+	}
+
+
+	/// Replace the time of the cached smartctl run with the time of the new one
+	SmartctlParseCache::RepositoryPtr patch_output_time(const StoragePropertyRepository& repository,
+			const OutputTime& from, const OutputTime& to)
+	{
+		StoragePropertyRepository patched = repository;
+		patched.modify_properties([&from, &to](StorageProperty& p) {
+			if (p.generic_name == "local_time/time_t") {
+				int64_t value = 0;
+				if (hz::string_is_numeric_nolocale(to.time_t_str, value)) {
+					p.value = value;
+					p.readable_value = hz::number_to_string_locale(value);
+				}
+				return;
+			}
+			if (from.asctime.empty() || from.asctime == to.asctime) {
+				return;
+			}
+			hz::string_replace(p.reported_value, from.asctime, to.asctime);
+			hz::string_replace(p.readable_value, from.asctime, to.asctime);
+			if (auto* str_value = std::get_if<std::string>(&p.value)) {
+				hz::string_replace(*str_value, from.asctime, to.asctime);
+			}
+		});
+		return std::make_shared<const StoragePropertyRepository>(std::move(patched));
+	}
+
+
+	/// Cached parse result
+	struct CacheEntry {
+		std::size_t hash = 0;  ///< Hash of output
+		SmartctlParserType parser_type = SmartctlParserType::Basic;  ///< Parser type
+		SmartctlOutputFormat format = SmartctlOutputFormat::Text;  ///< Output format
+		std::string output;  ///< Output without the time of the run, to rule out hash collisions
+		OutputTime time;  ///< Time of the run the properties were parsed (or patched) for
+		SmartctlParseCache::RepositoryPtr parsed;  ///< Parsed properties
+
+		/// Processed properties. When the rules or the theme change, the results for the new ones are added.
+		std::map<ProcessKey, SmartctlParseCache::RepositoryPtr> processed;
+	};
+
+
+	/// Cache state
+	struct CacheState {
+		std::mutex mutex;  ///< Protects the members below
+		std::list<CacheEntry> entries;  ///< Most recently used first
+		std::size_t max_entries = 32;  ///< Maximum size of entries
+		SmartctlParseCacheStats stats;  ///< Statistics
+	};
+
+
+	/// Get cache state
+	CacheState& get_cache_state()
+	{
+		static CacheState state;
+		return state;
+	}
+
+
+	/// Remove the least recently used entries until there are at most \c max_entries left. Must be called under lock.
+	void trim_cache(CacheState& state)
+	{
+		while (state.entries.size() > state.max_entries) {
+			state.entries.pop_back();
+			++state.stats.evictions;
+		}
+		state.stats.entries = state.entries.size();
+	}
+
+}
+
+
+
+double SmartctlParseCacheStats::get_parse_hit_rate() const
+{
+	const std::size_t total = parse_hits + parse_misses;
+	return total == 0 ? 0. : (double(parse_hits) / double(total));
+}
+
+
+
+double SmartctlParseCacheStats::get_process_hit_rate() const
+{
+	const std::size_t total = process_hits + process_misses;
+	return total == 0 ? 0. : (double(process_hits) / double(total));
+}
+
+
+
+hz::ExpectedValue<SmartctlParseCache::RepositoryPtr, SmartctlParserError> SmartctlParseCache::parse(
+		SmartctlParserType parser_type, SmartctlOutputFormat format, std::string_view output)
+{
+	auto& state = get_cache_state();
+
+	OutputTime time;
+	std::string stripped_output = strip_output_time(format, output, time);
+	const std::size_t hash = std::hash<std::string>()(stripped_output);
+
+	RepositoryPtr cached;
+	OutputTime cached_time;
+	std::map<ProcessKey, RepositoryPtr> cached_processed;
+	double hit_rate = 0.;
+	{
+		const std::scoped_lock lock(state.mutex);
+		for (auto iter = state.entries.begin(); iter != state.entries.end(); ++iter) {
+			if (iter->hash == hash && iter->parser_type == parser_type && iter->format == format && iter->output == stripped_output) {
+				state.entries.splice(state.entries.begin(), state.entries, iter);  // move to front
+				++state.stats.parse_hits;
+				hit_rate = state.stats.get_parse_hit_rate();
+				cached = iter->parsed;
+				cached_time = iter->time;
+				if (cached_time != time) {
+					cached_processed = iter->processed;
+				}
+				break;
+			}
+		}
+		if (!cached) {
+			++state.stats.parse_misses;
+		}
+	}
+	// Log outside the lock, debug output has its own lock.
+	if (cached) {
+		debug_out_dump("app", DBG_FUNC_MSG << "Parse cache hit, hit rate: " << hit_rate << ".\n");
+	}
+	if (cached && cached_time == time) {
+		return cached;
+	}
+
+	// Only the time of the run differs. Update it in the cached results, outside the lock.
+	if (cached) {
+		auto patched = patch_output_time(*cached, cached_time, time);
+		for (auto& [key, processed] : cached_processed) {
+			processed = patch_output_time(*processed, cached_time, time);
+		}
+
+		const std::scoped_lock lock(state.mutex);
+		for (auto& entry : state.entries) {
+			if (entry.parsed == cached) {
+				entry.time = time;
+				entry.parsed = patched;
+				entry.processed = std::move(cached_processed);
+				break;
+			}
+		}
+		return patched;
+	}
+
+	// Parse outside the lock, this is the slow part.
+	auto parser = SmartctlParser::create(parser_type, format);
+	DBG_ASSERT_RETURN(parser, hz::Unexpected(SmartctlParserError::InternalError, _("Cannot create parser.")));
+
+	auto parse_status = parser->parse(output);
+	if (!parse_status) {
+		return hz::UnexpectedFrom(parse_status);
+	}
+	auto parsed = std::make_shared<const StoragePropertyRepository>(parser->get_property_repository());
+
+	const std::scoped_lock lock(state.mutex);
+	if (state.max_entries > 0) {
+		CacheEntry entry;
+		entry.hash = hash;
+		entry.parser_type = parser_type;
+		entry.format = format;
+		entry.output = std::move(stripped_output);
+		entry.time = std::move(time);
+		entry.parsed = parsed;
+		state.entries.push_front(std::move(entry));
+		trim_cache(state);
+	}
+
+	return parsed;
+}
+
+
+
+SmartctlParseCache::RepositoryPtr SmartctlParseCache::process(const RepositoryPtr& parsed, StorageDeviceDetectedType detected_type)
+{
+	DBG_ASSERT_RETURN(parsed, nullptr);
+
+	auto& state = get_cache_state();
+
+	const ProcessKey key(detected_type, StoragePropertyProcessor::get_user_warning_rules(),
+			storage_property_get_warning_reason_dark_mode());
+	const auto& user_rules = std::get<std::shared_ptr<const StoragePropertyUserRules>>(key);
+
+	{
+		const std::scoped_lock lock(state.mutex);
+		for (auto& entry : state.entries) {
+			if (entry.parsed == parsed) {
+				if (auto found = entry.processed.find(key); found != entry.processed.end()) {
+					++state.stats.process_hits;
+					return found->second;
+				}
+				break;
+			}
+		}
+		++state.stats.process_misses;
+	}
+
+	auto processed = std::make_shared<const StoragePropertyRepository>(
+			StoragePropertyProcessor::process_properties(*parsed, detected_type, *user_rules));
+
+	// The entry may have been removed while processing. In this case, don't cache the result.
+	const std::scoped_lock lock(state.mutex);
+	for (auto& entry : state.entries) {
+		if (entry.parsed == parsed) {
+			entry.processed.insert_or_assign(key, processed);
+			break;
+		}
+	}
+
+	return processed;
+}
+
+
+
+void SmartctlParseCache::set_max_entries(std::size_t max_entries)
+{
+	auto& state = get_cache_state();
+	const std::scoped_lock lock(state.mutex);
+	state.max_entries = max_entries;
+	trim_cache(state);
+}
+
+
+
+void SmartctlParseCache::clear()
+{
+	auto& state = get_cache_state();
+	const std::scoped_lock lock(state.mutex);
+	state.entries.clear();
+	state.stats.entries = 0;
+}
+
+
+
+SmartctlParseCacheStats SmartctlParseCache::get_stats()
+{
+	auto& state = get_cache_state();
+	const std::scoped_lock lock(state.mutex);
+	return state.stats;
+}
+
+
+
+
+
+
+/// @}
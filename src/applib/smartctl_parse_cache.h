@@ -0,0 +1,90 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SMARTCTL_PARSE_CACHE_H
+#define SMARTCTL_PARSE_CACHE_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "hz/error_container.h"
+#include "smartctl_parser_types.h"
+#include "storage_property.h"
+#include "storage_property_repository.h"
+#include "storage_device_detected_type.h"
+
+
+
+/// Parse cache statistics
+struct SmartctlParseCacheStats {
+	std::size_t parse_hits = 0;  ///< Number of parse() calls which did not have to parse
+	std::size_t parse_misses = 0;  ///< Number of parse() calls which parsed the output
+	std::size_t process_hits = 0;  ///< Number of process() calls which did not have to process
+	std::size_t process_misses = 0;  ///< Number of process() calls which processed the properties
+	std::size_t evictions = 0;  ///< Number of entries removed because the cache was full
+	std::size_t entries = 0;  ///< Current number of entries
+
+	/// Get parse() hit rate, 0 - 1.
+	[[nodiscard]] double get_parse_hit_rate() const;
+
+	/// Get process() hit rate, 0 - 1.
+	[[nodiscard]] double get_process_hit_rate() const;
+};
+
+
+
+/// A bounded, process-wide cache of parsed smartctl outputs, keyed by the output
+/// hash, parser type and output format. The time of the smartctl run ("Local Time is:",
+/// local_time) is not a part of the key, so outputs which differ only in it (unchanged
+/// virtual files, refreshes of idle drives, self-test polling) are parsed and processed
+/// only once; the cached properties are returned with the time updated.
+/// The least recently used entries are removed when the cache is full.
+/// All functions are thread-safe.
+class SmartctlParseCache {
+	public:
+
+		/// Shared, immutable property repository
+		using RepositoryPtr = std::shared_ptr<const StoragePropertyRepository>;
+
+
+		/// Parse the output using a parser of specified type and format, or return the
+		/// previous result for the same output, ignoring the time of the run. Parse errors are not cached.
+		[[nodiscard]] static hz::ExpectedValue<RepositoryPtr, SmartctlParserError> parse(
+				SmartctlParserType parser_type, SmartctlOutputFormat format, std::string_view output);
+
+
+		/// Process the properties returned by parse() using StoragePropertyProcessor::process_properties(),
+		/// or return the previous result for the same input. The input includes the current user warning rules
+		/// and the dark mode of warning reasons, so changing them doesn't return stale warnings.
+		/// The descriptions of the returned properties are
+		/// not generated yet; copy the repository before accessing them, since the result is shared.
+		[[nodiscard]] static RepositoryPtr process(const RepositoryPtr& parsed, StorageDeviceDetectedType detected_type);
+
+
+		/// Set the maximum number of cached outputs. 0 disables the cache.
+		static void set_max_entries(std::size_t max_entries);
+
+		/// Remove all the entries (statistics are kept)
+		static void clear();
+
+		/// Get statistics
+		[[nodiscard]] static SmartctlParseCacheStats get_stats();
+
+};
+
+
+
+
+
+#endif
+
+/// @}
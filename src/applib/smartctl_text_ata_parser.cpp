@@ -976,7 +976,7 @@ SCT capabilities: 	       (0x003d)	SCT Status supported.
 				hz::string_trim(v);
 			}
 
-			p.value = cap;  // Capability-type value
+			p.set_value(cap);  // Capability-type value
 
 			// find some special capabilities we're interested in and add them. p is unmodified.
 			if (parse_section_data_internal_capabilities(p)) {
@@ -1143,7 +1143,7 @@ hz::ExpectedVoid<SmartctlParserError> SmartctlTextAtaParser::parse_section_data_
 			}
 		}
 
-		p.value = sse;  // AtaStorageSelftestEntry-type value
+		p.set_value(sse);  // AtaStorageSelftestEntry-type value
 
 		add_property(p);
 
@@ -1461,7 +1461,7 @@ ID# ATTRIBUTE_NAME          FLAGS    VALUE WORST THRESH FAIL RAW_VALUE
 			StorageProperty p(pt);
 			p.set_name(hz::string_trim_copy(name), hz::string_trim_copy(name), hz::string_trim_copy(name));
 			p.reported_value = line;  // use the whole line here
-			p.value = attr;  // attribute-type value;
+			p.set_value(attr);  // attribute-type value;
 
 			add_property(p);
 			attr_found = true;
@@ -1690,7 +1690,7 @@ Error 1 [0] occurred at disk power-on lifetime: 1 hours (0 days + 1 hours)
 			eb.reported_types = etypes;
 			eb.type_more_info = hz::string_trim_copy(emore);
 
-			p.value = eb;  // Error block value
+			p.set_value(eb);  // Error block value
 
 			add_property(p);
 			data_found = true;
@@ -1870,7 +1870,7 @@ Num  Test_Description    Status                  Remaining  LifeTime(hours)  LBA
 			sse.status_str = status_str;
 			sse.status = status;
 
-			p.value = sse;  // AtaStorageSelftestEntry value
+			p.set_value(sse);  // AtaStorageSelftestEntry value
 
 			add_property(p);
 			data_found = true;
@@ -2255,7 +2255,7 @@ Page Offset Size         Value  Description
 		std::string gen_name = hz::string_trim_copy(description);
 		p.set_name(gen_name, gen_name, gen_name);
 		p.reported_value = line;  // use the whole line here
-		p.value = st;  // statistic-type value
+		p.set_value(st);  // statistic-type value
 
 		add_property(p);
 		entries_found = true;
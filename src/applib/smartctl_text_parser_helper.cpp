@@ -10,8 +10,11 @@ Copyright:
 /// @{
 
 #include "smartctl_text_parser_helper.h"
+
+#include <locale>
+#include <stdexcept>
+
 #include "build_config.h"
-#include "hz/locale_tools.h"
 #include "hz/format_unit.h"  // format_size
 #include "hz/string_num.h"  // string_is_numeric, number_to_string
 #include "hz/string_algo.h"  // string_*
@@ -42,18 +45,19 @@ std::string SmartctlTextParserHelper::parse_byte_size(std::string str, int64_t&
 	};
 
 	if constexpr(BuildEnv::is_kernel_family_windows()) {
-		// if current locale is C, then probably we didn't change it at application
-		// startup, so set it now (temporarily). Otherwise, just use the current locale's
-		// thousands separator.
-		{
-			const std::string old_locale = hz::locale_c_get();
-			const hz::ScopedCLocale loc("", old_locale == "C");  // set system locale if the current one is C
-
-			struct lconv* lc = std::localeconv();
-			if (lc && lc->thousands_sep && lc->thousands_sep[0] != '\0') {
-				to_replace.emplace_back(lc->thousands_sep);
+		// Use the system locale's thousands separator. This doesn't touch the global
+		// locale, so it's safe to call from the parser threads.
+		static const char system_thousands_sep = []() -> char {
+			try {
+				return std::use_facet<std::numpunct<char>>(std::locale("")).thousands_sep();
+			}
+			catch (const std::runtime_error&) {  // unsupported system locale
+				return '\0';
 			}
-		}  // the locale is restored here
+		}();
+		if (system_thousands_sep != '\0') {
+			to_replace.emplace_back(1, system_thousands_sep);
+		}
 	}
 
 	to_replace.emplace_back("bytes");
@@ -0,0 +1,203 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <glibmm.h>
+#include <glib/gstdio.h>  // g_stat, g_access
+#ifndef _WIN32
+	#include <unistd.h>  // X_OK
+#endif
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+#include "smartctl_version_cache.h"
+#include "rconfig/rconfig.h"
+#include "hz/debug.h"
+#include "hz/fs.h"
+#include "hz/string_algo.h"  // string_trim_copy
+
+
+
+namespace {
+
+	/// Config path of the cache
+	constexpr const char* cache_config_path = "system/smartctl_version_cache";
+
+	/// Keep at most this many binaries in cache
+	constexpr std::size_t max_cache_entries = 8;
+
+
+	/// Get the cache entries from config. Invalid entries are skipped.
+	std::vector<rconfig::json> get_cache_entries()
+	{
+		std::vector<rconfig::json> entries;
+		const auto cache = rconfig::get_data<rconfig::json>(cache_config_path);
+		if (!cache.is_array())
+			return entries;
+
+		for (const auto& entry : cache) {
+			if (entry.is_object() && entry.contains("path") && entry.contains("inode") && entry.contains("mtime")
+					&& entry.contains("size") && entry.contains("version") && entry.contains("version_full")) {
+				entries.push_back(entry);
+			}
+		}
+		return entries;
+	}
+
+
+	/// Check whether a cache entry matches the stamp
+	bool cache_entry_matches(const rconfig::json& entry, const SmartctlBinaryStamp& stamp)
+	{
+		try {
+			return entry.at("path").get<std::string>() == stamp.path
+					&& entry.at("inode").get<std::uint64_t>() == stamp.inode
+					&& entry.at("mtime").get<std::int64_t>() == stamp.mtime
+					&& entry.at("size").get<std::int64_t>() == stamp.size;
+		}
+		catch (rconfig::json::exception& e) {  // invalid types in user config
+			return false;
+		}
+	}
+
+
+	/// Check that the binary can still be executed. Its permissions may have been removed,
+	/// or (for scripts) its interpreter may be missing, without the binary itself changing.
+	bool binary_is_executable(const std::string& path)
+	{
+#ifndef _WIN32
+		if (g_access(path.c_str(), X_OK) != 0) {
+			debug_out_info("app", DBG_FUNC_MSG << "\"" << path << "\" is not executable.\n");
+			return false;
+		}
+
+		std::ifstream file(hz::fs_path_from_string(path), std::ios::binary);
+		std::string first_line;
+		if (file && file.get() == '#' && file.get() == '!' && std::getline(file, first_line)) {
+			const std::string line = hz::string_trim_copy(first_line);
+			const std::string interpreter = line.substr(0, line.find_first_of(" \t"));
+			if (!interpreter.empty() && g_access(interpreter.c_str(), X_OK) != 0) {
+				debug_out_info("app", DBG_FUNC_MSG << "Interpreter \"" << interpreter << "\" of \"" << path << "\" is not executable.\n");
+				return false;
+			}
+		}
+#endif
+		return true;
+	}
+
+}
+
+
+
+std::optional<SmartctlBinaryStamp> smartctl_get_binary_stamp(const hz::fs::path& binary)
+{
+	if (binary.empty())
+		return std::nullopt;
+
+	hz::fs::path binary_path = binary;
+	if (!binary.has_parent_path()) {
+		const std::string found = Glib::find_program_in_path(hz::fs_path_to_string(binary));
+		if (found.empty()) {
+			debug_out_info("app", DBG_FUNC_MSG << "Binary \"" << hz::fs_path_to_string(binary) << "\" not found in PATH.\n");
+			return std::nullopt;
+		}
+		binary_path = hz::fs_path_from_string(found);
+	}
+
+	// Resolve symlinks, so that switching a symlink to another version is noticed.
+	std::error_code ec;
+	const hz::fs::path canonical_path = hz::fs::canonical(binary_path, ec);
+	if (ec) {
+		debug_out_info("app", DBG_FUNC_MSG << "Cannot resolve \"" << hz::fs_path_to_string(binary_path) << "\": " << ec.message() << "\n");
+		return std::nullopt;
+	}
+
+	SmartctlBinaryStamp stamp;
+	stamp.path = hz::fs_path_to_string(canonical_path);
+
+	GStatBuf stat_buf = {};
+	if (g_stat(stamp.path.c_str(), &stat_buf) != 0) {
+		debug_out_info("app", DBG_FUNC_MSG << "Cannot stat \"" << stamp.path << "\".\n");
+		return std::nullopt;
+	}
+	stamp.inode = static_cast<std::uint64_t>(stat_buf.st_ino);
+	stamp.mtime = static_cast<std::int64_t>(stat_buf.st_mtime);
+	stamp.size = static_cast<std::int64_t>(stat_buf.st_size);
+
+	return stamp;
+}
+
+
+
+std::optional<SmartctlCachedVersion> smartctl_version_cache_lookup(const SmartctlBinaryStamp& stamp)
+{
+	// Let the caller execute it, so that the error is shown.
+	if (!binary_is_executable(stamp.path))
+		return std::nullopt;
+
+	for (const auto& entry : get_cache_entries()) {
+		if (cache_entry_matches(entry, stamp)) {
+			try {
+				SmartctlCachedVersion version;
+				version.version = entry.at("version").get<std::string>();
+				version.version_full = entry.at("version_full").get<std::string>();
+				if (!version.version.empty()) {
+					return version;
+				}
+			}
+			catch (rconfig::json::exception& e) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Invalid smartctl version cache entry: " << e.what() << "\n");
+			}
+			break;
+		}
+	}
+	return std::nullopt;
+}
+
+
+
+void smartctl_version_cache_store(const SmartctlBinaryStamp& stamp, const SmartctlCachedVersion& version)
+{
+	auto entries = get_cache_entries();
+
+	// Remove the old entry for this path, it's either the same or outdated.
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [&stamp](const rconfig::json& entry) {
+		return !entry.at("path").is_string() || entry.at("path").get<std::string>() == stamp.path;
+	}), entries.end());
+
+	// The most recent entry goes first
+	entries.insert(entries.begin(), rconfig::json {
+		{"path", stamp.path},
+		{"inode", stamp.inode},
+		{"mtime", stamp.mtime},
+		{"size", stamp.size},
+		{"version", version.version},
+		{"version_full", version.version_full},
+	});
+	if (entries.size() > max_cache_entries) {
+		entries.resize(max_cache_entries);
+	}
+
+	rconfig::set_data(cache_config_path, rconfig::json(entries));
+}
+
+
+
+void smartctl_version_cache_clear()
+{
+	rconfig::unset_data(cache_config_path);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,70 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef SMARTCTL_VERSION_CACHE_H
+#define SMARTCTL_VERSION_CACHE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "hz/fs_ns.h"
+
+
+
+/// Identity of a smartctl binary file. If any of the fields change (e.g. smartmontools
+/// was upgraded, or a different binary was selected), the binary is considered different.
+struct SmartctlBinaryStamp {
+	std::string path;  ///< Absolute path with symlinks resolved
+	std::uint64_t inode = 0;  ///< Inode number (0 on systems which don't have them)
+	std::int64_t mtime = 0;  ///< Modification time, seconds since epoch
+	std::int64_t size = 0;  ///< File size in bytes
+
+	/// Compare all fields
+	bool operator==(const SmartctlBinaryStamp& other) const = default;
+};
+
+
+
+/// Result of "smartctl -V" parsing, as returned by SmartctlVersionParser::parse_version_text().
+struct SmartctlCachedVersion {
+	std::string version;  ///< A string similar to "7.2"
+	std::string version_full;  ///< A string similar to "smartctl 7.2 2020-12-30 r5155"
+};
+
+
+
+/// Get the identity of a smartctl binary. Binaries without a directory component
+/// are looked up in PATH. This only calls stat(), so it's cheap compared to executing the binary.
+/// \return std::nullopt if the binary was not found.
+[[nodiscard]] std::optional<SmartctlBinaryStamp> smartctl_get_binary_stamp(const hz::fs::path& binary);
+
+
+/// Look up the version of a binary in the cache (stored in config, so it persists across runs).
+/// \return std::nullopt if the binary is not in cache, if it has changed since it was cached,
+/// or if it's no longer executable (e.g. its permissions were removed or its interpreter is missing).
+[[nodiscard]] std::optional<SmartctlCachedVersion> smartctl_version_cache_lookup(const SmartctlBinaryStamp& stamp);
+
+
+/// Store the version of a binary in the cache, replacing any previous entry for the same path.
+void smartctl_version_cache_store(const SmartctlBinaryStamp& stamp, const SmartctlCachedVersion& version);
+
+
+/// Remove all the entries from the cache
+void smartctl_version_cache_clear();
+
+
+
+
+
+#endif
+
+/// @}
@@ -39,13 +39,13 @@ hz::ExpectedVoid<StorageDetectorError> StorageDetector::detect(std::vector<Stora
 	// Try each one and move to next if it fails.
 
 	if constexpr(BuildEnv::is_kernel_linux()) {
-		detect_status = detect_drives_linux(all_detected, ex_factory);  // linux /proc/partitions as fallback.
+		detect_status = detect_drives_linux(all_detected, ex_factory, allow_wakeup_);  // linux /proc/partitions as fallback.
 
 	} else if constexpr(BuildEnv::is_kernel_family_windows()) {
-		detect_status = detect_drives_win32(all_detected, ex_factory);  // win32
+		detect_status = detect_drives_win32(all_detected, ex_factory, allow_wakeup_);  // win32
 
 	} else {  // freebsd, etc.
-		detect_status = detect_drives_other(all_detected, ex_factory);  // bsd, etc. . scans /dev.
+		detect_status = detect_drives_other(all_detected, ex_factory, allow_wakeup_);  // bsd, etc. . scans /dev.
 	}
 
 	if (all_detected.empty()) {
@@ -109,8 +109,14 @@ hz::ExpectedVoid<StorageDetectorError> StorageDetector::fetch_basic_data(std::ve
 		// no need for gui-based executors here, we already show the message in
 		// iconview background (if called from main window)
 		hz::ExpectedVoid<StorageDeviceError> fetch_status;
-		if (drive->get_basic_output().empty()) {  // if not fetched during detection
-			fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+		// If not fetched during detection. Drives found in standby mode there are not tried again.
+		if (drive->get_basic_output().empty() && !drive->get_is_in_standby()) {
+			fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup_);
+		}
+
+		// Drives in standby mode are not errors, they just don't have any data yet.
+		if (!fetch_status && fetch_status.error().data() == StorageDeviceError::InStandby) {
+			continue;
 		}
 
 		// normally we skip drives with errors - possibly scsi, etc.
@@ -65,6 +65,15 @@ class StorageDetector {
 // 		}
 
 
+		/// Set whether the drives in standby or sleep mode are woken up by detection and by
+		/// fetch_basic_data(). By default they are not; such drives are added without data, and
+		/// StorageDevice::get_is_in_standby() returns true for them.
+		void set_allow_wakeup(bool allow_wakeup)
+		{
+			allow_wakeup_ = allow_wakeup;
+		}
+
+
 		/// Add device patterns to drive detection blacklist
 		void add_blacklist_patterns(const std::vector<std::string>& patterns)
 		{
@@ -90,6 +99,7 @@ class StorageDetector {
 
 // 		std::vector<std::string> match_patterns_;  ///< First each file is matched against these
 		std::vector<std::string> blacklist_patterns_;  ///< If a device matches these, it's ignored.
+		bool allow_wakeup_ = false;  ///< Wake up the drives in low-power modes
 
 		std::vector<std::string> fetch_data_errors_;  ///< Errors that have occurred
 		std::vector<std::string> fetch_data_error_outputs_;  ///< Corresponding command outputs to fetch_data_errors_
@@ -155,11 +155,21 @@ inline hz::ExpectedVoid<StorageDetectorError> tw_cli_get_controllers(
 
 
 
+/// Check whether fetching the basic data of a drive during detection found it.
+/// Drives in standby mode are there, they're just not woken up if \c allow_wakeup is false.
+inline bool storage_detector_drive_found(const hz::ExpectedVoid<StorageDeviceError>& fetch_status)
+{
+	return fetch_status || fetch_status.error().data() == StorageDeviceError::InStandby;
+}
+
+
+
 /// Get number of ports by sequentially running smartctl on each port, until
 /// one of the gives an error. \c type contains a printf-formatted string with %d.
 /// \return an error message on error.
 inline hz::ExpectedVoid<StorageDetectorError> smartctl_scan_drives_sequentially(const std::string& dev, const std::string& type,
-	  int from, int to, std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, std::string& last_output)
+	  int from, int to, std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, std::string& last_output,
+	  bool allow_wakeup)
 {
 	std::shared_ptr<CommandExecutor> smartctl_ex = ex_factory->create_executor(CommandExecutorFactory::ExecutorType::Smartctl);
 
@@ -173,7 +183,7 @@ inline hz::ExpectedVoid<StorageDetectorError> smartctl_scan_drives_sequentially(
 		// "Read Device Identity failed: Input/output error"
 		// or
 		// "Read Device Identity failed: empty IDENTIFY data"
-		auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+		auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 		last_output = drive->get_basic_output();
 
 		// If we've reached smartctl port limit (older versions may have smaller limits), abort.
@@ -188,7 +198,7 @@ inline hz::ExpectedVoid<StorageDetectorError> smartctl_scan_drives_sequentially(
 			break;
 		}
 
-		if (!fetch_status) {
+		if (!storage_detector_drive_found(fetch_status)) {
 			debug_out_info("app", "Smartctl returned with an error: " << fetch_status.error().message() << "\n");
 			debug_out_dump("app", "Skipping drive " << drive->get_device_with_type() << " due to smartctl error.\n");
 		} else {
@@ -379,7 +379,7 @@ major minor  #blocks  name
 254 9 2007032 mmcblk1p1
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_proc_partitions(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives through partitions file (/proc/partitions by default; set \"system/linux_proc_partitions_path\" config key to override).\n");
 
@@ -460,8 +460,8 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_proc_partition
 
 	for (const auto& device : devices) {
 		auto drive = std::make_shared<StorageDevice>(device);
-		auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
-		if (!fetch_status) {
+		auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
+		if (!storage_detector_drive_found(fetch_status)) {
 			continue;
 		}
 
@@ -509,7 +509,7 @@ We can't handle a situation with mixed twa/twe/twl systems, since we don't know
 how they will be ordered for tw_cli.
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_3ware(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind 3ware controller(s)...\n");
 
@@ -608,7 +608,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_3ware(
 			debug_out_dump("app", "Starting brute-force port scan on 0-" << max_ports << " ports, device \"" << dev
 					<< "\". Change the maximum by setting \"system/linux_3ware_max_scan_port\" config key.\n");
 			std::string last_output;
-			exec_status = smartctl_scan_drives_sequentially(dev, "3ware,%d", 0, max_ports, drives, ex_factory, last_output);
+			exec_status = smartctl_scan_drives_sequentially(dev, "3ware,%d", 0, max_ports, drives, ex_factory, last_output, allow_wakeup);
 			debug_out_dump("app", "Brute-force port scan finished.\n");
 		}
 
@@ -644,7 +644,7 @@ Try "-d sat" by default. If it fails ("Device Read Identity Failed:" ? not
 sure how to detect the failure), fall back to "-d scsi".
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_adaptec(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind Adaptec controller(s)...\n");
 
@@ -716,7 +716,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_adaptec(
 			const std::string dev = std::string("/dev/sg") + hz::number_to_string_nolocale(sg_num);
 			auto drive = std::make_shared<StorageDevice>(dev, std::string("sat"));
 
-			auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+			auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 			const std::string output = drive->get_basic_output();
 
 			// Note: Not sure about this, have to check with real SAS drives
@@ -725,10 +725,10 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_adaptec(
 				drive->clear_parse_results();
 				drive->clear_outputs();
 				drive->set_type_argument("");
-				fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+				fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 			}
 
-			if (!fetch_status) {
+			if (!storage_detector_drive_found(fetch_status)) {
 				debug_out_info("app", "Smartctl returned with an error: " << fetch_status.error().message() << "\n");
 				debug_out_dump("app", "Skipping drive " << drive->get_device_with_type() << ".\n");
 			} else {
@@ -776,7 +776,7 @@ Notification: If /sys/bus/scsi/devices/hostN/scsi_host/hostN/host_fw_version
 	(maybe its better to grep the smartctl output for that on port 0?). NOT IMPLEMENTED YET.
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_areca(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind Areca controller(s)...\n");
 
@@ -857,7 +857,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_areca(
 						<< "\". Change the maximums by setting \"system/linux_areca_enc_max_scan_port\" and \"system/linux_areca_enc_max_enclosure\" config keys.\n");
 				std::string last_output;
 				for (int enclosure_no = 1; enclosure_no < max_enclosures; ++enclosure_no) {
-					exec_status = smartctl_scan_drives_sequentially(dev, "areca,%d/" + hz::number_to_string_nolocale(enclosure_no), 1, max_ports, drives, ex_factory, last_output);
+					exec_status = smartctl_scan_drives_sequentially(dev, "areca,%d/" + hz::number_to_string_nolocale(enclosure_no), 1, max_ports, drives, ex_factory, last_output, allow_wakeup);
 				}
 				debug_out_dump("app", "Brute-force port/enclosure scan finished.\n");
 
@@ -884,7 +884,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_areca(
 				debug_out_dump("app", "Starting brute-force port scan on 1-" << max_ports << " ports, device \"" << dev
 						<< "\". Change the maximum by setting \"system/linux_areca_noenc_max_scan_port\" config key.\n");
 				std::string last_output;
-				exec_status = smartctl_scan_drives_sequentially(dev, "areca,%d", 1, max_ports, drives, ex_factory, last_output);
+				exec_status = smartctl_scan_drives_sequentially(dev, "areca,%d", 1, max_ports, drives, ex_factory, last_output, allow_wakeup);
 				debug_out_dump("app", "Brute-force port scan finished.\n");
 			}
 
@@ -930,7 +930,7 @@ Detection:
 		so scan them until 15, just in case.
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_cciss(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind HP RAID (CCISS) controller(s)...\n");
 
@@ -966,7 +966,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_cciss(
 		for (int port = 0; port <= max_port; ++port) {
 			auto drive = std::make_shared<StorageDevice>(dev, std::string("cciss,") + hz::number_to_string_nolocale(port));
 
-			auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+			auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 			std::string output = drive->get_basic_output();
 
 			if (!fetch_status) {
@@ -984,7 +984,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_cciss(
 				break;
 			}
 
-			if (fetch_status) {
+			if (storage_detector_drive_found(fetch_status)) {
 				drives.push_back(drive);
 				debug_out_info("app", "Added drive " << drive->get_device_with_type() << ".\n");
 			} else {
@@ -1019,7 +1019,7 @@ Detection:
 		until "No such device or address" or "VALID ARGUMENTS ARE" is encountered in output.
 </pre> */
 inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_hpsa(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind HP RAID (hpsa/hpahcisr) controller(s)...\n");
 
@@ -1073,7 +1073,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_hpsa(
 			for (int port = 0; port <= max_port; ++port) {
 				auto drive = std::make_shared<StorageDevice>(dev, std::string("cciss,") + hz::number_to_string_nolocale(port));
 
-				auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+				auto fetch_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 				std::string output = drive->get_basic_output();
 
 				if (app_regex_partial_match("/No such device or address/mi", output)
@@ -1082,7 +1082,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_hpsa(
 					debug_out_dump("app", "Reached controller or smartctl port limit with port " << port << ", stopping port scan.\n");
 					break;
 				}
-				if (!fetch_status) {
+				if (!storage_detector_drive_found(fetch_status)) {
 					debug_out_info("app", "Smartctl returned with an error: " << fetch_status.error().message() << "\n");
 					debug_out_dump("app", "Skipping drive " << drive->get_device_with_type() << " due to smartctl error.\n");
 				} else {
@@ -1110,7 +1110,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_linux_hpsa(
 
 
 hz::ExpectedVoid<StorageDetectorError> detect_drives_linux(
-		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+		std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	clear_read_file_cache();
 
@@ -1123,32 +1123,32 @@ hz::ExpectedVoid<StorageDetectorError> detect_drives_linux(
 	// sda and sdb). Plus, there are no "*-partN" files (not that we need them).
 // 	error_message = detect_drives_linux_udev_byid(devices);  // linux udev
 
-	status = detect_drives_linux_proc_partitions(drives, ex_factory);
+	status = detect_drives_linux_proc_partitions(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
 
-	status = detect_drives_linux_3ware(drives, ex_factory);
+	status = detect_drives_linux_3ware(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
 
-	status = detect_drives_linux_areca(drives, ex_factory);
+	status = detect_drives_linux_areca(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
 
-	status = detect_drives_linux_adaptec(drives, ex_factory);
+	status = detect_drives_linux_adaptec(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
 
-	status = detect_drives_linux_cciss(drives, ex_factory);
+	status = detect_drives_linux_cciss(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
 
-	status = detect_drives_linux_hpsa(drives, ex_factory);
+	status = detect_drives_linux_hpsa(drives, ex_factory, allow_wakeup);
 	if (!status) {
 		error_msgs.push_back(status.error().message());
 	}
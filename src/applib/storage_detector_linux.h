@@ -24,9 +24,9 @@ Copyright:
 
 
 
-/// Detect drives in Linux
+/// Detect drives in Linux. If \c allow_wakeup is false, the drives in standby mode are added without waking them up.
 [[nodiscard]] hz::ExpectedVoid<StorageDetectorError> detect_drives_linux(std::vector<StorageDevicePtr>& drives,
-		const CommandExecutorFactoryPtr& ex_factory);
+		const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup);
 
 
 
@@ -30,7 +30,7 @@ Copyright:
 
 
 hz::ExpectedVoid<StorageDetectorError> detect_drives_other(std::vector<StorageDevicePtr>& drives,
-		[[maybe_unused]] const CommandExecutorFactoryPtr& ex_factory)
+		[[maybe_unused]] const CommandExecutorFactoryPtr& ex_factory, [[maybe_unused]] bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives through /dev...\n");
 
@@ -23,8 +23,9 @@ Copyright:
 
 
 /// Detect drives in FreeBSD, Solaris, etc. (all except Linux and Windows).
+/// The drives are not accessed here, so \c allow_wakeup is unused.
 [[nodiscard]] hz::ExpectedVoid<StorageDetectorError> detect_drives_other(std::vector<StorageDevicePtr>& drives,
-		const CommandExecutorFactoryPtr& ex_factory);
+		const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup);
 
 
 
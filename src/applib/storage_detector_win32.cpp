@@ -516,7 +516,8 @@ If CLI is not installed, do the brute-force way:
 		-d areca,[1-128]/[1-8] /dev/arcmsrN
 			It's 2-3 drives a second on an empty port, so some limits are set in config.
 </pre> */
-inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vector<StorageDevicePtr>& drives, const CommandExecutorFactoryPtr& ex_factory)
+inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vector<StorageDevicePtr>& drives,
+		const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Detecting drives behind Areca controller(s)...\n");
 
@@ -594,7 +595,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vec
 		debug_out_dump("app", "Testing Areca controller presence using smartctl...\n");
 
 		auto drive = std::make_shared<StorageDevice>("/dev/arcmsr0", "areca,1");
-		[[maybe_unused]] auto drive_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+		[[maybe_unused]] auto drive_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 		const std::string output = drive->get_basic_output();
 		if (app_regex_partial_match("/No Areca controller found/mi", output)
 				|| app_regex_partial_match("/Smartctl open device: .* failed: No such device/mi", output) ) {
@@ -642,7 +643,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vec
 
 			const std::size_t old_drive_count = drives.size();
 			std::string last_output;
-			auto scan_status = smartctl_scan_drives_sequentially(dev, "areca,%d", 1, max_noenc_ports, drives, ex_factory, last_output);
+			auto scan_status = smartctl_scan_drives_sequentially(dev, "areca,%d", 1, max_noenc_ports, drives, ex_factory, last_output, allow_wakeup);
 			// If the scan stopped because of no controller, stop it all.
 			if (!scan_status && (app_regex_partial_match("/No Areca controller found/mi", last_output)
 					|| app_regex_partial_match("/Smartctl open device: .* failed: No such device/mi", last_output)) ) {
@@ -657,7 +658,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vec
 					debug_out_dump("app", "Starting brute-force port scan (enclosure #" << enclosure_no << ") on 1-" << max_enc_ports << " ports, device \"" << dev
 							<< "\". Change the maximums by setting \"system/win32_areca_onc_max_scan_port\" and \"system/win32_areca_enc_max_enclosure\" config keys.\n");
 					// FIXME Not sure whether we should ignore this error message
-					[[maybe_unused]] auto encl_status = smartctl_scan_drives_sequentially(dev, "areca,%d/" + hz::number_to_string_nolocale(enclosure_no), 1, max_enc_ports, drives, ex_factory, last_output);
+					[[maybe_unused]] auto encl_status = smartctl_scan_drives_sequentially(dev, "areca,%d/" + hz::number_to_string_nolocale(enclosure_no), 1, max_enc_ports, drives, ex_factory, last_output, allow_wakeup);
 				}
 			}
 
@@ -682,7 +683,7 @@ inline hz::ExpectedVoid<StorageDetectorError> detect_drives_win32_areca(std::vec
 // "\\.\PhysicalDriveN" (winnt only).
 // http://msdn.microsoft.com/en-us/library/aa365247(VS.85).aspx
 hz::ExpectedVoid<StorageDetectorError> detect_drives_win32(std::vector<StorageDevicePtr>& drives,
-		const CommandExecutorFactoryPtr& ex_factory)
+		const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup)
 {
 	std::vector<std::string> error_msgs;
 
@@ -708,7 +709,7 @@ hz::ExpectedVoid<StorageDetectorError> detect_drives_win32(std::vector<StorageDe
 	// Find out their serial numbers and whether there are Arecas there.
 	std::map<std::string, StorageDevicePtr> serials;
 	for (auto& drive : drives) {
-		const auto local_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+		const auto local_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 		if (!local_status) {
 			debug_out_info("app", "Smartctl returned with an error: " << local_status.error().message() << "\n");
 			// Don't exit, just report it.
@@ -779,7 +780,7 @@ hz::ExpectedVoid<StorageDetectorError> detect_drives_win32(std::vector<StorageDe
 		debug_out_dump("app", "Drive letters for: " << drive->get_device() << ": " << drive->format_drive_letters(true) << ".\n");
 
 		// Fetch the drive data
-		auto local_status = drive->fetch_basic_data_and_parse(smartctl_ex);
+		auto local_status = drive->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);
 		if (!local_status) {
 			debug_out_info("app", "Smartctl returned with an error: " << local_status.error().message() << "\n");
 			// Don't exit, just report it.
@@ -833,7 +834,7 @@ hz::ExpectedVoid<StorageDetectorError> detect_drives_win32(std::vector<StorageDe
 
 
 	if (!areca_open_found) {
-		auto areca_status = detect_drives_win32_areca(drives, ex_factory);
+		auto areca_status = detect_drives_win32_areca(drives, ex_factory, allow_wakeup);
 		if (!areca_status) {
 			error_msgs.push_back(areca_status.error().message());
 		}
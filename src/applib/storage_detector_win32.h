@@ -22,9 +22,9 @@ Copyright:
 #include "storage_detector.h"
 
 
-/// Detect drives in Windows
+/// Detect drives in Windows. If \c allow_wakeup is false, the drives in standby mode are added without waking them up.
 [[nodiscard]] hz::ExpectedVoid<StorageDetectorError> detect_drives_win32(std::vector<StorageDevicePtr>& drives,
-		const CommandExecutorFactoryPtr& ex_factory);
+		const CommandExecutorFactoryPtr& ex_factory, bool allow_wakeup);
 
 
 
@@ -12,7 +12,9 @@ Copyright:
 #include "storage_device.h"
 
 #include <glibmm.h>
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
@@ -36,11 +38,76 @@ Copyright:
 #include "storage_property_descr.h"
 #include "build_config.h"
 #include "smartctl_parser.h"
+#include "smartctl_parse_cache.h"
+#include "smartctl_log_support_cache.h"
 //#include "smartctl_text_parser_helper.h"
 //#include "ata_storage_property_descr.h"
 
 
 
+namespace {
+
+	/// Makes smartctl exit with status 2 without accessing the device if it's in standby or sleep mode.
+	/// Exit status 2 is also used for other device open failures, so the output is checked to tell them apart.
+	constexpr const char* smartctl_nocheck_standby_option = "--nocheck=standby,2";
+
+
+	/// Get smartctl options for a tier lower than Full.
+	/// \return an empty vector if the drive type has no such tier.
+	std::vector<std::string> get_tier_command_options(StorageDeviceFetchTier tier, StorageDeviceDetectedType type)
+	{
+		const bool with_selftest_log = (tier == StorageDeviceFetchTier::Standard);
+		switch (type) {
+			case StorageDeviceDetectedType::AtaAny:
+			case StorageDeviceDetectedType::AtaHdd:
+			case StorageDeviceDetectedType::AtaSsd:
+			{
+				// Same format as in the full fetch, so that the attributes can be merged.
+				std::vector<std::string> options = {"--health", "--attributes", "--format=brief"};
+				if (with_selftest_log) {
+					options.emplace_back("--log=xselftest,50,selftest");
+				}
+				return options;
+			}
+			case StorageDeviceDetectedType::Nvme:
+			{
+				std::vector<std::string> options = {"--health", "--attributes"};
+				if (with_selftest_log) {
+					options.emplace_back("--log=selftest");
+				}
+				return options;
+			}
+			case StorageDeviceDetectedType::Unknown:
+			case StorageDeviceDetectedType::NeedsExplicitType:
+			case StorageDeviceDetectedType::BasicScsi:
+			case StorageDeviceDetectedType::CdDvd:
+			case StorageDeviceDetectedType::UnsupportedRaid:
+				break;
+		}
+		return {};
+	}
+
+
+	/// Get the sections fetched by a tier lower than Full
+	std::vector<StoragePropertySection> get_tier_sections(StorageDeviceFetchTier tier, StorageDeviceDetectedType type)
+	{
+		std::vector<StoragePropertySection> sections = {StoragePropertySection::OverallHealth};
+		if (type == StorageDeviceDetectedType::Nvme) {
+			sections.push_back(StoragePropertySection::NvmeHealth);
+			sections.push_back(StoragePropertySection::NvmeAttributes);
+		} else {
+			sections.push_back(StoragePropertySection::AtaAttributes);
+		}
+		if (tier == StorageDeviceFetchTier::Standard) {
+			sections.push_back(StoragePropertySection::SelftestLog);
+		}
+		return sections;
+	}
+
+}
+
+
+
 std::string StorageDevice::get_status_displayable_name(SmartStatus status)
 {
 	static const std::unordered_map<SmartStatus, std::string> m {
@@ -78,6 +145,7 @@ void StorageDevice::clear_outputs()
 {
 	basic_output_.clear();
 	full_output_.clear();
+	tier_output_.clear();
 }
 
 
@@ -88,28 +156,32 @@ void StorageDevice::clear_parse_results()
 //	test_is_active_ = false;  // not sure
 
 	property_repository_.clear();
+	property_changes_.reset();
+	previous_property_repository_.clear();
+	fetched_property_repository_.reset();
+	full_data_time_.reset();
+	section_data_times_.clear();
 
 	smart_supported_.reset();
 	smart_enabled_.reset();
 	model_name_.reset();
 	family_name_.reset();
+	firmware_version_.reset();
 	size_.reset();
 	health_property_.reset();
+
+	invalidate_derived_values();
 }
 
 
 
 hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_basic_data_and_parse(
-		const std::shared_ptr<CommandExecutor>& smartctl_ex)
+		const std::shared_ptr<CommandExecutor>& smartctl_ex, bool allow_wakeup)
 {
 	if (this->test_is_active_) {
 		return hz::Unexpected(StorageDeviceError::TestRunning, _("A test is currently being performed on this drive."));
 	}
 
-	// Clear everything fetched before, including outputs
-	this->clear_parse_results();
-	this->clear_outputs();
-
 	// We don't use "--all" - it may cause really screwed up the output (tests, etc.).
 	// This looks just like "--info" only on non-smart devices.
 	const auto default_parser_type = SmartctlVersionParser::get_default_format(SmartctlParserType::Basic);
@@ -118,8 +190,24 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_basic_data_and_parse(
 		// --json flags: o means include original output (just in case).
 		command_options.push_back("--json=o");
 	}
+	if (!allow_wakeup) {
+		command_options.emplace_back(smartctl_nocheck_standby_option);
+	}
 
-	auto execute_status = execute_device_smartctl(command_options, smartctl_ex, this->basic_output_, true);  // set type to invalid if needed
+	std::string output;
+	auto execute_status = execute_device_smartctl(command_options, smartctl_ex, output, true);  // set type to invalid if needed
+
+	// Keep the previous data, it's still the most recent one.
+	if (!execute_status && execute_status.error().data() == StorageDeviceError::InStandby) {
+		set_is_in_standby(true);
+		return execute_status;
+	}
+	set_is_in_standby(false);
+
+	// Clear everything fetched before, including outputs
+	this->clear_parse_results();
+	this->clear_outputs();
+	this->basic_output_ = std::move(output);
 
 	// Smartctl 5.39 cvs/svn version defaults to usb type on at least linux and windows.
 	// This means that the old SCSI identify command isn't executed by default,
@@ -133,7 +221,7 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_basic_data_and_parse(
 		debug_out_info("app", "The device seems to be of different type than auto-detected, trying again with scsi.\n");
 		this->set_type_argument("scsi");
 		this->set_detected_type(StorageDeviceDetectedType::BasicScsi);
-		return this->fetch_basic_data_and_parse(smartctl_ex);  // try again with scsi
+		return this->fetch_basic_data_and_parse(smartctl_ex, allow_wakeup);  // try again with scsi
 	}
 
 	// Since the type error leads to "command line didn't parse" error here,
@@ -166,11 +254,8 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_basic_data()
 	}
 
 	// Parse using Basic parser. This supports all drive types.
-	auto basic_parser = SmartctlParser::create(SmartctlParserType::Basic, output_format);
-	DBG_ASSERT_RETURN(basic_parser, hz::Unexpected(StorageDeviceError::ParseError, _("Cannot create parser")));
-
 	// This also fills the drive type properties.
-	auto parse_status = basic_parser->parse(this->get_basic_output());
+	auto parse_status = SmartctlParseCache::parse(SmartctlParserType::Basic, output_format, this->get_basic_output());
 	if (!parse_status) {
 		std::string message = parse_status.error().message();
 		return hz::Unexpected(StorageDeviceError::ParseError,
@@ -179,13 +264,13 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_basic_data()
 
 	// See if we can narrow down the drive type from what was detected
 	// by StorageDetector and properties set by Basic parser.
-	auto basic_property_repo = basic_parser->get_property_repository();
+	const auto& basic_property_repo = parse_status.value();
 
 	// Make detected type more exact.
-	detect_drive_type_from_properties(basic_property_repo);
+	detect_drive_type_from_properties(*basic_property_repo);
 
 	// Add property descriptions and set to the drive.
-	this->set_property_repository(StoragePropertyProcessor::process_properties(basic_property_repo, get_detected_type()));
+	this->process_and_set_property_repository(basic_property_repo);
 
 	debug_out_dump("app", "Drive " << get_device_with_type() << " set to be "
 			<< StorageDeviceDetectedTypeExt::get_displayable_name(get_detected_type()) << " device.\n");
@@ -216,7 +301,7 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_basic_data()
 
 
 hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_full_data_and_parse(
-		const std::shared_ptr<CommandExecutor>& smartctl_ex)
+		const std::shared_ptr<CommandExecutor>& smartctl_ex, bool allow_wakeup)
 {
 	if (this->test_is_active_) {
 		return hz::Unexpected(StorageDeviceError::TestRunning, _("A test is currently being performed on this drive."));
@@ -225,10 +310,6 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_full_data_and_parse(
 	// Drive type must be already set at this point, using fetch_basic_data_and_parse().
 	DBG_ASSERT(this->get_detected_type() != StorageDeviceDetectedType::Unknown);
 
-	// Clear everything fetched before, including outputs
-	this->clear_parse_results();
-	this->clear_outputs();
-
 	// Execute smartctl.
 
 	// Instead of -x, we use all the individual options -x encompasses, so that
@@ -275,16 +356,45 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_full_data_and_parse(
 			break;
 	}
 
+	// Leave out the logs which this drive model didn't support when they were last requested.
+	// If they are not known, all the logs are requested and the result is cached after parsing.
+	const bool is_ata = (this->get_detected_type() == StorageDeviceDetectedType::AtaAny
+			|| this->get_detected_type() == StorageDeviceDetectedType::AtaHdd
+			|| this->get_detected_type() == StorageDeviceDetectedType::AtaSsd);
+	std::optional<std::vector<std::string>> unsupported_logs;
+	if (is_ata) {
+		unsupported_logs = smartctl_log_support_cache_lookup(get_model_name(), get_firmware_version(), std::chrono::system_clock::now());
+	}
+	if (unsupported_logs.has_value()) {
+		command_options.erase(std::remove_if(command_options.begin(), command_options.end(), [&unsupported_logs](const std::string& option) {
+			return std::find(unsupported_logs->begin(), unsupported_logs->end(), option) != unsupported_logs->end();
+		}), command_options.end());
+	}
+
 	auto parser_type = SmartctlVersionParser::get_default_parser_type(this->get_detected_type());
 	auto parser_format = SmartctlVersionParser::get_default_format(parser_type);
 	if (parser_format == SmartctlOutputFormat::Json) {
 		// --json flags: o means include original output (just in case).
 		command_options.push_back("--json=o");
 	}
+	if (!allow_wakeup) {
+		command_options.emplace_back(smartctl_nocheck_standby_option);
+	}
 
 	std::string output;
 	auto execute_status = execute_device_smartctl(command_options, smartctl_ex, output);
 
+	// Keep the previous data, it's still the most recent one.
+	if (!execute_status && execute_status.error().data() == StorageDeviceError::InStandby) {
+		set_is_in_standby(true);
+		return execute_status;
+	}
+	set_is_in_standby(false);
+
+	// Clear the outputs fetched before. The old properties are cleared (and compared
+	// to the new ones) by parse_full_data().
+	this->clear_outputs();
+
 //	if (this->get_type_argument() == "scsi") {  // not sure about correctness... FIXME probably fails with RAID/scsi
 //		const auto default_parser_type = SmartctlVersionParser::get_default_format(SmartctlParserType::Basic);
 //		// This doesn't do much yet, but just in case...
@@ -320,36 +430,134 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_full_data_and_parse(
 	// we do this after the scsi stuff.
 
 
-	if (!execute_status)
+	if (!execute_status) {
+		this->clear_parse_results();
 		return execute_status;
+	}
 
 	this->full_output_ = output;
-	return this->parse_full_data(parser_type, parser_format);
+	this->tier_output_.clear();
+	auto parse_status = this->parse_full_data(parser_type, parser_format);
+	if (parse_status) {
+		full_data_time_ = std::chrono::system_clock::now();
+		for (const auto& p : property_repository_.get_properties()) {
+			section_data_times_[p.section] = full_data_time_.value();
+		}
+		if (is_ata && !unsupported_logs.has_value()) {
+			smartctl_log_support_cache_store(get_model_name(), get_firmware_version(),
+					smartctl_log_support_find_unsupported(command_options, property_repository_, output), full_data_time_.value());
+		}
+	}
+	return parse_status;
+}
+
+
+
+hz::ExpectedVoid<StorageDeviceError> StorageDevice::fetch_data_and_parse(StorageDeviceFetchTier tier,
+		const std::shared_ptr<CommandExecutor>& smartctl_ex, bool allow_wakeup)
+{
+	std::vector<std::string> command_options;
+	if (tier != StorageDeviceFetchTier::Full && parse_status_ == ParseStatus::Full && !is_virtual_) {
+		command_options = get_tier_command_options(tier, get_detected_type());
+	}
+	// Nothing to merge into, or no such tier for this drive type
+	if (command_options.empty()) {
+		return fetch_full_data_and_parse(smartctl_ex, allow_wakeup);
+	}
+
+	if (this->test_is_active_) {
+		return hz::Unexpected(StorageDeviceError::TestRunning, _("A test is currently being performed on this drive."));
+	}
+
+	const auto parser_type = SmartctlVersionParser::get_default_parser_type(this->get_detected_type());
+	const auto parser_format = SmartctlVersionParser::get_default_format(parser_type);
+	if (parser_format == SmartctlOutputFormat::Json) {
+		// --json flags: o means include original output (just in case).
+		command_options.push_back("--json=o");
+	}
+	if (!allow_wakeup) {
+		command_options.emplace_back(smartctl_nocheck_standby_option);
+	}
+
+	std::string output;
+	auto execute_status = execute_device_smartctl(command_options, smartctl_ex, output);
+
+	// Keep the previous data, it's still the most recent one.
+	if (!execute_status && execute_status.error().data() == StorageDeviceError::InStandby) {
+		set_is_in_standby(true);
+		return execute_status;
+	}
+	set_is_in_standby(false);
+
+	// The previous data is kept on errors as well. The full output is not touched,
+	// the merged output is kept separately (see get_tier_output()).
+	if (!execute_status) {
+		return execute_status;
+	}
+
+	const auto parse_status = SmartctlParseCache::parse(parser_type, parser_format, output);
+	if (!parse_status) {
+		std::string message = parse_status.error().message();
+		return hz::Unexpected(StorageDeviceError::ParseError,
+				fmt::format(fmt::runtime(_("Cannot parse smartctl output: {}")), message));
+	}
+
+	const auto sections = get_tier_sections(tier, get_detected_type());
+	merge_tier_properties(sections, *SmartctlParseCache::process(parse_status.value(), get_detected_type()));
+	tier_output_ = std::move(output);
+
+	health_property_.reset();
+	read_common_properties();
+
+	const auto now = std::chrono::system_clock::now();
+	for (const auto section : sections) {
+		if (property_repository_.has_properties_for_section(section)) {
+			section_data_times_[section] = now;
+		} else {
+			section_data_times_.erase(section);
+		}
+	}
+
+	signal_changed().emit(this);  // notify listeners
+
+	return {};
 }
 
 
 
 hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_full_data(SmartctlParserType parser_type, SmartctlOutputFormat format)
 {
+	// Keep the old properties to find out what changed
+	StoragePropertyRepository old_property_repository;
+	if (parse_status_ == ParseStatus::Full) {
+		old_property_repository = std::move(property_repository_);
+	}
+
 	// Clear everything fetched before, except outputs and disk type
 	clear_parse_results();
 
-	auto parser = SmartctlParser::create(parser_type, format);
-	DBG_ASSERT_RETURN(parser, hz::Unexpected(StorageDeviceError::ParseError, _("Cannot create parser")));
-
-	const auto parse_status = parser->parse(this->full_output_);
+	const auto parse_status = SmartctlParseCache::parse(parser_type, format, this->full_output_);
 	if (parse_status.has_value()) {
 		set_parse_status(parser_type == SmartctlParserType::Basic ? ParseStatus::Basic : ParseStatus::Full);
 
 		// Detect drive type based on parsed properties
-		detect_drive_type_from_properties(parser->get_property_repository());
+		detect_drive_type_from_properties(*parse_status.value());
 
 		// Set the full properties, overwriting old data.
-		set_property_repository(StoragePropertyProcessor::process_properties(parser->get_property_repository(), get_detected_type()));
+		process_and_set_property_repository(parse_status.value());
 
 		// Read common properties from the repository.
 		read_common_properties();
 
+		if (parser_type != SmartctlParserType::Basic && !is_virtual_) {
+			update_attribute_trends(property_repository_);
+		}
+
+		// The changes are computed on demand, see get_property_changes().
+		if (parser_type != SmartctlParserType::Basic) {
+			previous_property_repository_ = std::move(old_property_repository);
+		}
+
 		signal_changed().emit(this);  // notify listeners
 
 		return {};
@@ -372,26 +580,21 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_any_data_for_virtual()
 		return hz::Unexpected(StorageDeviceError::ParseError, parser_format.error().message());
 	}
 
-	auto basic_parser = SmartctlParser::create(SmartctlParserType::Basic, parser_format.value());
-	if (!basic_parser) {
-		return hz::Unexpected(StorageDeviceError::ParseError, _("Cannot create parser"));
-	}
-
 	// This will add some properties and emit signal_changed().
-	auto basic_parse_status = basic_parser->parse(this->full_output_);
+	auto basic_parse_status = SmartctlParseCache::parse(SmartctlParserType::Basic, parser_format.value(), this->full_output_);
 	if (!basic_parse_status) {
 		std::string message = basic_parse_status.error().message();
 		return hz::Unexpected(StorageDeviceError::ParseError,
 				fmt::format(fmt::runtime(_("Cannot parse smartctl output: {}")), message));
 	}
 
-	auto basic_property_repo = basic_parser->get_property_repository();
+	const auto& basic_property_repo = basic_parse_status.value();
 
 	// Make detected type more exact.
-	detect_drive_type_from_properties(basic_property_repo);
+	detect_drive_type_from_properties(*basic_property_repo);
 
 	// Set properties from the basic parser.
-	set_property_repository(StoragePropertyProcessor::process_properties(basic_property_repo, get_detected_type()));
+	process_and_set_property_repository(basic_property_repo);
 
 	// Read common properties from the repository.
 	read_common_properties();
@@ -402,24 +605,21 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::parse_any_data_for_virtual()
 
 	if (parser_type != SmartctlParserType::Basic) {
 		// Try specialized parser
-		auto parser = SmartctlParser::create(parser_type, parser_format.value());
-		DBG_ASSERT_RETURN(parser, hz::Unexpected(StorageDeviceError::ParseError, _("Cannot create parser.")));
-
-		const auto parse_status = parser->parse(this->full_output_);
+		const auto parse_status = SmartctlParseCache::parse(parser_type, parser_format.value(), this->full_output_);
 		if (parse_status.has_value()) {
 			// Call this after parse_basic_data(), since it sets parse status to "info".
 			set_parse_status(StorageDevice::ParseStatus::Full);
 
 			// set the full properties.
 			// copy to our drive, overwriting old data.
-			set_property_repository(StoragePropertyProcessor::process_properties(parser->get_property_repository(), get_detected_type()));
+			process_and_set_property_repository(parse_status.value());
 		}
 	}
 
 	if (get_parse_status() != ParseStatus::Full) {
 		// Only basic data available
 		set_parse_status(ParseStatus::Basic);
-		set_property_repository(StoragePropertyProcessor::process_properties(basic_parser->get_property_repository(), get_detected_type()));
+		process_and_set_property_repository(basic_property_repo);
 	}
 
 	signal_changed().emit(this);  // notify listeners
@@ -491,29 +691,32 @@ A mandatory SMART command failed: exiting. To continue, add one or more '-T perm
 
 void StorageDevice::read_common_properties()
 {
-	if (auto prop = property_repository_.lookup_property("smart_support/available"); !prop.empty()) {
-		smart_supported_ = prop.get_value<bool>();
+	if (const auto* prop = property_repository_.find_property("smart_support/available")) {
+		smart_supported_ = prop->get_value<bool>();
+	}
+	if (const auto* prop = property_repository_.find_property("smart_support/enabled")) {
+		smart_enabled_ = prop->get_value<bool>();
 	}
-	if (auto prop = property_repository_.lookup_property("smart_support/enabled"); !prop.empty()) {
-		smart_enabled_ = prop.get_value<bool>();
+	if (const auto* prop = property_repository_.find_property("model_name")) {
+		model_name_ = prop->get_value<std::string>();
+	} else if (prop = property_repository_.find_property("scsi_model_name"); prop) {  // USB flash
+		model_name_ = prop->get_value<std::string>();
 	}
-	if (auto prop = property_repository_.lookup_property("model_name"); !prop.empty()) {
-		model_name_ = prop.get_value<std::string>();
-	} else if (prop = property_repository_.lookup_property("scsi_model_name"); !prop.empty()) {  // USB flash
-		model_name_ = prop.get_value<std::string>();
+	if (const auto* prop = property_repository_.find_property("model_family")) {
+		family_name_ = prop->get_value<std::string>();
+	} else if (prop = property_repository_.find_property("scsi_vendor"); prop) {  // USB flash
+		family_name_ = prop->get_value<std::string>();
 	}
-	if (auto prop = property_repository_.lookup_property("model_family"); !prop.empty()) {
-		family_name_ = prop.get_value<std::string>();
-	} else if (prop = property_repository_.lookup_property("scsi_vendor"); !prop.empty()) {  // USB flash
-		family_name_ = prop.get_value<std::string>();
+	if (const auto* prop = property_repository_.find_property("serial_number")) {
+		serial_number_ = prop->get_value<std::string>();
 	}
-	if (auto prop = property_repository_.lookup_property("serial_number"); !prop.empty()) {
-		serial_number_ = prop.get_value<std::string>();
+	if (const auto* prop = property_repository_.find_property("firmware_version")) {
+		firmware_version_ = prop->get_value<std::string>();
 	}
-	if (auto prop = property_repository_.lookup_property("user_capacity/bytes/_short"); !prop.empty()) {
-		size_ = prop.readable_value;
-	} else if (auto prop2 = property_repository_.lookup_property("user_capacity/bytes"); !prop.empty()) {
-		size_ = prop2.readable_value;
+	if (const auto* prop = property_repository_.find_property("user_capacity/bytes/_short")) {
+		size_ = prop->readable_value;
+	} else if (prop = property_repository_.find_property("user_capacity/bytes"); prop) {
+		size_ = prop->readable_value;
 	}
 }
 
@@ -631,9 +834,10 @@ bool StorageDevice::get_smart_switch_supported() const
 
 
 
-std::string StorageDevice::get_device_size_str() const
+const std::string& StorageDevice::get_device_size_str() const
 {
-	return (size_.has_value() ? size_.value() : "");
+	static const std::string empty_size;
+	return (size_.has_value() ? size_.value() : empty_size);
 }
 
 
@@ -660,32 +864,55 @@ std::string StorageDevice::get_device() const
 
 
 
-std::string StorageDevice::get_device_base() const
+const std::string& StorageDevice::get_device_base() const
 {
-	if (is_virtual_)
-		return "";
+	if (derived_values_.device_base.has_value())  // cached return value
+		return derived_values_.device_base.value();
 
-	const std::string::size_type pos = device_.rfind('/');  // find basename
-	if (pos == std::string::npos)
-		return device_;  // fall back
-	return device_.substr(pos+1, std::string::npos);
+	std::string base;
+	if (!is_virtual_) {
+		const std::string::size_type pos = device_.rfind('/');  // find basename
+		base = (pos == std::string::npos ? device_ : device_.substr(pos+1, std::string::npos));
+	}
+	return derived_values_.device_base.emplace(std::move(base));
 }
 
 
 
-std::string StorageDevice::get_device_with_type() const
+const std::string& StorageDevice::get_device_with_type() const
 {
+	if (derived_values_.device_with_type.has_value())  // cached return value
+		return derived_values_.device_with_type.value();
+
 	if (this->get_is_virtual()) {
 		const std::string vf = this->get_virtual_filename();
 		/// Translators: %1 is filename
 		std::string ret = Glib::ustring::compose(C_("filename", "Virtual (%1)"), (vf.empty() ? (std::string("[") + C_("filename", "empty") + "]") : vf));
-		return ret;
+		return derived_values_.device_with_type.emplace(std::move(ret));
 	}
 	std::string device = get_device();
-	if (!get_type_argument().empty()) {
-		device = Glib::ustring::compose(_("%1 (%2)"), device, get_type_argument());
+	if (!type_arg_.empty()) {
+		device = Glib::ustring::compose(_("%1 (%2)"), device, type_arg_);
+	}
+	return derived_values_.device_with_type.emplace(std::move(device));
+}
+
+
+
+const std::string& StorageDevice::get_sort_key() const
+{
+	if (derived_values_.sort_key.has_value())  // cached return value
+		return derived_values_.sort_key.value();
+
+	// The first byte puts real drives before virtual ones
+	std::string key(1, (is_virtual_ ? '\x01' : '\x00'));
+	if (is_virtual_) {
+		key += hz::string_natural_sort_key(get_virtual_filename());
+	} else {
+		key += hz::string_natural_sort_key(get_device_base());
+		key += hz::string_natural_sort_key(type_arg_);
 	}
-	return device;
+	return derived_values_.sort_key.emplace(std::move(key));
 }
 
 
@@ -707,6 +934,7 @@ StorageDeviceDetectedType StorageDevice::get_detected_type() const
 void StorageDevice::set_type_argument(std::string arg)
 {
 	type_arg_ = std::move(arg);
+	invalidate_derived_values();
 }
 
 
@@ -735,6 +963,7 @@ std::vector<std::string> StorageDevice::get_extra_arguments() const
 void StorageDevice::set_drive_letters(std::map<char, std::string> letters)
 {
 	drive_letters_ = std::move(letters);
+	invalidate_derived_values();
 }
 
 
@@ -746,8 +975,12 @@ const std::map<char, std::string>& StorageDevice::get_drive_letters() const
 
 
 
-std::string StorageDevice::format_drive_letters(bool with_volnames) const
+const std::string& StorageDevice::format_drive_letters(bool with_volnames) const
 {
+	std::optional<std::string>& cached = (with_volnames ? derived_values_.drive_letters_with_volnames : derived_values_.drive_letters);
+	if (cached.has_value())  // cached return value
+		return cached.value();
+
 	std::vector<std::string> drive_letters_decorated;
 	for (const auto& iter : drive_letters_) {
 		drive_letters_decorated.push_back(std::string() + (char)std::toupper(iter.first) + ":");
@@ -756,7 +989,7 @@ std::string StorageDevice::format_drive_letters(bool with_volnames) const
 			drive_letters_decorated.back() = Glib::ustring::compose(_("%1 (%2)"), drive_letters_decorated.back(), iter.second);
 		}
 	}
-	return hz::string_join(drive_letters_decorated, ", ");
+	return cached.emplace(hz::string_join(drive_letters_decorated, ", "));
 }
 
 
@@ -789,6 +1022,47 @@ const StoragePropertyRepository& StorageDevice::get_property_repository() const
 
 
 
+const StoragePropertyRepository& StorageDevice::get_fetched_property_repository() const
+{
+	return fetched_property_repository_.has_value() ? fetched_property_repository_.value() : property_repository_;
+}
+
+
+
+void StorageDevice::ensure_section_processed(StoragePropertySection section) const
+{
+	for (const auto* p : property_repository_.get_section_properties(section)) {
+		[[maybe_unused]] const std::string& description = p->get_description_ref();  // generates it
+	}
+}
+
+
+
+bool StorageDevice::get_section_processed(StoragePropertySection section) const
+{
+	const auto properties = property_repository_.get_section_properties(section);
+	return std::none_of(properties.begin(), properties.end(), [](const StorageProperty* p) {
+		return p->get_description_pending();
+	});
+}
+
+
+
+const StoragePropertyRepositoryDiff& StorageDevice::get_property_changes() const
+{
+	if (!property_changes_.has_value()) {
+		if (previous_property_repository_.get_properties().empty()) {
+			property_changes_.emplace();
+		} else {
+			property_changes_ = previous_property_repository_.diff(property_repository_);
+			previous_property_repository_.clear();  // not needed anymore
+		}
+	}
+	return property_changes_.value();
+}
+
+
+
 std::string StorageDevice::get_model_name() const
 {
 	return (model_name_.has_value() ? model_name_.value() : "");
@@ -810,6 +1084,13 @@ std::string StorageDevice::get_serial_number() const
 
 
 
+std::string StorageDevice::get_firmware_version() const
+{
+	return (firmware_version_.has_value() ? firmware_version_.value() : "");
+}
+
+
+
 void StorageDevice::set_info_output(std::string s)
 {
 	basic_output_ = std::move(s);
@@ -838,6 +1119,13 @@ std::string StorageDevice::get_full_output() const
 
 
 
+std::string StorageDevice::get_tier_output() const
+{
+	return tier_output_;
+}
+
+
+
 void StorageDevice::set_is_manually_added(bool b)
 {
 	is_manually_added_ = b;
@@ -870,6 +1158,55 @@ bool StorageDevice::get_test_is_active() const
 
 
 
+bool StorageDevice::get_is_in_standby() const
+{
+	return is_in_standby_;
+}
+
+
+
+void StorageDevice::set_attribute_trend_tracker(std::shared_ptr<AttributeTrendTracker> tracker)
+{
+	trend_tracker_ = std::move(tracker);
+}
+
+
+
+std::shared_ptr<AttributeTrendTracker> StorageDevice::get_attribute_trend_tracker() const
+{
+	return trend_tracker_;
+}
+
+
+
+std::optional<std::chrono::system_clock::time_point> StorageDevice::get_full_data_time() const
+{
+	return full_data_time_;
+}
+
+
+
+std::optional<std::chrono::system_clock::time_point> StorageDevice::get_section_data_time(StoragePropertySection section) const
+{
+	if (auto iter = section_data_times_.find(section); iter != section_data_times_.end()) {
+		return iter->second;
+	}
+	return std::nullopt;
+}
+
+
+
+std::optional<std::chrono::system_clock::time_point> StorageDevice::get_last_data_time() const
+{
+	std::optional<std::chrono::system_clock::time_point> last_time;
+	for (const auto& [section, time] : section_data_times_) {
+		last_time = std::max(last_time.value_or(time), time);
+	}
+	return last_time;
+}
+
+
+
 StorageDevice::SelfTestSupportStatus StorageDevice::get_self_test_support_status() const
 {
 	if (get_parse_status() == ParseStatus::Full) {
@@ -941,8 +1278,21 @@ hz::ExpectedVoid<StorageDeviceError> StorageDevice::execute_device_smartctl(cons
 
 	const std::string device = get_device();
 
+	// We need the exit status, so create the default executor here.
+	const std::shared_ptr<CommandExecutor> executor = smartctl_ex ? smartctl_ex : std::make_shared<SmartctlExecutor>();
+
 	auto smartctl_status = execute_smartctl(device, this->get_device_options(),
-			command_options, smartctl_ex, smartctl_output);
+			command_options, executor, smartctl_output);
+
+	// With --nocheck=standby, smartctl exits with status 2 without accessing the device if it's in a low-power mode.
+	// Note: This match works even with JSON (the text output is included in --json=o).
+	const bool nocheck_standby = std::find(command_options.begin(), command_options.end(),
+			smartctl_nocheck_standby_option) != command_options.end();
+	if (nocheck_standby && executor->get_exit_status() == 2
+			&& app_regex_partial_match("/Device is in [^\\n\"]+ mode, exit\\(/mi", smartctl_output)) {
+		debug_out_info("app", DBG_FUNC_MSG << "Device " << get_device_with_type() << " is in a low-power mode, not waking it up.\n");
+		return hz::Unexpected(StorageDeviceError::InStandby, _("The device is in standby mode."));
+	}
 
 	if (!smartctl_status) {
 		debug_out_warn("app", DBG_FUNC_MSG << "Smartctl binary did not execute cleanly.\n");
@@ -982,6 +1332,109 @@ void StorageDevice::set_parse_status(ParseStatus value)
 void StorageDevice::set_property_repository(StoragePropertyRepository repository)
 {
 	property_repository_ = std::move(repository);
+	fetched_property_repository_.reset();
+}
+
+
+
+void StorageDevice::process_and_set_property_repository(const std::shared_ptr<const StoragePropertyRepository>& repository)
+{
+	// Identical outputs are processed only once
+	property_repository_ = *SmartctlParseCache::process(repository, get_detected_type());
+}
+
+
+
+void StorageDevice::merge_tier_properties(const std::vector<StoragePropertySection>& sections,
+		const StoragePropertyRepository& tier_repository)
+{
+	const auto is_tier_section = [&sections](StoragePropertySection section) {
+		return std::find(sections.begin(), sections.end(), section) != sections.end();
+	};
+
+	// Keep the text output of the full fetch, it's used when saving the data.
+	const auto find_tier_property = [](const StoragePropertyRepository& repository, const StorageProperty& p) {
+		if (p.generic_name.empty() || p.generic_name == "smartctl/output") {
+			return static_cast<const StorageProperty*>(nullptr);
+		}
+		return repository.find_property(p.generic_name, p.section);
+	};
+
+	// Only the replaced properties are fresh, the rest stay as they were fetched before.
+	std::vector<StorageProperty> old_replaced, new_replaced;
+
+	for (const auto& p : property_repository_.get_properties()) {
+		if (is_tier_section(p.section)) {
+			old_replaced.push_back(p);
+		} else if (const auto* tier_p = find_tier_property(tier_repository, p)) {
+			old_replaced.push_back(p);
+			new_replaced.push_back(*tier_p);
+		}
+	}
+	for (const auto& p : tier_repository.get_properties()) {
+		if (is_tier_section(p.section)) {
+			new_replaced.push_back(p);
+		}
+	}
+
+	StoragePropertyRepository old_repository;
+	old_repository.set_properties(std::move(old_replaced));
+	auto& fetched_repository = fetched_property_repository_.emplace();
+	fetched_repository.set_properties(std::move(new_replaced));
+
+	// The kept properties already have their trend warnings from the fetch they came from.
+	update_attribute_trends(fetched_repository);
+
+	std::vector<StorageProperty> properties;
+	properties.reserve(property_repository_.get_properties().size());
+
+	for (const auto& p : property_repository_.get_properties()) {
+		if (!is_tier_section(p.section)) {
+			const auto* tier_p = find_tier_property(fetched_repository, p);
+			properties.push_back(tier_p ? *tier_p : p);
+		}
+	}
+	for (const auto& p : fetched_repository.get_properties()) {
+		if (is_tier_section(p.section)) {
+			properties.push_back(p);
+		}
+	}
+
+	property_repository_.set_properties(std::move(properties));
+
+	property_changes_ = old_repository.diff(fetched_repository);
+	previous_property_repository_.clear();
+}
+
+
+
+void StorageDevice::set_is_in_standby(bool b)
+{
+	const bool changed = (is_in_standby_ != b);
+	is_in_standby_ = b;
+	if (changed) {
+		signal_changed().emit(this);  // the data is now old, or fresh again
+	}
+}
+
+
+
+void StorageDevice::invalidate_derived_values()
+{
+	derived_values_ = {};
+}
+
+
+
+void StorageDevice::update_attribute_trends(StoragePropertyRepository& repository)
+{
+	if (!trend_tracker_) {
+		return;
+	}
+
+	trend_tracker_->add_sample(AttributeHistorySample::create(repository,
+			std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now())));
+	trend_tracker_->apply_warnings(repository);
 }
 
 
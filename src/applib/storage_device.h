@@ -12,6 +12,7 @@ Copyright:
 #ifndef STORAGE_DEVICE_H
 #define STORAGE_DEVICE_H
 
+#include <chrono>
 #include <string>
 #include <map>
 #include <optional>
@@ -25,6 +26,7 @@ Copyright:
 #include "smartctl_executor.h"
 #include "storage_property_repository.h"
 #include "storage_device_detected_type.h"
+#include "attribute_trend.h"
 
 
 
@@ -45,6 +47,17 @@ enum class StorageDeviceError {
 	CommandFailed,  ///< SMART command (e.g. enable/disable SMART) failed.
 	CommandUnknownError,  ///< Unknown error from the command.
 	ParseError,  ///< Error parsing the output.
+	InStandby,  ///< The device is in a low-power mode and was not woken up.
+};
+
+
+
+/// Amount of data fetched by StorageDevice::fetch_data_and_parse().
+/// The lower tiers are cheaper and are merged into the previously fetched full data.
+enum class StorageDeviceFetchTier {
+	Pulse,  ///< Health and attributes (NVMe health log). For periodic refreshes.
+	Standard,  ///< Pulse, plus the self-test log.
+	Full,  ///< Everything, including all the logs. Same as fetch_full_data_and_parse().
 };
 
 
@@ -96,8 +109,11 @@ class StorageDevice {
 		/// Calls "smartctl -i -H -c" (info section, health, capabilities), then parse_basic_data().
 		/// Called during drive detection.
 		/// Note: this will clear all previous properties!
+		/// \param smartctl_ex Executor, nullptr for the default one.
+		/// \param allow_wakeup If false and the device is in standby or sleep mode, it is not
+		/// woken up. StorageDeviceError::InStandby is returned and the previous data is kept.
 		[[nodiscard]] hz::ExpectedVoid<StorageDeviceError> fetch_basic_data_and_parse(
-				const std::shared_ptr<CommandExecutor>& smartctl_ex = nullptr);
+				const std::shared_ptr<CommandExecutor>& smartctl_ex = nullptr, bool allow_wakeup = true);
 
 		/// Detects type, smart support, smart status (on / off).
 		/// Note: this will clear all previous properties!
@@ -105,7 +121,24 @@ class StorageDevice {
 
 
 		/// Execute smartctl --all / -x (all sections), get output, parse it (basic data too), fill properties.
-		[[nodiscard]] hz::ExpectedVoid<StorageDeviceError> fetch_full_data_and_parse(const std::shared_ptr<CommandExecutor>& smartctl_ex);
+		/// \param smartctl_ex Executor, nullptr for the default one.
+		/// \param allow_wakeup If false and the device is in standby or sleep mode, it is not
+		/// woken up. StorageDeviceError::InStandby is returned and the previous data is kept.
+		[[nodiscard]] hz::ExpectedVoid<StorageDeviceError> fetch_full_data_and_parse(const std::shared_ptr<CommandExecutor>& smartctl_ex,
+				bool allow_wakeup = true);
+
+		/// Fetch the data of a tier, parse it and merge it into the existing data.
+		/// The sections of the tier are replaced, the other sections are kept (only their values which
+		/// are reported by the tier as well, e.g. the current temperature, are updated).
+		/// If there is no full data to merge into, or the drive type has no specialized parser,
+		/// the full data is fetched instead. The full output stays as it was, the tier output
+		/// is available through get_tier_output().
+		/// \param tier Fetch tier
+		/// \param smartctl_ex Executor, nullptr for the default one.
+		/// \param allow_wakeup If false and the device is in standby or sleep mode, it is not
+		/// woken up. StorageDeviceError::InStandby is returned and the previous data is kept.
+		[[nodiscard]] hz::ExpectedVoid<StorageDeviceError> fetch_data_and_parse(StorageDeviceFetchTier tier,
+				const std::shared_ptr<CommandExecutor>& smartctl_ex, bool allow_wakeup = true);
 
 		/// Parse full info.
 		[[nodiscard]] hz::ExpectedVoid<StorageDeviceError> parse_full_data(SmartctlParserType parser_type, SmartctlOutputFormat format);
@@ -136,7 +169,7 @@ class StorageDevice {
 
 
 		/// Get format size string, or an empty string on error.
-		[[nodiscard]] std::string get_device_size_str() const;
+		[[nodiscard]] const std::string& get_device_size_str() const;
 
 		/// Get the overall health property
 		[[nodiscard]] StorageProperty get_health_property() const;
@@ -146,10 +179,15 @@ class StorageDevice {
 		[[nodiscard]] std::string get_device() const;
 
 		/// Get device name without path. For example, "sda".
-		[[nodiscard]] std::string get_device_base() const;
+		[[nodiscard]] const std::string& get_device_base() const;
 
 		/// Get device name for display purposes (with a type argument in parentheses)
-		[[nodiscard]] std::string get_device_with_type() const;
+		[[nodiscard]] const std::string& get_device_with_type() const;
+
+		/// Get a key for sorting: real drives first, in natural order of device base and
+		/// type argument, then virtual drives in natural order of filenames.
+		/// The keys can be compared with the < operator without allocation.
+		[[nodiscard]] const std::string& get_sort_key() const;
 
 
 		/// Set detected type
@@ -180,7 +218,7 @@ class StorageDevice {
 		[[nodiscard]] const std::map<char, std::string>& get_drive_letters() const;
 
 		/// Get comma-separated win32 drive letters (if present)
-		[[nodiscard]] std::string format_drive_letters(bool with_volnames) const;
+		[[nodiscard]] const std::string& format_drive_letters(bool with_volnames) const;
 
 
 		/// Get "virtual" status
@@ -193,9 +231,28 @@ class StorageDevice {
 		[[nodiscard]] std::string get_virtual_filename() const;
 
 
-		/// Get properties
+		/// Get properties.
+		/// Note: Property descriptions are generated on first access, see ensure_section_processed().
 		[[nodiscard]] const StoragePropertyRepository& get_property_repository() const;
 
+		/// Get the properties fetched by the last fetch. For a lower fetch tier, these are only
+		/// the properties merged into the full data (see fetch_data_and_parse()), the rest may be stale.
+		[[nodiscard]] const StoragePropertyRepository& get_fetched_property_repository() const;
+
+		/// Generate the descriptions of the properties of a section, if they're not generated yet.
+		/// This is done when a section is displayed, so that the rest of the code may read them freely.
+		/// This does not invalidate pointers to properties.
+		void ensure_section_processed(StoragePropertySection section) const;
+
+		/// Check whether the properties of a section have their descriptions generated
+		[[nodiscard]] bool get_section_processed(StoragePropertySection section) const;
+
+		/// Get the property changes made by the last fetch, compared to the data before it.
+		/// For a full parse, the changes are computed on the first call (the previous properties are
+		/// kept until then). For a lower fetch tier, only the merged properties are compared.
+		/// Empty if there was no full parse before it.
+		[[nodiscard]] const StoragePropertyRepositoryDiff& get_property_changes() const;
+
 
 		/// Get model name.
 		/// \return empty string if not found
@@ -209,6 +266,10 @@ class StorageDevice {
 		/// \return empty string if not found
 		[[nodiscard]] std::string get_serial_number() const;
 
+		/// Get firmware version.
+		/// \return empty string if not found
+		[[nodiscard]] std::string get_firmware_version() const;
+
 
 		/// Set "info" output to parse
 		void set_info_output(std::string s);
@@ -223,6 +284,11 @@ class StorageDevice {
 		/// Get "full" output to parse
 		[[nodiscard]] std::string get_full_output() const;
 
+		/// Get the output of the last lower-tier fetch (see fetch_data_and_parse()), which was merged
+		/// into the full data after the full output was fetched. Empty if the last fetch was a full one.
+		/// Such properties are newer than the full output.
+		[[nodiscard]] std::string get_tier_output() const;
+
 
 		/// Set "manually added" flag
 		void set_is_manually_added(bool b);
@@ -238,6 +304,32 @@ class StorageDevice {
 		[[nodiscard]] bool get_test_is_active() const;
 
 
+		/// Check if the last fetch found the device in standby or sleep mode, without waking it up.
+		/// The data shown is then from get_full_data_time().
+		[[nodiscard]] bool get_is_in_standby() const;
+
+		/// Get the time the current full data was fetched.
+		/// \return std::nullopt if there is no full data, or it was not fetched from the device.
+		[[nodiscard]] std::optional<std::chrono::system_clock::time_point> get_full_data_time() const;
+
+		/// Get the time the properties of a section were fetched, by any tier.
+		/// \return std::nullopt if the section has no properties, or they were not fetched from the device.
+		[[nodiscard]] std::optional<std::chrono::system_clock::time_point> get_section_data_time(StoragePropertySection section) const;
+
+		/// Get the time of the most recent fetch, by any tier.
+		/// \return std::nullopt if no data was fetched from the device.
+		[[nodiscard]] std::optional<std::chrono::system_clock::time_point> get_last_data_time() const;
+
+
+		/// Set the attribute trend tracker. Full data fetched from the device is added to it, and its
+		/// trend warnings are applied to the properties. Without a tracker, the trends are not tracked.
+		/// See AttributeTrendTracker::create().
+		void set_attribute_trend_tracker(std::shared_ptr<AttributeTrendTracker> tracker);
+
+		/// Get the attribute trend tracker. May return nullptr.
+		[[nodiscard]] std::shared_ptr<AttributeTrendTracker> get_attribute_trend_tracker() const;
+
+
 		/// Get whether the tests are supported, based on parsed properties
 		[[nodiscard]] SelfTestSupportStatus get_self_test_support_status() const;
 
@@ -267,9 +359,32 @@ class StorageDevice {
 		/// Set properties
 		void set_property_repository(StoragePropertyRepository repository);
 
+		/// Set warnings on parsed properties (and descriptions, to be generated on first access), and set them.
+		/// \param repository Properties returned by SmartctlParseCache::parse().
+		void process_and_set_property_repository(const std::shared_ptr<const StoragePropertyRepository>& repository);
+
 
 	private:
 
+		/// Set "in standby" flag, emit the "changed" signal if needed.
+		void set_is_in_standby(bool b);
+
+		/// Replace the properties of \c sections with the ones from \c tier_repository, keeping the other sections.
+		/// The properties of the other sections reported in \c tier_repository as well are updated in place.
+		/// The merged properties are compared to the ones they replace (see get_property_changes()),
+		/// and only they are added to the attribute trends.
+		void merge_tier_properties(const std::vector<StoragePropertySection>& sections,
+				const StoragePropertyRepository& tier_repository);
+
+		/// Clear the cached display strings and sort key, so that they are rebuilt on next access.
+		/// Called whenever the values they are built from change.
+		void invalidate_derived_values();
+
+		/// Add freshly fetched properties to the attribute trends and apply the
+		/// trend warnings to them. Does nothing if there is no trend tracker.
+		void update_attribute_trends(StoragePropertyRepository& repository);
+
+
 		std::string device_;  ///< e.g. /dev/sda or pd0. empty if virtual.
 		std::string type_arg_;  ///< Device type (for -d smartctl parameter), as specified when adding the device.
 		std::vector<std::string> extra_args_;  ///< Extra parameters for smartctl, as specified when adding the device.
@@ -284,15 +399,24 @@ class StorageDevice {
 		/// except "-l selftest" and maybe "--capabilities" and "--info" (not sure).
 		bool test_is_active_ = false;
 
+		bool is_in_standby_ = false;  ///< The last fetch found the device in a low-power mode
+		std::optional<std::chrono::system_clock::time_point> full_data_time_;  ///< Time the full data was fetched
+		std::map<StoragePropertySection, std::chrono::system_clock::time_point> section_data_times_;  ///< Time each section was fetched
+
 		// Outputs
 		std::string basic_output_;  ///< "smartctl --info" output
 		std::string full_output_;  ///< "smartctl --all" or "-x" output
+		std::string tier_output_;  ///< Output of the last lower-tier fetch, merged into the full data
 
 		StorageDeviceDetectedType detected_type_ = StorageDeviceDetectedType::Unknown;  ///< Detected by basic parser
 
 		ParseStatus parse_status_ = ParseStatus::None;  ///< "Fully parsed" flag
 
 		StoragePropertyRepository property_repository_;  ///< Parsed data properties
+		mutable std::optional<StoragePropertyRepositoryDiff> property_changes_;  ///< Changes made to properties by the last fetch, computed on demand
+		mutable StoragePropertyRepository previous_property_repository_;  ///< Properties before the last full parse, until property_changes_ is computed
+		std::optional<StoragePropertyRepository> fetched_property_repository_;  ///< Properties merged by the last lower-tier fetch, if it was one
+		std::shared_ptr<AttributeTrendTracker> trend_tracker_;  ///< Attribute trends of a real drive, may be empty
 
 		// Common properties
 		std::optional<bool> smart_supported_;  ///< SMART support status
@@ -300,9 +424,20 @@ class StorageDevice {
 		std::optional<std::string> model_name_;  ///< Model name
 		std::optional<std::string> family_name_;  ///< Family name
 		std::optional<std::string> serial_number_;  ///< Serial number
+		std::optional<std::string> firmware_version_;  ///< Firmware version
 		std::optional<std::string> size_;  ///< Formatted size
 		mutable std::optional<StorageProperty> health_property_;  ///< Cached health property.
 
+		/// Display strings and sort key, built on first access
+		struct DerivedValues {
+			std::optional<std::string> device_base;  ///< get_device_base() result
+			std::optional<std::string> device_with_type;  ///< get_device_with_type() result
+			std::optional<std::string> drive_letters;  ///< format_drive_letters(false) result
+			std::optional<std::string> drive_letters_with_volnames;  ///< format_drive_letters(true) result
+			std::optional<std::string> sort_key;  ///< get_sort_key() result
+		};
+		mutable DerivedValues derived_values_;  ///< Cached display strings and sort key
+
 
 		/// Emitted whenever new information is available
 		sigc::signal<void, StorageDevice*> signal_changed_;
@@ -319,16 +454,7 @@ inline bool operator< (const StorageDevicePtr& a, const StorageDevicePtr& b)
 // 	if (a->get_detected_type() != a->get_detected_type()) {
 // 		return (a->get_detected_type() == StorageDevice::DetectedType::unknown);  // hard drives first
 // 	}
-	if (a->get_is_virtual() != b->get_is_virtual()) {
-		return int(a->get_is_virtual()) < int(b->get_is_virtual());
-	}
-	if (a->get_is_virtual()) {
-		return hz::string_natural_compare(a->get_virtual_filename(), b->get_virtual_filename()) < 0;
-	}
-	if (a->get_device_base() != b->get_device_base()) {
-		return hz::string_natural_compare(a->get_device_base(), b->get_device_base()) < 0;
-	}
-	return hz::string_natural_compare(a->get_type_argument(), b->get_type_argument()) < 0;
+	return a->get_sort_key() < b->get_sort_key();
 }
 
 
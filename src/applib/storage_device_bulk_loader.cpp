@@ -0,0 +1,358 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include "storage_device_bulk_loader.h"
+
+#include <glibmm.h>
+#include <algorithm>
+#include <utility>
+
+#include "hz/debug.h"
+#include "hz/fs.h"
+#include "gui_utils.h"
+#include "warning_colors.h"
+
+
+
+namespace {
+
+	/// Delivery interval of results to the main loop
+	constexpr std::chrono::milliseconds poll_interval(100);
+
+}
+
+
+
+double StorageDeviceBulkLoaderStats::get_files_per_second() const
+{
+	const double seconds = std::chrono::duration<double>(elapsed).count();
+	if (seconds <= 0.) {
+		return 0.;
+	}
+	return double(files_loaded + files_failed) / seconds;
+}
+
+
+
+std::vector<hz::fs::path> StorageDeviceBulkLoader::expand_sources(const std::vector<std::string>& sources)
+{
+	std::vector<hz::fs::path> files;
+
+	for (const auto& source : sources) {
+		if (source.empty())
+			continue;
+
+		const hz::fs::path path = hz::fs_path_from_string(source);
+		const std::string filename = hz::fs_path_to_string(path.filename());
+		std::error_code ec;
+
+		// Glob pattern
+		if (filename.find_first_of("*?") != std::string::npos) {
+			const hz::fs::path dir = path.has_parent_path() ? path.parent_path() : hz::fs::path(".");
+			const Glib::PatternSpec pattern(filename);
+			for (const auto& entry : hz::fs::directory_iterator(dir, ec)) {
+				if (entry.is_regular_file(ec) && pattern.match(hz::fs_path_to_string(entry.path().filename()))) {
+					files.push_back(entry.path());
+				}
+			}
+			if (ec) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Cannot list directory \"" << hz::fs_path_to_string(dir) << "\": " << ec.message() << "\n");
+			}
+
+		// Directory
+		} else if (hz::fs::is_directory(path, ec)) {
+			for (const auto& entry : hz::fs::directory_iterator(path, ec)) {
+				if (entry.is_regular_file(ec)) {
+					files.push_back(entry.path());
+				}
+			}
+			if (ec) {
+				debug_out_warn("app", DBG_FUNC_MSG << "Cannot list directory \"" << source << "\": " << ec.message() << "\n");
+			}
+
+		// Plain file. Let it fail later if it doesn't exist, so that the error is reported.
+		} else {
+			files.push_back(path);
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	files.erase(std::unique(files.begin(), files.end()), files.end());
+
+	return files;
+}
+
+
+
+StorageDeviceBulkLoader::StorageDeviceBulkLoader(std::size_t num_workers, std::size_t io_queue_size, std::uintmax_t max_file_size)
+		: num_workers_(num_workers), io_queue_size_(std::max(io_queue_size, std::size_t(1))), max_file_size_(max_file_size)
+{
+	if (num_workers_ == 0) {
+		num_workers_ = std::max(std::thread::hardware_concurrency(), 1U);
+	}
+}
+
+
+
+StorageDeviceBulkLoader::~StorageDeviceBulkLoader()
+{
+	cancel();
+}
+
+
+
+void StorageDeviceBulkLoader::set_batch_callback(batch_callback_t callback)
+{
+	batch_callback_ = std::move(callback);
+}
+
+
+
+void StorageDeviceBulkLoader::set_error_callback(error_callback_t callback)
+{
+	error_callback_ = std::move(callback);
+}
+
+
+
+void StorageDeviceBulkLoader::set_finished_callback(finished_callback_t callback)
+{
+	finished_callback_ = std::move(callback);
+}
+
+
+
+bool StorageDeviceBulkLoader::start(std::vector<hz::fs::path> files)
+{
+	if (running_) {
+		debug_out_error("app", DBG_FUNC_MSG << "Loading is already in progress.\n");
+		return false;
+	}
+
+	files_ = std::move(files);
+	io_queue_.clear();
+	results_.clear();
+	reading_finished_ = false;
+	cancel_requested_ = false;
+
+	stats_ = StorageDeviceBulkLoaderStats();
+	stats_.files_total = files_.size();
+	start_time_ = std::chrono::steady_clock::now();
+	running_ = true;
+
+	// GTK cannot be queried from worker threads
+	storage_property_set_warning_reason_dark_mode(gui_is_dark_theme_active());
+
+	debug_out_info("app", DBG_FUNC_MSG << "Loading " << files_.size() << " files using "
+			<< num_workers_ << " worker threads.\n");
+
+	reader_thread_ = std::thread(&StorageDeviceBulkLoader::reader_thread_func, this);
+	for (std::size_t i = 0; i < std::min(num_workers_, std::max(files_.size(), std::size_t(1))); ++i) {
+		worker_threads_.emplace_back(&StorageDeviceBulkLoader::worker_thread_func, this);
+	}
+
+	poll_timeout_conn_ = Glib::signal_timeout().connect(
+			sigc::mem_fun(*this, &StorageDeviceBulkLoader::on_poll_timeout), guint(poll_interval.count()));
+
+	return true;
+}
+
+
+
+void StorageDeviceBulkLoader::cancel()
+{
+	if (!running_)
+		return;
+
+	{
+		const std::scoped_lock lock(mutex_);
+		cancel_requested_ = true;
+	}
+	io_queue_not_full_.notify_all();
+	io_queue_not_empty_.notify_all();
+
+	join_threads();
+	poll_timeout_conn_.disconnect();
+
+	io_queue_.clear();
+	results_.clear();
+	running_ = false;
+	stats_.elapsed = std::chrono::steady_clock::now() - start_time_;
+	storage_property_set_warning_reason_dark_mode(std::nullopt);
+
+	debug_out_info("app", DBG_FUNC_MSG << "Loading cancelled.\n");
+}
+
+
+
+bool StorageDeviceBulkLoader::is_running() const
+{
+	return running_;
+}
+
+
+
+StorageDeviceBulkLoaderStats StorageDeviceBulkLoader::get_stats() const
+{
+	StorageDeviceBulkLoaderStats stats = stats_;
+	if (running_) {
+		stats.elapsed = std::chrono::steady_clock::now() - start_time_;
+	}
+	return stats;
+}
+
+
+
+void StorageDeviceBulkLoader::reader_thread_func()
+{
+	for (const auto& file : files_) {
+		ReadFile read_file;
+		read_file.file = file;
+		const std::error_code ec = hz::fs_file_get_contents(file, read_file.contents, max_file_size_);
+
+		std::unique_lock lock(mutex_);
+		if (ec) {
+			// No need to pass it through the parser queue
+			results_.push_back({file, nullptr, ec.message()});
+			continue;
+		}
+
+		io_queue_not_full_.wait(lock, [this]() { return cancel_requested_ || io_queue_.size() < io_queue_size_; });
+		if (cancel_requested_)
+			return;
+
+		io_queue_.push_back(std::move(read_file));
+		lock.unlock();
+		io_queue_not_empty_.notify_one();
+	}
+
+	{
+		const std::scoped_lock lock(mutex_);
+		reading_finished_ = true;
+	}
+	io_queue_not_empty_.notify_all();
+}
+
+
+
+void StorageDeviceBulkLoader::worker_thread_func()
+{
+	while (true) {
+		ReadFile read_file;
+		{
+			std::unique_lock lock(mutex_);
+			io_queue_not_empty_.wait(lock, [this]() { return cancel_requested_ || reading_finished_ || !io_queue_.empty(); });
+			if (cancel_requested_ || io_queue_.empty())  // cancelled or all files are read and parsed
+				return;
+
+			read_file = std::move(io_queue_.front());
+			io_queue_.pop_front();
+		}
+		io_queue_not_full_.notify_one();
+
+		LoadResult result = parse_file(std::move(read_file));
+
+		const std::scoped_lock lock(mutex_);
+		results_.push_back(std::move(result));
+	}
+}
+
+
+
+StorageDeviceBulkLoader::LoadResult StorageDeviceBulkLoader::parse_file(ReadFile read_file)
+{
+	LoadResult result;
+	result.file = read_file.file;
+
+	auto drive = std::make_shared<StorageDevice>(hz::fs_path_to_string(read_file.file), true);
+	drive->set_info_output(read_file.contents);  // info can be parsed from full output string too.
+	drive->set_full_output(std::move(read_file.contents));
+
+	// The parsers are thread-safe, so each worker parses independently
+	const auto parse_status = drive->parse_any_data_for_virtual();
+	if (parse_status) {
+		result.drive = std::move(drive);
+	} else {
+		result.error_message = parse_status.error().message();
+	}
+	return result;
+}
+
+
+
+bool StorageDeviceBulkLoader::on_poll_timeout()
+{
+	std::vector<LoadResult> results;
+	{
+		const std::scoped_lock lock(mutex_);
+		results.swap(results_);
+	}
+
+	std::vector<StorageDevicePtr> drives;
+	for (auto& result : results) {
+		if (result.drive) {
+			drives.push_back(std::move(result.drive));
+			++stats_.files_loaded;
+		} else {
+			++stats_.files_failed;
+			debug_out_warn("app", "Cannot load virtual drive file \"" << hz::fs_path_to_string(result.file)
+					<< "\": " << result.error_message << "\n");
+			if (error_callback_) {
+				error_callback_(result.file, result.error_message);
+			}
+		}
+	}
+	if (!drives.empty() && batch_callback_) {
+		batch_callback_(std::move(drives));
+	}
+
+	// Each file produces exactly one result
+	if (stats_.files_loaded + stats_.files_failed < stats_.files_total) {
+		return true;  // continue polling
+	}
+
+	join_threads();
+	running_ = false;
+	stats_.elapsed = std::chrono::steady_clock::now() - start_time_;
+	storage_property_set_warning_reason_dark_mode(std::nullopt);
+
+	debug_out_info("app", DBG_FUNC_MSG << "Loaded " << stats_.files_loaded << " of " << stats_.files_total << " files in "
+			<< std::chrono::duration<double>(stats_.elapsed).count() << " seconds ("
+			<< stats_.get_files_per_second() << " files/s).\n");
+
+	if (finished_callback_) {
+		finished_callback_(stats_);
+	}
+
+	return false;  // disconnect
+}
+
+
+
+void StorageDeviceBulkLoader::join_threads()
+{
+	if (reader_thread_.joinable()) {
+		reader_thread_.join();
+	}
+	for (auto& thread : worker_threads_) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	worker_threads_.clear();
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,180 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_DEVICE_BULK_LOADER_H
+#define STORAGE_DEVICE_BULK_LOADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sigc++/sigc++.h>
+
+#include "hz/fs_ns.h"
+#include "storage_device.h"
+
+
+
+/// Statistics of a bulk load operation
+struct StorageDeviceBulkLoaderStats {
+	std::size_t files_total = 0;  ///< Number of files to load
+	std::size_t files_loaded = 0;  ///< Number of files successfully loaded
+	std::size_t files_failed = 0;  ///< Number of files which could not be read or parsed
+	std::chrono::steady_clock::duration elapsed = {};  ///< Time spent loading
+
+	/// Get the number of processed (loaded or failed) files per second
+	[[nodiscard]] double get_files_per_second() const;
+};
+
+
+
+/// Loads saved smartctl outputs as virtual drives in background threads.
+/// A reader thread reads the files into a bounded queue, a pool of worker threads
+/// parses them, and the finished drives are delivered to the Glib main loop in batches.
+/// All the callbacks are invoked in the main loop thread.
+class StorageDeviceBulkLoader {
+	public:
+
+		/// Called with each batch of loaded drives
+		using batch_callback_t = std::function<void(std::vector<StorageDevicePtr> drives)>;
+
+		/// Called for each file which could not be loaded
+		using error_callback_t = std::function<void(const hz::fs::path& file, const std::string& message)>;
+
+		/// Called once all files have been processed
+		using finished_callback_t = std::function<void(const StorageDeviceBulkLoaderStats& stats)>;
+
+
+		/// Expand a list of files, directories and glob patterns into a sorted list of files.
+		/// Directories are expanded (non-recursively) to all regular files inside them.
+		/// Wildcards (* and ?) are supported in the last path component only.
+		[[nodiscard]] static std::vector<hz::fs::path> expand_sources(const std::vector<std::string>& sources);
+
+
+		/// Constructor. If \c num_workers is 0, use the number of CPUs.
+		/// \c io_queue_size is the maximum number of read, but not yet parsed, files kept in memory.
+		explicit StorageDeviceBulkLoader(std::size_t num_workers = 0, std::size_t io_queue_size = 32,
+				std::uintmax_t max_file_size = 10*1024*1024);
+
+		/// Deleted
+		StorageDeviceBulkLoader(const StorageDeviceBulkLoader& other) = delete;
+
+		/// Deleted
+		StorageDeviceBulkLoader(StorageDeviceBulkLoader&& other) = delete;
+
+		/// Deleted
+		StorageDeviceBulkLoader& operator=(const StorageDeviceBulkLoader& other) = delete;
+
+		/// Deleted
+		StorageDeviceBulkLoader& operator=(StorageDeviceBulkLoader&& other) = delete;
+
+		/// Destructor. Cancels the loading and waits for the threads to exit.
+		~StorageDeviceBulkLoader();
+
+
+		/// Set the callback for loaded drives
+		void set_batch_callback(batch_callback_t callback);
+
+		/// Set the callback for load errors
+		void set_error_callback(error_callback_t callback);
+
+		/// Set the callback for load completion
+		void set_finished_callback(finished_callback_t callback);
+
+
+		/// Start loading the files. Must be called from the main loop thread.
+		/// \return false if the previous load is still running.
+		bool start(std::vector<hz::fs::path> files);
+
+		/// Stop loading and wait for the threads to exit. The drives which have not
+		/// been delivered yet are discarded, and the finished callback is not called.
+		void cancel();
+
+		/// Check if the loading is in progress
+		[[nodiscard]] bool is_running() const;
+
+		/// Get current statistics
+		[[nodiscard]] StorageDeviceBulkLoaderStats get_stats() const;
+
+
+	private:
+
+		/// A file read by the reader thread, waiting to be parsed
+		struct ReadFile {
+			hz::fs::path file;  ///< File path
+			std::string contents;  ///< File contents
+		};
+
+		/// A processed file, waiting to be delivered to the main loop
+		struct LoadResult {
+			hz::fs::path file;  ///< File path
+			StorageDevicePtr drive;  ///< Loaded drive, or nullptr on error
+			std::string error_message;  ///< Error message if the drive is nullptr
+		};
+
+
+		/// Reader thread function
+		void reader_thread_func();
+
+		/// Worker thread function
+		void worker_thread_func();
+
+		/// Read a file and parse it into a drive
+		[[nodiscard]] static LoadResult parse_file(ReadFile read_file);
+
+		/// Deliver the results to the callbacks. Invoked periodically in the main loop.
+		bool on_poll_timeout();
+
+		/// Wait for all threads to exit
+		void join_threads();
+
+
+		std::size_t num_workers_ = 1;  ///< Number of parser threads
+		std::size_t io_queue_size_ = 1;  ///< Maximum number of read files waiting for parsing
+		std::uintmax_t max_file_size_ = 0;  ///< Files larger than this are not loaded
+
+		batch_callback_t batch_callback_;  ///< Callback
+		error_callback_t error_callback_;  ///< Callback
+		finished_callback_t finished_callback_;  ///< Callback
+
+		std::vector<hz::fs::path> files_;  ///< Files to load. Read-only while the threads are running.
+		std::thread reader_thread_;  ///< Reads the files into io_queue_
+		std::vector<std::thread> worker_threads_;  ///< Parse the files from io_queue_
+
+		mutable std::mutex mutex_;  ///< Protects the members below
+		std::condition_variable io_queue_not_full_;  ///< Signalled when a file is taken from io_queue_
+		std::condition_variable io_queue_not_empty_;  ///< Signalled when a file is added to io_queue_
+		std::deque<ReadFile> io_queue_;  ///< Read files waiting to be parsed
+		bool reading_finished_ = false;  ///< Set by the reader thread when all files are read
+		bool cancel_requested_ = false;  ///< Set to make the threads exit
+		std::vector<LoadResult> results_;  ///< Processed files waiting to be delivered
+
+		// Main thread only
+		bool running_ = false;  ///< True between start() and completion / cancel()
+		StorageDeviceBulkLoaderStats stats_;  ///< Statistics of the current / last run
+		std::chrono::steady_clock::time_point start_time_;  ///< When start() was called
+		sigc::connection poll_timeout_conn_;  ///< Periodic results delivery
+
+};
+
+
+
+
+
+#endif
+
+/// @}
@@ -14,6 +14,7 @@ Copyright:
 #include <chrono>
 #include <ios>
 #include <map>
+#include <mutex>
 #include <ostream>  // not iosfwd - it doesn't work
 #include <sstream>
 #include <locale>
@@ -32,6 +33,19 @@ Copyright:
 
 
 
+namespace {
+
+	/// Serializes the generation of descriptions with the copying of pending ones
+	std::mutex& get_description_mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+}
+
+
+
 std::ostream& operator<< (std::ostream& os, const AtaStorageTextCapability& p)
 {
 	os
@@ -283,30 +297,40 @@ std::ostream& operator<<(std::ostream& os, const NvmeStorageSelftestEntry& b)
 
 
 
+std::ostream& operator<<(std::ostream& os, const AtaStorageTemperatureHistory& b)
+{
+	return os << "Temperature history: " << b.temperatures.size() << " entries, "
+		<< b.logging_interval_minutes << " min. interval";
+}
+
+
+
 std::string StorageProperty::get_storable_value_type_name() const
 {
-	if (std::holds_alternative<std::monostate>(value))
+	if (is_value_type<std::monostate>())
 		return "empty";
-	if (std::holds_alternative<std::string>(value))
+	if (is_value_type<std::string>())
 		return "string";
-	if (std::holds_alternative<std::int64_t>(value))
+	if (is_value_type<std::int64_t>())
 		return "integer";
-	if (std::holds_alternative<bool>(value))
+	if (is_value_type<bool>())
 		return "bool";
-	if (std::holds_alternative<std::chrono::seconds>(value))
+	if (is_value_type<std::chrono::seconds>())
 		return "time_length";
-	if (std::holds_alternative<AtaStorageTextCapability>(value))
+	if (is_value_type<AtaStorageTextCapability>())
 		return "capability";
-	if (std::holds_alternative<AtaStorageAttribute>(value))
+	if (is_value_type<AtaStorageAttribute>())
 		return "attribute";
-	if (std::holds_alternative<AtaStorageStatistic>(value))
+	if (is_value_type<AtaStorageStatistic>())
 		return "statistic";
-	if (std::holds_alternative<AtaStorageErrorBlock>(value))
+	if (is_value_type<AtaStorageErrorBlock>())
 		return "error_block";
-	if (std::holds_alternative<AtaStorageSelftestEntry>(value))
+	if (is_value_type<AtaStorageSelftestEntry>())
 		return "ata_selftest_entry";
-	if (std::holds_alternative<NvmeStorageSelftestEntry>(value))
+	if (is_value_type<NvmeStorageSelftestEntry>())
 		return "nvme_selftest_entry";
+	if (is_value_type<AtaStorageTemperatureHistory>())
+		return "temperature_history";
 	return "[internal_error]";
 }
 
@@ -314,7 +338,24 @@ std::string StorageProperty::get_storable_value_type_name() const
 
 bool StorageProperty::empty() const
 {
-	return std::holds_alternative<std::monostate>(value);
+	return is_value_type<std::monostate>();
+}
+
+
+
+bool StorageProperty::value_equals(const StorageProperty& other) const
+{
+	if (reported_value != other.reported_value || value.index() != other.value.index())
+		return false;
+
+	return std::visit([&other]<typename T>(const T& v) -> bool {
+		const T& other_v = std::get<T>(other.value);
+		if constexpr(requires { typename T::element_type; }) {  // boxed
+			return v == other_v || (v && other_v && *v == *other_v);
+		} else {
+			return v == other_v;
+		}
+	}, value);
 }
 
 
@@ -331,28 +372,30 @@ void StorageProperty::dump(std::ostream& os, std::size_t internal_offset) const
 	// if (!readable_value.empty())
 	// 	os << readable_value;
 
-	if (std::holds_alternative<std::monostate>(value)) {
+	if (is_value_type<std::monostate>()) {
 		os << "[empty]";
-	} else if (std::holds_alternative<std::string>(value)) {
-		os << std::get<std::string>(value);
-	} else if (std::holds_alternative<std::int64_t>(value)) {
-		os << std::get<std::int64_t>(value) << " [" << reported_value << "]";
-	} else if (std::holds_alternative<bool>(value)) {
-		os << std::string(std::get<bool>(value) ? "Yes" : "No") << " [" << reported_value << "]";
-	} else if (std::holds_alternative<std::chrono::seconds>(value)) {
-		os << std::get<std::chrono::seconds>(value).count() << " sec [" << reported_value << "]";
-	} else if (std::holds_alternative<AtaStorageTextCapability>(value)) {
-		os << std::get<AtaStorageTextCapability>(value);
-	} else if (std::holds_alternative<AtaStorageAttribute>(value)) {
-		os << std::get<AtaStorageAttribute>(value);
-	} else if (std::holds_alternative<AtaStorageStatistic>(value)) {
-		os << std::get<AtaStorageStatistic>(value);
-	} else if (std::holds_alternative<AtaStorageErrorBlock>(value)) {
-		os << std::get<AtaStorageErrorBlock>(value);
-	} else if (std::holds_alternative<AtaStorageSelftestEntry>(value)) {
-		os << std::get<AtaStorageSelftestEntry>(value);
-	} else if (std::holds_alternative<NvmeStorageSelftestEntry>(value)) {
-		os << std::get<NvmeStorageSelftestEntry>(value);
+	} else if (is_value_type<std::string>()) {
+		os << get_value<std::string>();
+	} else if (is_value_type<std::int64_t>()) {
+		os << get_value<std::int64_t>() << " [" << reported_value << "]";
+	} else if (is_value_type<bool>()) {
+		os << std::string(get_value<bool>() ? "Yes" : "No") << " [" << reported_value << "]";
+	} else if (is_value_type<std::chrono::seconds>()) {
+		os << get_value<std::chrono::seconds>().count() << " sec [" << reported_value << "]";
+	} else if (is_value_type<AtaStorageTextCapability>()) {
+		os << get_value<AtaStorageTextCapability>();
+	} else if (is_value_type<AtaStorageAttribute>()) {
+		os << get_value<AtaStorageAttribute>();
+	} else if (is_value_type<AtaStorageStatistic>()) {
+		os << get_value<AtaStorageStatistic>();
+	} else if (is_value_type<AtaStorageErrorBlock>()) {
+		os << get_value<AtaStorageErrorBlock>();
+	} else if (is_value_type<AtaStorageSelftestEntry>()) {
+		os << get_value<AtaStorageSelftestEntry>();
+	} else if (is_value_type<NvmeStorageSelftestEntry>()) {
+		os << get_value<NvmeStorageSelftestEntry>();
+	} else if (is_value_type<AtaStorageTemperatureHistory>()) {
+		os << get_value<AtaStorageTemperatureHistory>();
 	}
 }
 
@@ -363,28 +406,30 @@ std::string StorageProperty::format_value(bool add_reported_too) const
 	if (!readable_value.empty())
 		return readable_value;
 
-	if (std::holds_alternative<std::monostate>(value))
+	if (is_value_type<std::monostate>())
 		return "[unknown]";
-	if (std::holds_alternative<std::string>(value))
-		return std::get<std::string>(value);
-	if (std::holds_alternative<int64_t>(value))
-		return hz::number_to_string_locale(std::get<int64_t>(value)) + (add_reported_too ? (" [" + reported_value + "]") : "");
-	if (std::holds_alternative<bool>(value))
-		return std::string(std::get<bool>(value) ? "Yes" : "No") + (add_reported_too ? (" [" + reported_value + "]") : "");
-	if (std::holds_alternative<std::chrono::seconds>(value))
-		return hz::format_time_length(std::get<std::chrono::seconds>(value)) + (add_reported_too ? (" [" + reported_value + "]") : "");
-	if (std::holds_alternative<AtaStorageTextCapability>(value))
-		return hz::stream_cast<std::string>(std::get<AtaStorageTextCapability>(value));
-	if (std::holds_alternative<AtaStorageAttribute>(value))
-		return hz::stream_cast<std::string>(std::get<AtaStorageAttribute>(value));
-	if (std::holds_alternative<AtaStorageStatistic>(value))
-		return hz::stream_cast<std::string>(std::get<AtaStorageStatistic>(value));
-	if (std::holds_alternative<AtaStorageErrorBlock>(value))
-		return hz::stream_cast<std::string>(std::get<AtaStorageErrorBlock>(value));
-	if (std::holds_alternative<AtaStorageSelftestEntry>(value))
-		return hz::stream_cast<std::string>(std::get<AtaStorageSelftestEntry>(value));
-	if (std::holds_alternative<NvmeStorageSelftestEntry>(value))
-		return hz::stream_cast<std::string>(std::get<NvmeStorageSelftestEntry>(value));
+	if (is_value_type<std::string>())
+		return get_value<std::string>();
+	if (is_value_type<int64_t>())
+		return hz::number_to_string_locale(get_value<int64_t>()) + (add_reported_too ? (" [" + reported_value + "]") : "");
+	if (is_value_type<bool>())
+		return std::string(get_value<bool>() ? "Yes" : "No") + (add_reported_too ? (" [" + reported_value + "]") : "");
+	if (is_value_type<std::chrono::seconds>())
+		return hz::format_time_length(get_value<std::chrono::seconds>()) + (add_reported_too ? (" [" + reported_value + "]") : "");
+	if (is_value_type<AtaStorageTextCapability>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageTextCapability>());
+	if (is_value_type<AtaStorageAttribute>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageAttribute>());
+	if (is_value_type<AtaStorageStatistic>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageStatistic>());
+	if (is_value_type<AtaStorageErrorBlock>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageErrorBlock>());
+	if (is_value_type<AtaStorageSelftestEntry>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageSelftestEntry>());
+	if (is_value_type<NvmeStorageSelftestEntry>())
+		return hz::stream_cast<std::string>(get_value<NvmeStorageSelftestEntry>());
+	if (is_value_type<AtaStorageTemperatureHistory>())
+		return hz::stream_cast<std::string>(get_value<AtaStorageTemperatureHistory>());
 
 	return "[internal_error]";
 }
@@ -393,16 +438,100 @@ std::string StorageProperty::format_value(bool add_reported_too) const
 
 std::string StorageProperty::get_description(bool clean) const
 {
+	ensure_description();
 	if (clean)
-		return this->description;
-	return (this->description.empty() ? "No description available" : this->description);
+		return this->description_.text.str();
+	return (this->description_.text.empty() ? "No description available" : this->description_.text.str());
+}
+
+
+
+const std::string& StorageProperty::get_description_ref() const
+{
+	ensure_description();
+	return this->description_.text.str();
 }
 
 
 
 void StorageProperty::set_description(const std::string& descr)
 {
-	this->description = descr;
+	this->description_.generator.store(nullptr, std::memory_order_relaxed);
+	this->description_.text = hz::SharedString(descr);
+}
+
+
+
+void StorageProperty::set_description_generator(DescriptionGenerator generator, StorageDeviceDetectedType device_type)
+{
+	this->description_.generator.store(generator, std::memory_order_relaxed);
+	this->description_.device_type = device_type;
+	this->description_.text = hz::SharedString();
+}
+
+
+
+bool StorageProperty::get_description_pending() const
+{
+	return this->description_.generator.load(std::memory_order_acquire) != nullptr;
+}
+
+
+
+void StorageProperty::ensure_description() const
+{
+	const auto generator = this->description_.generator.load(std::memory_order_acquire);
+	if (!generator)
+		return;
+
+	// Generate outside the lock, the generator may log or take other locks.
+	hz::SharedString text(generator(*this, this->description_.device_type));
+
+	std::scoped_lock lock(get_description_mutex());
+	// Another thread may have generated it while we were generating
+	if (this->description_.generator.load(std::memory_order_relaxed)) {
+		this->description_.text = std::move(text);
+		this->description_.generator.store(nullptr, std::memory_order_release);
+	}
+}
+
+
+
+StorageProperty::LazyDescription::LazyDescription(const LazyDescription& other)
+{
+	*this = other;
+}
+
+
+
+StorageProperty::LazyDescription& StorageProperty::LazyDescription::operator=(const LazyDescription& other)
+{
+	if (this == &other)
+		return *this;
+
+	// Another thread may be generating the description of other
+	std::unique_lock lock(get_description_mutex(), std::defer_lock);
+	if (other.generator.load(std::memory_order_acquire) != nullptr) {
+		lock.lock();
+	}
+	this->text = other.text;
+	this->generator.store(other.generator.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	this->device_type = other.device_type;
+	return *this;
+}
+
+
+
+StorageProperty::LazyDescription::LazyDescription(LazyDescription&& other) noexcept
+{
+	*this = other;
+}
+
+
+
+StorageProperty::LazyDescription& StorageProperty::LazyDescription::operator=(LazyDescription&& other) noexcept
+{
+	return (*this = other);
 }
 
 
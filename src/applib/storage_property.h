@@ -21,13 +21,18 @@ Copyright:
 #include <utility>
 #include <vector>
 #include <iosfwd>
+#include <atomic>
+#include <memory>
 #include <cstdint>
 #include <optional>
 #include <chrono>
+#include <type_traits>
 #include <variant>
 
 #include "warning_level.h"
+#include "storage_device_detected_type.h"
 #include "hz/enum_helper.h"
+#include "hz/string_pool.h"
 
 
 
@@ -39,6 +44,9 @@ class AtaStorageTextCapability {
 		uint16_t flag_value = 0x0;  ///< Flag value. This is one or sometimes two bytes (maybe more?)
 		std::string reported_strvalue;  ///< Original flag descriptions
 		std::vector<std::string> strvalues;  ///< A list of capabilities in the block.
+
+		/// Equality operator
+		bool operator==(const AtaStorageTextCapability& other) const = default;
 };
 
 
@@ -110,6 +118,9 @@ class AtaStorageAttribute {
 		std::string raw_value;  ///< Raw value as a string, as presented by smartctl (formatted).
 		std::int64_t raw_value_int = 0;  ///< Same as raw_value, but parsed as int64. original value is 6 bytes I think.
 
+		/// Equality operator
+		bool operator==(const AtaStorageAttribute& other) const = default;
+
 };
 
 
@@ -136,6 +147,9 @@ class AtaStorageStatistic {
 		std::int64_t value_int = 0;  ///< Same as value, but parsed as int64.
 		std::int64_t page = 0;  ///< Page
 		std::int64_t offset = 0;  ///< Offset in page
+
+		/// Equality operator
+		bool operator==(const AtaStorageStatistic& other) const = default;
 };
 
 
@@ -163,6 +177,9 @@ class AtaStorageErrorBlock {
 		std::vector<std::string> reported_types;  ///< Array of reported types (strings), e.g. "UNC".
 		std::string type_more_info;  ///< More info on error type (e.g. "at LBA = 0x0253eac0 = 39054016")
 		std::uint64_t lba = 0;  ///< LBA of the error
+
+		/// Equality operator
+		bool operator==(const AtaStorageErrorBlock& other) const = default;
 };
 
 
@@ -210,6 +227,9 @@ class AtaStorageSelftestEntry {
 		std::uint32_t lifetime_hours = 0;  ///< When the test happened (in lifetime hours). capability: unused.
 		std::string lba_of_first_error;  ///< LBA of the first error. "-" or value (format? usually hex). capability: unused.
 		bool passed = false;  ///< Test passed or not. capability: unused.
+
+		/// Equality operator
+		bool operator==(const AtaStorageSelftestEntry& other) const = default;
 };
 
 
@@ -349,6 +369,9 @@ class NvmeStorageSelftestEntry {
 		NvmeSelfTestResultType result = NvmeSelfTestResultType::Unknown;  ///< Test result
 		std::uint32_t power_on_hours = 0;  ///< When the test happened (in power-on hours).
 		std::optional<std::uint64_t> lba;  ///< LBA of the first error.
+
+		/// Equality operator
+		bool operator==(const NvmeStorageSelftestEntry& other) const = default;
 };
 
 
@@ -357,6 +380,24 @@ std::ostream& operator<< (std::ostream& os, const NvmeStorageSelftestEntry& b);
 
 
 
+/// SCT temperature history table.
+/// ATA only.
+class AtaStorageTemperatureHistory {
+	public:
+
+		std::int64_t logging_interval_minutes = 0;  ///< Time between the entries
+		std::vector<std::optional<std::int64_t>> temperatures;  ///< Temperatures (C), oldest first. std::nullopt for unused entries.
+
+		/// Equality operator
+		bool operator==(const AtaStorageTemperatureHistory& other) const = default;
+};
+
+
+/// Output operator for debug purposes
+std::ostream& operator<< (std::ostream& os, const AtaStorageTemperatureHistory& b);
+
+
+
 /// Sections in output
 enum class StoragePropertySection {
 	Unknown,  ///< Used when searching in all sections
@@ -419,21 +460,38 @@ struct StoragePropertySectionExt
 class StorageProperty {
 	public:
 
+		/// Shared immutable storage for large value types (log entries, attributes, etc.).
+		/// Keeping them out of line makes each property small, and lets copies of
+		/// the repository (caches, processed repositories) share them.
+		template<typename T>
+		using BoxedValue = std::shared_ptr<const T>;
+
 		using ValueVariantType = std::variant<
 			std::monostate,  ///< None
 			std::string,  ///< Value (if it's a string)
 			std::int64_t,   ///< Value (if it's an integer)
 			bool,  ///< Value (if it's bool)
 			std::chrono::seconds,  ///< Value in seconds (if it's time interval)
-			AtaStorageTextCapability,  ///< Value (if it's a capability)
-			AtaStorageAttribute,  ///< Value (if it's an attribute)
-			AtaStorageStatistic,  ///< Value (if it's a statistic from devstat)
-			AtaStorageErrorBlock,  ///< Value (if it's a error block)
-			AtaStorageSelftestEntry,  ///< Value (if it's ATA self-test log entry)
-			NvmeStorageSelftestEntry  ///< Value (if it's NVMe self-test log entry)
+			BoxedValue<AtaStorageTextCapability>,  ///< Value (if it's a capability)
+			BoxedValue<AtaStorageAttribute>,  ///< Value (if it's an attribute)
+			BoxedValue<AtaStorageStatistic>,  ///< Value (if it's a statistic from devstat)
+			BoxedValue<AtaStorageErrorBlock>,  ///< Value (if it's a error block)
+			BoxedValue<AtaStorageSelftestEntry>,  ///< Value (if it's ATA self-test log entry)
+			NvmeStorageSelftestEntry,  ///< Value (if it's NVMe self-test log entry)
+			BoxedValue<AtaStorageTemperatureHistory>  ///< Value (if it's SCT temperature history)
 		>;
 
 
+		/// Whether values of type T are stored in BoxedValue<T>
+		template<typename T>
+		static constexpr bool is_boxed_value_type = std::is_same_v<T, AtaStorageTextCapability>
+				|| std::is_same_v<T, AtaStorageAttribute>
+				|| std::is_same_v<T, AtaStorageStatistic>
+				|| std::is_same_v<T, AtaStorageErrorBlock>
+				|| std::is_same_v<T, AtaStorageSelftestEntry>
+				|| std::is_same_v<T, AtaStorageTemperatureHistory>;
+
+
 		/// Constructor
 		StorageProperty() = default;
 
@@ -451,6 +509,11 @@ class StorageProperty {
 		[[nodiscard]] bool empty() const;
 
 
+		/// Check if the value (and the reported value) of this property is the same as that of \c other.
+		/// Boxed values are compared by contents.
+		[[nodiscard]] bool value_equals(const StorageProperty& other) const;
+
+
 		/// Dump the property to a stream for debugging purposes
 		void dump(std::ostream& os, std::size_t internal_offset = 0) const;
 
@@ -469,14 +532,39 @@ class StorageProperty {
 		[[nodiscard]] bool is_value_type() const;
 
 
+		/// Set value of type T. Use this instead of assigning to \c value directly,
+		/// since large types have to be boxed.
+		template<typename T>
+		void set_value(T v);
+
+
+		/// Function returning the description of a property. See set_description_generator().
+		using DescriptionGenerator = std::string (*)(const StorageProperty& p, StorageDeviceDetectedType device_type);
+
+
 		/// Get property description (used in tooltips)
 		[[nodiscard]] std::string get_description(bool clean = false) const;
 
 
+		/// Get property description without copying it. Empty if not set.
+		[[nodiscard]] const std::string& get_description_ref() const;
+
+
 		/// Set property description (used in tooltips)
 		void set_description(const std::string& descr);
 
 
+		/// Make the description be set by \c generator on first access, instead of setting it now.
+		/// The first access may happen in any thread which reads the property (e.g. a shared repository),
+		/// the generation is serialized with the other accesses to pending descriptions.
+		/// The generator must not access the description of the property.
+		void set_description_generator(DescriptionGenerator generator, StorageDeviceDetectedType device_type);
+
+
+		/// Check whether the description is yet to be generated
+		[[nodiscard]] bool get_description_pending() const;
+
+
 		/// Set generic (internal) name, readable name, and smartctl-reported name (optional)
 		void set_name(const std::string& gen_name, const std::string& disp_name, const std::string& rep_name = "");
 
@@ -485,8 +573,6 @@ class StorageProperty {
 		std::string displayable_name;  ///< Readable property name. May be the same as reported_name, or something more user-readable. Possibly translatable.
 		std::string reported_name;  ///< Property name as reported by smartctl. Mainly used by Text parser.
 
-		std::string description;  ///< Property description (for tooltips, etc.). May contain markup.
-
 		StoragePropertySection section = StoragePropertySection::Unknown;  ///< Section this property belongs to
 
 		std::string reported_value;  ///< String representation of the value as reported
@@ -499,6 +585,44 @@ class StorageProperty {
 
 		bool show_in_ui = true;  ///< Whether to show this property in UI or not
 
+
+	private:
+
+		/// Set the description using the description generator, if there is one
+		void ensure_description() const;
+
+
+		/// Description which may be generated on first access. Copying it is safe while
+		/// another thread generates it.
+		struct LazyDescription {
+			/// Constructor
+			LazyDescription() = default;
+
+			/// Copy constructor
+			LazyDescription(const LazyDescription& other);
+
+			/// Copy assignment operator
+			LazyDescription& operator=(const LazyDescription& other);
+
+			/// Move constructor. Same as copying, but keeps StorageProperty nothrow-movable.
+			LazyDescription(LazyDescription&& other) noexcept;
+
+			/// Move assignment operator
+			LazyDescription& operator=(LazyDescription&& other) noexcept;
+
+			/// Destructor
+			~LazyDescription() = default;
+
+			/// Property description (for tooltips, etc.). May contain markup.
+			/// Descriptions are long and mostly the same for identical drives, so they're interned.
+			hz::SharedString text;
+
+			std::atomic<DescriptionGenerator> generator {nullptr};  ///< Sets the text on first access, if not nullptr
+			StorageDeviceDetectedType device_type = StorageDeviceDetectedType::Unknown;  ///< Passed to generator
+		};
+
+		mutable LazyDescription description_;  ///< Property description
+
 };
 
 
@@ -518,7 +642,11 @@ std::ostream& operator<< (std::ostream& os, const StorageProperty& p);
 template<typename T>
 const T& StorageProperty::get_value() const
 {
-	return std::get<T>(value);
+	if constexpr(is_boxed_value_type<T>) {
+		return *std::get<BoxedValue<T>>(value);
+	} else {
+		return std::get<T>(value);
+	}
 }
 
 
@@ -526,7 +654,23 @@ const T& StorageProperty::get_value() const
 template<typename T>
 bool StorageProperty::is_value_type() const
 {
-	return std::holds_alternative<T>(value);
+	if constexpr(is_boxed_value_type<T>) {
+		return std::holds_alternative<BoxedValue<T>>(value);
+	} else {
+		return std::holds_alternative<T>(value);
+	}
+}
+
+
+
+template<typename T>
+void StorageProperty::set_value(T v)
+{
+	if constexpr(is_boxed_value_type<T>) {
+		value = std::make_shared<const T>(std::move(v));
+	} else {
+		value = std::move(v);
+	}
 }
 
 
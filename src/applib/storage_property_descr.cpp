@@ -10,242 +10,270 @@ Copyright:
 /// @{
 
 //#include <glibmm.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <utility>
-//#include <vector>
-//#include <map>
-//#include <unordered_map>
-
-#include "hz/string_algo.h"  // string_replace_copy
-#include "applib/app_regex.h"
 
 #include "storage_property_descr.h"
+#include "storage_property_descr_rules.h"
 #include "warning_colors.h"
 #include "storage_property_descr_ata_attribute.h"
 #include "storage_property_descr_ata_statistic.h"
 #include "storage_property_descr_nvme_attribute.h"
+#include "smartctl_parse_cache.h"
+#include "hz/debug.h"
 
 
 namespace {
 
 
-	/// Check if a property matches a name (generic or reported)
-	inline bool name_match(StorageProperty& p, const std::string& name)
+	/// Description rules
+	constexpr StoragePropertyRuleTable description_rules(std::to_array<StoragePropertyDescriptionRule>({
+		// Section Info
+		{StoragePropertySection::Info, "model_family", "Model family (from smartctl database)"},
+		{StoragePropertySection::Info, "model_name", "Device model"},
+		{StoragePropertySection::Info, "serial_number", "Serial number, unique to each physical drive"},
+		{StoragePropertySection::Info, "user_capacity/bytes/_short", "User-serviceable drive capacity as reported to an operating system"},
+		{StoragePropertySection::Info, "user_capacity/bytes", "User-serviceable drive capacity as reported to an operating system"},
+		{StoragePropertySection::Info, "in_smartctl_database", "Whether the device is in smartctl database or not. "
+				"If it is, additional information may be provided; otherwise, Raw values of some attributes may be incorrectly formatted."},
+		{StoragePropertySection::Info, "smart_support/available", "Whether the device supports SMART. If not, then only very limited information will be available."},
+		{StoragePropertySection::Info, "smart_support/enabled", "Whether the device has SMART enabled. If not, most of the reported values will be incorrect."},
+		{StoragePropertySection::Info, "ata_aam/enabled", "Automatic Acoustic Management (AAM) feature"},
+		{StoragePropertySection::Info, "ata_aam/level", "Automatic Acoustic Management (AAM) level"},
+		{StoragePropertySection::Info, "ata_apm/enabled", "Automatic Power Management (APM) feature"},
+		{StoragePropertySection::Info, "ata_apm/level", "Advanced Power Management (APM) level"},
+		{StoragePropertySection::Info, "ata_dsn/enabled", "Device Statistics Notification (DSN) feature"},
+		{StoragePropertySection::Info, "power_mode", "Power mode at the time of query"},
+
+		{StoragePropertySection::OverallHealth, "smart_status/passed", "Overall health self-assessment test result. Note: If the drive passes this test, it doesn't mean it's OK. "
+				"However, if the drive doesn't pass it, then it's either already dead, or it's predicting its own failure within the next 24 hours. In this case do a backup immediately!"},
+
+		{StoragePropertySection::Capabilities, "ata_smart_data/offline_data_collection/status/_group", "Offline Data Collection (a.k.a. Offline test) is usually automatically performed when the device is idle or every fixed amount of time. "
+				"This should show if Automatic Offline Data Collection is enabled."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/offline_data_collection/completion_seconds", "Offline Data Collection (a.k.a. Offline test) is usually automatically performed when the device is idle or every fixed amount of time. "
+				"This value shows the estimated time required to perform this operation in idle conditions. A value of 0 means unsupported."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/self_test/polling_minutes/short", "This value shows the estimated time required to perform a short self-test in idle conditions. A value of 0 means unsupported."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/self_test/polling_minutes/extended", "This value shows the estimated time required to perform a long self-test in idle conditions. A value of 0 means unsupported."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/self_test/polling_minutes/conveyance", "This value shows the estimated time required to perform a conveyance self-test in idle conditions. "
+				"A value of 0 means unsupported."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/self_test/status/_group", "Status of the last self-test run."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/offline_data_collection/_group", "Drive properties related to Offline Data Collection and self-tests."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/capabilities/_group", "Drive properties related to SMART handling."},
+		{StoragePropertySection::Capabilities, "ata_smart_data/capabilities/error_logging_supported/_group", "Drive properties related to error logging."},
+		{StoragePropertySection::Capabilities, "ata_sct_capabilities/_group", "Drive properties related to temperature information."},
+
+		// Empty description - the displayable name is used
+		{StoragePropertySection::AtaAttributes, "ata_smart_attributes/revision", ""},
+
+		{StoragePropertySection::AtaErrorLog, "ata_smart_error_log/extended/revision", ""},
+		{StoragePropertySection::AtaErrorLog, "ata_smart_error_log/extended/count", "Number of errors in error log. Note: Some manufacturers may list completely harmless errors in this log "
+				"(e.g., command invalid, not implemented, etc.)."},
+// 		{StoragePropertySection::AtaErrorLog, "error_log_unsupported", "This device does not support error logging."},  // the property text already says that
+
+		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/extended/revision", ""},
+		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/standard/revision", ""},
+		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/extended/count", "Number of tests in selftest log. Note: The number of entries may be limited to the newest manual tests."},
+		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/standard/count", "Number of tests in selftest log. Note: The number of entries may be limited to the newest manual tests."},
+// 		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/_present", "This device does not support self-test logging."},  // the property text already says that
+
+		{StoragePropertySection::TemperatureLog, "_text_only/ata_sct_status/_not_present", "SCT support is needed for SCT temperature logging."},
+	}));
+
+
+
+	/// Check if a property reports a checksum error in smartctl output
+	inline bool is_checksum_error_property(const StorageProperty& p)
 	{
-		if (p.generic_name.empty()) {
-			return hz::string_to_lower_copy(p.reported_name) == hz::string_to_lower_copy(name);
-		}
-		return hz::string_to_lower_copy(p.generic_name) == hz::string_to_lower_copy(name);
+		return p.generic_name.find("_text_only/_checksum_error") != std::string::npos;
 	}
 
 
-	/// Check if a property matches a name (generic or reported) and if it does,
-	/// set a description on it.
-	inline bool auto_set(StorageProperty& p, const std::string& name, const char* descr)
+
+	/// Warning rules. For each property, the first rule with a satisfied condition is used.
+	constexpr StoragePropertyRuleTable warning_rules(std::to_array<StoragePropertyWarningRule>({
+		{StoragePropertySection::Info, "smart_support/available",
+				[](const StorageProperty& p) { return !p.get_value<bool>(); },
+				WarningLevel::Notice, "SMART is not supported. You won't be able to read any SMART information from this drive."},
+		{StoragePropertySection::Info, "smart_support/enabled",
+				[](const StorageProperty& p) { return !p.get_value<bool>(); },
+				WarningLevel::Notice, "SMART is disabled. You should enable it to read any SMART information from this drive. "
+						"Additionally, some drives do not log useful data with SMART disabled, so it's advisable to keep it always enabled."},
+		{StoragePropertySection::Info, "_text_only/info_warning", nullptr,
+				WarningLevel::Notice, "Your drive may be affected by the warning, please see the details."},
+
+		{StoragePropertySection::OverallHealth, "smart_status/passed",
+				[](const StorageProperty& p) { return !p.get_value<bool>(); },
+				WarningLevel::Alert, "The drive is reporting that it will FAIL very soon. Please back up as soon as possible!"},
+
+		// Note: The error list table doesn't display any descriptions, so if any
+		// error-entry related descriptions are added here, don't forget to enable
+		// the tooltips.
+		{StoragePropertySection::AtaErrorLog, "ata_smart_error_log/extended/count",
+				[](const StorageProperty& p) { return p.get_value<int64_t>() > 0; },
+				WarningLevel::Notice, "The drive is reporting internal errors. Usually this means uncorrectable data loss and similar severe errors. "
+						"Check the actual errors for details."},
+		{StoragePropertySection::AtaErrorLog, "_text_only/ata_smart_error_log/_not_present", nullptr,
+				WarningLevel::Notice, "The drive does not support error logging. This means that SMART error history is unavailable."},
+
+		// Don't include selftest warnings - they may be old or something.
+		// Self-tests are carried manually anyway, so the user is expected to check their status anyway.
+		{StoragePropertySection::SelftestLog, "ata_smart_self_test_log/_present", nullptr,
+				WarningLevel::Notice, "The drive does not support self-test logging. This means that SMART test results won't be logged."},
+
+		// Don't highlight SCT Unsupported as warning, it's harmless.
+// 		{StoragePropertySection::TemperatureLog, "_text_only/ata_sct_status/_not_present", nullptr,
+// 				WarningLevel::Notice, "The drive does not support SCT Temperature logging."},
+		// Current temperature
+		{StoragePropertySection::TemperatureLog, "ata_sct_status/temperature/current",
+				[](const StorageProperty& p) { return p.get_value<int64_t>() > 50; },  // 50C
+				WarningLevel::Notice, "The temperature of the drive is higher than 50 degrees Celsius. "
+						"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution."},
+	}));
+
+
+	/// User warning rules used by StoragePropertyProcessor
+	struct UserWarningRulesState {
+		std::mutex mutex;  ///< Protects the members below
+		std::shared_ptr<const StoragePropertyUserRules> rules = std::make_shared<const StoragePropertyUserRules>();  ///< Rules
+	};
+
+
+	/// Get user warning rules state
+	UserWarningRulesState& get_user_warning_rules_state()
 	{
-		if (name_match(p, name)) {
-			p.set_description(descr);
-			return true;
-		}
-		return false;
+		static UserWarningRulesState state;
+		return state;
 	}
 
 }
 
 
 
-bool storage_property_autoset_description(StorageProperty& p, StorageDeviceDetectedType device_type)
+bool storage_property_get_description(const StorageProperty& p, StorageDeviceDetectedType device_type, std::string& description)
 {
-	bool found = false;
-
-
 	// checksum errors first
-	if (p.generic_name.find("_text_only/_checksum_error") != std::string::npos) {
-		p.set_description("Checksum errors indicate that SMART data is invalid. This shouldn't happen in normal circumstances.");
-		found = true;
-
-	// Section Info
-	} else {
-		switch (p.section) {
-			case StoragePropertySection::Info:
-				found = auto_set(p, "model_family", "Model family (from smartctl database)")
-				|| auto_set(p, "model_name", "Device model")
-				|| auto_set(p, "serial_number", "Serial number, unique to each physical drive")
-				|| auto_set(p, "user_capacity/bytes/_short", "User-serviceable drive capacity as reported to an operating system")
-				|| auto_set(p, "user_capacity/bytes", "User-serviceable drive capacity as reported to an operating system")
-				|| auto_set(p, "in_smartctl_database", "Whether the device is in smartctl database or not. "
-						"If it is, additional information may be provided; otherwise, Raw values of some attributes may be incorrectly formatted.")
-				|| auto_set(p, "smart_support/available", "Whether the device supports SMART. If not, then only very limited information will be available.")
-				|| auto_set(p, "smart_support/enabled", "Whether the device has SMART enabled. If not, most of the reported values will be incorrect.")
-				|| auto_set(p, "ata_aam/enabled", "Automatic Acoustic Management (AAM) feature")
-				|| auto_set(p, "ata_aam/level", "Automatic Acoustic Management (AAM) level")
-				|| auto_set(p, "ata_apm/enabled", "Automatic Power Management (APM) feature")
-				|| auto_set(p, "ata_apm/level", "Advanced Power Management (APM) level")
-				|| auto_set(p, "ata_dsn/enabled", "Device Statistics Notification (DSN) feature")
-				|| auto_set(p, "power_mode", "Power mode at the time of query");
-
-				// set just its name as a tooltip
-				if (!found) {
-					p.set_description(p.displayable_name);
-					found = true;
-				}
-				break;
+	if (is_checksum_error_property(p)) {
+		description = "Checksum errors indicate that SMART data is invalid. This shouldn't happen in normal circumstances.";
+		return true;
+	}
 
-			case StoragePropertySection::OverallHealth:
-				found = auto_set(p, "smart_status/passed", "Overall health self-assessment test result. Note: If the drive passes this test, it doesn't mean it's OK. "
-						"However, if the drive doesn't pass it, then it's either already dead, or it's predicting its own failure within the next 24 hours. In this case do a backup immediately!");
-				break;
+	bool found = false;
+	if (const auto* rule = description_rules.find(StoragePropertyRuleKey(p))) {
+		description = (rule->description.empty() ? p.displayable_name : std::string(rule->description));
+		found = true;
+	}
 
-			case StoragePropertySection::Capabilities:
-				found = auto_set(p, "ata_smart_data/offline_data_collection/status/_group", "Offline Data Collection (a.k.a. Offline test) is usually automatically performed when the device is idle or every fixed amount of time. "
-						"This should show if Automatic Offline Data Collection is enabled.")
-				|| auto_set(p, "ata_smart_data/offline_data_collection/completion_seconds", "Offline Data Collection (a.k.a. Offline test) is usually automatically performed when the device is idle or every fixed amount of time. "
-						"This value shows the estimated time required to perform this operation in idle conditions. A value of 0 means unsupported.")
-				|| auto_set(p, "ata_smart_data/self_test/polling_minutes/short", "This value shows the estimated time required to perform a short self-test in idle conditions. A value of 0 means unsupported.")
-				|| auto_set(p, "ata_smart_data/self_test/polling_minutes/extended", "This value shows the estimated time required to perform a long self-test in idle conditions. A value of 0 means unsupported.")
-				|| auto_set(p, "ata_smart_data/self_test/polling_minutes/conveyance", "This value shows the estimated time required to perform a conveyance self-test in idle conditions. "
-						"A value of 0 means unsupported.")
-				|| auto_set(p, "ata_smart_data/self_test/status/_group", "Status of the last self-test run.")
-				|| auto_set(p, "ata_smart_data/offline_data_collection/_group", "Drive properties related to Offline Data Collection and self-tests.")
-				|| auto_set(p, "ata_smart_data/capabilities/_group", "Drive properties related to SMART handling.")
-				|| auto_set(p, "ata_smart_data/capabilities/error_logging_supported/_group", "Drive properties related to error logging.")
-				|| auto_set(p, "ata_sct_capabilities/_group", "Drive properties related to temperature information.");
-				break;
+	switch (p.section) {
+		case StoragePropertySection::Info:
+			// set just its name as a tooltip
+			if (!found) {
+				description = p.displayable_name;
+				found = true;
+			}
+			break;
 
-			case StoragePropertySection::AtaAttributes:
-				found = auto_set(p, "ata_smart_attributes/revision", p.displayable_name.c_str());
-				if (!found) {
-					auto_set_ata_attribute_description(p, device_type);
-					found = true;  // true, because auto_set_attr() may set "Unknown attribute", which is still "found".
-				}
-				break;
+		case StoragePropertySection::AtaAttributes:
+			if (!found) {
+				description = get_ata_attribute_description(p, device_type);
+				found = true;  // true, because auto_set_attr() may set "Unknown attribute", which is still "found".
+			}
+			break;
 
-			case StoragePropertySection::Statistics:
-				found = auto_set_ata_statistic_description(p);
-				break;
+		case StoragePropertySection::Statistics:
+			found = get_ata_statistic_description(p, description);
+			break;
 
-			case StoragePropertySection::AtaErrorLog:
-				found = auto_set(p, "ata_smart_error_log/extended/revision", p.displayable_name.c_str())
-				|| auto_set(p, "ata_smart_error_log/extended/count", "Number of errors in error log. Note: Some manufacturers may list completely harmless errors in this log "
-					"(e.g., command invalid, not implemented, etc.).");
-// 				|| auto_set(p, "error_log_unsupported", "This device does not support error logging.");  // the property text already says that
-				if (p.is_value_type<AtaStorageErrorBlock>()) {
-					if (!p.get_value<AtaStorageErrorBlock>().reported_types.empty()) {  // Text parser only
-						p.set_description(AtaStorageErrorBlock::format_readable_error_types(
-								p.get_value<AtaStorageErrorBlock>().reported_types));
-					}
-					/// TODO JSON parser
-					found = true;
+		case StoragePropertySection::AtaErrorLog:
+			if (p.is_value_type<AtaStorageErrorBlock>()) {
+				if (!p.get_value<AtaStorageErrorBlock>().reported_types.empty()) {  // Text parser only
+					description = AtaStorageErrorBlock::format_readable_error_types(
+							p.get_value<AtaStorageErrorBlock>().reported_types);
 				}
-				break;
-
-			case StoragePropertySection::SelftestLog:
-				found = auto_set(p, "ata_smart_self_test_log/extended/revision", p.displayable_name.c_str())
-				|| auto_set(p, "ata_smart_self_test_log/standard/revision", p.displayable_name.c_str())
-				|| auto_set(p, "ata_smart_self_test_log/extended/count", "Number of tests in selftest log. Note: The number of entries may be limited to the newest manual tests.")
-				|| auto_set(p, "ata_smart_self_test_log/standard/count", "Number of tests in selftest log. Note: The number of entries may be limited to the newest manual tests.");
-		// 		|| auto_set(p, "ata_smart_self_test_log/_present", "This device does not support self-test logging.");  // the property text already says that
-				break;
-
-			case StoragePropertySection::SelectiveSelftestLog:
-				// nothing here
-				break;
+				/// TODO JSON parser
+				found = true;
+			}
+			break;
+
+		case StoragePropertySection::NvmeAttributes:
+			found = get_nvme_attribute_description(p, description);
+			break;
+
+		case StoragePropertySection::OverallHealth:
+		case StoragePropertySection::Capabilities:
+		case StoragePropertySection::SelftestLog:
+		case StoragePropertySection::SelectiveSelftestLog:
+		case StoragePropertySection::TemperatureLog:
+		case StoragePropertySection::NvmeHealth:
+		case StoragePropertySection::NvmeErrorLog:
+		case StoragePropertySection::ErcLog:
+		case StoragePropertySection::PhyLog:
+		case StoragePropertySection::DirectoryLog:
+		case StoragePropertySection::Unknown:
+			// rules only
+			break;
+	}
 
-			case StoragePropertySection::TemperatureLog:
-				found = auto_set(p, "_text_only/ata_sct_status/_not_present", "SCT support is needed for SCT temperature logging.");
-				break;
+	return found;
+}
 
-			case StoragePropertySection::NvmeHealth:
-			case StoragePropertySection::NvmeErrorLog:
-				break;
 
-			case StoragePropertySection::NvmeAttributes:
-				found = auto_set_nvme_attribute_description(p);
-				break;
 
-			case StoragePropertySection::ErcLog:
-			case StoragePropertySection::PhyLog:
-			case StoragePropertySection::DirectoryLog:
-			case StoragePropertySection::Unknown:
-				// nothing
-				break;
-		}
+bool storage_property_autoset_description(StorageProperty& p, StorageDeviceDetectedType device_type)
+{
+	std::string description;
+	const bool found = storage_property_get_description(p, device_type, description);
+	if (!description.empty()) {
+		p.set_description(description);
 	}
-
+	storage_property_autoset_names(p, device_type);
 	return found;
 }
 
 
 
 
-void storage_property_autoset_warning(StorageProperty& p)
+void storage_property_autoset_warning(StorageProperty& p, const StoragePropertyUserRules* user_rules)
 {
 	std::optional<WarningLevel> w;
 	std::string reason;
 
 	// checksum errors first
-	if (p.generic_name.find("_text_only/_checksum_error") != std::string::npos) {
+	if (is_checksum_error_property(p)) {
 		w = WarningLevel::Warning;
 		reason = "The drive may have a broken implementation of SMART, or it's failing.";
 
+	// User rules replace the built-in ones, but not the failures reported by the drive
+	} else if (user_rules && user_rules->has_rules_for(p)) {
+		const auto* rule = user_rules->find_matching(p);
+		p.warning_level = (rule ? rule->warning_level : WarningLevel::None);
+		p.warning_reason = (rule ? rule->reason : std::string());
+		storage_property_ata_attribute_autoset_failure_warning(p);
+		return;
 
-	// Section Info
 	} else {
-		switch (p.section) {
-			case StoragePropertySection::Info:
-				if (name_match(p, "smart_support/available") && !p.get_value<bool>()) {
-					w = WarningLevel::Notice;
-					reason = "SMART is not supported. You won't be able to read any SMART information from this drive.";
-
-				} else if (name_match(p, "smart_support/enabled") && !p.get_value<bool>()) {
-					w = WarningLevel::Notice;
-					reason = "SMART is disabled. You should enable it to read any SMART information from this drive. "
-							 "Additionally, some drives do not log useful data with SMART disabled, so it's advisable to keep it always enabled.";
-
-				} else if (name_match(p, "_text_only/info_warning")) {
-					w = WarningLevel::Notice;
-					reason = "Your drive may be affected by the warning, please see the details.";
-				}
-				break;
-
-			case StoragePropertySection::OverallHealth:
-				if (name_match(p, "smart_status/passed") && !p.get_value<bool>()) {
-					w = WarningLevel::Alert;
-					reason = "The drive is reporting that it will FAIL very soon. Please back up as soon as possible!";
-				}
-				break;
-
-			case StoragePropertySection::Capabilities:
-				// nothing
-				break;
+		const auto* rule = warning_rules.find_if(StoragePropertyRuleKey(p),
+				[&p](const StoragePropertyWarningRule& r) { return r.condition_matches(p); });
+		if (rule) {
+			w = rule->warning_level;
+			reason = rule->reason;
+		}
 
+		switch (p.section) {
 			case StoragePropertySection::AtaAttributes:
-			{
 				storage_property_ata_attribute_autoset_warning(p);
 				break;
-			}
 
 			case StoragePropertySection::Statistics:
-			{
 				storage_property_ata_statistic_autoset_warning(p);
 				break;
-			}
 
 			case StoragePropertySection::AtaErrorLog:
 			{
-				// Note: The error list table doesn't display any descriptions, so if any
-				// error-entry related descriptions are added here, don't forget to enable
-				// the tooltips.
-
-				if (name_match(p, "ata_smart_error_log/extended/count") && p.get_value<int64_t>() > 0) {
-					w = WarningLevel::Notice;
-					reason = "The drive is reporting internal errors. Usually this means uncorrectable data loss and similar severe errors. "
-							"Check the actual errors for details.";
-
-				} else if (name_match(p, "_text_only/ata_smart_error_log/_not_present")) {
-					w = WarningLevel::Notice;
-					reason = "The drive does not support error logging. This means that SMART error history is unavailable.";
-				}
-
 				// Rate individual error log entries.
 				if (p.is_value_type<AtaStorageErrorBlock>()) {
 					const auto& eb = p.get_value<AtaStorageErrorBlock>();
@@ -263,60 +291,26 @@ void storage_property_autoset_warning(StorageProperty& p)
 						}
 					}
 				}
-
 				break;
 			}
 
-			case StoragePropertySection::SelftestLog:
-			{
-				// Note: The error list table doesn't display any descriptions, so if any
-				// error-entry related descriptions are added here, don't forget to enable
-				// the tooltips.
-
-				// Don't include selftest warnings - they may be old or something.
-				// Self-tests are carried manually anyway, so the user is expected to check their status anyway.
-
-				if (name_match(p, "ata_smart_self_test_log/_present")) {
-					w = WarningLevel::Notice;
-					reason = "The drive does not support self-test logging. This means that SMART test results won't be logged.";
-				}
+			case StoragePropertySection::NvmeAttributes:
+				storage_property_nvme_attribute_autoset_warning(p);
 				break;
-			}
 
+			case StoragePropertySection::Info:
+			case StoragePropertySection::OverallHealth:
+			case StoragePropertySection::Capabilities:
+			case StoragePropertySection::SelftestLog:
 			case StoragePropertySection::SelectiveSelftestLog:
-				// nothing here
-				break;
-
 			case StoragePropertySection::TemperatureLog:
-				// Don't highlight SCT Unsupported as warning, it's harmless.
-// 				if (name_match(p, "_text_only/ata_sct_status/_not_present") && p.value_bool) {
-// 					w = WarningLevel::notice;
-// 					reason = "The drive does not support SCT Temperature logging.";
-// 				}
-				// Current temperature
-				if (name_match(p, "ata_sct_status/temperature/current") && p.get_value<int64_t>() > 50) {  // 50C
-					w = WarningLevel::Notice;
-					reason = "The temperature of the drive is higher than 50 degrees Celsius. "
-							"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
-				}
-				break;
-
 			case StoragePropertySection::NvmeHealth:
 			case StoragePropertySection::NvmeErrorLog:
-				break;
-
-			case StoragePropertySection::NvmeAttributes:
-			{
-				storage_property_nvme_attribute_autoset_warning(p);
-				break;
-			}
-
 			case StoragePropertySection::ErcLog:
 			case StoragePropertySection::PhyLog:
 			case StoragePropertySection::DirectoryLog:
 			case StoragePropertySection::Unknown:
-//			case AtaStoragePropertySection::Internal:
-				// nothing here
+				// rules only
 				break;
 		}
 	}
@@ -329,13 +323,31 @@ void storage_property_autoset_warning(StorageProperty& p)
 
 
 
-/// Append warning text to description and set it on the property
-inline void storage_property_autoset_warning_descr(StorageProperty& p)
+void storage_property_autoset_names(StorageProperty& p, StorageDeviceDetectedType device_type)
 {
-	std::string reason = storage_property_get_warning_reason(p);
+	if (is_checksum_error_property(p)) {
+		return;
+	}
+	if (p.section == StoragePropertySection::AtaAttributes && p.is_value_type<AtaStorageAttribute>()) {
+		auto_set_ata_attribute_names(p, device_type);
+	} else if (p.section == StoragePropertySection::Statistics) {
+		auto_set_ata_statistic_names(p);
+	}
+}
+
+
+
+std::string storage_property_generate_description(const StorageProperty& p, StorageDeviceDetectedType device_type)
+{
+	std::string description;
+	storage_property_get_description(p, device_type, description);
+
+	// append warning to description
+	const std::string reason = storage_property_get_warning_reason(p);
 	if (!reason.empty()) {
-		p.set_description(p.get_description() + "\n\n" + reason);
+		description = (description.empty() ? std::string("No description available") : description) + "\n\n" + reason;
 	}
+	return description;
 }
 
 
@@ -343,14 +355,62 @@ inline void storage_property_autoset_warning_descr(StorageProperty& p)
 StoragePropertyRepository StoragePropertyProcessor::process_properties(
 		StoragePropertyRepository properties, StorageDeviceDetectedType device_type)
 {
-	for (auto& p : properties.get_properties_ref()) {
-		storage_property_autoset_description(p, device_type);
-		storage_property_autoset_warning(p);
-		storage_property_autoset_warning_descr(p);  // append warning to description
+	const auto user_rules = get_user_warning_rules();
+	return process_properties(std::move(properties), device_type, *user_rules);
+}
+
+
+
+StoragePropertyRepository StoragePropertyProcessor::process_properties(StoragePropertyRepository properties,
+		StorageDeviceDetectedType device_type, const StoragePropertyUserRules& user_rules)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+
+	// Select the user rules for this drive model once, so that each property is a lookup
+	std::optional<StoragePropertyUserRules> model_rules;
+	if (!user_rules.empty()) {
+		const auto* model_prop = properties.find_property("model_name");
+		model_rules = user_rules.select_for_model(
+				(model_prop && model_prop->is_value_type<std::string>()) ? model_prop->get_value<std::string>() : std::string());
 	}
+	const StoragePropertyUserRules* rules = (model_rules.has_value() && !model_rules->empty()) ? &model_rules.value() : nullptr;
+
+	properties.modify_properties([device_type, rules](StorageProperty& p) {
+		storage_property_autoset_names(p, device_type);
+		// Warning levels are needed right away for tab and icon highlighting
+		storage_property_autoset_warning(p, rules);
+		p.set_description_generator(&storage_property_generate_description, device_type);
+	});
+
+	debug_out_dump("app", DBG_FUNC_MSG << "Evaluated name and warning rules on " << properties.get_properties().size()
+			<< " properties (" << (rules ? rules->size() : 0) << " user rules) in "
+			<< std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count() << " us.\n");
+
 	return properties;
 }
 
 
 
+void StoragePropertyProcessor::set_user_warning_rules(StoragePropertyUserRules rules)
+{
+	{
+		auto& state = get_user_warning_rules_state();
+		const std::scoped_lock lock(state.mutex);
+		state.rules = std::make_shared<const StoragePropertyUserRules>(std::move(rules));
+	}
+	// Cached processed properties were evaluated with the old rules
+	SmartctlParseCache::clear();
+}
+
+
+
+std::shared_ptr<const StoragePropertyUserRules> StoragePropertyProcessor::get_user_warning_rules()
+{
+	auto& state = get_user_warning_rules_state();
+	const std::scoped_lock lock(state.mutex);
+	return state.rules;
+}
+
+
+
 /// @}
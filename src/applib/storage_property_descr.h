@@ -12,20 +12,66 @@ Copyright:
 #ifndef STORAGE_PROPERTY_DESCR_H
 #define STORAGE_PROPERTY_DESCR_H
 
+#include <memory>
+#include <string>
+
 #include "storage_property_repository.h"
+#include "storage_property_user_rules.h"
 #include "storage_device_detected_type.h"
 
 
 
+/// Get the description of a property, depending on its section and name. The property is not modified.
+/// \c description is left empty if there is none.
+/// \return true if the property is known.
+bool storage_property_get_description(const StorageProperty& p, StorageDeviceDetectedType device_type, std::string& description);
+
+
+/// Set a description on a property, depending on its section and name.
+/// \return true if the property is known.
+bool storage_property_autoset_description(StorageProperty& p, StorageDeviceDetectedType device_type);
+
+
+/// Set a warning level and a warning reason on a property, depending on its section, name and value.
+/// If \c user_rules has rules for the property, they are used instead of the built-in ones.
+void storage_property_autoset_warning(StorageProperty& p, const StoragePropertyUserRules* user_rules = nullptr);
+
+
+/// Set generic and displayable names on a property if they come from a description database
+/// (ATA attributes and statistics). The warnings depend on these names.
+/// storage_property_autoset_description() sets them as well.
+void storage_property_autoset_names(StorageProperty& p, StorageDeviceDetectedType device_type);
+
+
+/// Get the description of a property, with the warning reason appended to it.
+/// This is the description generator used by StoragePropertyProcessor.
+std::string storage_property_generate_description(const StorageProperty& p, StorageDeviceDetectedType device_type);
+
 
 
 class StoragePropertyProcessor {
 	public:
 
-		/// Set descriptions, warnings, etc. on properties, and return them.
+		/// Set names and warnings on properties, and return them.
+		/// The descriptions (and the warning reasons appended to them) are mostly seen only in tooltips,
+		/// so they are generated on first access (see StorageProperty::set_description_generator()).
+		/// The user warning rules set with set_user_warning_rules() are used.
 		static StoragePropertyRepository process_properties(StoragePropertyRepository properties,
 				StorageDeviceDetectedType device_type);
 
+		/// Same as above, but using the specified user warning rules.
+		/// The time spent on evaluating the rules is reported to the debug log.
+		static StoragePropertyRepository process_properties(StoragePropertyRepository properties,
+				StorageDeviceDetectedType device_type, const StoragePropertyUserRules& user_rules);
+
+
+		/// Set the user warning rules (usually loaded from config). This clears SmartctlParseCache,
+		/// since the cached properties were processed with the old rules. Thread-safe.
+		static void set_user_warning_rules(StoragePropertyUserRules rules);
+
+		/// Get the user warning rules. Thread-safe.
+		[[nodiscard]] static std::shared_ptr<const StoragePropertyUserRules> get_user_warning_rules();
+
 };
 
 
@@ -10,17 +10,22 @@ Copyright:
 /// @{
 
 #include <glibmm.h>
-#include <utility>
-#include <vector>
-#include <map>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 #include <unordered_map>
 
+#include "hz/perfect_hash.h"
 #include "hz/string_algo.h"  // string_replace_copy
 #include "applib/app_regex.h"
 
 #include "storage_property_descr_ata_attribute.h"
 //#include "warning_colors.h"
 #include "storage_property_descr_helpers.h"
+#include "storage_property_descr_rules.h"
 #include "hz/string_num.h"
 
 
@@ -30,32 +35,36 @@ namespace {
 
 	/// Attribute description for attribute database
 	struct AtaAttributeDescription {
-		/// Constructor
-		AtaAttributeDescription() = default;
-
-		/// Constructor
-		AtaAttributeDescription(int32_t id_, std::optional<StorageDeviceDetectedType> type, std::string reported_name_,
-				std::string displayable_name_, std::string generic_name_, std::string description_)
-				: id(id_), drive_type(type), reported_name(std::move(reported_name_)), displayable_name(std::move(displayable_name_)),
-				generic_name(std::move(generic_name_)), description(std::move(description_))
-		{ }
-
 		int32_t id = -1;  ///< e.g. 190
 		std::optional<StorageDeviceDetectedType> drive_type;  ///< HDD-only, SSD-only or universal attribute
-		std::string reported_name;  ///< e.g. Airflow_Temperature_Cel
-		std::string displayable_name;  ///< e.g. Airflow Temperature (C). This is a translatable string.
-		std::string generic_name;  ///< Generic name to be set on the property, e.g. "airflow_temperature". For lookups.
-		std::string description;  ///< Attribute description, can be empty.
+		std::string_view reported_name;  ///< e.g. Airflow_Temperature_Cel
+		std::string_view displayable_name;  ///< e.g. Airflow Temperature (C). This is a translatable string.
+		std::string_view generic_name;  ///< Generic name to be set on the property, e.g. "airflow_temperature". For lookups.
+		std::string_view description;  ///< Attribute description, can be empty.
+		bool uncorrectable_suffix = false;  ///< Append get_suffix_for_uncorrectable_property_description() to description
 	};
 
 
 
-	/// Attribute description database
+	/// Description has get_suffix_for_uncorrectable_property_description() appended to it
+	constexpr bool with_uncorrectable_suffix = true;
+
+
+
+	/// Attribute description database. It's built at compile time, together with
+	/// a perfect hash index on (id, drive type, case-folded smartctl name).
 	class AtaAttributeDescriptionDatabase {
 		public:
 
+			/// Maximum number of descriptions
+			static constexpr std::size_t max_descriptions = 400;
+
+			/// Maximum attribute ID + 1
+			static constexpr std::size_t max_ids = 256;
+
+
 			/// Constructor
-			AtaAttributeDescriptionDatabase()
+			constexpr AtaAttributeDescriptionDatabase()
 			{
 				// Note: The first one with the same ID is the one displayed in case smartctl
 				// doesn't return a name. See atacmds.cpp (get_default_attr_name()) in smartmontools.
@@ -89,8 +98,8 @@ namespace {
 						"Number of start/stop cycles of a spindle (Raw value). That is, number of drive spin-ups.");
 				// Reallocated Sector Count (smartctl)
 				add(5, StorageDeviceDetectedType::AtaHdd, "Reallocated_Sector_Ct", "Reallocated Sector Count", "attr_reallocated_sector_count",
-						"Number of reallocated sectors (Raw value). Non-zero Raw value indicates a disk surface failure."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"Number of reallocated sectors (Raw value). Non-zero Raw value indicates a disk surface failure.",
+						with_uncorrectable_suffix);
 				// SSD: Reallocated Sector Count (smartctl)
 				add(5, StorageDeviceDetectedType::AtaSsd, "Reallocated_Sector_Ct", "Reallocated Sector Count", "attr_reallocated_sector_count",
 						"Number of reallocated sectors (Raw value). High Raw value indicates an old age for an SSD.");
@@ -516,8 +525,8 @@ namespace {
 				// Reallocation Event Count (smartctl)
 				add(196, std::nullopt, "Reallocated_Event_Count", "Reallocation Event Count", "attr_reallocation_event_count",
 						"Number of reallocation (remap) operations. Raw value <i>should</i> show the total number of attempts "
-						"(both successful and unsuccessful) to reallocate sectors. An increase in Raw value indicates a disk surface failure."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"(both successful and unsuccessful) to reallocate sectors. An increase in Raw value indicates a disk surface failure.",
+						with_uncorrectable_suffix);
 				// Indilinx Barefoot SSD: Erase_Failure_Blk_Ct (smartctl) (description?)
 				add(196, StorageDeviceDetectedType::AtaSsd, "Erase_Failure_Blk_Ct", "Erase Failure Block Count", "",
 						"Number of flash erase failures.");
@@ -528,8 +537,8 @@ namespace {
 				add(197, "Current_Pending_Sector", "Current Pending Sector Count", "attr_current_pending_sector_count",
 						"Number of &quot;unstable&quot; (waiting to be remapped) sectors (Raw value). "
 						"If the unstable sector is subsequently read from or written to successfully, this value is decreased and the sector is not remapped. "
-						"An increase in Raw value indicates a disk surface failure."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"An increase in Raw value indicates a disk surface failure.",
+						with_uncorrectable_suffix);
 				// Indilinx Barefoot SSD: Read_Failure_Blk_Ct (smartctl) (description?)
 				add(197, StorageDeviceDetectedType::AtaSsd, "Read_Failure_Blk_Ct", "Read Failure Block Count", "",
 						"Number of blocks that failed to be read.");
@@ -537,8 +546,8 @@ namespace {
 				// unlike Current_Pending_Sector, this won't decrease on reallocation.
 				add(197, "Total_Pending_Sectors", "Total Pending Sectors", "attr_total_pending_sectors",
 						"Number of &quot;unstable&quot; (waiting to be remapped) sectors and already remapped sectors (Raw value). "
-						"An increase in Raw value indicates a disk surface failure."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"An increase in Raw value indicates a disk surface failure.",
+						with_uncorrectable_suffix);
 				// OCZ SSD (smartctl)
 				add(197, StorageDeviceDetectedType::AtaSsd, "Total_Unc_Read_Failures", "Total Uncorrectable Read Failures", "",
 						"");
@@ -547,14 +556,14 @@ namespace {
 						"Number of sectors which couldn't be corrected during Offline Data Collection (Raw value). "
 						"An increase in Raw value indicates a disk surface failure. "
 						"The value may be decreased automatically when the errors are corrected (e.g., when an unreadable sector is "
-						"reallocated and the next Offline test is run to see the change)."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"reallocated and the next Offline test is run to see the change).",
+						with_uncorrectable_suffix);
 				// Samsung: Offline Uncorrectable (smartctl). From smartctl man page:
 				// unlike Current_Pending_Sector, this won't decrease on reallocation.
 				add(198, "Total_Offl_Uncorrectabl", "Total Offline Uncorrectable", "attr_total_attr_offline_uncorrectable",
 						"Number of sectors which couldn't be corrected during Offline Data Collection (Raw value), currently and in the past. "
-						"An increase in Raw value indicates a disk surface failure."
-						"\n\n" + get_suffix_for_uncorrectable_property_description());
+						"An increase in Raw value indicates a disk surface failure.",
+						with_uncorrectable_suffix);
 				// Sandforce SSD: Uncorrectable_Sector_Ct (smartctl) (same description?)
 				add(198, StorageDeviceDetectedType::AtaSsd, "Uncorrectable_Sector_Ct");
 				// Indilinx Barefoot SSD: Read_Sectors_Tot_Ct (smartctl) (description?)
@@ -1040,187 +1049,351 @@ namespace {
 				// Free Fall Protection (smartctl) (seagate laptop drives)
 				add(254, StorageDeviceDetectedType::AtaHdd, "Free_Fall_Sensor", "Free Fall Protection", "",
 						"Number of free fall events detected by accelerometer sensor.");
+
+				build_index();
 			}
 
 
 			/// Add an attribute description to the attribute database
-			void add(AtaAttributeDescription descr)
+			constexpr void add(const AtaAttributeDescription& descr)
 			{
-				id_db[descr.id].emplace_back(std::move(descr));
+				if (size_ >= max_descriptions || descr.id < 0 || std::size_t(descr.id) >= max_ids) {
+					throw std::out_of_range("Invalid attribute description.");
+				}
+				descriptions_[size_++] = descr;
 			}
 
 
 			/// Add an attribute description to the attribute database
-			void add(int32_t id, std::string reported_name, std::string displayable_name,
-					std::string generic_name, std::string description)
+			constexpr void add(int32_t id, std::string_view reported_name, std::string_view displayable_name,
+					std::string_view generic_name, std::string_view description, bool uncorrectable_suffix = false)
 			{
-				add(AtaAttributeDescription(id, std::nullopt,
-						std::move(reported_name), std::move(displayable_name), std::move(generic_name), std::move(description)));
+				add(AtaAttributeDescription{id, std::nullopt, reported_name, displayable_name, generic_name, description, uncorrectable_suffix});
 			}
 
 
-			/// Add a previously added description to the attribute database under a
-			/// different smartctl name (fill the other members from the previous attribute).
-// 			void add(int32_t id, const std::string& reported_name)
-// 			{
-// 				auto iter = id_db.find(id);
-// 				DBG_ASSERT(iter != id_db.end() && !iter->second.empty());
-// 				if (iter != id_db.end() || iter->second.empty()) {
-// 					AttributeDescription attr = iter->second.front();
-// 					add(AttributeDescription(id, std::nullopt, reported_name, attr.displayable_name, attr.generic_name, attr.description));
-// 				}
-// 			}
-
 			/// Add an attribute description to the attribute database
-			void add(int32_t id, std::optional<StorageDeviceDetectedType> type, std::string reported_name, std::string displayable_name,
-					std::string generic_name, std::string description)
+			constexpr void add(int32_t id, std::optional<StorageDeviceDetectedType> type, std::string_view reported_name, std::string_view displayable_name,
+					std::string_view generic_name, std::string_view description, bool uncorrectable_suffix = false)
 			{
-				add(AtaAttributeDescription(id, type, std::move(reported_name), std::move(displayable_name), std::move(generic_name), std::move(description)));
+				add(AtaAttributeDescription{id, type, reported_name, displayable_name, generic_name, description, uncorrectable_suffix});
 			}
 
 
 			/// Add a previously added description to the attribute database under a
 			/// different smartctl name (fill the other members from the previous attribute).
-			void add(int32_t id, std::optional<StorageDeviceDetectedType> type, std::string reported_name)
+			constexpr void add(int32_t id, std::optional<StorageDeviceDetectedType> type, std::string_view reported_name)
 			{
-				auto iter = id_db.find(id);
-				DBG_ASSERT(iter != id_db.end() && !iter->second.empty());
-				if (iter != id_db.end() && !iter->second.empty()) {
-					AtaAttributeDescription attr = iter->second.front();
-					add(AtaAttributeDescription(id, type,
-							std::move(reported_name), std::move(attr.displayable_name), std::move(attr.generic_name), std::move(attr.description)));
+				for (std::size_t i = 0; i < size_; ++i) {
+					if (descriptions_[i].id == id) {
+						AtaAttributeDescription attr = descriptions_[i];
+						attr.drive_type = type;
+						attr.reported_name = reported_name;
+						add(attr);
+						return;
+					}
 				}
+				throw std::invalid_argument("Attribute description must be added before its alias.");
 			}
 
 
-			/// Find the description by smartctl name or id, merging them if they're partial.
-			[[nodiscard]] AtaAttributeDescription find(const std::string& reported_name, int32_t id, std::optional<StorageDeviceDetectedType> type) const
+			/// Find the description by smartctl name or id. If there is no description with
+			/// this name, the first one with this id is returned.
+			/// \return An empty description (with id -1) if not found.
+			[[nodiscard]] constexpr const AtaAttributeDescription& find(std::string_view reported_name, int32_t id,
+					std::optional<StorageDeviceDetectedType> type) const
 			{
-				// search by ID first
-				auto id_iter = id_db.find(id);
-				if (id_iter == id_db.end()) {
-					return {};  // not found
-				}
-				DBG_ASSERT(!id_iter->second.empty());
-				if (id_iter->second.empty()) {
-					return {};  // invalid DB?
+				if (id < 0 || std::size_t(id) >= max_ids) {
+					return empty_description_;
 				}
 
-				std::vector<AtaAttributeDescription> type_matched;
-				for (const auto& attr_iter : id_iter->second) {
-					if (!attr_iter.drive_type.has_value() || !type.has_value() || attr_iter.drive_type == type) {
-						type_matched.push_back(attr_iter);
+				// Search by smartctl name. Both drive-specific and universal descriptions match,
+				// the one added first wins.
+				std::size_t found = size_;
+				if (type.has_value()) {
+					for (const auto& key_type : {type, std::optional<StorageDeviceDetectedType>()}) {
+						if (auto index = name_index_.find(get_key_hash(id, key_type, reported_name)); index.has_value()) {
+							const AtaAttributeDescription& attr = descriptions_[*index];
+							if (attr.id == id && attr.drive_type == key_type && hz::string_equal_ascii_nocase(attr.reported_name, reported_name)) {
+								found = std::min(found, std::size_t(*index));
+							}
+						}
+					}
+				} else {
+					for (std::size_t i = first_by_id_[std::size_t(id)]; i != 0; i = next_by_id_[i - 1]) {
+						if (hz::string_equal_ascii_nocase(descriptions_[i - 1].reported_name, reported_name)) {
+							found = i - 1;
+							break;
+						}
 					}
 				}
-				if (type_matched.empty()) {
-					return {};  // not found
+				if (found != size_) {
+					return descriptions_[found];
 				}
 
-				// search by smartctl name in ID-supplied vector
-				for (const auto& attr_iter : type_matched) {
-					// compare them case-insensitively, just in case
-					if ( hz::string_to_lower_copy(attr_iter.reported_name) == hz::string_to_lower_copy(reported_name)) {
-						return attr_iter;  // found it
+				// Nothing was found by name, return the first one by that ID.
+				for (std::size_t i = first_by_id_[std::size_t(id)]; i != 0; i = next_by_id_[i - 1]) {
+					const AtaAttributeDescription& attr = descriptions_[i - 1];
+					if (!attr.drive_type.has_value() || !type.has_value() || attr.drive_type == type) {
+						return attr;
 					}
 				}
-
-				// nothing was found by name, return the first one by that ID.
-				return type_matched.front();
+				return empty_description_;
 			}
 
 
 		private:
 
-			std::map< int32_t, std::vector<AtaAttributeDescription> > id_db;  ///< id => attribute descriptions
+			/// Get the key hash for the name index
+			static constexpr std::uint64_t get_key_hash(int32_t id, std::optional<StorageDeviceDetectedType> type, std::string_view reported_name)
+			{
+				const std::uint64_t type_key = type.has_value() ? (std::uint64_t(*type) + 1) : 0;
+				return hz::string_hash_fnv1a(reported_name, true, hz::integer_hash_fnv1a((std::uint64_t(id) << 32) | type_key));
+			}
+
+
+			/// Build the indices. Called after all the descriptions have been added.
+			constexpr void build_index()
+			{
+				for (std::size_t i = size_; i > 0; --i) {  // in reverse, so that the lists are in insertion order
+					const auto id = std::size_t(descriptions_[i - 1].id);
+					next_by_id_[i - 1] = first_by_id_[id];
+					first_by_id_[id] = i;
+				}
+
+				// Only the first description with the same key can be found by name, skip the rest.
+				for (std::size_t i = 0; i < size_; ++i) {
+					const AtaAttributeDescription& attr = descriptions_[i];
+					bool duplicate = false;
+					for (std::size_t j = first_by_id_[std::size_t(attr.id)]; j != 0 && j - 1 < i && !duplicate; j = next_by_id_[j - 1]) {
+						const AtaAttributeDescription& prev = descriptions_[j - 1];
+						duplicate = prev.drive_type == attr.drive_type && hz::string_equal_ascii_nocase(prev.reported_name, attr.reported_name);
+					}
+					if (!duplicate) {
+						name_index_.insert(get_key_hash(attr.id, attr.drive_type, attr.reported_name), std::uint32_t(i));
+					}
+				}
+				name_index_.build();
+			}
+
+
+			std::array<AtaAttributeDescription, max_descriptions> descriptions_ {};  ///< Descriptions, in insertion order
+			std::size_t size_ = 0;  ///< Number of descriptions
+
+			hz::PerfectHashIndex<max_descriptions> name_index_;  ///< (id, drive type, case-folded name) -> index in descriptions_
+			std::array<std::size_t, max_ids> first_by_id_ {};  ///< id -> index of the first description with this id + 1, or 0
+			std::array<std::size_t, max_descriptions> next_by_id_ {};  ///< index -> index of the next description with the same id + 1, or 0
+
+			AtaAttributeDescription empty_description_;  ///< Returned if nothing was found
 
 	};
 
 
 
 
+	/// Program-wide attribute description database
+	constexpr AtaAttributeDescriptionDatabase ata_attribute_description_db;
+
+
+
 	/// Get program-wide attribute description database
 	[[nodiscard]] inline const AtaAttributeDescriptionDatabase& get_ata_attribute_description_db()
 	{
-		static const AtaAttributeDescriptionDatabase attribute_db;
-		return attribute_db;
+		return ata_attribute_description_db;
 	}
 
 
 
-	/// Check if a property is an attribute and matches a generic name
-	inline bool attr_match(StorageProperty& p, const std::string& generic_name)
+	/// Check if the raw value of an attribute is positive
+	inline bool raw_value_is_positive(const StorageProperty& p)
 	{
-		return (p.is_value_type<AtaStorageAttribute>() && p.generic_name == generic_name);
+		return p.get_value<AtaStorageAttribute>().raw_value_int > 0;
 	}
 
 
+	/// Warning reason for attributes related to bad sectors
+	constexpr std::string_view bad_sector_reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
+			"This could be an indication of future failures and/or potential data loss in bad sectors.";
+
+	/// Warning reason for high temperature
+	constexpr std::string_view temperature_reason = "The temperature of the drive is higher than 50 degrees Celsius. "
+			"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
+
+
+	/// Warning rules for attributes which are not reported as failing. For each property,
+	/// the first rule with a satisfied condition is used. The properties are known to hold AtaStorageAttribute.
+	constexpr StoragePropertyRuleTable ata_attribute_warning_rules(std::to_array<StoragePropertyWarningRule>({
+		// Reallocated Sector Count
+		{StoragePropertySection::AtaAttributes, "attr_reallocated_sector_count",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+
+		// Spin-up Retry Count
+		{StoragePropertySection::AtaAttributes, "attr_spin_up_retry_count",
+				&raw_value_is_positive,
+				WarningLevel::Notice, "The drive has a non-zero Raw value, but there is no SMART warning yet. "
+						"Your drive may have problems spinning up, which could lead to a complete mechanical failure. Please back up."},
+
+		// Soft Read Error Rate
+		{StoragePropertySection::AtaAttributes, "attr_soft_read_error_rate",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+
+		// Temperature (for some it may be 10xTemp, so limit the upper bound.)
+		{StoragePropertySection::AtaAttributes, "attr_temperature_celsius",
+				[](const StorageProperty& p) {
+					// Raw value may be 27, or 253403791387 (which encodes min/max values as well).
+					// Use string instead.
+					std::int64_t temp_int = 0;
+					return hz::string_is_numeric_nolocale(p.get_value<AtaStorageAttribute>().raw_value, temp_int, false)
+							&& temp_int > 50 && temp_int <= 120;  // 50C
+				},
+				WarningLevel::Notice, temperature_reason},
+
+		// Temperature (for some it may be 10xTemp, so limit the upper bound.)
+		{StoragePropertySection::AtaAttributes, "attr_temperature_celsius_x10",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageAttribute>().raw_value_int > 500; },  // 50C
+				WarningLevel::Notice, temperature_reason},
+
+		// Reallocation Event Count
+		{StoragePropertySection::AtaAttributes, "attr_reallocation_event_count",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+
+		// Current Pending Sector Count
+		{StoragePropertySection::AtaAttributes, "attr_current_pending_sector_count",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+		{StoragePropertySection::AtaAttributes, "attr_total_pending_sectors",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+
+		// Uncorrectable Sector Count
+		{StoragePropertySection::AtaAttributes, "attr_offline_uncorrectable",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+		{StoragePropertySection::AtaAttributes, "attr_total_attr_offline_uncorrectable",
+				&raw_value_is_positive,
+				WarningLevel::Notice, bad_sector_reason},
+
+		// SSD Life Left (%)
+		{StoragePropertySection::AtaAttributes, "attr_ssd_life_left",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageAttribute>().value.value_or(100) < 50; },
+				WarningLevel::Notice, "The drive has less than half of its estimated life left."},
+
+		// SSD Life Used (%)
+		{StoragePropertySection::AtaAttributes, "attr_ssd_life_used",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageAttribute>().raw_value_int >= 50; },
+				WarningLevel::Notice, "The drive has less than half of its estimated life left."},
+	}));
+
+
 }
 
 
 
-void auto_set_ata_attribute_description(StorageProperty& p, StorageDeviceDetectedType drive_type)
-{
-	AtaAttributeDescription attr = get_ata_attribute_description_db().find(p.reported_name, p.get_value<AtaStorageAttribute>().id, drive_type);
-
-	std::string humanized_reported_name;
-	std::string ssd_hdd_str;
-	const bool known_by_smartctl = !app_regex_partial_match("/Unknown_(HDD|SSD)_?Attr.*/i", p.reported_name, &ssd_hdd_str);
-	if (known_by_smartctl) {
-		humanized_reported_name = " " + p.reported_name + " ";  // spaces are for easy replacements
-
-		static const std::unordered_map<std::string, std::string> replacement_map = {
-				{"_", " "},
-				{"/", " / "},
-				{" Ct ", " Count "},
-				{" Tot ", " Total "},
-				{" Blk ", " Block "},
-				{" Cel ", " Celsius "},
-				{" Uncorrect ", " Uncorrectable "},
-				{" Cnt ", " Count "},
-				{" Offl ", " Offline "},
-				{" UNC ", " Uncorrectable "},
-				{" Err ", " Error "},
-				{" Errs ", " Errors "},
-				{" Perc ", " Percent "},
-				{" Ct ", " Count "},
-				{" Avg ", " Average "},
-				{" Max ", " Maximum "},
-				{" Min ", " Minimum "}
-		};
-
-		hz::string_replace_array(humanized_reported_name, replacement_map);
-		hz::string_trim(humanized_reported_name);
-		hz::string_remove_adjacent_duplicates(humanized_reported_name, ' ');  // may happen with slashes
+namespace {
+
+	/// Humanized form of the attribute name reported by smartctl
+	struct AtaAttributeReportedName {
+		bool known_by_smartctl = false;  ///< False if smartctl reported it as Unknown_Attribute, etc.
+		std::string humanized_name;  ///< e.g. "Reallocated Sector Count" for "Reallocated_Sector_Ct". Empty if unknown to smartctl.
+		std::string ssd_hdd_str;  ///< "SSD" or "HDD" if unknown to smartctl and reported as such.
+	};
+
+
+
+	/// Humanize the attribute name reported by smartctl
+	AtaAttributeReportedName humanize_ata_attribute_reported_name(const std::string& reported_name)
+	{
+		AtaAttributeReportedName name;
+		name.known_by_smartctl = !app_regex_partial_match("/Unknown_(HDD|SSD)_?Attr.*/i", reported_name, &name.ssd_hdd_str);
+		if (name.known_by_smartctl) {
+			name.humanized_name = " " + reported_name + " ";  // spaces are for easy replacements
+
+			static const std::unordered_map<std::string, std::string> replacement_map = {
+					{"_", " "},
+					{"/", " / "},
+					{" Ct ", " Count "},
+					{" Tot ", " Total "},
+					{" Blk ", " Block "},
+					{" Cel ", " Celsius "},
+					{" Uncorrect ", " Uncorrectable "},
+					{" Cnt ", " Count "},
+					{" Offl ", " Offline "},
+					{" UNC ", " Uncorrectable "},
+					{" Err ", " Error "},
+					{" Errs ", " Errors "},
+					{" Perc ", " Percent "},
+					{" Ct ", " Count "},
+					{" Avg ", " Average "},
+					{" Max ", " Maximum "},
+					{" Min ", " Minimum "}
+			};
+
+			hz::string_replace_array(name.humanized_name, replacement_map);
+			hz::string_trim(name.humanized_name);
+			hz::string_remove_adjacent_duplicates(name.humanized_name, ' ');  // may happen with slashes
+		}
+		return name;
 	}
 
-	if (attr.displayable_name.empty()) {
+
+
+	/// Get the displayable name of an attribute, using the humanized reported name if there is none in the database
+	std::string get_ata_attribute_displayable_name(const AtaAttributeDescription& attr, const AtaAttributeReportedName& reported_name)
+	{
+		if (!attr.displayable_name.empty()) {
+			return std::string(attr.displayable_name);
+		}
 		// try to display something sensible (use humanized form of smartctl name)
-		if (!humanized_reported_name.empty()) {
-			attr.displayable_name = humanized_reported_name;
-
-		} else {  // unknown to smartctl
-			if (hz::string_to_upper_copy(ssd_hdd_str) == "SSD") {
-				attr.displayable_name = "Unknown SSD Attribute";
-			} else if (hz::string_to_upper_copy(ssd_hdd_str) == "HDD") {
-				attr.displayable_name = "Unknown HDD Attribute";
-			} else {
-				attr.displayable_name = "Unknown Attribute";
-			}
+		if (!reported_name.humanized_name.empty()) {
+			return reported_name.humanized_name;
+		}
+		// unknown to smartctl
+		if (hz::string_to_upper_copy(reported_name.ssd_hdd_str) == "SSD") {
+			return "Unknown SSD Attribute";
+		}
+		if (hz::string_to_upper_copy(reported_name.ssd_hdd_str) == "HDD") {
+			return "Unknown HDD Attribute";
 		}
+		return "Unknown Attribute";
 	}
 
+}
+
+
+
+void auto_set_ata_attribute_names(StorageProperty& p, StorageDeviceDetectedType drive_type)
+{
+	const AtaAttributeDescription& attr = get_ata_attribute_description_db().find(p.reported_name, p.get_value<AtaStorageAttribute>().id, drive_type);
+	if (!attr.displayable_name.empty()) {
+		p.displayable_name = attr.displayable_name;  // no need to humanize the reported name
+	} else {
+		p.displayable_name = get_ata_attribute_displayable_name(attr, humanize_ata_attribute_reported_name(p.reported_name));
+	}
+	p.generic_name = attr.generic_name;
+}
+
 
 
+std::string get_ata_attribute_description(const StorageProperty& p, StorageDeviceDetectedType drive_type)
+{
+	const AtaAttributeDescription& attr = get_ata_attribute_description_db().find(p.reported_name, p.get_value<AtaStorageAttribute>().id, drive_type);
+	const AtaAttributeReportedName reported_name = humanize_ata_attribute_reported_name(p.reported_name);
+	const std::string displayable_name = get_ata_attribute_displayable_name(attr, reported_name);
+	std::string description;
+
 	if (attr.description.empty()) {
-		attr.description = "No description is available for this attribute.";
+		description = "No description is available for this attribute.";
 
 	} else {
 		bool same_names = true;
-		if (known_by_smartctl) {
+		if (reported_name.known_by_smartctl) {
 			// See if humanized smartctl-reported name looks like our found name.
 			// If not, show it in description.
-			std::string match = " " + humanized_reported_name + " ";
-			std::string against = " " + attr.displayable_name + " ";
+			std::string match = " " + reported_name.humanized_name + " ";
+			std::string against = " " + displayable_name + " ";
 
 			static const std::unordered_map<std::string, std::string> replacement_map = {
 					{" Percent ", " % "},
@@ -1235,131 +1408,79 @@ void auto_set_ata_attribute_description(StorageProperty& p, StorageDeviceDetecte
 			same_names = app_regex_partial_match("/^" + app_regex_escape(match) + "$/i", against);
 		}
 
-		std::string descr =  std::string("<b>") + Glib::Markup::escape_text(attr.displayable_name) + "</b>";
+		std::string descr =  std::string("<b>") + Glib::Markup::escape_text(displayable_name) + "</b>";
 		if (!same_names) {
 			const std::string reported_name_for_descr = Glib::Markup::escape_text(hz::string_replace_copy(p.reported_name, '_', ' '));
 			descr += "\n<small>Reported by smartctl as <b>\"" + reported_name_for_descr + "\"</b></small>\n";
 		}
 		descr += "\n";
 		descr += attr.description;
+		if (attr.uncorrectable_suffix) {
+			descr += "\n\n" + get_suffix_for_uncorrectable_property_description();
+		}
 
-		attr.description = descr;
+		description = descr;
 	}
 
-	p.displayable_name = attr.displayable_name;
-	p.set_description(attr.description);
-	p.generic_name = attr.generic_name;
+	return description;
 }
 
 
 
-void storage_property_ata_attribute_autoset_warning(StorageProperty& p)
+void auto_set_ata_attribute_description(StorageProperty& p, StorageDeviceDetectedType drive_type)
 {
-	std::optional<WarningLevel> w;
-	std::string reason;
+	p.set_description(get_ata_attribute_description(p, drive_type));
+	auto_set_ata_attribute_names(p, drive_type);
+}
 
-	if (p.section == StoragePropertySection::AtaAttributes && p.is_value_type<AtaStorageAttribute>()) {
-		const auto& attr = p.get_value<AtaStorageAttribute>();
 
+
+void storage_property_ata_attribute_autoset_warning(StorageProperty& p)
+{
+	if (p.section == StoragePropertySection::AtaAttributes && p.is_value_type<AtaStorageAttribute>()) {
 		// Set notices for known pre-fail attributes. These are notices only, since the warnings
 		// and alerts are shown only in case of attribute failure.
+		const auto* rule = ata_attribute_warning_rules.find_if(StoragePropertyRuleKey(p),
+				[&p](const StoragePropertyWarningRule& r) { return r.condition_matches(p); });
+		if (rule) {
+			p.warning_level = rule->warning_level;
+			p.warning_reason = rule->reason;
+		}
+	}
 
-		// Reallocated Sector Count
-		if (attr_match(p, "attr_reallocated_sector_count") && attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		// Spin-up Retry Count
-		} else if (attr_match(p, "attr_spin_up_retry_count") && attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"Your drive may have problems spinning up, which could lead to a complete mechanical failure. Please back up.";
-
-		// Soft Read Error Rate
-		} else if (attr_match(p, "attr_soft_read_error_rate") && attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		// Temperature (for some it may be 10xTemp, so limit the upper bound.)
-		} else if (attr_match(p, "attr_temperature_celsius")) {
-			// Raw value may be 27, or 253403791387 (which encodes min/max values as well).
-			// Use string instead.
-			std::int64_t temp_int = 0;
-			if (hz::string_is_numeric_nolocale(attr.raw_value, temp_int, false)
-					&& temp_int > 50 && temp_int <= 120) {  // 50C
-				w = WarningLevel::Notice;
-				reason = "The temperature of the drive is higher than 50 degrees Celsius. "
-							"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
-			}
-		// Temperature (for some it may be 10xTemp, so limit the upper bound.)
-		} else if (attr_match(p, "attr_temperature_celsius_x10") && attr.raw_value_int > 500) {  // 50C
-			w = WarningLevel::Notice;
-			reason = "The temperature of the drive is higher than 50 degrees Celsius. "
-					"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
+	// Now override this with reported SMART attribute failure warnings / errors
+	storage_property_ata_attribute_autoset_failure_warning(p);
+}
 
-		// Reallocation Event Count
-		} else if (attr_match(p, "attr_reallocation_event_count") && attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"This could be an indication of future failures and/or potential data loss in bad sectors.";
 
-		// Current Pending Sector Count
-		} else if ((attr_match(p, "attr_current_pending_sector_count") || attr_match(p, "attr_total_pending_sectors"))
-					&& attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"This could be an indication of future failures and/or potential data loss in bad sectors.";
 
-		// Uncorrectable Sector Count
-		} else if ((attr_match(p, "attr_offline_uncorrectable") || attr_match(p, "attr_total_attr_offline_uncorrectable"))
-					&& attr.raw_value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive has a non-zero Raw value, but there is no SMART warning yet. "
-					"This could be an indication of future failures and/or potential data loss in bad sectors.";
+void storage_property_ata_attribute_autoset_failure_warning(StorageProperty& p)
+{
+	if (p.section != StoragePropertySection::AtaAttributes || !p.is_value_type<AtaStorageAttribute>()) {
+		return;
+	}
+	const auto& attr = p.get_value<AtaStorageAttribute>();
 
-		// SSD Life Left (%)
-		} else if ((attr_match(p, "attr_ssd_life_left"))
-					&& attr.value.value() < 50) {
-			w = WarningLevel::Notice;
-			reason = "The drive has less than half of its estimated life left.";
+	if (attr.when_failed == AtaStorageAttribute::FailTime::Now) {  // NOW
 
-		// SSD Life Used (%)
-		} else if ((attr_match(p, "attr_ssd_life_used"))
-					&& attr.raw_value_int >= 50) {
-			w = WarningLevel::Notice;
-			reason = "The drive has less than half of its estimated life left.";
+		if (attr.attr_type == AtaStorageAttribute::AttributeType::OldAge) {  // old-age
+			p.warning_level = WarningLevel::Warning;
+			p.warning_reason = "The drive has a failing old-age attribute. Usually this indicates a wear-out. You should consider replacing the drive.";
+		} else {  // pre-fail
+			p.warning_level = WarningLevel::Alert;
+			p.warning_reason = "The drive has a failing pre-fail attribute. Usually this indicates a that the drive will FAIL soon. Please back up immediately!";
 		}
 
-		// Now override this with reported SMART attribute failure warnings / errors
-
-		if (attr.when_failed == AtaStorageAttribute::FailTime::Now) {  // NOW
-
-			if (attr.attr_type == AtaStorageAttribute::AttributeType::OldAge) {  // old-age
-				w = WarningLevel::Warning;
-				reason = "The drive has a failing old-age attribute. Usually this indicates a wear-out. You should consider replacing the drive.";
-			} else {  // pre-fail
-				w = WarningLevel::Alert;
-				reason = "The drive has a failing pre-fail attribute. Usually this indicates a that the drive will FAIL soon. Please back up immediately!";
-			}
-
-		} else if (attr.when_failed == AtaStorageAttribute::FailTime::Past) {  // PAST
+	} else if (attr.when_failed == AtaStorageAttribute::FailTime::Past) {  // PAST
 
-			if (attr.attr_type == AtaStorageAttribute::AttributeType::OldAge) {  // old-age
-				// nothing. we don't warn about e.g. temperature increase in the past
-			} else {  // pre-fail
-				w = WarningLevel::Warning;  // there was a problem, it got corrected (hopefully)
-				reason = "The drive had a failing pre-fail attribute, but it has been restored to a normal value. "
-						"This may be a serious problem, you should consider replacing the drive.";
-			}
+		if (attr.attr_type == AtaStorageAttribute::AttributeType::OldAge) {  // old-age
+			// nothing. we don't warn about e.g. temperature increase in the past
+		} else {  // pre-fail
+			p.warning_level = WarningLevel::Warning;  // there was a problem, it got corrected (hopefully)
+			p.warning_reason = "The drive had a failing pre-fail attribute, but it has been restored to a normal value. "
+					"This may be a serious problem, you should consider replacing the drive.";
 		}
 	}
-
-	if (w.has_value()) {
-		p.warning_level = w.value();
-		p.warning_reason = reason;
-	}
 }
 
 
@@ -16,6 +16,18 @@ Copyright:
 #include "storage_device_detected_type.h"
 #include "storage_property.h"
 
+#include <string>
+
+
+/// Find a property's attribute in the attribute database and set its generic and displayable names.
+/// This is a subset of auto_set_ata_attribute_description(), needed by the warnings.
+void auto_set_ata_attribute_names(StorageProperty& p, StorageDeviceDetectedType drive_type);
+
+
+/// Find a property's attribute in the attribute database and return its description.
+/// The property is not modified.
+std::string get_ata_attribute_description(const StorageProperty& p, StorageDeviceDetectedType drive_type);
+
 
 /// Find a property's attribute in the attribute database and fill the property
 /// with all the readable information we can gather.
@@ -26,6 +38,11 @@ void auto_set_ata_attribute_description(StorageProperty& p, StorageDeviceDetecte
 void storage_property_ata_attribute_autoset_warning(StorageProperty& p);
 
 
+/// Set a warning on an attribute which the drive reports as failing (now or in the past).
+/// This overrides any other warning of the attribute.
+void storage_property_ata_attribute_autoset_failure_warning(StorageProperty& p);
+
+
 #endif
 
 /// @}
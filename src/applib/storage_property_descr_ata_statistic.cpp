@@ -10,6 +10,7 @@ Copyright:
 /// @{
 
 #include <glibmm.h>
+#include <array>
 #include <utility>
 //#include <vector>
 #include <map>
@@ -21,6 +22,7 @@ Copyright:
 #include "storage_property_descr_ata_statistic.h"
 //#include "warning_colors.h"
 #include "storage_property_descr_helpers.h"
+#include "storage_property_descr_rules.h"
 
 
 namespace {
@@ -233,12 +235,13 @@ namespace {
 
 
 			/// Find the description by smartctl name or id, merging them if they're partial.
-			[[nodiscard]] AtaStatisticDescription find(const std::string& reported_name) const
+			/// \return An empty description if not found.
+			[[nodiscard]] const AtaStatisticDescription& find(const std::string& reported_name) const
 			{
 				// search by ID first
 				auto iter = devstat_db.find(reported_name);
 				if (iter == devstat_db.end()) {
-					return {};  // not found
+					return empty_description_;  // not found
 				}
 				return iter->second;
 			}
@@ -247,6 +250,7 @@ namespace {
 		private:
 
 			std::map<std::string, AtaStatisticDescription> devstat_db;  ///< reported_name => devstat entry description
+			AtaStatisticDescription empty_description_;  ///< Returned by find() if not found
 
 	};
 
@@ -261,22 +265,89 @@ namespace {
 
 
 
-	/// Check if a property matches a name (generic or reported)
-	inline bool name_match(StorageProperty& p, const std::string& name)
-	{
-		if (p.generic_name.empty()) {
-			return hz::string_to_lower_copy(p.reported_name) == hz::string_to_lower_copy(name);
-		}
-		return hz::string_to_lower_copy(p.generic_name) == hz::string_to_lower_copy(name);
-	}
+	/// Warning rules. For each property, the first rule with a satisfied condition is used.
+	/// The properties are known to hold AtaStorageStatistic.
+	constexpr StoragePropertyRuleTable ata_statistic_warning_rules(std::to_array<StoragePropertyWarningRule>({
+		{StoragePropertySection::Statistics, "Pending Error Count",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors."},
+
+		// "Workload Utilization" is either normalized, or encodes several values, so we can't use it.
+/*
+		{StoragePropertySection::Statistics, "Workload Utilization",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 50; },
+				WarningLevel::Notice, "The drive has less than half of its estimated life left."},
+		{StoragePropertySection::Statistics, "Workload Utilization",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 100; },
+				WarningLevel::Warning, "The drive is past its estimated lifespan."},
+*/
+
+		{StoragePropertySection::Statistics, "Utilization Usage Rate",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 50; },
+				WarningLevel::Notice, "The drive has less than half of its estimated life left."},
+		{StoragePropertySection::Statistics, "Utilization Usage Rate",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 100; },
+				WarningLevel::Warning, "The drive is past its estimated lifespan."},
+
+		{StoragePropertySection::Statistics, "Number of Reallocated Logical Sectors",
+				[](const StorageProperty& p) { return !p.get_value<AtaStorageStatistic>().is_normalized() && p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors."},
+		{StoragePropertySection::Statistics, "Number of Reallocated Logical Sectors",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().is_normalized() && p.get_value<AtaStorageStatistic>().value_int <= 0; },
+				WarningLevel::Warning, "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors."},
+
+		{StoragePropertySection::Statistics, "Number of Mechanical Start Failures",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The drive is reporting mechanical errors."},
+
+		{StoragePropertySection::Statistics, "Number of Realloc. Candidate Logical Sectors",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors."},
+
+		{StoragePropertySection::Statistics, "Number of Reported Uncorrectable Errors",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors."},
+
+		{StoragePropertySection::Statistics, "Current Temperature",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 50; },
+				WarningLevel::Notice, "The temperature of the drive is higher than 50 degrees Celsius. "
+						"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution."},
+
+		{StoragePropertySection::Statistics, "Time in Over-Temperature",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The temperature of the drive is or was over the manufacturer-specified maximum. "
+						"This may have shortened its lifespan and caused damage. Please install a cooling solution."},
+
+		{StoragePropertySection::Statistics, "Time in Under-Temperature",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int > 0; },
+				WarningLevel::Notice, "The temperature of the drive is or was under the manufacturer-specified minimum. "
+						"This may have shortened its lifespan and caused damage. Please operate the drive within manufacturer-specified temperature range."},
+
+		{StoragePropertySection::Statistics, "Percentage Used Endurance Indicator",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 50; },
+				WarningLevel::Notice, "The drive has less than half of its estimated life left."},
+		{StoragePropertySection::Statistics, "Percentage Used Endurance Indicator",
+				[](const StorageProperty& p) { return p.get_value<AtaStorageStatistic>().value_int >= 100; },
+				WarningLevel::Warning, "The drive is past its estimated lifespan."},
+	}));
 
 }
 
 
 
-/// Find a property's statistic in the statistics database and fill the property
-/// with all the readable information we can gather.
-bool auto_set_ata_statistic_description(StorageProperty& p)
+void auto_set_ata_statistic_names(StorageProperty& p)
+{
+	const AtaStatisticDescription& sd = get_ata_statistic_description_db().find(p.reported_name);
+	const std::string& displayable_name = (sd.displayable_name.empty() ? sd.reported_name : sd.displayable_name);
+	if (!displayable_name.empty()) {
+		p.displayable_name = displayable_name;
+	}
+	p.generic_name = sd.generic_name;
+}
+
+
+
+bool get_ata_statistic_description(const StorageProperty& p, std::string& description)
 {
 	AtaStatisticDescription sd = get_ata_statistic_description_db().find(p.reported_name);
 
@@ -297,12 +368,20 @@ bool auto_set_ata_statistic_description(StorageProperty& p)
 		sd.description = descr;
 	}
 
-	if (!displayable_name.empty()) {
-		p.displayable_name = displayable_name;
-	}
-	p.set_description(sd.description);
-	p.generic_name = sd.generic_name;
+	description = sd.description;
+	return found;
+}
+
 
+
+/// Find a property's statistic in the statistics database and fill the property
+/// with all the readable information we can gather.
+bool auto_set_ata_statistic_description(StorageProperty& p)
+{
+	std::string description;
+	const bool found = get_ata_statistic_description(p, description);
+	p.set_description(description);
+	auto_set_ata_statistic_names(p);
 	return found;
 }
 
@@ -314,73 +393,11 @@ void storage_property_ata_statistic_autoset_warning(StorageProperty& p)
 	std::string reason;
 
 	if (p.section == StoragePropertySection::Statistics && p.is_value_type<AtaStorageStatistic>()) {
-		const auto& statistic = p.get_value<AtaStorageStatistic>();
-
-		if (name_match(p, "Pending Error Count") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		// "Workload Utilization" is either normalized, or encodes several values, so we can't use it.
-/*
-		} else if (name_match(p, "Workload Utilization") && statistic.value_int >= 50) {
-			w = WarningLevel::notice;
-			reason = "The drive has less than half of its estimated life left.";
-
-		} else if (name_match(p, "Workload Utilization") && statistic.value_int >= 100) {
-			w = WarningLevel::warning;
-			reason = "The drive is past its estimated lifespan.";
-*/
-
-		} else if (name_match(p, "Utilization Usage Rate") && statistic.value_int >= 50) {
-			w = WarningLevel::Notice;
-			reason = "The drive has less than half of its estimated life left.";
-
-		} else if (name_match(p, "Utilization Usage Rate") && statistic.value_int >= 100) {
-			w = WarningLevel::Warning;
-			reason = "The drive is past its estimated lifespan.";
-
-		} else if (name_match(p, "Number of Reallocated Logical Sectors") && !statistic.is_normalized() && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		} else if (name_match(p, "Number of Reallocated Logical Sectors") && statistic.is_normalized() && statistic.value_int <= 0) {
-			w = WarningLevel::Warning;
-			reason = "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		} else if (name_match(p, "Number of Mechanical Start Failures") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive is reporting mechanical errors.";
-
-		} else if (name_match(p, "Number of Realloc. Candidate Logical Sectors") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		} else if (name_match(p, "Number of Reported Uncorrectable Errors") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The drive is reporting surface errors. This could be an indication of future failures and/or potential data loss in bad sectors.";
-
-		} else if (name_match(p, "Current Temperature") && statistic.value_int > 50) {
-			w = WarningLevel::Notice;
-			reason = "The temperature of the drive is higher than 50 degrees Celsius. "
-					"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
-
-		} else if (name_match(p, "Time in Over-Temperature") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The temperature of the drive is or was over the manufacturer-specified maximum. "
-					"This may have shortened its lifespan and caused damage. Please install a cooling solution.";
-
-		} else if (name_match(p, "Time in Under-Temperature") && statistic.value_int > 0) {
-			w = WarningLevel::Notice;
-			reason = "The temperature of the drive is or was under the manufacturer-specified minimum. "
-					"This may have shortened its lifespan and caused damage. Please operate the drive within manufacturer-specified temperature range.";
-
-		} else if (name_match(p, "Percentage Used Endurance Indicator") && statistic.value_int >= 50) {
-			w = WarningLevel::Notice;
-			reason = "The drive has less than half of its estimated life left.";
-
-		} else if (name_match(p, "Percentage Used Endurance Indicator") && statistic.value_int >= 100) {
-			w = WarningLevel::Warning;
-			reason = "The drive is past its estimated lifespan.";
+		const auto* rule = ata_statistic_warning_rules.find_if(StoragePropertyRuleKey(p),
+				[&p](const StoragePropertyWarningRule& r) { return r.condition_matches(p); });
+		if (rule) {
+			w = rule->warning_level;
+			reason = rule->reason;
 		}
 	}
 
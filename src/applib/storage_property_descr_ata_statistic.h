@@ -12,11 +12,24 @@ Copyright:
 #ifndef STORAGE_PROPERTY_DESCR_ATA_STATISTIC_H
 #define STORAGE_PROPERTY_DESCR_ATA_STATISTIC_H
 
+#include <string>
+
 #include "storage_property_repository.h"
 //#include "storage_device_detected_type.h"
 
 
 
+/// Find a property's statistic in the statistic database and set its generic and displayable names.
+/// This is a subset of auto_set_ata_statistic_description(), needed by the warnings.
+void auto_set_ata_statistic_names(StorageProperty& p);
+
+
+/// Find a property's statistic in the statistic database and put its description into \c description.
+/// The property is not modified.
+/// \return true if the statistic has a description in the database.
+bool get_ata_statistic_description(const StorageProperty& p, std::string& description);
+
+
 /// Find a property's statistic in the statistic database and fill the property
 /// with all the readable information we can gather.
 bool auto_set_ata_statistic_description(StorageProperty& p);
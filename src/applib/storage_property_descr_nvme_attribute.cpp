@@ -10,6 +10,7 @@ Copyright:
 /// @{
 
 #include <glibmm.h>
+#include <array>
 #include <utility>
 #include <map>
 #include <optional>
@@ -19,6 +20,7 @@ Copyright:
 //#include "applib/app_regex.h"
 
 #include "storage_property_descr_nvme_attribute.h"
+#include "storage_property_descr_rules.h"
 //#include "warning_colors.h"
 //#include "storage_property_descr_helpers.h"
 
@@ -158,14 +160,39 @@ namespace {
 
 
 
-	/// Check if a property matches a name (generic or reported)
-	inline bool name_match(StorageProperty& p, const std::string& name)
-	{
-		if (p.generic_name.empty()) {
-			return hz::string_to_lower_copy(p.reported_name) == hz::string_to_lower_copy(name);
-		}
-		return hz::string_to_lower_copy(p.generic_name) == hz::string_to_lower_copy(name);
-	}
+	/// Warning rules. For each property, the first rule with a satisfied condition is used.
+	constexpr StoragePropertyRuleTable nvme_attribute_warning_rules(std::to_array<StoragePropertyWarningRule>({
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/temperature",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() > 50; },  // 50C
+				WarningLevel::Notice, "The temperature of the drive is higher than 50 degrees Celsius. "
+						"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution."},
+
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/available_spare",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() <= 10; },  // 10% (arbitrary value)
+				WarningLevel::Warning, "The drive has less than 10% available spare lifetime left."},
+
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/percentage_used",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() >= 90; },  // 90% (arbitrary value)
+				WarningLevel::Warning, "The estimate drive lifetime is nearing its limit."},
+
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/media_errors",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() > 0; },
+				WarningLevel::Notice, "There are media errors present on this drive."},
+
+//		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/num_err_log_entries",
+//				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() > 0; },
+//				WarningLevel::Warning, "The drive has errors in its persistent error log."},
+
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/warning_temp_time",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() > 0; },
+				WarningLevel::Notice, "The drive detected is or was overheating. "
+						"This may have shortened its lifespan and caused damage. Please install a cooling solution."},
+
+		{StoragePropertySection::NvmeAttributes, "nvme_smart_health_information_log/critical_comp_time",
+				[](const StorageProperty& p) { return p.is_value_type<int64_t>() && p.get_value<int64_t>() > 0; },
+				WarningLevel::Notice, "The drive detected is or was overheating. "
+						"This may have shortened its lifespan and caused damage. Please install a cooling solution."},
+	}));
 
 
 }
@@ -173,7 +200,7 @@ namespace {
 
 /// Find a property's statistic in the statistics database and fill the property
 /// with all the readable information we can gather.
-bool auto_set_nvme_attribute_description(StorageProperty& p)
+bool get_nvme_attribute_description(const StorageProperty& p, std::string& description)
 {
 	NvmeAttributeDescription attr_descr = get_nvme_attribute_description_db().find(p.generic_name);
 
@@ -193,7 +220,7 @@ bool auto_set_nvme_attribute_description(StorageProperty& p)
 		attr_descr.description = descr;
 	}
 
-	p.set_description(attr_descr.description);
+	description = attr_descr.description;
 //		p.generic_name = attr_descr.generic_name;
 
 	return found;
@@ -201,6 +228,16 @@ bool auto_set_nvme_attribute_description(StorageProperty& p)
 
 
 
+bool auto_set_nvme_attribute_description(StorageProperty& p)
+{
+	std::string description;
+	const bool found = get_nvme_attribute_description(p, description);
+	p.set_description(description);
+	return found;
+}
+
+
+
 
 
 void storage_property_nvme_attribute_autoset_warning(StorageProperty& p)
@@ -212,42 +249,11 @@ void storage_property_nvme_attribute_autoset_warning(StorageProperty& p)
 		return;
 	}
 
-	if (name_match(p, "nvme_smart_health_information_log/temperature") && p.is_value_type<int64_t >() && p.get_value<int64_t>() > 50) {  // 50C
-		w = WarningLevel::Notice;
-		reason = "The temperature of the drive is higher than 50 degrees Celsius. "
-				"This may shorten its lifespan and cause damage under severe load. Please install a cooling solution.";
-
-	} else if (name_match(p, "nvme_smart_health_information_log/available_spare") && p.is_value_type<int64_t >()
-			&& p.get_value<int64_t>() <= 10) {  // 10% (arbitrary value)
-		w = WarningLevel::Warning;
-		reason = "The drive has less than 10% available spare lifetime left.";
-
-	} else if (name_match(p, "nvme_smart_health_information_log/percentage_used") && p.is_value_type<int64_t >()
-			&& p.get_value<int64_t>() >= 90) {  // 90% (arbitrary value)
-		w = WarningLevel::Warning;
-		reason = "The estimate drive lifetime is nearing its limit.";
-
-	} else if (name_match(p, "nvme_smart_health_information_log/media_errors") && p.is_value_type<int64_t >()
-			&& p.get_value<int64_t>() > 0) {
-		w = WarningLevel::Notice;
-		reason = "There are media errors present on this drive.";
-
-//	} else if (name_match(p, "nvme_smart_health_information_log/num_err_log_entries") && p.is_value_type<int64_t >()
-//			&& p.get_value<int64_t>() > 0) {
-//		w = WarningLevel::Warning;
-//		reason = "The drive has errors in its persistent error log.";
-
-	} else if (name_match(p, "nvme_smart_health_information_log/warning_temp_time") && p.is_value_type<int64_t >()
-			&& p.get_value<int64_t>() > 0) {
-		w = WarningLevel::Notice;
-		reason = "The drive detected is or was overheating. "
-				 "This may have shortened its lifespan and caused damage. Please install a cooling solution.";
-
-	} else if (name_match(p, "nvme_smart_health_information_log/critical_comp_time") && p.is_value_type<int64_t >()
-			&& p.get_value<int64_t>() > 0) {
-		w = WarningLevel::Notice;
-		reason = "The drive detected is or was overheating. "
-				 "This may have shortened its lifespan and caused damage. Please install a cooling solution.";
+	const auto* rule = nvme_attribute_warning_rules.find_if(StoragePropertyRuleKey(p),
+			[&p](const StoragePropertyWarningRule& r) { return r.condition_matches(p); });
+	if (rule) {
+		w = rule->warning_level;
+		reason = rule->reason;
 	}
 
 	if (w.has_value()) {
@@ -12,11 +12,19 @@ Copyright:
 #ifndef STORAGE_PROPERTY_DESCR_NVME_ATTRIBUTE_H
 #define STORAGE_PROPERTY_DESCR_NVME_ATTRIBUTE_H
 
+#include <string>
+
 #include "storage_property_repository.h"
 //#include "storage_device_detected_type.h"
 
 
 
+/// Find a property's attribute in the attribute database and put its description into \c description.
+/// The property is not modified.
+/// \return true if the attribute has a description in the database.
+bool get_nvme_attribute_description(const StorageProperty& p, std::string& description);
+
+
 /// Find a property's statistic in the statistic database and fill the property
 /// with all the readable information we can gather.
 bool auto_set_nvme_attribute_description(StorageProperty& p);
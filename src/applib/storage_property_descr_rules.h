@@ -0,0 +1,164 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_PROPERTY_DESCR_RULES_H
+#define STORAGE_PROPERTY_DESCR_RULES_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "hz/perfect_hash.h"
+
+#include "storage_property.h"
+#include "warning_level.h"
+
+
+
+/// The name a property is matched against rules by (generic name, or reported name if
+/// there is no generic name), with its case-insensitive hash.
+/// Computed once per property, so that matching against rules doesn't allocate.
+class StoragePropertyRuleKey {
+	public:
+
+		/// Constructor. The property must outlive the key.
+		explicit StoragePropertyRuleKey(const StorageProperty& p)
+				: section_(p.section), name_(p.generic_name.empty() ? p.reported_name : p.generic_name),
+				hash_(get_hash(section_, name_))
+		{ }
+
+
+		/// Get the hash of a (section, name) pair, ignoring the case of the name
+		[[nodiscard]] static constexpr std::uint64_t get_hash(StoragePropertySection section, std::string_view name)
+		{
+			return hz::integer_hash_fnv1a(static_cast<std::uint64_t>(section), hz::string_hash_fnv1a(name, true));
+		}
+
+
+		/// Check if a rule (section, name) matches this key
+		[[nodiscard]] constexpr bool matches(StoragePropertySection section, std::string_view name) const
+		{
+			return section == section_ && hz::string_equal_ascii_nocase(name, name_);
+		}
+
+
+		/// Get the hash
+		[[nodiscard]] constexpr std::uint64_t get_hash() const
+		{
+			return hash_;
+		}
+
+
+	private:
+
+		StoragePropertySection section_ = StoragePropertySection::Unknown;  ///< Property section
+		std::string_view name_;  ///< Property name
+		std::uint64_t hash_ = 0;  ///< Hash of section and case-folded name
+
+};
+
+
+
+/// A rule setting a description on a property with a specific section and name
+struct StoragePropertyDescriptionRule {
+	StoragePropertySection section = StoragePropertySection::Unknown;  ///< Property section
+	std::string_view name;  ///< Generic name (or reported name, if there is no generic name). Case-insensitive.
+	std::string_view description;  ///< Description. If empty, the displayable name is used.
+};
+
+
+
+/// A rule setting a warning on a property with a specific section and name, if the property
+/// value satisfies a condition.
+struct StoragePropertyWarningRule {
+	StoragePropertySection section = StoragePropertySection::Unknown;  ///< Property section
+	std::string_view name;  ///< Generic name (or reported name, if there is no generic name). Case-insensitive.
+	bool (*condition)(const StorageProperty& p) = nullptr;  ///< Condition on the property value. nullptr means always.
+	WarningLevel warning_level = WarningLevel::None;  ///< Warning level to set
+	std::string_view reason;  ///< Warning reason to set
+
+	/// Check if the condition is satisfied
+	[[nodiscard]] bool condition_matches(const StorageProperty& p) const
+	{
+		return condition == nullptr || condition(p);
+	}
+};
+
+
+
+/// A table of rules (StoragePropertyDescriptionRule, StoragePropertyWarningRule),
+/// dispatched by a perfect hash of (section, case-folded name) built at compile time.
+/// Several rules may have the same section and name; they are tried in declaration order.
+template<typename Rule, std::size_t N>
+class StoragePropertyRuleTable {
+	public:
+
+		/// Constructor
+		constexpr explicit StoragePropertyRuleTable(const std::array<Rule, N>& rules)
+				: rules_(rules)
+		{
+			for (std::size_t i = 0; i < N; ++i) {
+				bool key_exists = false;
+				for (std::size_t prev = i; prev > 0 && !key_exists; --prev) {
+					const Rule& prev_rule = rules_[prev - 1];
+					if (prev_rule.section == rules_[i].section && hz::string_equal_ascii_nocase(prev_rule.name, rules_[i].name)) {
+						next_[prev - 1] = static_cast<std::uint32_t>(i + 1);  // this is the last one in the chain so far
+						key_exists = true;
+					}
+				}
+				if (!key_exists) {
+					index_.insert(StoragePropertyRuleKey::get_hash(rules_[i].section, rules_[i].name), static_cast<std::uint32_t>(i));
+				}
+			}
+			index_.build();
+		}
+
+
+		/// Find the first rule matching a property key, for which \c pred returns true.
+		/// \return nullptr if not found.
+		template<typename Predicate>
+		[[nodiscard]] const Rule* find_if(const StoragePropertyRuleKey& key, Predicate&& pred) const
+		{
+			const auto first = index_.find(key.get_hash());
+			if (!first.has_value() || !key.matches(rules_[first.value()].section, rules_[first.value()].name)) {
+				return nullptr;
+			}
+			for (std::uint32_t i = first.value() + 1; i > 0; i = next_[i - 1]) {
+				if (pred(rules_[i - 1])) {
+					return &rules_[i - 1];
+				}
+			}
+			return nullptr;
+		}
+
+
+		/// Find the first rule matching a property key.
+		/// \return nullptr if not found.
+		[[nodiscard]] const Rule* find(const StoragePropertyRuleKey& key) const
+		{
+			return find_if(key, []([[maybe_unused]] const Rule& rule) { return true; });
+		}
+
+
+	private:
+
+		std::array<Rule, N> rules_;  ///< Rules, in declaration order
+		std::array<std::uint32_t, N> next_ {};  ///< Index + 1 of the next rule with the same key, 0 if none
+		hz::PerfectHashIndex<N> index_;  ///< Key hash -> index of the first rule with this key
+
+};
+
+
+
+#endif
+
+/// @}
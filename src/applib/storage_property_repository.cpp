@@ -7,9 +7,85 @@ Copyright:
 #include "storage_property_repository.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <span>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "hz/debug.h"
+
+
+
+namespace {
+
+	/// Identity of a property, used to match properties of two repositories
+	struct PropertyIdentity {
+		StoragePropertySection section = StoragePropertySection::Unknown;  ///< Section
+		std::string_view name;  ///< Generic name, or reported name if there is no generic name
+		std::int64_t entry_id = -1;  ///< Attribute ID, log entry number, etc., -1 if not applicable
+		std::size_t occurrence = 0;  ///< Number of preceding properties with the same identity
+
+		/// Equality operator
+		bool operator==(const PropertyIdentity& other) const = default;
+	};
+
+
+	/// Hash function for PropertyIdentity
+	struct PropertyIdentityHash {
+		/// Hash function
+		std::size_t operator()(const PropertyIdentity& id) const
+		{
+			std::size_t hash = std::hash<std::string_view>()(id.name);
+			for (const auto v : {std::size_t(id.section), std::size_t(id.entry_id), id.occurrence}) {
+				hash ^= v + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+			}
+			return hash;
+		}
+	};
+
+
+	/// Get the attribute ID, log entry number or statistic location of a property.
+	/// \return -1 if the property has none.
+	std::int64_t get_property_entry_id(const StorageProperty& p)
+	{
+		if (p.is_value_type<AtaStorageAttribute>())
+			return p.get_value<AtaStorageAttribute>().id;
+		if (p.is_value_type<AtaStorageStatistic>())
+			return p.get_value<AtaStorageStatistic>().page * 0x10000 + p.get_value<AtaStorageStatistic>().offset;
+		if (p.is_value_type<AtaStorageErrorBlock>())
+			return p.get_value<AtaStorageErrorBlock>().error_num;
+		if (p.is_value_type<AtaStorageSelftestEntry>())
+			return p.get_value<AtaStorageSelftestEntry>().test_num;
+		if (p.is_value_type<NvmeStorageSelftestEntry>())
+			return p.get_value<NvmeStorageSelftestEntry>().test_num;
+		return -1;
+	}
+
+
+	/// Get the identities of properties, in the same order.
+	/// The identities refer to the property names, so the properties must outlive them.
+	std::vector<PropertyIdentity> get_property_identities(std::span<const StorageProperty> properties)
+	{
+		std::vector<PropertyIdentity> identities;
+		identities.reserve(properties.size());
+		std::unordered_map<PropertyIdentity, std::size_t, PropertyIdentityHash> counts;
+		counts.reserve(properties.size());
+
+		for (const auto& p : properties) {
+			PropertyIdentity id;
+			id.section = p.section;
+			id.name = (p.generic_name.empty() ? p.reported_name : p.generic_name);
+			id.entry_id = get_property_entry_id(p);
+			id.occurrence = counts[id]++;
+			identities.push_back(id);
+		}
+		return identities;
+	}
+
+}
 
 
 
@@ -20,9 +96,54 @@ const std::vector<StorageProperty>& StoragePropertyRepository::get_properties()
 
 
 
-std::vector<StorageProperty>& StoragePropertyRepository::get_properties_ref()
+void StoragePropertyRepository::modify_properties(const std::function<void(StorageProperty& p)>& func)
 {
-	return properties_;
+	for (auto& p : properties_) {
+		func(p);
+	}
+	rebuild_index();
+}
+
+
+
+void StoragePropertyRepository::modify_section_properties(StoragePropertySection section,
+		const std::function<void(StorageProperty& p)>& func)
+{
+	auto iter = section_index_.find(section);
+	if (iter == section_index_.end())
+		return;
+
+	bool names_changed = false;
+	for (const std::size_t index : iter->second) {
+		StorageProperty& p = properties_[index];
+		const std::string old_name = p.generic_name;
+		func(p);
+		DBG_ASSERT(p.section == section);
+		names_changed = names_changed || (p.generic_name != old_name);
+	}
+	if (names_changed) {
+		rebuild_index();
+	}
+}
+
+
+
+const StorageProperty* StoragePropertyRepository::find_property(
+		std::string_view generic_name, StoragePropertySection section) const
+{
+	auto iter = name_index_.find(generic_name);
+	if (iter == name_index_.end())
+		return nullptr;
+
+	const SectionIndexList& list = iter->second;
+	if (section == StoragePropertySection::Unknown) {
+		return list.empty() ? nullptr : &properties_[list.front().second];
+	}
+	for (const auto& [list_section, index] : list) {
+		if (list_section == section)
+			return &properties_[index];
+	}
+	return nullptr;
 }
 
 
@@ -30,12 +151,8 @@ std::vector<StorageProperty>& StoragePropertyRepository::get_properties_ref()
 StorageProperty StoragePropertyRepository::lookup_property(
 		const std::string& generic_name, StoragePropertySection section) const
 {
-	for (const auto& p : properties_) {
-		if (section != StoragePropertySection::Unknown && p.section != section)
-			continue;
-
-		if (p.generic_name == generic_name)
-			return p;
+	if (const auto* p = find_property(generic_name, section)) {
+		return *p;
 	}
 	return {};  // check with .empty()
 }
@@ -45,6 +162,7 @@ StorageProperty StoragePropertyRepository::lookup_property(
 void StoragePropertyRepository::set_properties(std::vector<StorageProperty> properties)
 {
 	properties_ = std::move(properties);
+	rebuild_index();
 }
 
 
@@ -52,6 +170,7 @@ void StoragePropertyRepository::set_properties(std::vector<StorageProperty> prop
 void StoragePropertyRepository::add_property(StorageProperty property)
 {
 	properties_.push_back(std::move(property));
+	index_property(properties_.size() - 1);
 }
 
 
@@ -59,13 +178,97 @@ void StoragePropertyRepository::add_property(StorageProperty property)
 void StoragePropertyRepository::clear()
 {
 	properties_.clear();
+	name_index_.clear();
+	section_index_.clear();
 }
 
 
 
 bool StoragePropertyRepository::has_properties_for_section(StoragePropertySection section) const
 {
-	return std::any_of(properties_.begin(), properties_.end(),
-			[section](const StorageProperty& p) { return p.section == section; });
+	return section_index_.contains(section);
+}
+
+
+
+std::vector<const StorageProperty*> StoragePropertyRepository::get_section_properties(StoragePropertySection section) const
+{
+	std::vector<const StorageProperty*> props;
+	if (auto iter = section_index_.find(section); iter != section_index_.end()) {
+		props.reserve(iter->second.size());
+		for (const std::size_t index : iter->second) {
+			props.push_back(&properties_[index]);
+		}
+	}
+	return props;
+}
+
+
+
+void StoragePropertyRepository::index_property(std::size_t index)
+{
+	const StorageProperty& p = properties_[index];
+
+	section_index_[p.section].push_back(index);
+
+	// Only the first property with this name in the section is indexed
+	SectionIndexList& list = name_index_[p.generic_name];
+	const bool section_found = std::any_of(list.begin(), list.end(),
+			[&p](const auto& entry) { return entry.first == p.section; });
+	if (!section_found) {
+		list.emplace_back(p.section, index);
+	}
+}
+
+
+
+void StoragePropertyRepository::rebuild_index()
+{
+	name_index_.clear();
+	section_index_.clear();
+	for (std::size_t i = 0; i < properties_.size(); ++i) {
+		index_property(i);
+	}
 }
 
+
+
+StoragePropertyRepositoryDiff StoragePropertyRepository::diff(const StoragePropertyRepository& newer) const
+{
+	const auto& old_properties = get_properties();
+	const auto& new_properties = newer.get_properties();
+	const std::vector<PropertyIdentity> old_identities = get_property_identities(old_properties);
+	const std::vector<PropertyIdentity> new_identities = get_property_identities(new_properties);
+
+	// Identity -> index in old_properties
+	std::unordered_map<PropertyIdentity, std::size_t, PropertyIdentityHash> old_index;
+	old_index.reserve(old_identities.size());
+	for (std::size_t i = 0; i < old_identities.size(); ++i) {
+		old_index.emplace(old_identities[i], i);
+	}
+
+	StoragePropertyRepositoryDiff result;
+	std::vector<bool> old_matched(old_properties.size(), false);
+
+	for (std::size_t i = 0; i < new_properties.size(); ++i) {
+		const StorageProperty& new_p = new_properties[i];
+		auto iter = old_index.find(new_identities[i]);
+		if (iter == old_index.end()) {
+			result.added.push_back(new_p);
+			continue;
+		}
+		old_matched[iter->second] = true;
+		const StorageProperty& old_p = old_properties[iter->second];
+		if (!old_p.value_equals(new_p)) {
+			result.changed.push_back({old_p, new_p});
+		}
+	}
+
+	for (std::size_t i = 0; i < old_properties.size(); ++i) {
+		if (!old_matched[i]) {
+			result.removed.push_back(old_properties[i]);
+		}
+	}
+
+	return result;
+}
@@ -6,24 +6,66 @@ Copyright:
 #ifndef STORAGE_PROPERTY_REPOSITORY_H
 #define STORAGE_PROPERTY_REPOSITORY_H
 
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "storage_property.h"
 
 
+/// Difference between two property repositories, see StoragePropertyRepository::diff().
+struct StoragePropertyRepositoryDiff {
+
+	/// A property present in both repositories, with a different value
+	struct Change {
+		StorageProperty old_property;  ///< Property in the old repository
+		StorageProperty new_property;  ///< Property in the new repository
+	};
+
+	/// Check if there are no differences
+	[[nodiscard]] bool empty() const
+	{
+		return added.empty() && removed.empty() && changed.empty();
+	}
+
+	std::vector<StorageProperty> added;  ///< Properties present only in the new repository, in its order
+	std::vector<StorageProperty> removed;  ///< Properties present only in the old repository, in its order
+	std::vector<Change> changed;  ///< Properties with changed values, in the order of the new repository
+
+};
+
+
+
 /// A repository of properties. Used to store and look up drive properties.
+/// The properties are indexed by (section, generic name) and by section, so that
+/// lookups don't have to scan all the properties (error logs may have thousands of them).
 class StoragePropertyRepository {
 	public:
 
 		/// Get all properties
 		[[nodiscard]] const std::vector<StorageProperty>& get_properties() const;
 
-		/// Get all properties
-		[[nodiscard]] std::vector<StorageProperty>& get_properties_ref();
 
+		/// Modify all properties using a function. The function may change
+		/// generic names and sections, the index is rebuilt afterwards.
+		void modify_properties(const std::function<void(StorageProperty& p)>& func);
 
-		/// Find a property.
+		/// Modify all properties of a section using a function.
+		/// The function may change generic names, but not sections.
+		void modify_section_properties(StoragePropertySection section, const std::function<void(StorageProperty& p)>& func);
+
+
+		/// Find a property. If there are several properties with the same name, the first one is returned.
 		/// If section is Section::Unknown, search in all sections.
+		/// \return nullptr if not found. The pointer is invalidated when the repository is modified.
+		[[nodiscard]] const StorageProperty* find_property(std::string_view generic_name,
+				StoragePropertySection section = StoragePropertySection::Unknown) const;
+
+		/// Same as find_property(), but returns a copy.
+		/// \return An empty property if not found.
 		[[nodiscard]] StorageProperty lookup_property(const std::string& generic_name,
 				StoragePropertySection section = StoragePropertySection::Unknown) const;
 
@@ -41,11 +83,47 @@ class StoragePropertyRepository {
 		/// Check if there are any properties for a given section
 		[[nodiscard]] bool has_properties_for_section(StoragePropertySection section) const;
 
+		/// Get the properties of a section, in the order they were added
+		[[nodiscard]] std::vector<const StorageProperty*> get_section_properties(StoragePropertySection section) const;
+
+
+		/// Compare this (old) repository with a newer one.
+		/// Properties are matched by identity: section, generic name (reported name if there is
+		/// no generic name), and the attribute ID / log entry number / statistic location for
+		/// properties which have them. Properties with the same identity are matched in order.
+		/// Matched properties are reported as changed if their values differ (see StorageProperty::value_equals()).
+		[[nodiscard]] StoragePropertyRepositoryDiff diff(const StoragePropertyRepository& newer) const;
+
 
 	private:
 
+		/// Add a property at index to the index
+		void index_property(std::size_t index);
+
+		/// Rebuild the index from scratch
+		void rebuild_index();
+
+
+		/// Transparent hash, allows lookups by std::string_view
+		struct NameHash {
+			using is_transparent = void;  ///< Enable heterogeneous lookup
+
+			/// Hash function
+			std::size_t operator()(std::string_view s) const
+			{
+				return std::hash<std::string_view>()(s);
+			}
+		};
+
+		/// Index of the first property with a generic name in each section it occurs in.
+		/// The entries are sorted by index, since they are added in insertion order.
+		using SectionIndexList = std::vector<std::pair<StoragePropertySection, std::size_t>>;
+
 		std::vector<StorageProperty> properties_;  ///< Parsed data properties
 
+		std::unordered_map<std::string, SectionIndexList, NameHash, std::equal_to<>> name_index_;  ///< Generic name -> (section, index)
+		std::unordered_map<StoragePropertySection, std::vector<std::size_t>> section_index_;  ///< Section -> indices of its properties
+
 };
 
 
@@ -0,0 +1,271 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#include <chrono>
+#include <utility>
+
+#include "storage_property_user_rules.h"
+#include "rconfig/rconfig.h"
+#include "hz/debug.h"
+#include "hz/perfect_hash.h"
+#include "hz/string_num.h"
+#include "app_regex.h"
+
+
+
+namespace {
+
+	/// Config path of the rules
+	constexpr const char* rules_config_path = "system/warning_rules";
+
+
+	/// Parse a warning level name
+	std::optional<WarningLevel> parse_warning_level(const std::string& name)
+	{
+		if (name == "none")
+			return WarningLevel::None;
+		if (name == "notice")
+			return WarningLevel::Notice;
+		if (name == "warning")
+			return WarningLevel::Warning;
+		if (name == "alert")
+			return WarningLevel::Alert;
+		return std::nullopt;
+	}
+
+
+	/// Parse a rule from a JSON object
+	/// \return std::nullopt if the rule has invalid types or values.
+	std::optional<StoragePropertyUserWarningRule> parse_rule(const nlohmann::json& node)
+	{
+		if (!node.is_object())
+			return std::nullopt;
+
+		StoragePropertyUserWarningRule rule;
+		try {
+			rule.model_pattern = node.value("model", std::string());
+			rule.name = node.value("name", std::string());
+			if (node.contains("attribute_id")) {
+				rule.attribute_id = node.at("attribute_id").get<std::int32_t>();
+			}
+			if (node.contains("section")) {
+				rule.section = StoragePropertySectionExt::get_by_storable_name(node.at("section").get<std::string>());
+				if (rule.section == StoragePropertySection::Unknown) {
+					return std::nullopt;
+				}
+			}
+			const std::string value_type = node.value("value", std::string("raw"));
+			if (value_type != "raw" && value_type != "normalized") {
+				return std::nullopt;
+			}
+			rule.use_normalized_value = (value_type == "normalized");
+			if (node.contains("above")) {
+				rule.above = node.at("above").get<std::int64_t>();
+			}
+			if (node.contains("below")) {
+				rule.below = node.at("below").get<std::int64_t>();
+			}
+			const auto level = parse_warning_level(node.value("level", std::string("notice")));
+			if (!level.has_value()) {
+				return std::nullopt;
+			}
+			rule.warning_level = level.value();
+			rule.reason = node.value("reason", std::string("The value is outside the limits set in the configuration file."));
+		}
+		catch (nlohmann::json::exception& e) {  // invalid types in user config
+			return std::nullopt;
+		}
+		return rule;
+	}
+
+
+	/// Get the value of a property which the rules compare against
+	/// \return std::nullopt if the property has no numeric value.
+	std::optional<std::int64_t> get_rule_value(const StorageProperty& p, bool use_normalized_value)
+	{
+		if (p.is_value_type<AtaStorageAttribute>()) {
+			const auto& attr = p.get_value<AtaStorageAttribute>();
+			if (use_normalized_value) {
+				if (attr.value.has_value())
+					return attr.value.value();
+				return std::nullopt;
+			}
+			// Raw value may be 27, or 253403791387 (which encodes min/max temperature as well).
+			// Use the leading number of the string instead.
+			std::int64_t raw_value = 0;
+			if (hz::string_is_numeric_nolocale(attr.raw_value, raw_value, false))
+				return raw_value;
+			return attr.raw_value_int;
+		}
+		if (p.is_value_type<AtaStorageStatistic>())
+			return p.get_value<AtaStorageStatistic>().value_int;
+		if (p.is_value_type<std::int64_t>())
+			return p.get_value<std::int64_t>();
+		if (p.is_value_type<bool>())
+			return p.get_value<bool>() ? 1 : 0;
+		if (p.is_value_type<std::chrono::seconds>())
+			return p.get_value<std::chrono::seconds>().count();
+		return std::nullopt;
+	}
+
+}
+
+
+
+StoragePropertyUserRules StoragePropertyUserRules::from_json(const nlohmann::json& rules)
+{
+	StoragePropertyUserRules result;
+	if (!rules.is_array())
+		return result;
+
+	for (const auto& node : rules) {
+		auto rule = parse_rule(node);
+		if (!rule.has_value() || !result.add_rule(std::move(rule.value()))) {
+			debug_out_warn("app", DBG_FUNC_MSG << "Invalid warning rule in config: " << node.dump() << "\n");
+		}
+	}
+	return result;
+}
+
+
+
+StoragePropertyUserRules StoragePropertyUserRules::from_config()
+{
+	return from_json(rconfig::get_data<rconfig::json>(rules_config_path));
+}
+
+
+
+bool StoragePropertyUserRules::add_rule(StoragePropertyUserWarningRule rule)
+{
+	if ((rule.name.empty() && !rule.attribute_id.has_value()) || (!rule.above.has_value() && !rule.below.has_value())) {
+		return false;
+	}
+
+	Entry entry;
+	if (!rule.model_pattern.empty()) {
+		try {
+			entry.model_regex = app_regex_re(rule.model_pattern);
+		}
+		catch (std::regex_error& e) {
+			return false;
+		}
+	}
+	entry.rule = std::move(rule);
+	add_entry(std::move(entry));
+	return true;
+}
+
+
+
+StoragePropertyUserRules StoragePropertyUserRules::select_for_model(const std::string& model_name) const
+{
+	StoragePropertyUserRules result;
+	for (const auto& entry : entries_) {
+		if (!entry.model_regex.has_value() || app_regex_partial_match(entry.model_regex.value(), model_name)) {
+			result.add_entry(entry);
+		}
+	}
+	return result;
+}
+
+
+
+void StoragePropertyUserRules::add_entry(Entry entry)
+{
+	const std::size_t index = entries_.size();
+	if (entry.rule.attribute_id.has_value()) {
+		id_index_[entry.rule.attribute_id.value()].push_back(index);
+	} else {
+		name_index_[hz::string_hash_fnv1a(entry.rule.name, true)].push_back(index);
+	}
+	entries_.push_back(std::move(entry));
+}
+
+
+
+template<typename Func>
+const StoragePropertyUserWarningRule* StoragePropertyUserRules::find_rule(const StorageProperty& p, Func&& func) const
+{
+	if (entries_.empty())
+		return nullptr;
+
+	static const std::vector<std::size_t> no_indices;
+	const std::vector<std::size_t>* id_indices = &no_indices;
+	if (p.is_value_type<AtaStorageAttribute>()) {
+		if (auto iter = id_index_.find(p.get_value<AtaStorageAttribute>().id); iter != id_index_.end()) {
+			id_indices = &iter->second;
+		}
+	}
+	const std::vector<std::size_t>* name_indices = &no_indices;
+	if (auto iter = name_index_.find(hz::string_hash_fnv1a(p.generic_name, true)); iter != name_index_.end()) {
+		name_indices = &iter->second;
+	}
+
+	// Merge the two lists, so that the rules are tried in the order they were added
+	auto id_iter = id_indices->begin();
+	auto name_iter = name_indices->begin();
+	while (id_iter != id_indices->end() || name_iter != name_indices->end()) {
+		std::size_t index = 0;
+		if (name_iter == name_indices->end() || (id_iter != id_indices->end() && *id_iter < *name_iter)) {
+			index = *(id_iter++);
+		} else {
+			index = *(name_iter++);
+			if (!hz::string_equal_ascii_nocase(entries_[index].rule.name, p.generic_name)) {
+				continue;  // hash collision
+			}
+		}
+		const StoragePropertyUserWarningRule& rule = entries_[index].rule;
+		if ((rule.section == StoragePropertySection::Unknown || rule.section == p.section) && func(rule)) {
+			return &rule;
+		}
+	}
+	return nullptr;
+}
+
+
+
+bool StoragePropertyUserRules::has_rules_for(const StorageProperty& p) const
+{
+	return find_rule(p, []([[maybe_unused]] const StoragePropertyUserWarningRule& rule) { return true; }) != nullptr;
+}
+
+
+
+const StoragePropertyUserWarningRule* StoragePropertyUserRules::find_matching(const StorageProperty& p) const
+{
+	return find_rule(p, [&p](const StoragePropertyUserWarningRule& rule) {
+		const auto value = get_rule_value(p, rule.use_normalized_value);
+		return value.has_value()
+				&& (!rule.above.has_value() || value.value() > rule.above.value())
+				&& (!rule.below.has_value() || value.value() < rule.below.value());
+	});
+}
+
+
+
+bool StoragePropertyUserRules::empty() const
+{
+	return entries_.empty();
+}
+
+
+
+std::size_t StoragePropertyUserRules::size() const
+{
+	return entries_.size();
+}
+
+
+
+
+
+/// @}
@@ -0,0 +1,117 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib
+/// \weakgroup applib
+/// @{
+
+#ifndef STORAGE_PROPERTY_USER_RULES_H
+#define STORAGE_PROPERTY_USER_RULES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+#include "storage_property.h"
+#include "warning_level.h"
+
+
+
+/// A warning rule defined by the user in the config file ("system/warning_rules" array).
+/// For example, this raises the temperature limit of a specific drive model:
+/// {"model": "^WDC WD40EFRX", "name": "attr_temperature_celsius", "above": 60, "level": "notice",
+/// "reason": "The drive is hotter than 60 degrees Celsius."}
+struct StoragePropertyUserWarningRule {
+	std::string model_pattern;  ///< Perl-style regex, matched against the drive model ("model"). Empty means any drive.
+	std::string name;  ///< Generic name of the property, case-insensitive ("name"). Not used if attribute_id is set.
+	std::optional<std::int32_t> attribute_id;  ///< ATA attribute ID ("attribute_id")
+	StoragePropertySection section = StoragePropertySection::Unknown;  ///< Section ("section", storable name). Unknown means any.
+	bool use_normalized_value = false;  ///< For ATA attributes, compare the normalized value instead of the raw one ("value": "normalized")
+	std::optional<std::int64_t> above;  ///< The rule matches if the value is greater than this ("above")
+	std::optional<std::int64_t> below;  ///< The rule matches if the value is less than this ("below")
+	WarningLevel warning_level = WarningLevel::Notice;  ///< Warning level ("level": "none", "notice", "warning", "alert")
+	std::string reason;  ///< Warning reason ("reason")
+};
+
+
+
+/// User-defined warning rules, indexed by property name and attribute ID.
+/// If there are user rules for a property, they replace the built-in rules for it, so that
+/// the built-in limits can be changed. The warnings reported by the drive itself (e.g. failing
+/// attributes) are still set.
+class StoragePropertyUserRules {
+	public:
+
+		/// Parse rules from a JSON array. Invalid rules are skipped with a warning.
+		[[nodiscard]] static StoragePropertyUserRules from_json(const nlohmann::json& rules);
+
+		/// Load rules from config ("system/warning_rules")
+		[[nodiscard]] static StoragePropertyUserRules from_config();
+
+
+		/// Add a rule. Rules are tried in the order they were added.
+		/// \return false if the rule is invalid (no name or ID, no limits, invalid model pattern).
+		bool add_rule(StoragePropertyUserWarningRule rule);
+
+
+		/// Get the rules which apply to a drive model
+		[[nodiscard]] StoragePropertyUserRules select_for_model(const std::string& model_name) const;
+
+
+		/// Check if there are any rules for a property, regardless of its value
+		[[nodiscard]] bool has_rules_for(const StorageProperty& p) const;
+
+		/// Find the first rule for a property which matches its value.
+		/// \return nullptr if none match.
+		[[nodiscard]] const StoragePropertyUserWarningRule* find_matching(const StorageProperty& p) const;
+
+
+		/// Check if there are no rules
+		[[nodiscard]] bool empty() const;
+
+		/// Get the number of rules
+		[[nodiscard]] std::size_t size() const;
+
+
+	private:
+
+		/// A rule with its compiled model pattern
+		struct Entry {
+			StoragePropertyUserWarningRule rule;  ///< Rule
+			std::optional<std::regex> model_regex;  ///< Compiled model pattern, if any
+		};
+
+
+		/// Add a validated rule and index it
+		void add_entry(Entry entry);
+
+
+		/// Call \c func for each rule which applies to a property (by name or ID, and section),
+		/// in the order the rules were added, until it returns true.
+		/// \return The rule for which \c func returned true, or nullptr.
+		template<typename Func>
+		const StoragePropertyUserWarningRule* find_rule(const StorageProperty& p, Func&& func) const;
+
+
+		std::vector<Entry> entries_;  ///< Rules, in the order they were added
+		std::unordered_map<std::uint64_t, std::vector<std::size_t>> name_index_;  ///< Hash of case-folded name -> rule indices
+		std::unordered_map<std::int32_t, std::vector<std::size_t>> id_index_;  ///< Attribute ID -> rule indices
+
+};
+
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,215 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "applib/attribute_history.h"
+#include "hz/fs.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Start time of the generated samples
+	const std::chrono::sys_seconds start_time(1700000000s);
+
+
+	/// Create a sample similar to the ones of a working drive, polled every 5 minutes
+	AttributeHistorySample create_sample(int index)
+	{
+		AttributeHistorySample sample;
+		sample.time = start_time + index * 5min;
+		sample.values = {
+			{"ata_attribute/9/raw", 10000 + index / 12},  // power-on hours
+			{"ata_attribute/194/raw", 35 + (index / 7) % 5},  // temperature
+			{"ata_attribute/5/raw", 0},  // reallocated sectors
+		};
+		return sample;
+	}
+
+
+	/// Get the sample file of a history
+	hz::fs::path get_data_file(const hz::fs::path& file_base)
+	{
+		hz::fs::path file = file_base;
+		file += ".gshist";
+		return file;
+	}
+
+
+	/// Remove the history files
+	void remove_history(const hz::fs::path& file_base)
+	{
+		std::error_code ec;
+		for (const auto* ext : {".gshist", ".gshidx", ".gshser"}) {
+			hz::fs::path file = file_base;
+			file += ext;
+			hz::fs::remove(file, ec);
+		}
+	}
+
+}
+
+
+
+TEST_CASE("AttributeHistory", "[app][history]")
+{
+	const hz::fs::path file_base = hz::fs::temp_directory_path() / "gsc_test_attribute_history";
+	remove_history(file_base);
+
+	const int num_samples = 2000;
+	{
+		AttributeHistoryWriter writer;
+		REQUIRE(writer.open(file_base));
+		for (int i = 0; i < num_samples; ++i) {
+			REQUIRE(writer.append(create_sample(i)));
+		}
+	}
+
+	SECTION("Read") {
+		AttributeHistoryReader reader;
+		REQUIRE(reader.open(file_base));
+		REQUIRE(reader.get_series_names().size() == 3);
+		REQUIRE(reader.get_time_range() == std::pair {start_time, start_time + (num_samples - 1) * 5min});
+		REQUIRE(reader.get_index().size() == (num_samples + AttributeHistoryWriter::keyframe_interval - 1) / AttributeHistoryWriter::keyframe_interval);
+
+		// Unchanged values take almost no space
+		std::error_code ec;
+		REQUIRE(hz::fs::file_size(get_data_file(file_base), ec) < num_samples * 8);
+
+		const auto temperatures = reader.read_series("ata_attribute/194/raw", start_time, start_time + 24h * 365);
+		REQUIRE(temperatures.size() == num_samples);
+		for (int i = 0; i < num_samples; ++i) {
+			REQUIRE(temperatures.at(static_cast<std::size_t>(i)).first == create_sample(i).time);
+			REQUIRE(temperatures.at(static_cast<std::size_t>(i)).second == create_sample(i).values.at(1).second);
+		}
+
+		// A range in the middle
+		const auto hours = reader.read_series("ata_attribute/9/raw", start_time + 1000 * 5min, start_time + 1099 * 5min);
+		REQUIRE(hours.size() == 100);
+		REQUIRE(hours.front().second == 10000 + 1000 / 12);
+
+		REQUIRE(reader.read_series("ata_attribute/5/raw", start_time, start_time + 1h).size() == 13);
+		REQUIRE(reader.read_series("nonexistent", start_time, start_time + 1h).empty());
+		REQUIRE(reader.read_series("ata_attribute/5/raw", start_time - 1h, start_time - 1s).empty());
+	}
+
+	SECTION("Continue") {
+		AttributeHistoryWriter writer;
+		REQUIRE(writer.open(file_base));
+
+		// Earlier time is recorded as the last one, extreme values and new series are supported.
+		AttributeHistorySample sample = create_sample(num_samples);
+		sample.time = start_time;
+		sample.values.emplace_back("nvme_smart_health_information_log/data_units_written", std::numeric_limits<std::int64_t>::max());
+		REQUIRE(writer.append(sample));
+		sample.values.back().second = std::numeric_limits<std::int64_t>::min();
+		REQUIRE(writer.append(sample));
+		writer.close();
+
+		AttributeHistoryReader reader;
+		REQUIRE(reader.open(file_base));
+		REQUIRE(reader.get_series_names().size() == 4);
+		REQUIRE(reader.get_time_range()->second == start_time + (num_samples - 1) * 5min);
+
+		const auto written = reader.read_series("nvme_smart_health_information_log/data_units_written", start_time, start_time + 24h * 365);
+		REQUIRE(written.size() == 2);
+		REQUIRE(written.at(0).second == std::numeric_limits<std::int64_t>::max());
+		REQUIRE(written.at(1).second == std::numeric_limits<std::int64_t>::min());
+		REQUIRE(reader.read_series("ata_attribute/9/raw", start_time, start_time + 24h * 365).size() == num_samples + 2);
+	}
+
+	SECTION("Torn write") {
+		std::error_code ec;
+		const auto size = hz::fs::file_size(get_data_file(file_base), ec);
+		hz::fs::resize_file(get_data_file(file_base), size - 1, ec);
+		REQUIRE(!ec);
+
+		{
+			AttributeHistoryReader reader;
+			REQUIRE(reader.open(file_base));
+			REQUIRE(reader.get_valid_data_size() < size - 1);
+			REQUIRE(reader.get_time_range()->second == start_time + (num_samples - 2) * 5min);
+		}
+
+		// The writer removes the incomplete record
+		AttributeHistoryWriter writer;
+		REQUIRE(writer.open(file_base));
+		REQUIRE(writer.append(create_sample(num_samples)));
+		writer.close();
+
+		AttributeHistoryReader reader;
+		REQUIRE(reader.open(file_base));
+		REQUIRE(reader.get_valid_data_size() == hz::fs::file_size(get_data_file(file_base), ec));
+		const auto temperatures = reader.read_series("ata_attribute/194/raw", start_time, start_time + 24h * 365);
+		REQUIRE(temperatures.size() == num_samples);
+		REQUIRE(temperatures.back().first == create_sample(num_samples).time);
+	}
+
+	SECTION("Sample from properties") {
+		StoragePropertyRepository repository;
+
+		AtaStorageAttribute attribute;
+		attribute.id = 194;
+		attribute.value = 65;
+		attribute.raw_value_int = 35;
+		StorageProperty attribute_property;
+		attribute_property.section = StoragePropertySection::AtaAttributes;
+		attribute_property.set_value(attribute);
+		repository.add_property(attribute_property);
+
+		StorageProperty nvme_property;
+		nvme_property.set_name("nvme_smart_health_information_log/media_errors", "nvme_smart_health_information_log/media_errors");
+		nvme_property.section = StoragePropertySection::NvmeAttributes;
+		nvme_property.set_value(std::int64_t(2));
+		repository.add_property(nvme_property);
+
+		StorageProperty info_property;
+		info_property.set_name("nvme_number_of_namespaces", "nvme_number_of_namespaces");
+		info_property.section = StoragePropertySection::Info;
+		info_property.set_value(std::int64_t(1));
+		repository.add_property(info_property);
+
+		const auto sample = AttributeHistorySample::create(repository, start_time);
+		REQUIRE(sample.time == start_time);
+		REQUIRE(sample.values == std::vector<std::pair<std::string, std::int64_t>> {
+			{"ata_attribute/194/value", 65},
+			{"ata_attribute/194/raw", 35},
+			{"nvme_smart_health_information_log/media_errors", 2},
+		});
+	}
+
+	SECTION("Invalid file") {
+		REQUIRE(!hz::fs_file_put_contents(get_data_file(file_base), "not a history file"));
+		AttributeHistoryReader reader;
+		REQUIRE(!reader.open(file_base));
+		AttributeHistoryWriter writer;
+		REQUIRE(!writer.open(file_base));
+	}
+
+	remove_history(file_base);
+}
+
+
+
+
+
+
+/// @}
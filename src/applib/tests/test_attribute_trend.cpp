@@ -0,0 +1,215 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+#include "applib/attribute_trend.h"
+#include "hz/fs.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Start time of the generated samples
+	const std::chrono::sys_seconds start_time(1700000000s);
+
+
+	/// Create an ATA attribute property
+	StorageProperty create_attribute_property(std::int32_t id, std::uint8_t value, std::uint8_t threshold, std::int64_t raw_value)
+	{
+		AtaStorageAttribute attribute;
+		attribute.id = id;
+		attribute.value = value;
+		attribute.threshold = threshold;
+		attribute.raw_value_int = raw_value;
+		StorageProperty p;
+		p.section = StoragePropertySection::AtaAttributes;
+		p.set_value(attribute);
+		return p;
+	}
+
+
+	/// Create an integer property
+	StorageProperty create_int_property(const std::string& name, std::int64_t value)
+	{
+		StorageProperty p;
+		p.set_name(name, name);
+		p.section = StoragePropertySection::NvmeAttributes;
+		p.set_value(value);
+		return p;
+	}
+
+}
+
+
+
+TEST_CASE("AttributeTrendStats", "[app][trend]")
+{
+	AttributeTrendStats stats;
+	REQUIRE(!stats.get_slope_per_day().has_value());
+
+	// A linear series has the same slope regardless of weights
+	for (int day = 0; day < 100; ++day) {
+		stats.add(start_time + day * 24h, 1000 + 3 * day, 24h * 30);
+	}
+	REQUIRE(stats.sample_count == 100);
+	REQUIRE(stats.get_time_span() == 99 * 24h);
+	REQUIRE(stats.min_value == 1000);
+	REQUIRE(stats.max_value == 1000 + 3 * 99);
+	REQUIRE(stats.get_slope_per_day().value() == Approx(3.));
+
+	// Recent samples outweigh the old ones
+	for (int day = 100; day < 200; ++day) {
+		stats.add(start_time + day * 24h, 1000 + 3 * 99, 24h * 30);
+	}
+	REQUIRE(std::abs(stats.get_slope_per_day().value()) < 0.5);
+
+	// Samples at the same time don't give a slope
+	AttributeTrendStats same_time;
+	same_time.add(start_time, 1, 24h);
+	same_time.add(start_time, 5, 24h);
+	REQUIRE(!same_time.get_slope_per_day().has_value());
+}
+
+
+
+TEST_CASE("AttributeTrendTracker", "[app][trend]")
+{
+	AttributeTrendTracker tracker;
+
+	SECTION("Stable drive") {
+		StoragePropertyRepository repository;
+		repository.add_property(create_attribute_property(5, 100, 10, 8));
+		repository.add_property(create_int_property("temperature/current", 40));
+		for (int day = 0; day < 60; ++day) {
+			tracker.add_sample(AttributeHistorySample::create(repository, start_time + day * 24h));
+		}
+		tracker.apply_warnings(repository);
+		for (const auto& p : repository.get_properties()) {
+			REQUIRE(p.warning_level == WarningLevel::None);
+			REQUIRE(p.warning_reason.empty());
+		}
+	}
+
+	SECTION("Growing error count") {
+		for (int hour = 0; hour < 48; ++hour) {
+			StoragePropertyRepository repository;
+			repository.add_property(create_attribute_property(197, 100, 0, hour < 24 ? 0 : hour));
+			tracker.add_sample(AttributeHistorySample::create(repository, start_time + hour * 1h));
+		}
+		StoragePropertyRepository repository;
+		repository.add_property(create_attribute_property(197, 100, 0, 47));
+		tracker.apply_warnings(repository);
+		REQUIRE(repository.get_properties().front().warning_level == WarningLevel::Alert);
+		REQUIRE(!repository.get_properties().front().warning_reason.empty());
+	}
+
+	SECTION("Time to threshold") {
+		// The normalized value drops by 1 every 2 days, with 40 left until the threshold.
+		for (int day = 0; day < 60; ++day) {
+			StoragePropertyRepository repository;
+			repository.add_property(create_attribute_property(1, static_cast<std::uint8_t>(100 - day / 2), 30, 0));
+			tracker.add_sample(AttributeHistorySample::create(repository, start_time + day * 24h));
+		}
+		StoragePropertyRepository repository;
+		auto p = create_attribute_property(1, 71, 30, 0);
+		p.warning_reason = "Existing reason";
+		repository.add_property(p);
+		tracker.apply_warnings(repository);
+		REQUIRE(repository.get_properties().front().warning_level == WarningLevel::Warning);
+		REQUIRE(repository.get_properties().front().warning_reason.starts_with("Existing reason\n"));
+	}
+
+	SECTION("NVMe wear-out") {
+		for (int day = 0; day < 30; ++day) {
+			StoragePropertyRepository repository;
+			repository.add_property(create_int_property("nvme_smart_health_information_log/percentage_used", 80 + day / 3));
+			repository.add_property(create_int_property("nvme_smart_health_information_log/temperature", 60));
+			tracker.add_sample(AttributeHistorySample::create(repository, start_time + day * 24h));
+		}
+		StoragePropertyRepository repository;
+		auto used = create_int_property("nvme_smart_health_information_log/percentage_used", 89);
+		used.warning_level = WarningLevel::Alert;  // never lowered
+		repository.add_property(used);
+		repository.add_property(create_int_property("nvme_smart_health_information_log/temperature", 60));
+		tracker.apply_warnings(repository);
+		REQUIRE(repository.get_properties()[0].warning_level == WarningLevel::Alert);
+		REQUIRE(!repository.get_properties()[0].warning_reason.empty());
+		REQUIRE(repository.get_properties()[1].warning_level == WarningLevel::None);  // within NVMe limits
+	}
+
+	SECTION("Temperature excursions") {
+		for (int i = 0; i < 30; ++i) {
+			StoragePropertyRepository repository;
+			repository.add_property(create_int_property("temperature/current", i % 3 == 0 ? 58 : 45));
+			tracker.add_sample(AttributeHistorySample::create(repository, start_time + i * 5min));
+		}
+		const auto* excursions = tracker.get_excursions("temperature/current");
+		REQUIRE(excursions);
+		REQUIRE(excursions->count == 10);
+		REQUIRE(excursions->max_temperature == 58);
+
+		StoragePropertyRepository repository;
+		repository.add_property(create_int_property("temperature/current", 45));
+		tracker.apply_warnings(repository);
+		REQUIRE(repository.get_properties().front().warning_level == WarningLevel::Warning);
+	}
+
+	SECTION("History") {
+		const hz::fs::path file_base = hz::fs::temp_directory_path() / "gsc_test_attribute_trend";
+		std::error_code ec;
+		for (const auto* ext : {".gshist", ".gshidx", ".gshser"}) {
+			hz::fs::path file = file_base;
+			file += ext;
+			hz::fs::remove(file, ec);
+		}
+
+		{
+			AttributeHistoryWriter writer;
+			REQUIRE(writer.open(file_base));
+			for (int day = 0; day < 10; ++day) {
+				REQUIRE(writer.append({start_time + day * 24h, {{"ata_attribute/5/raw", 2 * day}}}));
+			}
+		}
+
+		AttributeHistoryReader reader;
+		REQUIRE(reader.open(file_base));
+		tracker.add_sample({start_time + 4 * 24h, {{"ata_attribute/5/raw", 8}}});
+		tracker.add_history(reader);  // only the newer samples are added
+
+		const auto* stats = tracker.get_stats("ata_attribute/5/raw");
+		REQUIRE(stats);
+		REQUIRE(stats->sample_count == 6);
+		REQUIRE(stats->last_value == 18);
+		REQUIRE(stats->get_slope_per_day().value() == Approx(2.));
+		REQUIRE(tracker.get_last_time() == start_time + 9 * 24h);
+
+		for (const auto* ext : {".gshist", ".gshidx", ".gshser"}) {
+			hz::fs::path file = file_base;
+			file += ext;
+			hz::fs::remove(file, ec);
+		}
+	}
+}
+
+
+
+
+
+
+/// @}
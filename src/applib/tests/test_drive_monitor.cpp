@@ -0,0 +1,376 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "applib/command_executor_replay.h"
+#include "applib/drive_monitor.h"
+#include "applib/drive_monitor_file_sink.h"
+#include "hz/fs.h"
+#include "nlohmann/json.hpp"
+#include "rconfig/rconfig.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Create JSON output of "smartctl -x" for an ATA drive with reallocated sectors
+	std::string create_ata_output(int reallocated_sectors)
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["device"]["type"] = "sat";
+		root["model_name"] = "Test Drive";
+		root["serial_number"] = "TEST0001";
+		root["smart_status"]["passed"] = true;
+		root["ata_smart_attributes"]["table"].push_back({
+			{"id", 5}, {"name", "Reallocated_Sector_Ct"},
+			{"value", 100}, {"worst", 100}, {"thresh", 10}, {"when_failed", ""},
+			{"flags", {{"string", "PO--CK "}, {"prefailure", true}, {"updated_online", true}}},
+			{"raw", {{"value", reallocated_sectors}, {"string", std::to_string(reallocated_sectors)}}},
+		});
+		return root.dump();
+	}
+
+
+	/// Create JSON output of smartctl for a drive in standby mode, with "--nocheck=standby"
+	std::string create_standby_output()
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["smartctl"]["output"] = {"smartctl 7.4 2023-08-01 r5530 [x86_64-linux] (local build)", "",
+				"Device is in STANDBY mode, exit(2)"};
+		root["smartctl"]["exit_status"] = 2;
+		return root.dump();
+	}
+
+
+	/// Create a drive with a known type, as left by StorageDetector
+	StorageDevicePtr create_drive(const std::string& device)
+	{
+		auto drive = std::make_shared<StorageDevice>(device);
+		drive->set_detected_type(StorageDeviceDetectedType::AtaHdd);
+		return drive;
+	}
+
+
+	/// Count the lines in a file
+	int count_lines(const hz::fs::path& file)
+	{
+		std::ifstream ifs(file);
+		return static_cast<int>(std::count(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>(), '\n'));
+	}
+
+}
+
+
+
+TEST_CASE("DriveMonitor", "[app][monitor]")
+{
+	rconfig::set_default_data("system/smartctl_binary", "smartctl");
+	rconfig::set_default_data("system/smartctl_options", "");
+	rconfig::set_default_data("system/smartctl_device_options", "");
+	rconfig::set_default_data("system/skip_unsupported_logs", false);  // all the polls request the same logs
+	rconfig::set_default_data("system/log_support_cache", rconfig::json::array());
+	rconfig::set_default_data("system/log_support_reprobe_days", 30);
+
+	auto ex = std::make_shared<CommandExecutorReplay>();
+	DriveMonitor monitor(100s, 0.2, 1, [ex]() { return ex; });
+
+	SECTION("Jitter") {
+		const auto start_time = DriveMonitor::Clock::now();
+		for (int i = 0; i < 50; ++i) {
+			monitor.add_drive(create_drive("/dev/sd" + std::to_string(i)), start_time);
+		}
+		monitor.add_drive(std::make_shared<StorageDevice>("test.json", true), start_time);  // ignored
+		REQUIRE(monitor.get_drive_count() == 50);
+
+		// The first polls are spread over the jitter range
+		const auto next_time = monitor.get_next_poll_time();
+		REQUIRE(next_time.has_value());
+		REQUIRE(next_time.value() >= start_time);
+		REQUIRE(next_time.value() < start_time + 5s);
+
+		const int first_half = monitor.poll_due(start_time + 10s, nullptr);
+		REQUIRE(first_half > 0);
+		REQUIRE(first_half < 50);
+		REQUIRE(monitor.poll_due(start_time + 10s, nullptr) == 0);
+		REQUIRE(monitor.poll_due(start_time + 20s, nullptr) == 50 - first_half);
+
+		// Then they are spread over the jittered interval
+		REQUIRE(monitor.get_next_poll_time().value() >= start_time + 80s);
+		REQUIRE(monitor.poll_due(start_time + 79s, nullptr) == 0);
+		REQUIRE(monitor.poll_due(start_time + 140s, nullptr) == 50);
+	}
+
+	SECTION("Poll") {
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output(8));
+
+		const hz::fs::path history_dir = hz::fs::temp_directory_path() / "gsc_test_drive_monitor_history";
+		std::error_code ec;
+		hz::fs::remove_all(history_dir, ec);
+		hz::fs::create_directories(history_dir, ec);
+		monitor.set_history_dir(history_dir);
+
+		auto sda = create_drive("/dev/sda");
+		auto sdb = create_drive("/dev/sdb");
+		const auto start_time = DriveMonitor::Clock::now();
+		monitor.add_drive(sda, start_time);
+		monitor.add_drive(sdb, start_time);
+
+		std::vector<DriveMonitorRecord> records;
+		REQUIRE(monitor.poll_due(start_time + 100s, [&records](const DriveMonitorRecord& record) {
+			records.push_back(record);
+		}) == 2);
+		REQUIRE(records.size() == 2);
+
+		REQUIRE(records.at(0).device == "/dev/sda");
+		REQUIRE(records.at(0).model == "Test Drive");
+		REQUIRE(records.at(0).serial == "TEST0001");
+		REQUIRE(records.at(0).health_passed == true);
+		REQUIRE(records.at(0).error_message.empty());
+		REQUIRE(records.at(0).max_warning_level != WarningLevel::None);
+		REQUIRE(std::any_of(records.at(0).warnings.begin(), records.at(0).warnings.end(), [](const DriveMonitorWarning& w) {
+			return w.generic_name == "attr_reallocated_sector_count" && !w.reason.empty();
+		}));
+
+		// No output for sdb
+		REQUIRE(!records.at(1).error_message.empty());
+		REQUIRE(!records.at(1).health_passed.has_value());
+
+		// The outputs are not kept between polls
+		REQUIRE(sda->get_full_output().empty());
+
+		// Only the successful polls are recorded in history
+		AttributeHistoryReader history;
+		REQUIRE(history.open(attribute_history_get_file_base(history_dir, "Test Drive", "TEST0001", "/dev/sda")));
+		const auto time_range = history.get_time_range();
+		REQUIRE(time_range.has_value());
+		REQUIRE(history.read_series("ata_attribute/5/raw", time_range->first, time_range->second).at(0).second == 8);
+		REQUIRE(std::distance(hz::fs::directory_iterator(history_dir), hz::fs::directory_iterator()) == 3);
+		hz::fs::remove_all(history_dir, ec);
+	}
+
+	SECTION("Standby") {
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output(8));
+		ex->add_output({"--attributes", "/dev/sda"}, create_standby_output(), 2);
+
+		auto sda = create_drive("/dev/sda");
+		const auto start_time = DriveMonitor::Clock::now();
+		monitor.add_drive(sda, start_time);
+
+		std::vector<DriveMonitorRecord> records;
+		const auto sink = [&records](const DriveMonitorRecord& record) {
+			records.push_back(record);
+		};
+		REQUIRE(monitor.poll_due(start_time + 100s, sink) == 1);
+		REQUIRE(monitor.poll_due(start_time + 300s, sink) == 1);
+		REQUIRE(records.size() == 2);
+
+		// The drive is never woken up
+		REQUIRE(ex->get_executed_args().size() == 2);
+		for (const auto& args : ex->get_executed_args()) {
+			REQUIRE(std::find(args.begin(), args.end(), "--nocheck=standby,2") != args.end());
+		}
+
+		REQUIRE(!records.at(0).in_standby);
+		REQUIRE(records.at(0).data_time.has_value());
+
+		// The second poll reports the data of the first one
+		REQUIRE(records.at(1).in_standby);
+		REQUIRE(records.at(1).error_message.empty());
+		REQUIRE(records.at(1).data_time == records.at(0).data_time);
+		REQUIRE(records.at(1).health_passed == true);
+		REQUIRE(records.at(1).max_warning_level == records.at(0).max_warning_level);
+		REQUIRE(sda->get_is_in_standby());
+		REQUIRE(sda->get_parse_status() == StorageDevice::ParseStatus::Full);
+
+		const auto root = nlohmann::json::parse(records.at(1).to_json_line());
+		REQUIRE(root.at("in_standby") == true);
+		REQUIRE(root.contains("data_time"));
+		REQUIRE(!root.contains("error"));
+	}
+
+	SECTION("StandbyMessageOnly") {
+		// The message alone is not enough, smartctl must exit with the status requested by --nocheck
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output(8));
+		ex->add_output({"--attributes", "/dev/sda"}, create_standby_output(), 0);
+
+		auto sda = create_drive("/dev/sda");
+		const auto start_time = DriveMonitor::Clock::now();
+		monitor.add_drive(sda, start_time);
+
+		std::vector<DriveMonitorRecord> records;
+		const auto sink = [&records](const DriveMonitorRecord& record) {
+			records.push_back(record);
+		};
+		REQUIRE(monitor.poll_due(start_time + 100s, sink) == 1);
+		REQUIRE(monitor.poll_due(start_time + 300s, sink) == 1);
+		REQUIRE(records.size() == 2);
+
+		REQUIRE(!records.at(1).in_standby);
+		REQUIRE(!sda->get_is_in_standby());
+	}
+
+	SECTION("Wakeup") {
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output(8));
+		monitor.set_allow_wakeup(true);
+		monitor.add_drive(create_drive("/dev/sda"), DriveMonitor::Clock::now());
+		REQUIRE(monitor.poll_due(DriveMonitor::Clock::time_point::max(), nullptr) == 1);
+		const auto& args = ex->get_executed_args().at(0);
+		REQUIRE(std::find(args.begin(), args.end(), "--nocheck=standby,2") == args.end());
+	}
+
+	SECTION("Tiers") {
+		// Pulse output has no identity info
+		auto pulse_root = nlohmann::json::parse(create_ata_output(9));
+		pulse_root.erase("model_name");
+		pulse_root.erase("serial_number");
+		pulse_root["smartctl"]["output"] = {"smartctl 7.4 2023-08-01 r5530 [x86_64-linux] (local build)"};
+
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output(8));
+		ex->add_output({"--attributes", "/dev/sda"}, pulse_root.dump());
+
+		auto sda = create_drive("/dev/sda");
+		const auto start_time = DriveMonitor::Clock::now();
+		monitor.add_drive(sda, start_time);
+
+		std::vector<DriveMonitorRecord> records;
+		const auto sink = [&records](const DriveMonitorRecord& record) {
+			records.push_back(record);
+		};
+		REQUIRE(monitor.poll_due(start_time + 100s, sink) == 1);
+		const auto full_data_time = sda->get_full_data_time();
+		REQUIRE(full_data_time.has_value());
+		REQUIRE(monitor.poll_due(start_time + 300s, sink) == 1);
+		REQUIRE(records.size() == 2);
+
+		// The first poll fetches everything, the second one only the health and attributes
+		const auto has_arg = [](const std::vector<std::string>& args, const std::string& arg) {
+			return std::find(args.begin(), args.end(), arg) != args.end();
+		};
+		REQUIRE(has_arg(ex->get_executed_args().at(0), "--log=scttemp"));
+		REQUIRE(!has_arg(ex->get_executed_args().at(1), "--log=scttemp"));
+		REQUIRE(has_arg(ex->get_executed_args().at(1), "--health"));
+
+		// The attributes are merged into the full data
+		REQUIRE(records.at(1).error_message.empty());
+		REQUIRE(records.at(1).model == "Test Drive");
+		REQUIRE(records.at(1).serial == "TEST0001");
+		REQUIRE(sda->get_full_data_time() == full_data_time);
+		REQUIRE(sda->get_section_data_time(StoragePropertySection::AtaAttributes) >= full_data_time);
+		REQUIRE(sda->get_section_data_time(StoragePropertySection::Info) == full_data_time);
+		REQUIRE(records.at(1).data_time == sda->get_section_data_time(StoragePropertySection::AtaAttributes));
+
+		const auto* attr = sda->get_property_repository().find_property("attr_reallocated_sector_count",
+				StoragePropertySection::AtaAttributes);
+		REQUIRE(attr != nullptr);
+		REQUIRE(attr->get_value<AtaStorageAttribute>().raw_value_int == 9);
+		const auto attributes = sda->get_property_repository().get_section_properties(StoragePropertySection::AtaAttributes);
+		REQUIRE(std::count_if(attributes.begin(), attributes.end(), [](const StorageProperty* p) {
+			return p->generic_name == "attr_reallocated_sector_count";
+		}) == 1);
+
+		const auto& changes = sda->get_property_changes();
+		REQUIRE(std::any_of(changes.changed.begin(), changes.changed.end(), [](const StoragePropertyRepositoryDiff::Change& change) {
+			return change.new_property.generic_name == "attr_reallocated_sector_count";
+		}));
+		// Only the merged properties are compared
+		REQUIRE(changes.removed.empty());
+		REQUIRE(sda->get_tier_output() == pulse_root.dump());
+
+		// Only the merged properties are fresh, the kept ones are not sampled again
+		const auto& fetched = sda->get_fetched_property_repository();
+		REQUIRE(fetched.find_property("attr_reallocated_sector_count", StoragePropertySection::AtaAttributes) != nullptr);
+		REQUIRE(fetched.find_property("model_name") == nullptr);
+		REQUIRE(sda->get_property_repository().find_property("model_name") != nullptr);
+
+		// Everything is fetched again when the full data gets old
+		monitor.set_full_fetch_interval(0s);
+		REQUIRE(monitor.poll_due(start_time + 500s, sink) == 1);
+		REQUIRE(has_arg(ex->get_executed_args().at(2), "--log=scttemp"));
+		REQUIRE(sda->get_tier_output().empty());
+		REQUIRE(&sda->get_fetched_property_repository() == &sda->get_property_repository());
+
+		// The last recorded output has no identity info, which is reported as removed
+		const auto& full_changes = sda->get_property_changes();
+		REQUIRE(std::any_of(full_changes.removed.begin(), full_changes.removed.end(), [](const StorageProperty& p) {
+			return p.generic_name == "model_name";
+		}));
+	}
+
+	SECTION("JSON line") {
+		DriveMonitorRecord record;
+		record.time = std::chrono::system_clock::time_point(1700000000s);
+		record.device = "/dev/sda";
+		record.model = "Test\xff Drive";  // invalid UTF-8
+		record.health_passed = false;
+		record.max_warning_level = WarningLevel::Alert;
+		record.warnings.push_back({"attr_reallocated_sector_count", "Reallocated Sector Count", "8", WarningLevel::Alert, "Reason"});
+
+		const std::string line = record.to_json_line();
+		REQUIRE(line.find('\n') == std::string::npos);
+
+		const auto root = nlohmann::json::parse(line);
+		REQUIRE(root.at("time") == 1700000000);
+		REQUIRE(root.at("health_passed") == false);
+		REQUIRE(root.at("max_warning_level") == "alert");
+		REQUIRE(root.at("warnings").at(0).at("name") == "attr_reallocated_sector_count");
+		REQUIRE(root.at("warnings").at(0).at("level") == "alert");
+		REQUIRE(!root.contains("error"));
+
+		record.health_passed.reset();
+		REQUIRE(nlohmann::json::parse(record.to_json_line()).at("health_passed").is_null());
+	}
+
+	SECTION("File sink rotation") {
+		const hz::fs::path file = hz::fs::temp_directory_path() / "gsc_test_drive_monitor.jsonl";
+		std::error_code ec;
+		hz::fs::remove(file, ec);
+
+		DriveMonitorRecord record;
+		record.device = "/dev/sda";
+		const auto line_size = record.to_json_line().size() + 1;
+
+		DriveMonitorFileSink sink(file, line_size * 2);
+		hz::fs::remove(sink.get_rotated_file(), ec);
+
+		REQUIRE(!sink.write(record));
+		REQUIRE(!sink.write(record));
+		REQUIRE(count_lines(file) == 2);
+		REQUIRE(!hz::fs::exists(sink.get_rotated_file(), ec));
+
+		REQUIRE(!sink.write(record));
+		REQUIRE(count_lines(file) == 1);
+		REQUIRE(count_lines(sink.get_rotated_file()) == 2);
+
+		hz::fs::remove(file, ec);
+		hz::fs::remove(sink.get_rotated_file(), ec);
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,258 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "applib/command_executor_replay.h"
+#include "applib/selftest_orchestrator.h"
+#include "nlohmann/json.hpp"
+#include "rconfig/rconfig.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Output of "smartctl --test=short" on ATA drives
+	const std::string ata_test_started_output =
+			"Sending command: \"Execute SMART Short self-test routine immediately in off-line mode\".\n"
+			"Drive command \"Execute SMART Short self-test routine immediately in off-line mode\" successful.\n"
+			"Testing has begun.";
+
+
+	/// Output of "smartctl --abort" on ATA drives
+	const std::string ata_test_aborted_output =
+			"Sending command: \"Abort SMART off-line mode self-test routine\".\n"
+			"Self-testing aborted!";
+
+
+	/// Create JSON output of an ATA drive with self-test capabilities and the specified self-test execution status
+	std::string create_ata_output(int status_value, int remaining_percent = 0, bool conveyance_supported = false)
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["smartctl"]["output"] = {"smartctl 7.4 2023-08-01 r5530"};
+		root["device"]["type"] = "sat";
+		root["model_name"] = "Test Drive";
+		root["serial_number"] = "TEST0001";
+		root["ata_smart_data"]["capabilities"]["self_tests_supported"] = true;
+		root["ata_smart_data"]["capabilities"]["conveyance_self_test_supported"] = conveyance_supported;
+		root["ata_smart_data"]["self_test"]["polling_minutes"]["short"] = 2;
+		root["ata_smart_data"]["self_test"]["status"]["value"] = status_value;
+		if (remaining_percent > 0) {
+			root["ata_smart_data"]["self_test"]["status"]["remaining_percent"] = remaining_percent;
+		}
+		return root.dump();
+	}
+
+
+	/// Create a drive with the capabilities read from smartctl output
+	StorageDevicePtr create_drive(const std::string& device, bool conveyance_supported = false)
+	{
+		auto drive = std::make_shared<StorageDevice>(device);
+		drive->set_full_output(create_ata_output(0, 0, conveyance_supported));
+		REQUIRE(drive->parse_full_data(SmartctlParserType::Ata, SmartctlOutputFormat::Json));
+		return drive;
+	}
+
+
+	/// Count the executed commands containing all of \c args
+	int count_executed(const CommandExecutorReplay& ex, const std::vector<std::string>& args)
+	{
+		return static_cast<int>(std::count_if(ex.get_executed_args().begin(), ex.get_executed_args().end(),
+				[&args](const std::vector<std::string>& executed) {
+					return std::all_of(args.begin(), args.end(), [&executed](const std::string& arg) {
+						return std::find(executed.begin(), executed.end(), arg) != executed.end();
+					});
+				}));
+	}
+
+
+	/// Run tick() at the requested times until all the tests are done
+	int run_to_completion(SelfTestOrchestrator& orchestrator)
+	{
+		int ticks = 0;
+		while (auto next_time = orchestrator.get_next_tick_time()) {
+			orchestrator.tick(next_time.value());
+			++ticks;
+			REQUIRE(ticks < 100);
+		}
+		return ticks;
+	}
+
+}
+
+
+
+TEST_CASE("SelfTestOrchestrator", "[app][selftest]")
+{
+	rconfig::set_default_data("system/smartctl_binary", "smartctl");
+	rconfig::set_default_data("system/smartctl_options", "");
+	rconfig::set_default_data("system/smartctl_device_options", "");
+
+	auto ex = std::make_shared<CommandExecutorReplay>();
+	const auto executor_factory = [ex]() { return ex; };
+
+	// Two drives on the first controller, one on the second
+	const auto controller_key_func = [](const StorageDevice& drive) {
+		return std::string(drive.get_device() == "/dev/sdc" ? "hba1" : "hba0");
+	};
+
+	auto sda = create_drive("/dev/sda");
+	auto sdb = create_drive("/dev/sdb");
+	auto sdc = create_drive("/dev/sdc");
+
+	for (const std::string device : {"/dev/sda", "/dev/sdb", "/dev/sdc"}) {
+		ex->add_output({"--test=short", device}, ata_test_started_output);
+		ex->add_output({"--abort", device}, ata_test_aborted_output);
+	}
+
+	SelfTestOrchestrator orchestrator(SelfTest::TestType::ShortTest, 1, executor_factory, controller_key_func);
+
+	SECTION("Controller limit") {
+		ex->add_output({"--log=selftest", "/dev/sda"}, create_ata_output(0xf9, 50));
+		ex->add_output({"--log=selftest", "/dev/sda"}, create_ata_output(0x00));
+		ex->add_output({"--log=selftest", "/dev/sdb"}, create_ata_output(0x00));
+		ex->add_output({"--log=selftest", "/dev/sdc"}, create_ata_output(0x70));
+
+		orchestrator.add_drive(sda);
+		orchestrator.add_drive(sdb);
+		orchestrator.add_drive(sdc);
+		orchestrator.add_drive(sdc);  // ignored
+		REQUIRE(orchestrator.get_results().size() == 3);
+		REQUIRE(orchestrator.get_summary().queued == 3);
+
+		const auto start_time = SelfTestOrchestrator::Clock::now();
+		orchestrator.tick(start_time);
+
+		// sdb waits for sda
+		REQUIRE(count_executed(*ex, {"--test=short", "/dev/sda"}) == 1);
+		REQUIRE(count_executed(*ex, {"--test=short", "/dev/sdb"}) == 0);
+		REQUIRE(count_executed(*ex, {"--test=short", "/dev/sdc"}) == 1);
+		REQUIRE(orchestrator.get_summary().running == 2);
+		REQUIRE(orchestrator.get_summary().queued == 1);
+		REQUIRE(orchestrator.is_drive_active(sdb));
+		REQUIRE(sda->get_test_is_active());
+		REQUIRE(!sdb->get_test_is_active());
+		REQUIRE(orchestrator.get_next_tick_time() == start_time + SelfTestPollScheduler::first_poll_delay);
+
+		run_to_completion(orchestrator);
+
+		REQUIRE(!orchestrator.is_active());
+		REQUIRE(count_executed(*ex, {"--test=short", "/dev/sdb"}) == 1);
+		REQUIRE(count_executed(*ex, {"--log=selftest", "/dev/sda"}) == 2);
+		REQUIRE(count_executed(*ex, {"--log=selftest", "/dev/sdc"}) == 1);
+		REQUIRE(!sda->get_test_is_active());
+		REQUIRE(!sdb->get_test_is_active());
+
+		// Only one test ran on hba0 at a time
+		const auto& executed = ex->get_executed_args();
+		const auto sdb_started = std::find_if(executed.begin(), executed.end(), [](const std::vector<std::string>& args) {
+			return args.back() == "/dev/sdb";
+		});
+		REQUIRE(std::find_if(sdb_started, executed.end(), [](const std::vector<std::string>& args) {
+			return args.back() == "/dev/sda";
+		}) == executed.end());
+
+		const auto results = orchestrator.get_results();
+		REQUIRE(results.at(0).drive == sda);
+		REQUIRE(results.at(0).state == SelfTestOrchestrator::DriveState::Finished);
+		REQUIRE(results.at(0).status == SelfTestStatus::CompletedNoError);
+		REQUIRE(results.at(2).controller_key == "hba1");
+		REQUIRE(results.at(2).status == SelfTestStatus::CompletedWithError);
+
+		const auto summary = orchestrator.get_summary();
+		REQUIRE(summary.passed == 2);
+		REQUIRE(summary.failed == 1);
+		REQUIRE(summary.errors == 0);
+	}
+
+	SECTION("Failures and skipped drives") {
+		// Unexpected output: sdd fails to start, and sdb takes its slot in the same tick
+		ex->add_output({"--test=short", "/dev/sdd"}, "Unknown command");
+		ex->add_output({"--log=selftest", "/dev/sdb"}, create_ata_output(0x00));
+		ex->add_output({"--log=selftest", "/dev/sdc"}, "{\"smartctl\": ");
+
+		auto sdd = create_drive("/dev/sdd");
+		orchestrator.add_drive(sdd);
+		orchestrator.add_drive(sdb);
+		orchestrator.add_drive(sdc);
+
+		auto busy = create_drive("/dev/sde");
+		busy->set_test_is_active(true);
+		orchestrator.add_drive(busy);
+		orchestrator.add_drive(std::make_shared<StorageDevice>("test.json", true));
+
+		orchestrator.tick(SelfTestOrchestrator::Clock::now());
+		REQUIRE(orchestrator.get_results().at(0).state == SelfTestOrchestrator::DriveState::Failed);
+		REQUIRE(orchestrator.get_results().at(1).state == SelfTestOrchestrator::DriveState::Running);
+
+		run_to_completion(orchestrator);
+
+		// sdc output can't be parsed, so its test was aborted
+		REQUIRE(orchestrator.get_results().at(2).state == SelfTestOrchestrator::DriveState::Failed);
+		REQUIRE(count_executed(*ex, {"--abort", "/dev/sdc"}) == 1);
+		REQUIRE(count_executed(*ex, {"/dev/sde"}) == 0);
+
+		const auto summary = orchestrator.get_summary();
+		REQUIRE(summary.passed == 1);
+		REQUIRE(summary.errors == 2);
+		REQUIRE(summary.skipped == 2);
+	}
+
+	SECTION("Unsupported test") {
+		SelfTestOrchestrator conveyance(SelfTest::TestType::Conveyance, 1, executor_factory, controller_key_func);
+		conveyance.add_drive(sda);
+		conveyance.add_drive(create_drive("/dev/sdd", true));
+		REQUIRE(conveyance.get_results().at(0).state == SelfTestOrchestrator::DriveState::Skipped);
+		REQUIRE(conveyance.get_results().at(1).state == SelfTestOrchestrator::DriveState::Queued);
+	}
+
+	SECTION("Abort") {
+		ex->add_output({"--log=selftest", "/dev/sda"}, create_ata_output(0x10));
+
+		orchestrator.add_drive(sda);
+		orchestrator.add_drive(sdb);
+		orchestrator.tick(SelfTestOrchestrator::Clock::now());
+		orchestrator.abort();
+
+		REQUIRE(!orchestrator.is_active());
+		REQUIRE(!orchestrator.get_next_tick_time().has_value());
+		REQUIRE(count_executed(*ex, {"--abort", "/dev/sda"}) == 1);
+		REQUIRE(orchestrator.get_results().at(0).status == SelfTestStatus::ManuallyAborted);
+		REQUIRE(orchestrator.get_results().at(1).state == SelfTestOrchestrator::DriveState::Cancelled);
+		REQUIRE(!sda->get_test_is_active());
+		REQUIRE(orchestrator.get_summary().warnings == 1);
+		REQUIRE(orchestrator.get_summary().skipped == 1);
+	}
+
+	SECTION("Default controller key") {
+		const StorageDevice raid_drive_1("/dev/bus/0", "megaraid,1");
+		const StorageDevice raid_drive_2("/dev/bus/0", "megaraid,2");
+		REQUIRE(SelfTestOrchestrator::get_default_controller_key(raid_drive_1) == SelfTestOrchestrator::get_default_controller_key(raid_drive_2));
+		REQUIRE(SelfTestOrchestrator::get_default_controller_key(StorageDevice("/dev/gsc_test_nonexistent")) == "/dev/gsc_test_nonexistent");
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,119 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+#include "applib/selftest_poll_scheduler.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Result of a simulated test
+	struct SimulationResult {
+		int polls = 0;  ///< Number of polls while the test was running, plus the one that noticed the completion
+		std::chrono::seconds completion_latency {0};  ///< Time between the completion and the poll that noticed it
+	};
+
+
+	/// Simulate a test which takes \c actual_duration and reports the remaining percentage
+	/// from \c start_percent down to 0, in steps of \c percent_step.
+	SimulationResult simulate_test(std::chrono::seconds advertised_duration, std::chrono::seconds actual_duration,
+			int start_percent, int percent_step)
+	{
+		const auto start_time = SelfTestPollScheduler::Clock::time_point() + 1000h;
+		SelfTestPollScheduler scheduler(advertised_duration, start_time);
+
+		SimulationResult result;
+		std::chrono::seconds elapsed = 0s;
+		while (true) {
+			elapsed += scheduler.get_poll_delay();
+			++result.polls;
+			if (elapsed >= actual_duration) {
+				result.completion_latency = elapsed - actual_duration;
+				return result;
+			}
+			const int done_percent = int(elapsed.count() * start_percent / actual_duration.count());
+			const int remaining_percent = start_percent - done_percent / percent_step * percent_step;
+			scheduler.add_sample(start_time + elapsed, static_cast<int8_t>(remaining_percent));
+		}
+	}
+
+}
+
+
+
+TEST_CASE("SelfTestPollScheduler", "[app][selftest]")
+{
+	SECTION("First poll") {
+		SelfTestPollScheduler scheduler(10h, SelfTestPollScheduler::Clock::now());
+		REQUIRE(scheduler.get_poll_delay() == SelfTestPollScheduler::first_poll_delay);
+		REQUIRE(scheduler.get_seconds_per_percent().value() == Approx(400.));
+	}
+
+	SECTION("Learned rate") {
+		const auto start_time = SelfTestPollScheduler::Clock::now();
+		SelfTestPollScheduler scheduler(0s, start_time);
+		REQUIRE(!scheduler.get_seconds_per_percent().has_value());
+		REQUIRE(!scheduler.get_estimated_completion().has_value());
+
+		scheduler.add_sample(start_time + 10s, 100);
+		REQUIRE(!scheduler.get_seconds_per_percent().has_value());
+		scheduler.add_sample(start_time + 130s, 99);  // the change is assumed to be in the middle
+		REQUIRE(scheduler.get_seconds_per_percent().value() == Approx(60.));
+		REQUIRE(scheduler.get_estimated_completion().value() == start_time + 70s + 99 * 60s);
+	}
+
+	SECTION("ATA extended test, 10 hours") {
+		const auto result = simulate_test(10h, 10h, 90, 10);
+		// The old schedule (a third of each 10% step, 400 seconds during the last one) needed about 30 polls.
+		REQUIRE(result.polls <= 20);
+		REQUIRE(result.completion_latency <= SelfTestPollScheduler::max_uncertain_poll_delay);
+	}
+
+	SECTION("ATA extended test, slower than advertised") {
+		const auto result = simulate_test(10h, 13h, 90, 10);
+		REQUIRE(result.polls <= 30);
+		REQUIRE(result.completion_latency <= SelfTestPollScheduler::max_uncertain_poll_delay);
+	}
+
+	SECTION("ATA short test") {
+		const auto result = simulate_test(2min, 2min, 90, 10);
+		REQUIRE(result.polls <= 10);
+		REQUIRE(result.completion_latency <= SelfTestPollScheduler::min_poll_delay * 2);
+	}
+
+	SECTION("NVMe extended test, 10 hours") {
+		const auto result = simulate_test(0s, 10h, 100, 1);
+		// The old schedule polled every 15 seconds.
+		REQUIRE(result.polls * 10 <= 10h / 15s);
+		REQUIRE(result.completion_latency <= SelfTestPollScheduler::min_poll_delay * 2);
+	}
+
+	SECTION("NVMe short test") {
+		const auto result = simulate_test(0s, 2min, 100, 1);
+		REQUIRE(result.polls <= 10);
+		REQUIRE(result.completion_latency <= SelfTestPollScheduler::min_poll_delay * 2);
+	}
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,198 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "applib/selftest_status_probe.h"
+#include "applib/smartctl_parse_cache.h"
+#include "nlohmann/json.hpp"
+
+
+
+namespace {
+
+	/// Create JSON output of "smartctl --capabilities --log=selftest --json=o" with common keys
+	nlohmann::json create_json_output(const std::string& device_type)
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["smartctl"]["output"] = {"smartctl 7.4 2023-08-01 r5530", "=== START OF READ SMART DATA SECTION ==="};
+		root["device"]["type"] = device_type;
+		root["model_name"] = "Test Drive";
+		root["serial_number"] = "TEST0001";
+		return root;
+	}
+
+
+	/// Create ATA output with the specified self-test execution status
+	std::string create_ata_output(std::optional<int> status_value, std::optional<int> remaining_percent)
+	{
+		nlohmann::json root = create_json_output("sat");
+		root["ata_smart_data"]["capabilities"]["self_tests_supported"] = true;
+		if (status_value.has_value()) {
+			root["ata_smart_data"]["self_test"]["status"]["value"] = status_value.value();
+			if (remaining_percent.has_value()) {
+				root["ata_smart_data"]["self_test"]["status"]["remaining_percent"] = remaining_percent.value();
+			}
+		}
+		return root.dump();
+	}
+
+
+	/// Create NVMe output with the specified current operation and self-test log results (latest first)
+	std::string create_nvme_output(std::optional<int> current_operation, std::optional<int> completion_percent,
+			const std::vector<int>& results)
+	{
+		nlohmann::json root = create_json_output("nvme");
+		root["nvme_self_test_log"]["nsid"] = 1;
+		if (current_operation.has_value()) {
+			root["nvme_self_test_log"]["current_self_test_operation"]["value"] = current_operation.value();
+		}
+		if (completion_percent.has_value()) {
+			root["nvme_self_test_log"]["current_self_test_completion_percent"] = completion_percent.value();
+		}
+		for (int result : results) {
+			root["nvme_self_test_log"]["table"].push_back({
+				{"self_test_code", {{"value", 1}}},
+				{"self_test_result", {{"value", result}}},
+				{"power_on_hours", 1000},
+			});
+		}
+		return root.dump();
+	}
+
+
+	/// Get the self-test status the same way as SelfTest::update() did before the probe was added:
+	/// parse the output fully and read the status from the properties.
+	hz::ExpectedValue<std::optional<SelfTestStatusReport>, SmartctlParserError> get_status_from_full_parse(
+			StorageDeviceDetectedType detected_type, const std::string& output)
+	{
+		const auto parser_type = (detected_type == StorageDeviceDetectedType::Nvme ? SmartctlParserType::Nvme : SmartctlParserType::Ata);
+		auto parse_status = SmartctlParseCache::parse(parser_type, SmartctlOutputFormat::Json, output);
+		if (!parse_status) {
+			return hz::UnexpectedFrom(parse_status);
+		}
+		return SelfTestStatusProbe::from_properties(detected_type, *parse_status.value());
+	}
+
+
+	/// Check that the probe gives the same result as the full parse
+	void check_probe(StorageDeviceDetectedType detected_type, const std::string& output)
+	{
+		const auto probed = SelfTestStatusProbe::probe_json(detected_type, output);
+		const auto parsed = get_status_from_full_parse(detected_type, output);
+		REQUIRE(probed.has_value() == parsed.has_value());
+		if (probed.has_value()) {
+			REQUIRE(probed.value() == parsed.value());
+		} else {
+			REQUIRE(probed.error().data() == parsed.error().data());
+		}
+	}
+
+}
+
+
+
+TEST_CASE("SelfTestStatusProbe", "[app][parser]")
+{
+	SECTION("ATA") {
+		// In progress, with and without the remaining percentage
+		check_probe(StorageDeviceDetectedType::AtaHdd, create_ata_output(249, 90));
+		check_probe(StorageDeviceDetectedType::AtaHdd, create_ata_output(241, std::nullopt));
+		// All the status values
+		for (int status_value = 0; status_value <= 0xff; status_value += 0x10) {
+			check_probe(StorageDeviceDetectedType::AtaSsd, create_ata_output(status_value, std::nullopt));
+		}
+		// Not reported
+		check_probe(StorageDeviceDetectedType::AtaHdd, create_ata_output(std::nullopt, std::nullopt));
+
+		const auto report = SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::AtaHdd, create_ata_output(249, 90));
+		REQUIRE(report.has_value());
+		REQUIRE(report.value().has_value());
+		REQUIRE(report.value()->status == SelfTestStatus::InProgress);
+		REQUIRE(report.value()->remaining_percent == 90);
+
+		const auto completed = SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::AtaHdd, create_ata_output(0x70, std::nullopt));
+		REQUIRE(completed.has_value());
+		REQUIRE(completed.value()->status == SelfTestStatus::CompletedWithError);
+		REQUIRE(!completed.value()->remaining_percent.has_value());
+	}
+
+	SECTION("NVMe") {
+		// In progress, with and without the completion percentage, including unknown operations
+		check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(1, 25, {0}));
+		check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(2, std::nullopt, {}));
+		check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(5, 10, {}));
+		// Finished, with all the results of the latest entry
+		for (int result = 0; result <= 0x10; ++result) {
+			check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(0, std::nullopt, {result, 0}));
+			check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(std::nullopt, std::nullopt, {result}));
+		}
+		// Not reported
+		check_probe(StorageDeviceDetectedType::Nvme, create_nvme_output(0, std::nullopt, {}));
+
+		const auto report = SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::Nvme, create_nvme_output(1, 25, {0}));
+		REQUIRE(report.has_value());
+		REQUIRE(report.value()->status == SelfTestStatus::InProgress);
+		REQUIRE(report.value()->remaining_percent == 75);
+
+		const auto aborted = SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::Nvme, create_nvme_output(0, std::nullopt, {1, 0}));
+		REQUIRE(aborted.has_value());
+		REQUIRE(aborted.value()->status == SelfTestStatus::ManuallyAborted);
+	}
+
+	SECTION("Errors") {
+		for (auto detected_type : {StorageDeviceDetectedType::AtaHdd, StorageDeviceDetectedType::Nvme}) {
+			check_probe(detected_type, "");
+			check_probe(detected_type, " \n");
+			check_probe(detected_type, "{\"smartctl\": ");
+			check_probe(detected_type, "smartctl 7.4 2023-08-01 r5530\n");
+			check_probe(detected_type, R"({"device": {"type": "sat"}})");
+			check_probe(detected_type, R"({"smartctl": {"version": [5, 0]}, "model_name": "Test Drive"})");
+		}
+		REQUIRE(SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::AtaHdd, "").error().data() == SmartctlParserError::EmptyInput);
+	}
+}
+
+
+
+TEST_CASE("SelfTestStatusProbeBenchmark", "[.][app][parser][benchmark]")
+{
+	std::string ata_output = create_ata_output(249, 90);
+	std::string nvme_output = create_nvme_output(1, 25, std::vector<int>(20, 0));
+
+	BENCHMARK("probe_json (ATA)") {
+		return SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::AtaHdd, ata_output);
+	};
+	BENCHMARK("full parse (ATA)") {
+		ata_output += ' ';  // avoid the parse cache
+		return get_status_from_full_parse(StorageDeviceDetectedType::AtaHdd, ata_output);
+	};
+	BENCHMARK("probe_json (NVMe)") {
+		return SelfTestStatusProbe::probe_json(StorageDeviceDetectedType::Nvme, nvme_output);
+	};
+	BENCHMARK("full parse (NVMe)") {
+		nvme_output += ' ';  // avoid the parse cache
+		return get_status_from_full_parse(StorageDeviceDetectedType::Nvme, nvme_output);
+	};
+	SmartctlParseCache::clear();
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,121 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "applib/series_downsampler.h"
+
+
+
+namespace {
+
+	/// Compare the coordinates of two points
+	bool same_point(const SeriesPoint& a, const SeriesPoint& b)
+	{
+		return a.x == Approx(b.x) && a.y == Approx(b.y);
+	}
+
+
+	/// Create a slowly changing series with a single spike
+	std::vector<SeriesPoint> create_points(std::size_t count, std::size_t spike_index)
+	{
+		std::vector<SeriesPoint> points;
+		points.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			const double x = static_cast<double>(i) * 60.;
+			points.push_back({x, (i == spike_index ? 90. : 40. + 5. * std::sin(x / 100000.))});
+		}
+		return points;
+	}
+
+}
+
+
+
+TEST_CASE("SeriesDownsampler", "[app][graph]")
+{
+	const std::size_t count = 1'000'000;
+	const std::size_t spike_index = 123'457;
+	const SeriesDownsampler data(create_points(count, spike_index));
+	const double last_x = static_cast<double>(count - 1) * 60.;
+
+	REQUIRE(data.size() == count);
+	REQUIRE(data.get_x_range().value().first == Approx(0.));
+	REQUIRE(data.get_x_range().value().second == Approx(last_x));
+	REQUIRE(data.get_y_range(0., last_x).value().second == Approx(90.));
+	REQUIRE(data.get_y_range(0., static_cast<double>(spike_index - 1) * 60.).value().second < 50.);
+	REQUIRE(!data.get_y_range(-100., -1.).has_value());
+
+	SECTION("Line") {
+		// The output is limited by the width, and the spike survives
+		const auto line = data.get_line(0., last_x, 800);
+		REQUIRE(line.size() <= 800);
+		REQUIRE(same_point(line.front(), data.get_points().front()));
+		REQUIRE(std::is_sorted(line.begin(), line.end(), [](const SeriesPoint& a, const SeriesPoint& b) { return a.x < b.x; }));
+		REQUIRE(std::any_of(line.begin(), line.end(), [](const SeriesPoint& p) { return p.y == Approx(90.); }));
+
+		// Zoomed in enough, the points are returned as they are, with a neighbour on each side
+		const auto zoomed = data.get_line(600., 6000., 800);
+		REQUIRE(zoomed.size() == 93);
+		REQUIRE(zoomed.front().x == Approx(540.));
+		REQUIRE(zoomed.back().x == Approx(6060.));
+	}
+
+	SECTION("Envelope") {
+		const auto envelope = data.get_envelope(0., last_x, 1000);
+		REQUIRE(envelope.size() == 1000);
+		REQUIRE(std::all_of(envelope.begin(), envelope.end(), [](const auto& column) { return column.has_value(); }));
+		const auto spike_column = static_cast<std::size_t>(static_cast<double>(spike_index) * 60. / (last_x / 1000.));
+		REQUIRE(envelope.at(spike_column)->second == Approx(90.));
+		REQUIRE(envelope.at(spike_column + 1)->second < 50.);
+
+		// Columns between the points are empty
+		const auto sparse = data.get_envelope(0., 600., 100);
+		REQUIRE(std::count_if(sparse.begin(), sparse.end(), [](const auto& column) { return column.has_value(); }) == 11);
+	}
+
+	SECTION("Small series") {
+		REQUIRE(SeriesDownsampler().get_line(0., 1., 10).empty());
+		const SeriesDownsampler single({{5., 1.}});
+		REQUIRE(single.get_line(0., 10., 10).size() == 1);
+		REQUIRE(single.get_y_range(0., 10.).value().first == Approx(1.));
+		REQUIRE(single.get_y_range(0., 10.).value().second == Approx(1.));
+	}
+}
+
+
+
+TEST_CASE("SeriesDownsamplerLttb", "[app][graph]")
+{
+	std::vector<SeriesPoint> points;
+	for (int i = 0; i < 100; ++i) {
+		points.push_back({double(i), (i == 50 ? 10. : 0.)});
+	}
+	const auto reduced = series_downsample_lttb(points, 10);
+	REQUIRE(reduced.size() == 10);
+	REQUIRE(same_point(reduced.front(), points.front()));
+	REQUIRE(same_point(reduced.back(), points.back()));
+	REQUIRE(std::any_of(reduced.begin(), reduced.end(), [](const SeriesPoint& p) { return p.y == Approx(10.); }));
+
+	REQUIRE(series_downsample_lttb(points, 200).size() == 100);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,132 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include "applib/smartctl_log_support_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "applib/command_executor_replay.h"
+#include "applib/storage_device.h"
+#include "nlohmann/json.hpp"
+#include "rconfig/rconfig.h"
+
+
+
+namespace {
+
+	using namespace std::literals;
+
+
+	/// Create JSON output of "smartctl -x" for an ATA drive without SCT support
+	std::string create_ata_output()
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["smartctl"]["output"] = {"smartctl 7.4 2023-08-01 r5530 [x86_64-linux] (local build)", "",
+				"SCT Commands not supported", "", "Device Statistics (GP/SMART Log 0x04) not supported"};
+		root["device"]["type"] = "sat";
+		root["model_name"] = "Test Drive";
+		root["firmware_version"] = "FW01";
+		root["serial_number"] = "TEST0001";
+		root["smart_status"]["passed"] = true;
+		root["sata_phy_event_counters"]["table"].push_back({
+			{"id", 1}, {"name", "Command failed due to ICRC error"}, {"size", 2}, {"value", 0}, {"overflow", false},
+		});
+		return root.dump();
+	}
+
+}
+
+
+
+TEST_CASE("SmartctlLogSupportCache", "[app][parser]")
+{
+	rconfig::set_default_data("system/skip_unsupported_logs", true);
+	rconfig::set_default_data("system/log_support_cache", rconfig::json::array());
+	rconfig::set_default_data("system/log_support_reprobe_days", 30);
+	smartctl_log_support_cache_clear();
+
+	const auto now = std::chrono::system_clock::now();
+
+	SECTION("Lookup") {
+		REQUIRE(!smartctl_log_support_cache_lookup("Test Drive", "FW01", now).has_value());
+
+		smartctl_log_support_cache_store("Test Drive", "FW01", {"--log=scttemp"}, now);
+		auto cached = smartctl_log_support_cache_lookup("Test Drive", "FW01", now + 24h);
+		REQUIRE(cached.has_value());
+		REQUIRE(cached.value() == std::vector<std::string>{"--log=scttemp"});
+
+		// Different firmware may support different logs
+		REQUIRE(!smartctl_log_support_cache_lookup("Test Drive", "FW02", now).has_value());
+
+		// Probe again after the interval
+		REQUIRE(!smartctl_log_support_cache_lookup("Test Drive", "FW01", now + 24h * 30).has_value());
+
+		// Same model, new result replaces the old one
+		smartctl_log_support_cache_store("Test Drive", "FW01", {}, now);
+		REQUIRE(smartctl_log_support_cache_lookup("Test Drive", "FW01", now)->empty());
+		REQUIRE(rconfig::get_data<rconfig::json>("system/log_support_cache").size() == 1);
+	}
+
+	SECTION("Disabled") {
+		rconfig::set_data("system/skip_unsupported_logs", false);
+		smartctl_log_support_cache_store("Test Drive", "FW01", {"--log=scttemp"}, now);
+		REQUIRE(!smartctl_log_support_cache_lookup("Test Drive", "FW01", now).has_value());
+		rconfig::unset_data("system/skip_unsupported_logs");
+	}
+
+	SECTION("Fetch") {
+		rconfig::set_default_data("system/smartctl_binary", "smartctl");
+		rconfig::set_default_data("system/smartctl_options", "");
+		rconfig::set_default_data("system/smartctl_device_options", "");
+
+		auto ex = std::make_shared<CommandExecutorReplay>();
+		ex->add_output({"--attributes", "/dev/sda"}, create_ata_output());
+
+		StorageDevice drive("/dev/sda");
+		drive.set_detected_type(StorageDeviceDetectedType::AtaHdd);
+		REQUIRE(drive.fetch_full_data_and_parse(ex));
+		REQUIRE(drive.fetch_full_data_and_parse(ex));
+
+		const auto has_arg = [](const std::vector<std::string>& args, const std::string& arg) {
+			return std::find(args.begin(), args.end(), arg) != args.end();
+		};
+
+		// The first fetch probes all the logs
+		const auto& probe_args = ex->get_executed_args().at(0);
+		REQUIRE(has_arg(probe_args, "--log=scttemp"));
+		REQUIRE(has_arg(probe_args, "--log=sataphy"));
+
+		// The second one leaves out the unsupported ones
+		const auto& args = ex->get_executed_args().at(1);
+		REQUIRE(!has_arg(args, "--log=scttemp"));
+		REQUIRE(!has_arg(args, "--log=scterc"));
+		REQUIRE(!has_arg(args, "--log=devstat"));
+		REQUIRE(has_arg(args, "--log=sataphy"));
+		REQUIRE(has_arg(args, "--log=selective"));
+		REQUIRE(drive.get_property_repository().has_properties_for_section(StoragePropertySection::PhyLog));
+	}
+
+	smartctl_log_support_cache_clear();
+}
+
+
+
+
+
+
+/// @}
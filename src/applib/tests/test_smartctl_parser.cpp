@@ -11,7 +11,55 @@ Copyright:
 
 #include "catch2/catch.hpp"
 
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "applib/smartctl_parser.h"
+#include "applib/smartctl_parse_cache.h"
+#include "applib/warning_colors.h"
+#include "nlohmann/json.hpp"
+
+
+
+namespace {
+
+	/// Create JSON output of "smartctl -x" for an ATA drive with a full
+	/// attribute table and a large error log.
+	std::string create_json_ata_output(int num_error_entries)
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["device"]["type"] = "sat";
+		root["model_name"] = "ST2000DM001-1CH164";
+		root["serial_number"] = "Z1E0AAAA";
+		root["smart_status"]["passed"] = true;
+
+		auto& attributes = root["ata_smart_attributes"]["table"];
+		for (int id = 1; id <= 30; ++id) {
+			attributes.push_back({
+				{"id", id}, {"name", "Attribute_" + std::to_string(id)},
+				{"value", 100}, {"worst", 100}, {"thresh", 6}, {"when_failed", ""},
+				{"flags", {{"string", "PO--CK "}, {"prefailure", true}, {"updated_online", true}}},
+				{"raw", {{"value", id * 10}, {"string", std::to_string(id * 10)}}},
+			});
+		}
+
+		root["ata_smart_error_log"]["extended"]["count"] = num_error_entries;
+		auto& errors = root["ata_smart_error_log"]["extended"]["table"];
+		for (int i = 1; i <= num_error_entries; ++i) {
+			errors.push_back({
+				{"error_number", i}, {"log_index", i}, {"lifetime_hours", 1000 + i},
+				{"device_state", {{"string", "Active"}}},
+				{"completion_registers", {{"lba", 123456 + i}}},
+				{"error_description", "UNC at LBA = 0x0001e240 = 123456"},
+			});
+		}
+		return root.dump();
+	}
+
+}
 
 
 
@@ -37,6 +85,152 @@ Copyright (C) 2002-20, Bruce Allen, Christian Franke, www.smartmontools.org
 
 
 
+TEST_CASE("SmartctlParseCache", "[app][parser]")
+{
+	const std::string output = "smartctl 7.2 2020-12-30 r5155 [x86_64-linux-5.3.18-lp152.66-default] (SUSE RPM)\n";
+
+	SmartctlParseCache::clear();
+	const auto stats_before = SmartctlParseCache::get_stats();
+
+	auto parsed1 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, output);
+	REQUIRE(parsed1.has_value());
+	REQUIRE(!parsed1.value()->lookup_property("smartctl/version/_merged").empty());
+
+	// Byte-identical output is not parsed again
+	auto parsed2 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, output);
+	REQUIRE(parsed2.has_value());
+	REQUIRE(parsed2.value() == parsed1.value());
+
+	// Different output is
+	auto parsed3 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, output + "\n");
+	REQUIRE(parsed3.has_value());
+	REQUIRE(parsed3.value() != parsed1.value());
+
+	// Errors are not cached
+	REQUIRE(!SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, "invalid").has_value());
+
+	// Avoid GTK calls
+	storage_property_set_warning_reason_dark_mode(false);
+	auto processed1 = SmartctlParseCache::process(parsed1.value(), StorageDeviceDetectedType::AtaHdd);
+	auto processed2 = SmartctlParseCache::process(parsed1.value(), StorageDeviceDetectedType::AtaHdd);
+	REQUIRE(processed1 == processed2);
+	REQUIRE(SmartctlParseCache::process(parsed1.value(), StorageDeviceDetectedType::Nvme) != processed1);
+
+	// Warning reasons depend on the theme
+	storage_property_set_warning_reason_dark_mode(true);
+	REQUIRE(SmartctlParseCache::process(parsed1.value(), StorageDeviceDetectedType::AtaHdd) != processed1);
+	storage_property_set_warning_reason_dark_mode(std::nullopt);
+
+	const auto stats = SmartctlParseCache::get_stats();
+	REQUIRE(stats.parse_hits - stats_before.parse_hits == 1);
+	REQUIRE(stats.parse_misses - stats_before.parse_misses == 3);
+	REQUIRE(stats.process_hits - stats_before.process_hits == 1);
+	REQUIRE(stats.process_misses - stats_before.process_misses == 3);
+	REQUIRE(stats.entries == 2);
+
+	SmartctlParseCache::set_max_entries(1);
+	REQUIRE(SmartctlParseCache::get_stats().entries == 1);
+	SmartctlParseCache::set_max_entries(32);
+	SmartctlParseCache::clear();
+}
+
+
+
+TEST_CASE("SmartctlParseCacheLocalTime", "[app][parser]")
+{
+	SmartctlParseCache::clear();
+	const auto stats_before = SmartctlParseCache::get_stats();
+
+	// JSON outputs of two runs which differ only in the time of the run
+	auto json_output = [](int64_t time_t_value, const std::string& asctime) {
+		auto root = nlohmann::json::parse(create_json_ata_output(2));
+		root["local_time"]["time_t"] = time_t_value;
+		root["local_time"]["asctime"] = asctime;
+		root["smartctl"]["output"] = {"Local Time is:    " + asctime};
+		return root.dump(1);
+	};
+	const std::string asctime1 = "Tue Nov 14 22:13:20 2023 UTC";
+	const std::string asctime2 = "Tue Nov 14 22:23:20 2023 UTC";
+
+	auto parsed1 = SmartctlParseCache::parse(SmartctlParserType::Ata, SmartctlOutputFormat::Json, json_output(1700000000, asctime1));
+	REQUIRE(parsed1.has_value());
+
+	// Avoid GTK calls
+	storage_property_set_warning_reason_dark_mode(false);
+	auto processed1 = SmartctlParseCache::process(parsed1.value(), StorageDeviceDetectedType::AtaHdd);
+
+	auto parsed2 = SmartctlParseCache::parse(SmartctlParserType::Ata, SmartctlOutputFormat::Json, json_output(1700000600, asctime2));
+	REQUIRE(parsed2.has_value());
+	REQUIRE(SmartctlParseCache::get_stats().parse_hits - stats_before.parse_hits == 1);
+
+	// The time is updated in the returned properties, the rest is the same
+	REQUIRE(parsed2.value() != parsed1.value());
+	REQUIRE(parsed2.value()->lookup_property("local_time/time_t").get_value<int64_t>() == 1700000600);
+	REQUIRE(parsed2.value()->lookup_property("local_time/asctime").get_value<std::string>() == asctime2);
+	REQUIRE(parsed2.value()->lookup_property("smartctl/output").get_value<std::string>().find(asctime2) != std::string::npos);
+	REQUIRE(parsed2.value()->get_properties().size() == parsed1.value()->get_properties().size());
+	REQUIRE(parsed1.value()->lookup_property("local_time/time_t").get_value<int64_t>() == 1700000000);
+
+	// So are the processed ones, without processing them again
+	auto processed2 = SmartctlParseCache::process(parsed2.value(), StorageDeviceDetectedType::AtaHdd);
+	REQUIRE(processed2 != processed1);
+	REQUIRE(processed2->lookup_property("local_time/asctime").get_value<std::string>() == asctime2);
+	REQUIRE(SmartctlParseCache::get_stats().process_hits - stats_before.process_hits == 1);
+	storage_property_set_warning_reason_dark_mode(std::nullopt);
+
+	// Same for the text output
+	const std::string text_output = "smartctl 7.2 2020-12-30 r5155 [x86_64-linux-5.3.18-lp152.66-default] (SUSE RPM)\n"
+			"=== START OF INFORMATION SECTION ===\n"
+			"Local Time is:    ";
+	auto text1 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, text_output + asctime1 + "\n");
+	auto text2 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, text_output + asctime2 + "\n");
+	REQUIRE(text1.has_value());
+	REQUIRE(text2.has_value());
+	REQUIRE(text2.value() != text1.value());
+	REQUIRE(text2.value()->lookup_property("smartctl/output").get_value<std::string>().find(asctime2) != std::string::npos);
+
+	// Other changes are not ignored
+	auto text3 = SmartctlParseCache::parse(SmartctlParserType::Basic, SmartctlOutputFormat::Text, text_output + asctime2 + "\n\n");
+	REQUIRE(text3.has_value());
+
+	const auto stats = SmartctlParseCache::get_stats();
+	REQUIRE(stats.parse_hits - stats_before.parse_hits == 2);
+	REQUIRE(stats.parse_misses - stats_before.parse_misses == 3);
+	REQUIRE(stats.entries == 3);
+
+	SmartctlParseCache::clear();
+}
+
+
+
+TEST_CASE("SmartctlJsonTemperatureHistory", "[app][parser]")
+{
+	auto root = nlohmann::json::parse(create_json_ata_output(0));
+	root["ata_sct_status"]["temperature"]["current"] = 35;
+	root["ata_sct_temperature_history"]["logging_interval_minutes"] = 10;
+	root["ata_sct_temperature_history"]["table"] = {nullptr, nullptr, 34, 35, 36};
+	root["local_time"]["time_t"] = 1700000000;
+	root["local_time"]["asctime"] = "Tue Nov 14 22:13:20 2023 UTC";
+
+	auto parser = SmartctlParser::create(SmartctlParserType::Ata, SmartctlOutputFormat::Json);
+	REQUIRE(parser->parse(root.dump()));
+
+	const auto* p = parser->get_property_repository().find_property("ata_sct_temperature_history/table");
+	REQUIRE(p);
+	REQUIRE(!p->show_in_ui);
+	REQUIRE(p->get_value<AtaStorageTemperatureHistory>().logging_interval_minutes == 10);
+	REQUIRE(p->get_value<AtaStorageTemperatureHistory>().temperatures
+			== std::vector<std::optional<std::int64_t>> {std::nullopt, std::nullopt, 34, 35, 36});
+
+	// The graph ends at the time of the output
+	const auto* time_p = parser->get_property_repository().find_property("local_time/time_t");
+	REQUIRE(time_p);
+	REQUIRE(!time_p->show_in_ui);
+	REQUIRE(time_p->get_value<std::int64_t>() == 1700000000);
+}
+
+
+
 /// @}
 
 
@@ -0,0 +1,101 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include "applib/smartctl_version_cache.h"
+
+#include <fstream>
+
+#include "rconfig/rconfig.h"
+#include "hz/fs.h"
+
+
+
+TEST_CASE("SmartctlVersionCache", "[app][parser]")
+{
+	rconfig::set_default_data("system/smartctl_version_cache", rconfig::json::array());
+	smartctl_version_cache_clear();
+
+	const hz::fs::path binary = hz::fs::temp_directory_path() / "gsc_test_smartctl_version_cache";
+	{
+		std::ofstream(binary, std::ios::binary | std::ios::trunc) << "smartctl";
+	}
+	hz::fs::permissions(binary, hz::fs::perms::owner_exec, hz::fs::perm_options::add);
+
+	const auto stamp = smartctl_get_binary_stamp(binary);
+	REQUIRE(stamp.has_value());
+	REQUIRE(stamp->size == 8);
+
+	SECTION("Missing binary") {
+		REQUIRE(!smartctl_get_binary_stamp(binary.parent_path() / "gsc_test_nonexistent_binary").has_value());
+	}
+
+	SECTION("Lookup") {
+		REQUIRE(!smartctl_version_cache_lookup(*stamp).has_value());
+
+		smartctl_version_cache_store(*stamp, {"7.4", "7.4 2023-08-01 r5530"});
+		auto cached = smartctl_version_cache_lookup(*stamp);
+		REQUIRE(cached.has_value());
+		REQUIRE(cached->version == "7.4");
+		REQUIRE(cached->version_full == "7.4 2023-08-01 r5530");
+
+		// Same binary, new version replaces the old one
+		smartctl_version_cache_store(*stamp, {"7.5", "7.5"});
+		REQUIRE(smartctl_version_cache_lookup(*stamp)->version == "7.5");
+		REQUIRE(rconfig::get_data<rconfig::json>("system/smartctl_version_cache").size() == 1);
+	}
+
+#ifndef _WIN32
+	SECTION("Not executable") {
+		smartctl_version_cache_store(*stamp, {"7.4", "7.4"});
+		REQUIRE(smartctl_version_cache_lookup(*stamp).has_value());
+
+		hz::fs::permissions(binary, hz::fs::perms::owner_exec | hz::fs::perms::group_exec | hz::fs::perms::others_exec,
+				hz::fs::perm_options::remove);
+		REQUIRE(smartctl_get_binary_stamp(binary) == stamp);
+		REQUIRE(!smartctl_version_cache_lookup(*stamp).has_value());
+	}
+
+	SECTION("Missing interpreter") {
+		{
+			std::ofstream(binary, std::ios::binary | std::ios::trunc) << "#!/nonexistent/gsc_test_interpreter\n";
+		}
+		const auto script_stamp = smartctl_get_binary_stamp(binary);
+		REQUIRE(script_stamp.has_value());
+		smartctl_version_cache_store(*script_stamp, {"7.4", "7.4"});
+		REQUIRE(!smartctl_version_cache_lookup(*script_stamp).has_value());
+	}
+#endif
+
+	SECTION("Binary changed") {
+		smartctl_version_cache_store(*stamp, {"7.4", "7.4"});
+		{
+			std::ofstream(binary, std::ios::binary | std::ios::app) << " upgraded";
+		}
+		const auto new_stamp = smartctl_get_binary_stamp(binary);
+		REQUIRE(new_stamp.has_value());
+		REQUIRE(new_stamp->path == stamp->path);
+		REQUIRE(!(*new_stamp == *stamp));
+		REQUIRE(!smartctl_version_cache_lookup(*new_stamp).has_value());
+	}
+
+	smartctl_version_cache_clear();
+	std::error_code ec;
+	hz::fs::remove(binary, ec);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,131 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include "applib/storage_device_bulk_loader.h"
+
+#include <glibmm.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "hz/fs.h"
+#include "nlohmann/json.hpp"
+
+
+
+namespace {
+
+	/// Create JSON output of "smartctl -x" for an ATA drive
+	std::string create_ata_output(int index)
+	{
+		nlohmann::json root;
+		root["smartctl"]["version"] = {7, 4};
+		root["device"]["type"] = "sat";
+		root["model_name"] = "Test Drive";
+		root["serial_number"] = "TEST" + std::to_string(index);
+		root["smart_status"]["passed"] = true;
+		root["ata_smart_attributes"]["table"].push_back({
+			{"id", 5}, {"name", "Reallocated_Sector_Ct"},
+			{"value", 100}, {"worst", 100}, {"thresh", 10}, {"when_failed", ""},
+			{"flags", {{"string", "PO--CK "}, {"prefailure", true}, {"updated_online", true}}},
+			{"raw", {{"value", index}, {"string", std::to_string(index)}}},
+		});
+		root["ata_smart_attributes"]["table"].push_back({
+			{"id", 194}, {"name", "Temperature_Celsius"},
+			{"value", 60}, {"worst", 40}, {"thresh", 0}, {"when_failed", ""},
+			{"flags", {{"string", "-O---K "}, {"prefailure", false}, {"updated_online", true}}},
+			{"raw", {{"value", 40}, {"string", "40"}}},
+		});
+		return root.dump();
+	}
+
+}
+
+
+
+TEST_CASE("StorageDeviceBulkLoader", "[app][parser]")
+{
+	constexpr int num_files = 40;
+
+	const hz::fs::path dir = hz::fs::temp_directory_path() / "gsc_test_storage_device_bulk_loader";
+	std::error_code ec;
+	hz::fs::remove_all(dir, ec);
+	hz::fs::create_directories(dir, ec);
+
+	for (int i = 0; i < num_files; ++i) {
+		REQUIRE(!hz::fs_file_put_contents(dir / ("drive_" + std::to_string(i) + ".json"), create_ata_output(i)));
+	}
+	REQUIRE(!hz::fs_file_put_contents(dir / "invalid.json", "not a smartctl output"));
+
+	const auto files = StorageDeviceBulkLoader::expand_sources({hz::fs_path_to_string(dir)});
+	REQUIRE(files.size() == num_files + 1);
+
+	// Small queue, so that the reader waits for the workers
+	StorageDeviceBulkLoader loader(4, 2);
+
+	std::vector<StorageDevicePtr> drives;
+	std::vector<hz::fs::path> failed_files;
+	bool finished = false;
+	StorageDeviceBulkLoaderStats stats;
+
+	loader.set_batch_callback([&drives](std::vector<StorageDevicePtr> batch) {
+		drives.insert(drives.end(), batch.begin(), batch.end());
+	});
+	loader.set_error_callback([&failed_files](const hz::fs::path& file, [[maybe_unused]] const std::string& message) {
+		failed_files.push_back(file);
+	});
+	loader.set_finished_callback([&finished, &stats](const StorageDeviceBulkLoaderStats& s) {
+		finished = true;
+		stats = s;
+	});
+
+	REQUIRE(loader.start(files));
+	REQUIRE(loader.is_running());
+	REQUIRE(!loader.start(files));
+
+	const auto context = Glib::MainContext::get_default();
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+	while (!finished && std::chrono::steady_clock::now() < deadline) {
+		context->iteration(true);
+	}
+
+	REQUIRE(finished);
+	REQUIRE(!loader.is_running());
+	REQUIRE(stats.files_total == num_files + 1);
+	REQUIRE(stats.files_loaded == num_files);
+	REQUIRE(stats.files_failed == 1);
+	REQUIRE(failed_files == std::vector<hz::fs::path>{dir / "invalid.json"});
+
+	// Each drive is parsed from its own file
+	REQUIRE(drives.size() == num_files);
+	std::vector<std::string> serials;
+	for (const auto& drive : drives) {
+		REQUIRE(drive->get_is_virtual());
+		REQUIRE(drive->get_model_name() == "Test Drive");
+		REQUIRE(drive->get_property_repository().has_properties_for_section(StoragePropertySection::AtaAttributes));
+		serials.push_back(drive->get_serial_number());
+	}
+	std::sort(serials.begin(), serials.end());
+	serials.erase(std::unique(serials.begin(), serials.end()), serials.end());
+	REQUIRE(serials.size() == num_files);
+
+	hz::fs::remove_all(dir, ec);
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,475 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include "applib/storage_property_descr.h"
+#include "applib/storage_property_descr_ata_attribute.h"
+#include "applib/storage_property_descr_helpers.h"
+#include "hz/string_num.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+
+
+namespace {
+
+	/// Create an attribute property as reported by smartctl
+	StorageProperty create_attribute_property(const std::string& reported_name, std::int32_t id)
+	{
+		AtaStorageAttribute attr;
+		attr.id = id;
+		StorageProperty p;
+		p.set_name(reported_name, reported_name, reported_name);
+		p.section = StoragePropertySection::AtaAttributes;
+		p.set_value(attr);
+		return p;
+	}
+
+
+	/// Create a property with a value
+	template<typename T>
+	StorageProperty create_property(const std::string& generic_name, StoragePropertySection section, T value)
+	{
+		StorageProperty p;
+		p.set_name(generic_name, generic_name);
+		p.section = section;
+		p.set_value(std::move(value));
+		return p;
+	}
+
+
+	/// Create a statistic property as reported by smartctl
+	StorageProperty create_statistic_property(const std::string& reported_name, std::int64_t value)
+	{
+		AtaStorageStatistic statistic;
+		statistic.flags = "---";
+		statistic.value_int = value;
+		statistic.value = std::to_string(value);
+		StorageProperty p;
+		p.set_name("", reported_name, reported_name);
+		p.section = StoragePropertySection::Statistics;
+		p.set_value(statistic);
+		return p;
+	}
+
+
+	/// Create properties similar to the ones of a parsed ATA drive ("smartctl -x")
+	StoragePropertyRepository create_ata_properties()
+	{
+		StoragePropertyRepository repo;
+		for (const auto* name : {"model_family", "model_name", "serial_number", "firmware_version", "user_capacity/bytes",
+				"user_capacity/bytes/_short", "logical_block_size", "physical_block_size", "rotation_rate", "form_factor/name",
+				"in_smartctl_database", "ata_version/string", "sata_version/string", "interface_speed/max/string",
+				"local_time/asctime", "ata_aam/enabled", "ata_apm/enabled", "ata_apm/level", "ata_dsn/enabled", "power_mode",
+				"read_lookahead/enabled", "write_cache/enabled", "ata_security/string", "wwn/id"}) {
+			repo.add_property(create_property(name, StoragePropertySection::Info, std::string("value")));
+		}
+		repo.add_property(create_property("smart_support/available", StoragePropertySection::Info, true));
+		repo.add_property(create_property("smart_support/enabled", StoragePropertySection::Info, true));
+		repo.add_property(create_property("smart_status/passed", StoragePropertySection::OverallHealth, true));
+
+		for (const auto* name : {"ata_smart_data/offline_data_collection/status/_group",
+				"ata_smart_data/offline_data_collection/completion_seconds", "ata_smart_data/self_test/polling_minutes/short",
+				"ata_smart_data/self_test/polling_minutes/extended", "ata_smart_data/self_test/polling_minutes/conveyance",
+				"ata_smart_data/self_test/status/_group", "ata_smart_data/offline_data_collection/_group",
+				"ata_smart_data/capabilities/_group", "ata_smart_data/capabilities/error_logging_supported/_group",
+				"ata_sct_capabilities/_group", "ata_smart_data/capabilities/values", "ata_smart_data/capabilities/exec_offline_immediate_supported",
+				"ata_smart_data/capabilities/offline_is_aborted_upon_new_cmd", "ata_smart_data/capabilities/offline_surface_scan_supported",
+				"ata_smart_data/capabilities/self_tests_supported", "ata_smart_data/capabilities/conveyance_self_test_supported",
+				"ata_smart_data/capabilities/selective_self_test_supported", "ata_smart_data/capabilities/attribute_autosave_enabled",
+				"ata_smart_data/capabilities/gp_logging_supported", "ata_sct_capabilities/value"}) {
+			repo.add_property(create_property(name, StoragePropertySection::Capabilities, std::int64_t(1)));
+		}
+
+		repo.add_property(create_property("ata_smart_attributes/revision", StoragePropertySection::AtaAttributes, std::int64_t(16)));
+		const std::vector<std::pair<std::int32_t, std::string>> attributes = {
+			{1, "Raw_Read_Error_Rate"}, {3, "Spin_Up_Time"}, {4, "Start_Stop_Count"}, {5, "Reallocated_Sector_Ct"},
+			{7, "Seek_Error_Rate"}, {9, "Power_On_Hours"}, {10, "Spin_Retry_Count"}, {12, "Power_Cycle_Count"},
+			{183, "Runtime_Bad_Block"}, {184, "End-to-End_Error"}, {187, "Reported_Uncorrect"}, {188, "Command_Timeout"},
+			{189, "High_Fly_Writes"}, {190, "Airflow_Temperature_Cel"}, {191, "G-Sense_Error_Rate"}, {192, "Power-Off_Retract_Count"},
+			{193, "Load_Cycle_Count"}, {194, "Temperature_Celsius"}, {197, "Current_Pending_Sector"}, {198, "Offline_Uncorrectable"},
+			{199, "UDMA_CRC_Error_Count"}, {240, "Head_Flying_Hours"}, {241, "Total_LBAs_Written"}, {242, "Total_LBAs_Read"},
+		};
+		for (const auto& [id, name] : attributes) {
+			repo.add_property(create_attribute_property(name, id));
+		}
+
+		for (const auto* name : {"Lifetime Power-On Resets", "Power-on Hours", "Logical Sectors Written",
+				"Number of Write Commands", "Logical Sectors Read", "Number of Read Commands", "Date and Time TimeStamp",
+				"Spindle Motor Power-on Hours", "Head Flying Hours", "Head Load Events", "Number of Reallocated Logical Sectors",
+				"Read Recovery Attempts", "Number of Mechanical Start Failures", "Number of Realloc. Candidate Logical Sectors",
+				"Number of High Priority Unload Events", "Number of Reported Uncorrectable Errors", "Resets Between Cmd Acceptance and Completion",
+				"Current Temperature", "Average Short Term Temperature", "Average Long Term Temperature", "Highest Temperature",
+				"Lowest Temperature", "Highest Average Short Term Temperature", "Lowest Average Short Term Temperature",
+				"Highest Average Long Term Temperature", "Lowest Average Long Term Temperature", "Time in Over-Temperature",
+				"Specified Maximum Operating Temperature", "Time in Under-Temperature", "Specified Minimum Operating Temperature",
+				"Number of Hardware Resets", "Number of ASR Events", "Number of Interface CRC Errors",
+				"Percentage Used Endurance Indicator", "Pending Error Count", "Utilization Usage Rate"}) {
+			repo.add_property(create_statistic_property(name, 10));
+		}
+
+		repo.add_property(create_property("ata_smart_error_log/extended/revision", StoragePropertySection::AtaErrorLog, std::int64_t(1)));
+		repo.add_property(create_property("ata_smart_error_log/extended/count", StoragePropertySection::AtaErrorLog, std::int64_t(40)));
+		for (std::uint32_t i = 1; i <= 40; ++i) {
+			AtaStorageErrorBlock block;
+			block.error_num = i;
+			block.reported_types = {"UNC"};
+			repo.add_property(create_property("ata_smart_error_log/extended/table/" + std::to_string(i),
+					StoragePropertySection::AtaErrorLog, block));
+		}
+
+		repo.add_property(create_property("ata_smart_self_test_log/extended/revision", StoragePropertySection::SelftestLog, std::int64_t(1)));
+		repo.add_property(create_property("ata_smart_self_test_log/extended/count", StoragePropertySection::SelftestLog, std::int64_t(20)));
+		for (std::uint32_t i = 1; i <= 20; ++i) {
+			AtaStorageSelftestEntry entry;
+			entry.test_num = i;
+			repo.add_property(create_property("ata_smart_self_test_log/extended/table/" + std::to_string(i),
+					StoragePropertySection::SelftestLog, entry));
+		}
+
+		repo.add_property(create_property("ata_sct_status/temperature/current", StoragePropertySection::TemperatureLog, std::int64_t(40)));
+		return repo;
+	}
+
+
+	/// Create properties similar to the ones of a parsed NVMe drive ("smartctl -x")
+	StoragePropertyRepository create_nvme_properties()
+	{
+		StoragePropertyRepository repo;
+		for (const auto* name : {"model_name", "serial_number", "firmware_version", "nvme_pci_vendor/id",
+				"nvme_ieee_oui_identifier", "nvme_total_capacity", "nvme_unallocated_capacity", "nvme_controller_id",
+				"nvme_version/string", "nvme_number_of_namespaces", "local_time/asctime"}) {
+			repo.add_property(create_property(name, StoragePropertySection::Info, std::string("value")));
+		}
+		repo.add_property(create_property("smart_support/available", StoragePropertySection::Info, true));
+		repo.add_property(create_property("smart_status/passed", StoragePropertySection::OverallHealth, true));
+		for (const auto* name : {"critical_warning", "temperature", "available_spare", "available_spare_threshold",
+				"percentage_used", "data_units_read", "data_units_written", "host_reads", "host_writes",
+				"controller_busy_time", "power_cycles", "power_on_hours", "unsafe_shutdowns", "media_errors",
+				"num_err_log_entries", "warning_temp_time", "critical_comp_time"}) {
+			repo.add_property(create_property(std::string("nvme_smart_health_information_log/") + name,
+					StoragePropertySection::NvmeAttributes, std::int64_t(20)));
+		}
+		return repo;
+	}
+
+}
+
+
+
+TEST_CASE("AtaAttributeDescription", "[app][parser]")
+{
+	SECTION("Type-specific entry") {
+		StorageProperty p = create_attribute_property("Reallocated_Sector_Ct", 5);
+		auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaHdd);
+		REQUIRE(p.generic_name == "attr_reallocated_sector_count");
+		REQUIRE(p.displayable_name == "Reallocated Sector Count");
+		REQUIRE(p.get_description().find(get_suffix_for_uncorrectable_property_description()) != std::string::npos);
+	}
+
+	SECTION("Case-insensitive name") {
+		StorageProperty p = create_attribute_property("REALLOCATED_SECTOR_CT", 5);
+		auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaSsd);
+		REQUIRE(p.generic_name == "attr_reallocated_sector_count");
+	}
+
+	SECTION("Alias") {
+		// Same description as Power_On_Hours
+		StorageProperty p = create_attribute_property("Power_On_Hours_and_Msec", 9);
+		auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaSsd);
+		REQUIRE(p.displayable_name == "Power-On Time");
+	}
+
+	SECTION("Unknown name, known ID") {
+		StorageProperty p = create_attribute_property("Some_Vendor_Name", 5);
+		auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaHdd);
+		REQUIRE(p.generic_name == "attr_reallocated_sector_count");
+	}
+
+	SECTION("Unknown attribute") {
+		StorageProperty p = create_attribute_property("Unknown_SSD_Attribute", 253);
+		auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaSsd);
+		REQUIRE(p.generic_name.empty());
+		REQUIRE(p.displayable_name == "Unknown SSD Attribute");
+	}
+}
+
+
+
+TEST_CASE("StoragePropertyDescriptionRules", "[app][parser]")
+{
+	SECTION("Descriptions") {
+		StorageProperty p = create_property("Model_Name", StoragePropertySection::Info, std::string("ST2000DM001"));
+		REQUIRE(storage_property_autoset_description(p, StorageDeviceDetectedType::AtaHdd));
+		REQUIRE(p.get_description() == "Device model");
+
+		// Rules are per section
+		p.section = StoragePropertySection::Capabilities;
+		REQUIRE(!storage_property_autoset_description(p, StorageDeviceDetectedType::AtaHdd));
+
+		// Unknown Info properties get their name as a description
+		p = create_property("firmware_version", StoragePropertySection::Info, std::string("CC27"));
+		p.displayable_name = "Firmware Version";
+		REQUIRE(storage_property_autoset_description(p, StorageDeviceDetectedType::AtaHdd));
+		REQUIRE(p.get_description() == "Firmware Version");
+
+		// Matched by reported name if there is no generic name
+		p = create_property("", StoragePropertySection::SelftestLog, std::int64_t(1));
+		p.reported_name = "ata_smart_self_test_log/standard/count";
+		REQUIRE(storage_property_autoset_description(p, StorageDeviceDetectedType::AtaHdd));
+		REQUIRE(p.get_description().starts_with("Number of tests in selftest log."));
+	}
+
+	SECTION("Warnings") {
+		StorageProperty p = create_property("smart_support/enabled", StoragePropertySection::Info, false);
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::Notice);
+		REQUIRE(p.warning_reason.starts_with("SMART is disabled."));
+
+		p = create_property("smart_support/enabled", StoragePropertySection::Info, true);
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::None);
+
+		p = create_property("SMART_STATUS/passed", StoragePropertySection::OverallHealth, false);
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::Alert);
+
+		p = create_property("nvme_smart_health_information_log/available_spare", StoragePropertySection::NvmeAttributes, std::int64_t(5));
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::Warning);
+
+		// The first matching rule wins
+		p = create_statistic_property("Percentage Used Endurance Indicator", 100);
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::Notice);
+
+		p = create_statistic_property("Number of Reallocated Logical Sectors", 0);
+		storage_property_autoset_warning(p);
+		REQUIRE(p.warning_level == WarningLevel::None);
+	}
+}
+
+
+
+TEST_CASE("StoragePropertyProcessor", "[app][parser]")
+{
+	StoragePropertyRepository repo;
+	repo.add_property(create_attribute_property("Reallocated_Sector_Ct", 5));
+	repo.add_property(create_property("smart_status/passed", StoragePropertySection::OverallHealth, false));
+	repo.add_property(create_statistic_property("Current Temperature", 60));
+
+	const StoragePropertyRepository processed = StoragePropertyProcessor::process_properties(repo, StorageDeviceDetectedType::AtaHdd);
+
+	// Names and warnings are set right away
+	const StorageProperty* attr = processed.find_property("attr_reallocated_sector_count");
+	REQUIRE(attr != nullptr);
+	REQUIRE(attr->displayable_name == "Reallocated Sector Count");
+	const StorageProperty* health = processed.find_property("smart_status/passed");
+	REQUIRE(health->warning_level == WarningLevel::Alert);
+	REQUIRE(!health->warning_reason.empty());
+	REQUIRE(processed.get_section_properties(StoragePropertySection::Statistics).size() == 1);
+	const StorageProperty* statistic = processed.get_section_properties(StoragePropertySection::Statistics).front();
+	REQUIRE(statistic->generic_name == "stat_temperature_celsius");
+
+	// Descriptions are generated on first access
+	REQUIRE(health->get_description_pending());
+	REQUIRE(health->get_description().starts_with("Overall health self-assessment test result."));
+	REQUIRE(!health->get_description_pending());
+	REQUIRE(attr->get_description_ref().starts_with("<b>Reallocated Sector Count</b>"));
+	REQUIRE(statistic->get_description(true).starts_with("<b>Current Temperature (C)</b>"));
+
+	// Copies generate their own descriptions
+	StoragePropertyRepository copy = processed;
+	REQUIRE(copy.find_property("attr_reallocated_sector_count")->get_description_pending() == false);
+	copy.modify_properties([](StorageProperty& p) {
+		p.set_description_generator([](const StorageProperty&, StorageDeviceDetectedType) { return std::string("Generated"); },
+				StorageDeviceDetectedType::AtaHdd);
+	});
+	REQUIRE(copy.find_property("smart_status/passed")->get_description() == "Generated");
+	REQUIRE(health->get_description() != "Generated");
+
+	// Shared repositories may be read and copied from several threads
+	const StoragePropertyRepository shared = StoragePropertyProcessor::process_properties(repo, StorageDeviceDetectedType::AtaHdd);
+	std::vector<std::string> descriptions(4);
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < descriptions.size(); ++i) {
+		threads.emplace_back([&shared, &descriptions, i]() {
+			const StoragePropertyRepository thread_copy = shared;
+			descriptions[i] = shared.find_property("attr_reallocated_sector_count")->get_description()
+					+ thread_copy.find_property("smart_status/passed")->get_description();
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	REQUIRE(std::all_of(descriptions.begin(), descriptions.end(), [&descriptions](const std::string& d) {
+		return d == descriptions.front();
+	}));
+	REQUIRE(descriptions.front().starts_with("<b>Reallocated Sector Count</b>"));
+}
+
+
+
+TEST_CASE("StoragePropertyUserRules", "[app][parser]")
+{
+	const auto rules = StoragePropertyUserRules::from_json(nlohmann::json::parse(R"([
+		{"model": "^WDC WD40EFRX", "name": "attr_temperature_celsius", "above": 60, "level": "notice", "reason": "Hot"},
+		{"attribute_id": 5, "above": 10, "level": "warning"},
+		{"name": "ata_sct_status/temperature/current", "section": "temperatureLog", "above": 70, "level": "alert"},
+		{"name": "attr_spin_up_retry_count", "level": "notice"},
+		{"name": "attr_spin_up_retry_count", "above": 1, "level": "severe"},
+		{"model": "(", "name": "attr_spin_up_retry_count", "above": 1},
+		"invalid"
+	])"));
+	REQUIRE(rules.size() == 3);  // the rest are invalid
+	REQUIRE(rules.select_for_model("WDC WD40EFRX-68N32N0").size() == 3);
+	REQUIRE(rules.select_for_model("ST4000DM004-2CV104").size() == 2);
+
+	auto create_repository = [](const std::string& model_name) {
+		StoragePropertyRepository repo;
+		repo.add_property(create_property("model_name", StoragePropertySection::Info, model_name));
+		for (const auto& [reported_name, id, raw_value] : {
+				std::tuple{"Reallocated_Sector_Ct", 5, "3"},
+				std::tuple{"Spin_Up_Retry_Count", 10, "1"},
+				std::tuple{"Temperature_Celsius", 194, "55 (Min/Max 20/60)"} }) {
+			StorageProperty p = create_attribute_property(reported_name, id);
+			AtaStorageAttribute attr = p.get_value<AtaStorageAttribute>();
+			attr.raw_value = raw_value;
+			attr.raw_value_int = hz::string_to_number_nolocale<std::int64_t>(raw_value, false);
+			p.set_value(attr);
+			repo.add_property(p);
+		}
+		repo.add_property(create_property("ata_sct_status/temperature/current", StoragePropertySection::TemperatureLog, std::int64_t(75)));
+		return repo;
+	};
+
+	SECTION("Built-in rules only") {
+		const auto processed = StoragePropertyProcessor::process_properties(
+				create_repository("WDC WD40EFRX-68N32N0"), StorageDeviceDetectedType::AtaHdd, StoragePropertyUserRules());
+		REQUIRE(processed.find_property("attr_reallocated_sector_count")->warning_level == WarningLevel::Notice);
+		REQUIRE(processed.find_property("attr_temperature_celsius")->warning_level == WarningLevel::Notice);
+		REQUIRE(processed.find_property("ata_sct_status/temperature/current")->warning_level == WarningLevel::Notice);
+	}
+
+	SECTION("User rules replace built-in ones") {
+		const auto processed = StoragePropertyProcessor::process_properties(
+				create_repository("WDC WD40EFRX-68N32N0"), StorageDeviceDetectedType::AtaHdd, rules);
+		REQUIRE(processed.find_property("attr_reallocated_sector_count")->warning_level == WarningLevel::None);  // not above 10
+		REQUIRE(processed.find_property("attr_temperature_celsius")->warning_level == WarningLevel::None);  // not above 60
+		REQUIRE(processed.find_property("ata_sct_status/temperature/current")->warning_level == WarningLevel::Alert);
+		REQUIRE(processed.find_property("ata_sct_status/temperature/current")->warning_reason
+				== "The value is outside the limits set in the configuration file.");
+		REQUIRE(processed.find_property("attr_spin_up_retry_count")->warning_level == WarningLevel::Notice);  // no valid user rules
+	}
+
+	SECTION("Rules for other models are not used") {
+		const auto processed = StoragePropertyProcessor::process_properties(
+				create_repository("ST4000DM004-2CV104"), StorageDeviceDetectedType::AtaHdd, rules);
+		REQUIRE(processed.find_property("attr_temperature_celsius")->warning_level == WarningLevel::Notice);
+		REQUIRE(processed.find_property("attr_reallocated_sector_count")->warning_level == WarningLevel::None);
+	}
+
+	SECTION("Failures reported by the drive are kept") {
+		StoragePropertyRepository repo = create_repository("WDC WD40EFRX-68N32N0");
+		repo.modify_properties([](StorageProperty& p) {
+			if (p.is_value_type<AtaStorageAttribute>() && p.get_value<AtaStorageAttribute>().id == 5) {
+				AtaStorageAttribute attr = p.get_value<AtaStorageAttribute>();
+				attr.attr_type = AtaStorageAttribute::AttributeType::Prefail;
+				attr.when_failed = AtaStorageAttribute::FailTime::Now;
+				p.set_value(attr);
+			}
+		});
+		const auto processed = StoragePropertyProcessor::process_properties(repo, StorageDeviceDetectedType::AtaHdd, rules);
+		REQUIRE(processed.find_property("attr_reallocated_sector_count")->warning_level == WarningLevel::Alert);
+	}
+}
+
+
+
+TEST_CASE("AtaAttributeDescriptionBenchmark", "[.][app][parser][benchmark]")
+{
+	std::vector<StorageProperty> props = {
+		create_attribute_property("Raw_Read_Error_Rate", 1),
+		create_attribute_property("Reallocated_Sector_Ct", 5),
+		create_attribute_property("Power_On_Hours", 9),
+		create_attribute_property("Airflow_Temperature_Cel", 190),
+		create_attribute_property("Temperature_Celsius", 194),
+		create_attribute_property("Current_Pending_Sector", 197),
+		create_attribute_property("UDMA_CRC_Error_Count", 199),
+		create_attribute_property("Total_LBAs_Written", 241),
+	};
+
+	BENCHMARK("auto_set_ata_attribute_description")
+	{
+		std::size_t size = 0;
+		for (auto& p : props) {
+			auto_set_ata_attribute_description(p, StorageDeviceDetectedType::AtaHdd);
+			size += p.generic_name.size();
+		}
+		return size;
+	};
+}
+
+
+
+TEST_CASE("StoragePropertyProcessorBenchmark", "[.][app][parser][benchmark]")
+{
+	const StoragePropertyRepository ata_properties = create_ata_properties();
+	const StoragePropertyRepository nvme_properties = create_nvme_properties();
+
+	BENCHMARK("process_properties (ATA)")
+	{
+		return StoragePropertyProcessor::process_properties(ata_properties, StorageDeviceDetectedType::AtaHdd).get_properties().size();
+	};
+
+	const auto user_rules = StoragePropertyUserRules::from_json(nlohmann::json::parse(R"([
+		{"name": "attr_temperature_celsius", "above": 60, "level": "notice"},
+		{"attribute_id": 5, "above": 10, "level": "warning"},
+		{"model": "^WDC", "name": "attr_current_pending_sector_count", "above": 0, "level": "warning"}
+	])"));
+
+	BENCHMARK("process_properties (ATA, user rules)")
+	{
+		return StoragePropertyProcessor::process_properties(ata_properties, StorageDeviceDetectedType::AtaHdd, user_rules).get_properties().size();
+	};
+
+	BENCHMARK("process_properties (NVMe)")
+	{
+		return StoragePropertyProcessor::process_properties(nvme_properties, StorageDeviceDetectedType::Nvme).get_properties().size();
+	};
+
+	// Sections without per-property database lookups
+	BENCHMARK("Description and warning rules (ATA)")
+	{
+		std::size_t num_found = 0;
+		for (StorageProperty p : ata_properties.get_properties()) {
+			if (p.section == StoragePropertySection::AtaAttributes) {
+				continue;
+			}
+			num_found += std::size_t(storage_property_autoset_description(p, StorageDeviceDetectedType::AtaHdd));
+			storage_property_autoset_warning(p);
+		}
+		return num_found;
+	};
+}
+
+
+
+
+
+
+/// @}
@@ -0,0 +1,357 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup applib_tests
+/// \weakgroup applib_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+#include "applib/storage_property_repository.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+
+
+namespace {
+
+	/// Create a property
+	StorageProperty create_property(const std::string& generic_name, StoragePropertySection section, std::int64_t value)
+	{
+		StorageProperty p;
+		p.set_name(generic_name, generic_name);
+		p.section = section;
+		p.value = value;
+		return p;
+	}
+
+
+	/// Create an attribute property
+	StorageProperty create_attribute_property(const std::string& reported_name, std::int32_t id, std::int64_t raw_value)
+	{
+		AtaStorageAttribute attr;
+		attr.id = id;
+		attr.raw_value_int = raw_value;
+		attr.raw_value = std::to_string(raw_value);
+		StorageProperty p;
+		p.set_name(reported_name, reported_name, reported_name);
+		p.section = StoragePropertySection::AtaAttributes;
+		p.set_value(attr);
+		return p;
+	}
+
+
+	/// Create a repository similar to the one of a drive with a large error log
+	StoragePropertyRepository create_large_repository(std::size_t num_error_entries)
+	{
+		StoragePropertyRepository repo;
+		repo.add_property(create_property("model_name", StoragePropertySection::Info, 1));
+		repo.add_property(create_property("serial_number", StoragePropertySection::Info, 2));
+		for (std::int64_t id = 1; id <= 255; ++id) {
+			repo.add_property(create_property("attribute_" + std::to_string(id), StoragePropertySection::AtaAttributes, id));
+		}
+		for (std::size_t i = 0; i < num_error_entries; ++i) {
+			repo.add_property(create_property("ata_smart_error_log/extended/table/" + std::to_string(i),
+					StoragePropertySection::AtaErrorLog, std::int64_t(i)));
+		}
+		repo.add_property(create_property("smart_status/passed", StoragePropertySection::OverallHealth, 1));
+		repo.add_property(create_property("ata_smart_data/self_test/polling_minutes/short", StoragePropertySection::Capabilities, 2));
+		return repo;
+	}
+
+}
+
+
+
+TEST_CASE("StoragePropertyRepository", "[app][parser]")
+{
+	StoragePropertyRepository repo;
+	repo.add_property(create_property("temperature", StoragePropertySection::Info, 1));
+	repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 2));
+	repo.add_property(create_property("temperature", StoragePropertySection::Info, 3));  // duplicate
+	repo.add_property(create_property("model_name", StoragePropertySection::Info, 4));
+
+	SECTION("Lookup by name") {
+		const StorageProperty* p = repo.find_property("temperature");
+		REQUIRE(p != nullptr);
+		REQUIRE(p->get_value<std::int64_t>() == 1);  // the first one
+		REQUIRE(repo.find_property("nonexistent") == nullptr);
+		REQUIRE(repo.lookup_property("nonexistent").empty());
+		REQUIRE(repo.lookup_property("model_name").get_value<std::int64_t>() == 4);
+	}
+
+	SECTION("Lookup by section and name") {
+		REQUIRE(repo.find_property("temperature", StoragePropertySection::TemperatureLog)->get_value<std::int64_t>() == 2);
+		REQUIRE(repo.find_property("temperature", StoragePropertySection::Info)->get_value<std::int64_t>() == 1);
+		REQUIRE(repo.find_property("temperature", StoragePropertySection::AtaErrorLog) == nullptr);
+	}
+
+	SECTION("Sections") {
+		REQUIRE(repo.has_properties_for_section(StoragePropertySection::Info));
+		REQUIRE(repo.has_properties_for_section(StoragePropertySection::TemperatureLog));
+		REQUIRE(!repo.has_properties_for_section(StoragePropertySection::AtaErrorLog));
+		REQUIRE(repo.get_section_properties(StoragePropertySection::Info).size() == 3);
+		REQUIRE(repo.get_section_properties(StoragePropertySection::Info).back()->generic_name == "model_name");
+	}
+
+	SECTION("Modification") {
+		repo.modify_properties([](StorageProperty& p) {
+			if (p.section == StoragePropertySection::TemperatureLog) {
+				p.generic_name = "temperature_log";
+				p.section = StoragePropertySection::AtaErrorLog;
+			}
+		});
+		REQUIRE(repo.find_property("temperature", StoragePropertySection::TemperatureLog) == nullptr);
+		REQUIRE(repo.find_property("temperature_log", StoragePropertySection::AtaErrorLog) != nullptr);
+		REQUIRE(!repo.has_properties_for_section(StoragePropertySection::TemperatureLog));
+
+		repo.modify_section_properties(StoragePropertySection::Info, [](StorageProperty& p) {
+			p.generic_name += "_info";
+		});
+		REQUIRE(repo.find_property("model_name") == nullptr);
+		REQUIRE(repo.find_property("model_name_info") != nullptr);
+	}
+
+	SECTION("Copy") {
+		const StoragePropertyRepository copy = repo;
+		repo.clear();
+		REQUIRE(repo.find_property("model_name") == nullptr);
+		REQUIRE(copy.find_property("model_name")->get_value<std::int64_t>() == 4);
+	}
+}
+
+
+
+TEST_CASE("StoragePropertyRepositoryDiff", "[app][parser]")
+{
+	StoragePropertyRepository old_repo;
+	old_repo.add_property(create_property("model_name", StoragePropertySection::Info, 1));
+	old_repo.add_property(create_property("serial_number", StoragePropertySection::Info, 2));
+	old_repo.add_property(create_attribute_property("Reallocated_Sector_Ct", 5, 0));
+	old_repo.add_property(create_attribute_property("Unknown_Attribute", 200, 10));
+	old_repo.add_property(create_attribute_property("Unknown_Attribute", 201, 20));
+	old_repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 30));
+	old_repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 31));
+
+	SECTION("Identical") {
+		const StoragePropertyRepository copy = old_repo;
+		REQUIRE(old_repo.diff(copy).empty());
+		REQUIRE(StoragePropertyRepository().diff(StoragePropertyRepository()).empty());
+	}
+
+	SECTION("Changes") {
+		StoragePropertyRepository new_repo;
+		new_repo.add_property(create_property("model_name", StoragePropertySection::Info, 1));
+		new_repo.add_property(create_attribute_property("Reallocated_Sector_Ct", 5, 8));  // changed
+		new_repo.add_property(create_attribute_property("Unknown_Attribute", 201, 20));  // matched by ID
+		new_repo.add_property(create_attribute_property("Unknown_Attribute", 202, 0));  // added
+		new_repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 30));
+		new_repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 32));  // changed
+		new_repo.add_property(create_property("temperature", StoragePropertySection::TemperatureLog, 33));  // added
+		new_repo.add_property(create_property("model_name", StoragePropertySection::Capabilities, 1));  // added
+
+		const auto diff = old_repo.diff(new_repo);
+		REQUIRE(diff.added.size() == 3);
+		REQUIRE(diff.added[0].get_value<AtaStorageAttribute>().id == 202);
+		REQUIRE(diff.added[1].get_value<std::int64_t>() == 33);
+		REQUIRE(diff.added[2].section == StoragePropertySection::Capabilities);
+
+		REQUIRE(diff.removed.size() == 2);
+		REQUIRE(diff.removed[0].generic_name == "serial_number");
+		REQUIRE(diff.removed[1].get_value<AtaStorageAttribute>().id == 200);
+
+		REQUIRE(diff.changed.size() == 2);
+		REQUIRE(diff.changed[0].old_property.get_value<AtaStorageAttribute>().raw_value_int == 0);
+		REQUIRE(diff.changed[0].new_property.get_value<AtaStorageAttribute>().raw_value_int == 8);
+		REQUIRE(diff.changed[1].old_property.get_value<std::int64_t>() == 31);
+		REQUIRE(diff.changed[1].new_property.get_value<std::int64_t>() == 32);
+
+		// Reverse
+		const auto reverse_diff = new_repo.diff(old_repo);
+		REQUIRE(reverse_diff.added.size() == 2);
+		REQUIRE(reverse_diff.removed.size() == 3);
+		REQUIRE(reverse_diff.changed.size() == 2);
+	}
+
+	SECTION("Value types") {
+		StorageProperty p1 = create_attribute_property("Reallocated_Sector_Ct", 5, 0);
+		StorageProperty p2 = create_attribute_property("Reallocated_Sector_Ct", 5, 0);
+		REQUIRE(p1.value_equals(p2));  // different boxes, same contents
+		p2.reported_value = "0";
+		REQUIRE(!p1.value_equals(p2));
+		p2 = create_property("Reallocated_Sector_Ct", StoragePropertySection::AtaAttributes, 0);
+		REQUIRE(!p1.value_equals(p2));
+	}
+}
+
+
+
+TEST_CASE("StoragePropertyDescriptionSharing", "[app][parser]")
+{
+	const std::string descr = "<b>Reallocated Sector Count</b>\nNumber of reallocated sectors (bad sectors).";
+
+	StorageProperty p1, p2, p3;
+	p1.set_description(descr);
+	p2.set_description(std::string(descr));
+	p3.set_description(descr + " Changed.");
+
+	// Same contents - same storage
+	REQUIRE(&p1.get_description_ref() == &p2.get_description_ref());
+	REQUIRE(&p1.get_description_ref() != &p3.get_description_ref());
+	REQUIRE(p1.get_description() == descr);
+
+	// Appending a warning creates a new string
+	p2.set_description(p2.get_description() + "\n\nWarning");
+	REQUIRE(p1.get_description() == descr);
+	REQUIRE(p2.get_description() == descr + "\n\nWarning");
+
+	StorageProperty p4;
+	REQUIRE(p4.get_description(true).empty());
+	REQUIRE(p4.get_description() == "No description available");
+}
+
+
+
+TEST_CASE("StoragePropertyLayout", "[app][parser]")
+{
+	// Large values are boxed, so that the property (and the variant) stays small.
+	// If this fails, a large type was probably added to the variant directly.
+	CAPTURE(sizeof(StorageProperty), sizeof(StorageProperty::ValueVariantType));
+	REQUIRE(sizeof(StorageProperty::ValueVariantType) <= sizeof(std::string) + 16);
+	REQUIRE(sizeof(StorageProperty) <= 8 * sizeof(std::string) + sizeof(StorageProperty::ValueVariantType) + 32);
+
+	AtaStorageErrorBlock block;
+	block.error_num = 5;
+	StorageProperty p;
+	p.section = StoragePropertySection::AtaErrorLog;
+	p.set_value(block);
+	REQUIRE(p.is_value_type<AtaStorageErrorBlock>());
+	REQUIRE(!p.is_value_type<AtaStorageSelftestEntry>());
+	REQUIRE(p.get_value<AtaStorageErrorBlock>().error_num == 5);
+	REQUIRE(p.get_storable_value_type_name() == "error_block");
+
+	// Copies share the boxed value
+	const StorageProperty copy = p;
+	REQUIRE(&copy.get_value<AtaStorageErrorBlock>() == &p.get_value<AtaStorageErrorBlock>());
+
+	// Small values are stored inline
+	p.set_value(std::int64_t(3));
+	REQUIRE(p.get_value<std::int64_t>() == 3);
+	REQUIRE(copy.get_value<AtaStorageErrorBlock>().error_num == 5);
+}
+
+
+
+TEST_CASE("StoragePropertyMemoryUsage", "[.][app][parser][benchmark]")
+{
+	// Emulate a host with many identical drives, each with a full attribute table.
+	const std::size_t num_drives = 60;
+	const std::string long_text(1000, 'x');
+
+	std::vector<StoragePropertyRepository> drives(num_drives);
+	for (auto& repo : drives) {
+		repo = create_large_repository(0);
+		repo.modify_properties([&long_text](StorageProperty& p) {
+			p.set_description("<b>" + p.displayable_name + "</b>\n" + long_text);
+		});
+	}
+
+	// Heap memory used by description strings, if each property had its own copy
+	std::size_t copied_bytes = 0;
+	// Heap memory used by description strings, shared between drives
+	std::set<const std::string*> unique_descriptions;
+	std::size_t shared_bytes = 0;
+
+	for (const auto& repo : drives) {
+		for (const auto& p : repo.get_properties()) {
+			const std::string& descr = p.get_description_ref();
+			copied_bytes += descr.capacity() + 1;
+			if (unique_descriptions.insert(&descr).second) {
+				shared_bytes += sizeof(std::string) + descr.capacity() + 1;
+			}
+		}
+	}
+
+	WARN("Description memory per drive: " << (copied_bytes / num_drives) << " bytes copied, "
+			<< (shared_bytes / num_drives) << " bytes shared (" << num_drives << " drives).");
+	REQUIRE(shared_bytes * 10 < copied_bytes);
+}
+
+
+
+TEST_CASE("StoragePropertyRepositoryBenchmark", "[.][app][parser][benchmark]")
+{
+	const StoragePropertyRepository repo = create_large_repository(5000);
+
+	BENCHMARK("find_property")
+	{
+		std::int64_t sum = 0;
+		for (const auto* name : {"model_name", "smart_status/passed", "ata_smart_data/self_test/polling_minutes/short", "nonexistent"}) {
+			if (const auto* p = repo.find_property(name)) {
+				sum += p->get_value<std::int64_t>();
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("lookup_property")
+	{
+		std::int64_t sum = 0;
+		for (const auto* name : {"model_name", "smart_status/passed", "ata_smart_data/self_test/polling_minutes/short", "nonexistent"}) {
+			if (auto p = repo.lookup_property(name); !p.empty()) {
+				sum += p.get_value<std::int64_t>();
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("Linear scan (old lookup)")
+	{
+		std::int64_t sum = 0;
+		for (const std::string name : {"model_name", "smart_status/passed", "ata_smart_data/self_test/polling_minutes/short", "nonexistent"}) {
+			for (const auto& p : repo.get_properties()) {
+				if (p.generic_name == name) {
+					sum += p.get_value<std::int64_t>();
+					break;
+				}
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("has_properties_for_section")
+	{
+		return repo.has_properties_for_section(StoragePropertySection::SelftestLog);
+	};
+
+	const StoragePropertyRepository changed_repo = [&repo]() {
+		StoragePropertyRepository changed = repo;
+		changed.modify_section_properties(StoragePropertySection::AtaAttributes, [](StorageProperty& p) {
+			p.set_value(p.get_value<std::int64_t>() + 1);
+		});
+		return changed;
+	}();
+
+	BENCHMARK("diff")
+	{
+		return repo.diff(changed_repo).changed.size();
+	};
+
+	BENCHMARK("Build repository")
+	{
+		return create_large_repository(5000).get_properties().size();
+	};
+}
+
+
+
+
+
+
+/// @}
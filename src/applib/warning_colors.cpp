@@ -10,11 +10,21 @@ Copyright:
 /// @{
 
 #include <glibmm.h>
+#include <atomic>
 
 #include "warning_colors.h"
 #include "gui_utils.h"
 
 
+
+namespace {
+
+	/// Dark mode override for storage_property_get_warning_reason(). -1 means no override.
+	std::atomic<int> s_warning_reason_dark_mode = -1;
+
+}
+
+
 bool app_property_get_row_highlight_colors(bool dark_mode, WarningLevel warning, std::string& fg, std::string& bg)
 {
 	// Note: we're setting both fg and bg, to avoid theme conflicts.
@@ -59,8 +69,10 @@ bool app_property_get_label_highlight_color(bool dark_mode, WarningLevel warning
 
 std::string storage_property_get_warning_reason(const StorageProperty& p)
 {
+	const bool dark_mode = storage_property_get_warning_reason_dark_mode();
+
 	std::string fg, start = "<b>", stop = "</b>";
-	if (app_property_get_label_highlight_color(gui_is_dark_theme_active(), p.warning_level, fg)) {
+	if (app_property_get_label_highlight_color(dark_mode, p.warning_level, fg)) {
 		start += "<span color=\"" + fg + "\">";
 		stop = "</span>" + stop;
 	}
@@ -85,4 +97,19 @@ std::string storage_property_get_warning_reason(const StorageProperty& p)
 
 
 
+void storage_property_set_warning_reason_dark_mode(std::optional<bool> dark_mode)
+{
+	s_warning_reason_dark_mode = (dark_mode.has_value() ? int(dark_mode.value()) : -1);
+}
+
+
+
+bool storage_property_get_warning_reason_dark_mode()
+{
+	const int dark_mode_override = s_warning_reason_dark_mode.load();
+	return (dark_mode_override == -1 ? gui_is_dark_theme_active() : bool(dark_mode_override));
+}
+
+
+
 /// @}
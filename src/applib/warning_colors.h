@@ -12,6 +12,7 @@ Copyright:
 #ifndef WARNING_COLORS_H
 #define WARNING_COLORS_H
 
+#include <optional>
 #include <string>
 
 #include "storage_property.h"
@@ -32,6 +33,17 @@ bool app_property_get_label_highlight_color(bool dark_mode, WarningLevel warning
 std::string storage_property_get_warning_reason(const StorageProperty& p);
 
 
+/// Make storage_property_get_warning_reason() use \c dark_mode instead of querying the GTK theme.
+/// GTK may only be accessed from the main thread, so this must be set before properties are
+/// processed in worker threads. Pass std::nullopt to query the theme again.
+void storage_property_set_warning_reason_dark_mode(std::optional<bool> dark_mode);
+
+
+/// Get the dark mode used by storage_property_get_warning_reason(): the value set with
+/// storage_property_set_warning_reason_dark_mode(), or the GTK theme one.
+[[nodiscard]] bool storage_property_get_warning_reason_dark_mode();
+
+
 
 #endif
 
@@ -14,7 +14,9 @@ Copyright:
 #include <gdk/gdk.h>  // GDK_KEY_Escape
 #include <vector>  // better use vector, it's needed by others too
 #include <algorithm>  // std::min, std::max
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "hz/string_num.h"  // number_to_string
@@ -28,8 +30,10 @@ Copyright:
 #include "applib/warning_colors.h"
 #include "applib/gui_utils.h"  // gui_show_error_dialog
 #include "applib/smartctl_executor_gui.h"
+#include "applib/smartctl_parser.h"
 #include "applib/storage_property.h"
 #include "applib/storage_device_detected_type.h"
+#include "applib/attribute_history.h"
 
 #include "gsc_text_window.h"
 #include "gsc_info_window.h"
@@ -181,6 +185,13 @@ GscInfoWindow::GscInfoWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder>
 		device_name_hbox->pack_start(*device_name_label_, true, true);
 	}
 
+	if (auto* temperature_vbox = lookup_widget<Gtk::Box*>("temperature_log_tab_vbox")) {
+		temperature_graph_ = Gtk::manage(new GscTemperatureGraph());
+		temperature_graph_->set_size_request(-1, 200);
+		temperature_vbox->pack_start(*temperature_graph_, false, true);
+		temperature_vbox->reorder_child(*temperature_graph_, 1);  // below the labels
+	}
+
 
 	// Connect callbacks
 
@@ -205,6 +216,10 @@ GscInfoWindow::GscInfoWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder>
 	Gtk::Button* test_stop_button = nullptr;
 	APP_BUILDER_AUTO_CONNECT(test_stop_button, clicked);
 
+	if (auto* main_notebook = lookup_widget<Gtk::Notebook*>("main_notebook")) {
+		main_notebook->signal_switch_page().connect(sigc::mem_fun(*this, &GscInfoWindow::on_main_notebook_switch_page));
+	}
+
 
 	// Accelerators
 	if (close_window_button) {
@@ -328,6 +343,10 @@ GscInfoWindow::GscInfoWindow(BaseObjectType* gtkcobj, Glib::RefPtr<Gtk::Builder>
 
 GscInfoWindow::~GscInfoWindow()
 {
+	if (test_callback_source_id_ != 0) {
+		g_source_remove(test_callback_source_id_);
+	}
+
 	// Store window size. We don't store position to avoid overlaps.
 	{
 		int window_w = 0, window_h = 0;
@@ -354,7 +373,7 @@ void GscInfoWindow::set_drive(StorageDevicePtr d)
 
 
 
-void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests)
+void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests, StorageDeviceFetchTier tier)
 {
 	debug_out_info("app", DBG_FUNC_MSG << "Scan " << (scan ? "" : "not ") << "requested.\n");
 
@@ -367,7 +386,7 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 		if (scan) {
 			std::shared_ptr<SmartctlExecutorGui> ex(new SmartctlExecutorGui());
 			ex->create_running_dialog(this, Glib::ustring::compose(_("Running {command} on %1..."), drive_->get_device_with_type()));
-			auto fetch_status = drive_->fetch_full_data_and_parse(ex);  // run it with GUI support
+			auto fetch_status = drive_->fetch_data_and_parse(tier, ex);  // run it with GUI support
 
 			if (!fetch_status) {
 				gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), fetch_status.error().message(), this);
@@ -494,8 +513,17 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 		// Gtk::Label* device_name_label = lookup_widget<Gtk::Label*>("device_name_label");
 		if (device_name_label_) {
 			/// Translators: %1 is device name, %2 is drive letters (if not empty), %3 is device model.
-			device_name_label_->set_markup(Glib::ustring::compose(_("<b>Device:</b> %1%2  <b>Model:</b> %3"),
-					device, (drive_letters.empty() ? "" : (" (<b>" + drive_letters + "</b>)")), model));
+			Glib::ustring markup = Glib::ustring::compose(_("<b>Device:</b> %1%2  <b>Model:</b> %3"),
+					device, (drive_letters.empty() ? "" : (" (<b>" + drive_letters + "</b>)")), model);
+
+			// The drive was not woken up to refresh the data, show how old it is.
+			if (const auto data_time = drive_->get_last_data_time(); drive_->get_is_in_standby() && data_time.has_value()) {
+				const auto age = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - data_time.value());
+				markup += "  <i>" + Glib::Markup::escape_text(Glib::ustring::compose(
+						_("Data from %1 ago, the drive is in standby mode. Press Refresh to wake it up."),
+						hz::format_time_length(std::max(age, std::chrono::seconds(60))))) + "</i>";
+			}
+			device_name_label_->set_markup(markup);
 		}
 	}
 
@@ -512,28 +540,27 @@ void GscInfoWindow::fill_ui_with_info(bool scan, bool clear_ui, bool clear_tests
 	if (clear_tests) {
 		fill_ui_self_test_info();
 	}
-	fill_ui_self_test_log(property_repo);
-	fill_ui_ata_error_log(property_repo);
-	fill_ui_nvme_error_log(property_repo);
-	fill_ui_temperature_log(property_repo);
 
-	// Advanced tab
-	auto caps_warning_level = fill_ui_capabilities(property_repo);
-	auto errc_warning_level = fill_ui_error_recovery(property_repo);
-	auto selective_warning_level = fill_ui_selective_self_test_log(property_repo);
-	auto dir_warning_level = fill_ui_directory(property_repo);
-	auto phy_warning_level = fill_ui_physical(property_repo);
-
-	auto max_advanced_tab_warning = std::max({
-		caps_warning_level,
-		errc_warning_level,
-		selective_warning_level,
-		dir_warning_level,
-		phy_warning_level
-	});
+	// The log tabs are filled when the user opens them. Their properties are
+	// processed (descriptions set) only at that point.
+	deferred_tabs_ = {
+		DeferredTab::SelfTestLog,
+		DeferredTab::AtaErrorLog,
+		DeferredTab::NvmeErrorLog,
+		DeferredTab::TemperatureLog,
+		DeferredTab::Advanced,
+	};
+	for (const auto tab : deferred_tabs_) {
+		highlight_deferred_tab_label(tab);
+	}
 
-	// Advanced tab label
-	app_highlight_tab_label(lookup_widget("advanced_tab_label"), max_advanced_tab_warning, tab_names_.advanced);
+	// If one of the deferred tabs is already open (e.g. on refresh), fill it now.
+	if (auto* notebook = lookup_widget<Gtk::Notebook*>("main_notebook")) {
+		const int page_num = notebook->get_current_page();
+		if (page_num >= 0) {
+			on_main_notebook_switch_page(notebook->get_nth_page(page_num), guint(page_num));
+		}
+	}
 }
 
 
@@ -706,6 +733,10 @@ void GscInfoWindow::clear_ui_info(bool clear_tests_too)
 			Glib::RefPtr<Gtk::TextBuffer> buffer = textview->get_buffer();
 			buffer->set_text("\n"s + _("No data available"));
 		}
+		if (temperature_graph_) {
+			temperature_graph_->set_data({});
+			temperature_graph_->hide();
+		}
 
 		// tab label
 		app_highlight_tab_label(lookup_widget("temperature_log_tab_label"), WarningLevel::None, tab_names_.temperature);
@@ -773,12 +804,12 @@ void GscInfoWindow::clear_ui_info(bool clear_tests_too)
 
 
 
-void GscInfoWindow::refresh_info(bool clear_tests_too)
+void GscInfoWindow::refresh_info(bool clear_tests_too, StorageDeviceFetchTier tier)
 {
 	this->set_sensitive(false);  // make insensitive until filled. helps with pressed F5 problem.
 
 	// this->clear_ui_info();  // no need, fill_ui_with_info() will call it.
-	this->fill_ui_with_info(true, true, clear_tests_too);
+	this->fill_ui_with_info(true, true, clear_tests_too, tier);
 
 	this->set_sensitive(true);  // make sensitive again.
 }
@@ -823,6 +854,12 @@ void GscInfoWindow::on_view_output_button_clicked()
 		output = this->drive_->get_basic_output();
 	}
 
+	// The properties merged by a lower fetch tier are newer than the full output, show both.
+	const std::string tier_output = this->drive_->get_tier_output();
+	if (!tier_output.empty()) {
+		output += "\n\n" + std::string(_("Partial update of the above data:")) + "\n\n" + tier_output;
+	}
+
 	win->set_text_from_command(_("Smartctl Output"), output);
 
 	const std::string filename = drive_->get_save_filename();
@@ -933,15 +970,26 @@ void GscInfoWindow::on_save_info_button_clicked()
 				data = this->drive_->get_basic_output();
 			}
 			if (save_txt) {
-				if (auto p = this->drive_->get_property_repository().lookup_property("smartctl/output"); !p.empty()) {
-					const std::string text_output = p.get_value<std::string>();
+				if (const auto* p = this->drive_->get_property_repository().find_property("smartctl/output")) {
+					const std::string& text_output = p->get_value<std::string>();
 					if (!text_output.empty()) {
 						data = text_output;
 					}
 				}
 			}
 
-			const std::error_code ec = hz::fs_file_put_contents(file, data);
+			std::error_code ec = hz::fs_file_put_contents(file, data);
+
+			// The properties merged by a lower fetch tier are newer than the full output.
+			// Save them next to it, so that the file itself stays loadable.
+			const std::string tier_output = this->drive_->get_tier_output();
+			if (!ec && !tier_output.empty()) {
+				const auto tier_format = SmartctlParser::detect_output_format(tier_output);
+				hz::fs::path tier_file = file.parent_path() / file.stem();
+				tier_file += (tier_format && tier_format.value() == SmartctlOutputFormat::Text) ? ".update.txt" : ".update.json";
+				ec = hz::fs_file_put_contents(tier_file, tier_output);
+			}
+
 			if (ec) {
 				gui_show_error_dialog(_("Cannot save SMART data to file"), ec.message(), this);
 			}
@@ -1836,12 +1884,94 @@ void GscInfoWindow::fill_ui_temperature_log(const StoragePropertyRepository& pro
 	auto* label_vbox = lookup_widget<Gtk::Box*>("temperature_log_label_vbox");
 	app_set_top_labels(label_vbox, label_strings);
 
+	fill_ui_temperature_graph(property_repo);
+
 	// tab label
 	app_highlight_tab_label(lookup_widget("temperature_log_tab_label"), max_tab_warning, tab_names_.temperature);
 }
 
 
 
+
+void GscInfoWindow::fill_ui_temperature_graph(const StoragePropertyRepository& property_repo)
+{
+	if (!temperature_graph_) {
+		return;
+	}
+
+	std::vector<SeriesPoint> points;
+
+	// The SCT table ends at the time it was fetched (the tab may be filled much later).
+	// Virtual drives may be old, the time is taken from the output for them.
+	std::optional<std::chrono::system_clock::time_point> table_time;
+	if (drive_ && drive_->get_is_virtual()) {
+		if (const auto* time_prop = property_repo.find_property("local_time/time_t"); time_prop && time_prop->is_value_type<std::int64_t>()) {
+			table_time = std::chrono::system_clock::time_point(std::chrono::seconds(time_prop->get_value<std::int64_t>()));
+		}
+	}
+	if (drive_ && !table_time.has_value()) {
+		table_time = drive_->get_section_data_time(StoragePropertySection::TemperatureLog);
+	}
+	if (drive_ && !table_time.has_value()) {
+		table_time = drive_->get_full_data_time();
+	}
+
+	std::vector<SeriesPoint> sct_points;
+	const auto* table_prop = property_repo.find_property("ata_sct_temperature_history/table", StoragePropertySection::TemperatureLog);
+	if (table_prop && table_prop->is_value_type<AtaStorageTemperatureHistory>()) {
+		const auto& history = table_prop->get_value<AtaStorageTemperatureHistory>();
+		const double interval = static_cast<double>(std::max<std::int64_t>(history.logging_interval_minutes, 1) * 60);
+		const double end_time = std::chrono::duration<double>(
+				table_time.value_or(std::chrono::system_clock::now()).time_since_epoch()).count();
+		const auto size = history.temperatures.size();
+		for (std::size_t i = 0; i < size; ++i) {
+			if (history.temperatures[i].has_value()) {
+				sct_points.push_back({end_time - static_cast<double>(size - 1 - i) * interval,
+						static_cast<double>(history.temperatures[i].value())});
+			}
+		}
+	}
+
+	// Collected history (if enabled) goes before the SCT table, which has a higher resolution.
+	const auto history_dir = rconfig::get_data<std::string>("system/attribute_history_dir");
+	if (drive_ && !drive_->get_is_virtual() && !history_dir.empty()) {
+		AttributeHistoryReader reader;
+		const auto file_base = attribute_history_get_file_base(hz::fs_path_from_string(history_dir),
+				drive_->get_model_name(), drive_->get_serial_number(), drive_->get_device());
+		const auto time_range = reader.open(file_base) ? reader.get_time_range() : std::nullopt;
+		if (time_range.has_value()) {
+			for (const auto* series_name : {"ata_sct_status/temperature/current", "temperature/current",
+					"nvme_smart_health_information_log/temperature"}) {
+				auto series = reader.read_series(series_name, time_range->first, time_range->second);
+				if (series.empty()) {
+					continue;
+				}
+				points.reserve(series.size() + sct_points.size());
+				for (const auto& [time, value] : series) {
+					const auto x = static_cast<double>(time.time_since_epoch().count());
+					if (!sct_points.empty() && x >= sct_points.front().x) {
+						break;
+					}
+					points.push_back({x, static_cast<double>(value)});
+				}
+				break;
+			}
+		}
+	}
+	points.insert(points.end(), sct_points.begin(), sct_points.end());
+
+	std::optional<double> limit;
+	if (const auto* limit_prop = property_repo.find_property("ata_sct_temperature_history/temperature/op_limit_max")) {
+		limit = static_cast<double>(limit_prop->get_value<std::int64_t>());
+	}
+
+	temperature_graph_->set_data(std::move(points));
+	temperature_graph_->set_limit(limit);
+	temperature_graph_->set_visible(temperature_graph_->has_data());
+}
+
+
+
 WarningLevel GscInfoWindow::fill_ui_capabilities(const StoragePropertyRepository& property_repo)
 {
 	const auto& props = property_repo.get_properties();
@@ -2065,6 +2195,115 @@ WarningLevel GscInfoWindow::fill_ui_directory(const StoragePropertyRepository& p
 
 
 
+void GscInfoWindow::fill_ui_advanced(const StoragePropertyRepository& property_repo)
+{
+	auto caps_warning_level = fill_ui_capabilities(property_repo);
+	auto errc_warning_level = fill_ui_error_recovery(property_repo);
+	auto selective_warning_level = fill_ui_selective_self_test_log(property_repo);
+	auto dir_warning_level = fill_ui_directory(property_repo);
+	auto phy_warning_level = fill_ui_physical(property_repo);
+
+	auto max_advanced_tab_warning = std::max({
+		caps_warning_level,
+		errc_warning_level,
+		selective_warning_level,
+		dir_warning_level,
+		phy_warning_level
+	});
+
+	// Advanced tab label
+	app_highlight_tab_label(lookup_widget("advanced_tab_label"), max_advanced_tab_warning, tab_names_.advanced);
+}
+
+
+
+void GscInfoWindow::fill_ui_deferred_tab(DeferredTab tab)
+{
+	if (!drive_ || deferred_tabs_.erase(tab) == 0)
+		return;
+
+	// This generates the descriptions in-place, so the pointers held by other tabs remain valid.
+	const auto& property_repo = drive_->get_property_repository();
+
+	switch (tab) {
+		case DeferredTab::SelfTestLog:
+			drive_->ensure_section_processed(StoragePropertySection::SelftestLog);
+			fill_ui_self_test_log(property_repo);
+			break;
+		case DeferredTab::AtaErrorLog:
+			drive_->ensure_section_processed(StoragePropertySection::AtaErrorLog);
+			fill_ui_ata_error_log(property_repo);
+			break;
+		case DeferredTab::NvmeErrorLog:
+			drive_->ensure_section_processed(StoragePropertySection::NvmeErrorLog);
+			fill_ui_nvme_error_log(property_repo);
+			break;
+		case DeferredTab::TemperatureLog:
+			drive_->ensure_section_processed(StoragePropertySection::TemperatureLog);
+			fill_ui_temperature_log(property_repo);
+			break;
+		case DeferredTab::Advanced:
+			drive_->ensure_section_processed(StoragePropertySection::ErcLog);
+			drive_->ensure_section_processed(StoragePropertySection::SelectiveSelftestLog);
+			drive_->ensure_section_processed(StoragePropertySection::DirectoryLog);
+			drive_->ensure_section_processed(StoragePropertySection::PhyLog);
+			fill_ui_advanced(property_repo);
+			break;
+	}
+}
+
+
+
+void GscInfoWindow::highlight_deferred_tab_label(DeferredTab tab)
+{
+	std::vector<StoragePropertySection> sections;
+	std::string label_name;
+	Glib::ustring tab_name;
+
+	switch (tab) {
+		case DeferredTab::SelfTestLog:
+			sections = {StoragePropertySection::SelftestLog};
+			label_name = "test_tab_label";
+			tab_name = tab_names_.test;
+			break;
+		case DeferredTab::AtaErrorLog:
+			sections = {StoragePropertySection::AtaErrorLog};
+			label_name = "error_log_tab_label";
+			tab_name = tab_names_.ata_error_log;
+			break;
+		case DeferredTab::NvmeErrorLog:
+			sections = {StoragePropertySection::NvmeErrorLog};
+			label_name = "nvme_error_log_tab_label";
+			tab_name = tab_names_.nvme_error_log;
+			break;
+		case DeferredTab::TemperatureLog:
+			sections = {StoragePropertySection::TemperatureLog};
+			label_name = "temperature_log_tab_label";
+			tab_name = tab_names_.temperature;
+			break;
+		case DeferredTab::Advanced:
+			sections = {StoragePropertySection::Capabilities, StoragePropertySection::ErcLog,
+					StoragePropertySection::SelectiveSelftestLog, StoragePropertySection::DirectoryLog,
+					StoragePropertySection::PhyLog};
+			label_name = "advanced_tab_label";
+			tab_name = tab_names_.advanced;
+			break;
+	}
+
+	// Warnings are set on all properties, even if their sections are not processed yet.
+	WarningLevel max_tab_warning = WarningLevel::None;
+	for (const auto& p : drive_->get_property_repository().get_properties()) {
+		if (!p.show_in_ui || std::find(sections.begin(), sections.end(), p.section) == sections.end())
+			continue;
+		if (int(p.warning_level) > int(max_tab_warning))
+			max_tab_warning = p.warning_level;
+	}
+
+	app_highlight_tab_label(lookup_widget(label_name), max_tab_warning, tab_name);
+}
+
+
+
 /// Set cell renderer's foreground and background colors according to property warning level.
 inline void cell_renderer_set_warning_fg_bg(Gtk::CellRendererText* crt, const StorageProperty& p)
 {
@@ -2288,6 +2527,8 @@ gboolean GscInfoWindow::test_idle_callback(void* data)
 	auto* self = static_cast<GscInfoWindow*>(data);
 	DBG_ASSERT_RETURN(self, false);
 
+	self->test_callback_source_id_ = 0;  // this run is removed when we return
+
 	if (!self->current_test_)  // shouldn't happen
 		return FALSE;  // stop
 
@@ -2373,7 +2614,16 @@ gboolean GscInfoWindow::test_idle_callback(void* data)
 
 
 	if (active) {
-		return TRUE;  // continue the idle callback
+		// Wake up only when there is something to do: at the next poll (which may be
+		// an hour away during a long test), or at the next progress bar update.
+		auto delay = 300ms;  // progress bar update right after the poll
+		if (!self->test_force_bar_update_) {
+			const double poll_in = static_cast<double>(self->current_test_->get_poll_in_seconds().count()) - self->test_timer_poll_.elapsed();
+			const double bar_in = 5. - self->test_timer_bar_.elapsed();
+			delay = std::max(300ms, std::chrono::milliseconds(static_cast<int64_t>(std::min(poll_in, bar_in) * 1000.)));
+		}
+		self->schedule_test_callback(delay);
+		return FALSE;  // this run is done, the next one is scheduled
 	}
 
 
@@ -2496,7 +2746,8 @@ gboolean GscInfoWindow::test_idle_callback(void* data)
 		test_result_hbox->show();
 	}
 
-	self->refresh_info(false);  // don't clear the tests tab
+	// Only the self-test log and the attributes are affected by the test.
+	self->refresh_info(false, StorageDeviceFetchTier::Standard);  // don't clear the tests tab
 
 	return FALSE;  // stop idle callback
 }
@@ -2573,7 +2824,18 @@ void GscInfoWindow::on_test_execute_button_clicked()
 	// to escape the execute() loop.
 
 // 	g_idle_add(test_idle_callback, this);
-	g_timeout_add(300, test_idle_callback, this);  // every 300ms
+	// The callback reschedules itself for the next poll or progress bar update.
+	schedule_test_callback(300ms);
+}
+
+
+
+void GscInfoWindow::schedule_test_callback(std::chrono::milliseconds delay)
+{
+	if (test_callback_source_id_ != 0) {
+		g_source_remove(test_callback_source_id_);
+	}
+	test_callback_source_id_ = g_timeout_add(static_cast<guint>(delay.count()), test_idle_callback, this);
 }
 
 
@@ -2595,7 +2857,10 @@ void GscInfoWindow::on_test_stop_button_clicked()
 		return;
 	}
 
-	// nothing else to do - the cleanup is performed by the idle callback.
+	// The cleanup is performed by the idle callback. Run it now instead of at the next poll.
+	if (test_callback_source_id_ != 0) {
+		schedule_test_callback(300ms);
+	}
 }
 
 
@@ -2627,6 +2892,29 @@ void GscInfoWindow::on_drive_changed([[maybe_unused]] StorageDevice* pdrive)
 
 
 
+void GscInfoWindow::on_main_notebook_switch_page(Gtk::Widget* page, [[maybe_unused]] guint page_num)
+{
+	if (!page || deferred_tabs_.empty())
+		return;
+
+	static const std::vector<std::pair<const char*, DeferredTab>> tab_widgets {
+		{"test_tab_vbox", DeferredTab::SelfTestLog},
+		{"error_log_tab_vbox", DeferredTab::AtaErrorLog},
+		{"nvme_error_log_tab_vbox", DeferredTab::NvmeErrorLog},
+		{"temperature_log_tab_vbox", DeferredTab::TemperatureLog},
+		{"advanced_tab_vbox", DeferredTab::Advanced},
+	};
+
+	for (const auto& [widget_name, tab] : tab_widgets) {
+		if (lookup_widget(widget_name) == page) {
+			fill_ui_deferred_tab(tab);
+			break;
+		}
+	}
+}
+
+
+
 bool GscInfoWindow::on_treeview_button_press_event(GdkEventButton* button_event, Gtk::Menu* menu, Gtk::TreeView* treeview)
 {
 	if (button_event->type == GDK_BUTTON_PRESS && button_event->button == 3) {
@@ -13,12 +13,15 @@ Copyright:
 #define GSC_INFO_WINDOW_H
 
 #include <gtkmm.h>
+#include <chrono>
 #include <map>
 #include <memory>
+#include <set>
 
 #include "applib/app_builder_widget.h"
 #include "applib/storage_device.h"
 #include "applib/selftest.h"
+#include "gsc_temperature_graph.h"
 
 
 
@@ -118,14 +121,15 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// Set the drive to show
 		void set_drive(StorageDevicePtr d);
 
-		/// Fill the dialog with info from the drive
-		void fill_ui_with_info(bool scan = true, bool clear_ui = true, bool clear_tests = true);
+		/// Fill the dialog with info from the drive. If \c scan is true, the data of \c tier is fetched first.
+		void fill_ui_with_info(bool scan = true, bool clear_ui = true, bool clear_tests = true,
+				StorageDeviceFetchTier tier = StorageDeviceFetchTier::Full);
 
 		/// Clear all info in UI
 		void clear_ui_info(bool clear_tests_too = true);
 
-		/// Refresh the drive information in UI
-		void refresh_info(bool clear_tests_too = true);
+		/// Refresh the drive information in UI, fetching the data of \c tier
+		void refresh_info(bool clear_tests_too = true, StorageDeviceFetchTier tier = StorageDeviceFetchTier::Full);
 
 
 		// Show the Tests tab. Called by main window.
@@ -161,6 +165,10 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// fill_ui_with_info() helper
 		void fill_ui_temperature_log(const StoragePropertyRepository& property_repo);
 
+		/// fill_ui_temperature_log() helper. Fills the graph with the SCT temperature history
+		/// and the collected attribute history.
+		void fill_ui_temperature_graph(const StoragePropertyRepository& property_repo);
+
 		/// fill_ui_with_info() helper
 		WarningLevel fill_ui_capabilities(const StoragePropertyRepository& property_repo);
 
@@ -176,6 +184,26 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// fill_ui_with_info() helper
 		WarningLevel fill_ui_directory(const StoragePropertyRepository& property_repo);
 
+		/// fill_ui_with_info() helper. Fills the Advanced tab (capabilities and the smaller logs).
+		void fill_ui_advanced(const StoragePropertyRepository& property_repo);
+
+
+		/// Tabs which are filled only when the user opens them
+		enum class DeferredTab {
+			SelfTestLog,
+			AtaErrorLog,
+			NvmeErrorLog,
+			TemperatureLog,
+			Advanced,
+		};
+
+		/// Fill a deferred tab. The descriptions of its properties are generated at this point.
+		/// Does nothing if the tab is already filled.
+		void fill_ui_deferred_tab(DeferredTab tab);
+
+		/// Highlight a label of a deferred tab which is not filled yet, using the already known warnings.
+		void highlight_deferred_tab_label(DeferredTab tab);
+
 
 		// ---------- Helpers
 
@@ -209,6 +237,9 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// An idle callback to update the status while the test is running.
 		static gboolean test_idle_callback(void* data);
 
+		/// Schedule test_idle_callback() to run once after \c delay, replacing the scheduled run (if any).
+		void schedule_test_callback(std::chrono::milliseconds delay);
+
 
 		// ---------- Overridden virtual methods
 
@@ -252,6 +283,9 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		/// Callback
 		void on_treeview_menu_copy_clicked(Gtk::TreeView* treeview);
 
+		/// Callback. Fills the deferred tabs when they are opened.
+		void on_main_notebook_switch_page(Gtk::Widget* page, guint page_num);
+
 
 	private:
 
@@ -289,6 +323,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 
 		Gtk::Label* device_name_label_ = nullptr;  ///< Top label
 
+		GscTemperatureGraph* temperature_graph_ = nullptr;  ///< Temperature history graph
+
 		StorageDevicePtr drive_;  ///< The drive we're showing
 
 		std::shared_ptr<SelfTest> current_test_;  ///< Currently running test, or 0.
@@ -298,6 +334,7 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		Glib::Timer test_timer_poll_;  ///< Timer for testing phase
 		Glib::Timer test_timer_bar_;  ///< Timer for testing phase
 		bool test_force_bar_update_ = false;  ///< Helper for testing callback
+		guint test_callback_source_id_ = 0;  ///< Scheduled test_idle_callback() run, 0 if none
 
 		// "Test type" combobox columns
 		struct {
@@ -312,6 +349,8 @@ class GscInfoWindow : public AppBuilderWidget<GscInfoWindow, true> {
 		std::unique_ptr<GscInfoWindowColumns> columns_;
 
 		int book_selftest_page_no_ = -1;  ///< The page number of the self-test log in the notebook
+
+		std::set<DeferredTab> deferred_tabs_;  ///< Tabs which were not filled yet
 };
 
 
@@ -47,6 +47,7 @@
 
 #include "applib/window_instance_manager.h"
 #include "applib/gsc_settings.h"
+#include "applib/storage_property_descr.h"
 #include "gsc_main_window.h"
 #include "gsc_executor_log_window.h"
 #include "gsc_init.h"
@@ -140,6 +141,9 @@ namespace {
 			rconfig::autosave_start(std::chrono::seconds(autosave_timeout_sec));
 		}
 
+		// User warning rules are read once, changing them requires a restart.
+		StoragePropertyProcessor::set_user_warning_rules(StoragePropertyUserRules::from_config());
+
 		return true;
 	}
 
@@ -226,7 +230,8 @@ namespace {
 			{ "no-scan", '\0', G_OPTION_FLAG_REVERSE, G_OPTION_ARG_NONE, &(args.arg_scan),
 					N_("Don't scan devices on startup"), nullptr },
 			{ "add-virtual", '\0', 0, G_OPTION_ARG_FILENAME_ARRAY, &(args.arg_add_virtual),
-					N_("Load smartctl data from file, creating a virtual drive. You can specify this option multiple times."), nullptr },
+					N_("Load smartctl data from file, creating a virtual drive. Directories and wildcard patterns (e.g. \"dir/smart-*\")"
+					" load all matching files. You can specify this option multiple times."), nullptr },
 			{ "add-device", '\0', 0, G_OPTION_ARG_FILENAME_ARRAY, &(args.arg_add_device),
 					N_("Add this device to device list. The format of the device is \"<device>::<type>::<extra_args>\", where type and extra_args are optional."
 					" This option is useful with --no-scan to list certain drives only. You can specify this option multiple times."
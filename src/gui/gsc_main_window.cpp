@@ -11,6 +11,7 @@ Copyright:
 
 #include <glibmm.h>
 #include <gtkmm.h>
+#include <chrono>
 #include <system_error>
 #include <vector>
 #include <memory>
@@ -30,6 +31,10 @@ Copyright:
 #include "applib/warning_colors.h"  // app_property_get_label_highlight_color
 #include "applib/app_regex.h"
 #include "applib/smartctl_version_parser.h"
+#include "applib/smartctl_version_cache.h"
+#include "applib/attribute_trend.h"
+#include "applib/storage_device_bulk_loader.h"
+#include "applib/selftest_orchestrator.h"
 
 #include "gsc_init.h"  // app_quit()
 #include "gsc_about_dialog.h"
@@ -96,6 +101,10 @@ GscMainWindow::~GscMainWindow()
 	// on_iconview_selection_changed() is called even after the window is deleted,
 	// causing crash on exit.
 	// iconview_->clear_all();
+	bulk_loader_.reset();  // its callbacks use the iconview
+	if (test_orchestrator_source_id_ != 0) {
+		g_source_remove(test_orchestrator_source_id_);
+	}
 	delete iconview_;
 }
 
@@ -156,10 +165,8 @@ void GscMainWindow::populate_iconview_on_startup(bool smartctl_valid)
 		}
 	}
 
-	for (auto&& virt : get_startup_settings().load_virtuals) {
-		if (!virt.empty()) {
-			add_virtual_drive(virt);
-		}
+	if (!get_startup_settings().load_virtuals.empty()) {
+		add_virtual_drives(get_startup_settings().load_virtuals);
 	}
 
 	// update the menus (group sensitiveness, etc.)
@@ -206,6 +213,15 @@ bool GscMainWindow::create_widgets()
 	"		<menuitem action='" APP_ACTION_NAME(action_add_device) "' />"
 	"		<menuitem action='" APP_ACTION_NAME(action_load_virtual) "' />"
 	"		<menuitem action='" APP_ACTION_NAME(action_rescan_devices) "' />"
+
+	"		<separator />"
+	"		<menu action='test_all_menu'>"
+	"			<menuitem action='" APP_ACTION_NAME(action_test_all_short) "' />"
+	"			<menuitem action='" APP_ACTION_NAME(action_test_all_long) "' />"
+	"			<menuitem action='" APP_ACTION_NAME(action_test_all_conveyance) "' />"
+	"			<separator />"
+	"			<menuitem action='" APP_ACTION_NAME(action_test_all_stop) "' />"
+	"		</menu>"
 	"	</menu>"
 
 	"	<menu action='options_menu'>"
@@ -303,6 +319,30 @@ bool GscMainWindow::create_widgets()
 		actiongroup_main_->add((action_map_[action_rescan_devices] = action), Gtk::AccelKey("<control>R"),
 				sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_action_activated), action_rescan_devices));
 
+		// ---
+		actiongroup_main_->add(Gtk::Action::create("test_all_menu", _("Self-Test _All Drives")));
+
+		action = Gtk::Action::create(APP_ACTION_NAME(action_test_all_short), _("Run _Short Self-Test"),
+				_("Run a short self-test on all drives which support it"));
+		actiongroup_main_->add((action_map_[action_test_all_short] = action),
+				sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_action_activated), action_test_all_short));
+
+		action = Gtk::Action::create(APP_ACTION_NAME(action_test_all_long), _("Run _Extended Self-Test"),
+				_("Run an extended self-test on all drives which support it"));
+		actiongroup_main_->add((action_map_[action_test_all_long] = action),
+				sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_action_activated), action_test_all_long));
+
+		action = Gtk::Action::create(APP_ACTION_NAME(action_test_all_conveyance), _("Run _Conveyance Self-Test"),
+				_("Run a conveyance self-test on all drives which support it"));
+		actiongroup_main_->add((action_map_[action_test_all_conveyance] = action),
+				sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_action_activated), action_test_all_conveyance));
+
+		action = Gtk::Action::create(APP_ACTION_NAME(action_test_all_stop), Gtk::Stock::STOP, _("_Abort Self-Tests"),
+				_("Abort the self-tests started on all drives"));
+		action->set_sensitive(false);  // until the tests are started
+		actiongroup_main_->add((action_map_[action_test_all_stop] = action),
+				sigc::bind(sigc::mem_fun(*this, &GscMainWindow::on_action_activated), action_test_all_stop));
+
 	actiongroup_main_->add(Gtk::Action::create("options_menu", _("_Options")));
 
 		action = Gtk::Action::create(APP_ACTION_NAME(action_executor_log), _("View Execution Log"));
@@ -429,7 +469,48 @@ namespace {
 		}
 		return (status == Gtk::RESPONSE_YES);
 	}
-	
+
+
+	/// Ask the user which drives to run the test on. Return the selected drives, or
+	/// an empty vector if the user cancelled.
+	inline std::vector<StorageDevicePtr> choose_drives_for_test(Gtk::Window& parent,
+			const std::vector<StorageDevicePtr>& drives, SelfTest::TestType type)
+	{
+		/// Translators: %1 is test name
+		Gtk::Dialog dialog(Glib::ustring::compose(_("Run %1"), SelfTest::get_test_displayable_name(type)), parent, true);
+		dialog.add_button(Gtk::Stock::CANCEL, Gtk::RESPONSE_CANCEL);
+		dialog.add_button(Gtk::Stock::EXECUTE, Gtk::RESPONSE_ACCEPT);
+		dialog.set_default_response(Gtk::RESPONSE_ACCEPT);
+
+		auto* box = dialog.get_content_area();
+		box->set_spacing(6);
+		box->set_border_width(12);
+		box->pack_start(*Gtk::manage(new Gtk::Label(_("Select the drives to run the test on:"), Gtk::ALIGN_START)), false, false);
+
+		std::vector<Gtk::CheckButton*> checks;
+		for (const auto& drive : drives) {
+			const std::string model = drive->get_model_name();
+			auto* check = Gtk::manage(new Gtk::CheckButton(drive->get_device_with_type()
+					+ (model.empty() ? std::string() : " - " + model)));
+			check->set_active(true);
+			box->pack_start(*check, false, false);
+			checks.push_back(check);
+		}
+		box->show_all();
+
+		if (dialog.run() != Gtk::RESPONSE_ACCEPT) {
+			return {};
+		}
+
+		std::vector<StorageDevicePtr> selected;
+		for (std::size_t i = 0; i < drives.size(); ++i) {
+			if (checks[i]->get_active()) {
+				selected.push_back(drives[i]);
+			}
+		}
+		return selected;
+	}
+
 }
 
 
@@ -526,6 +607,22 @@ void GscMainWindow::on_action_activated(GscMainWindow::action_t action_type)
 			add_startup_manual_devices();
 			break;
 
+		case action_test_all_short:
+			run_test_on_all_drives(SelfTest::TestType::ShortTest);
+			break;
+
+		case action_test_all_long:
+			run_test_on_all_drives(SelfTest::TestType::LongTest);
+			break;
+
+		case action_test_all_conveyance:
+			run_test_on_all_drives(SelfTest::TestType::Conveyance);
+			break;
+
+		case action_test_all_stop:
+			stop_test_on_all_drives();
+			break;
+
 		case action_executor_log:
 		{
 			// this one will only hide on close.
@@ -860,6 +957,8 @@ void GscMainWindow::rescan_devices(bool startup)
 	StorageDetector sd;
 // 	sd.add_match_patterns(match_patterns);
 	sd.add_blacklist_patterns(blacklist_patterns);
+	// Scanning doesn't wake up the sleeping drives, they are shown without data until they're opened.
+	sd.set_allow_wakeup(false);
 
 
 	auto ex_factory = std::make_shared<CommandExecutorFactory>(true, this);  // run it with GUI support
@@ -893,7 +992,8 @@ void GscMainWindow::rescan_devices(bool startup)
 		// add them to iconview
 		for (auto& drive : drives_) {
 			if (rconfig::get_data<bool>("gui/show_smart_capable_only")) {
-				if (drive->get_smart_status() != StorageDevice::SmartStatus::Unsupported)
+				// The drives in standby mode have no data yet, so their status is unknown.
+				if (drive->get_smart_status() != StorageDevice::SmartStatus::Unsupported || drive->get_is_in_standby())
 					iconview_->add_entry(drive);
 			} else {
 				iconview_->add_entry(drive);
@@ -1009,7 +1109,9 @@ bool GscMainWindow::add_device(bool silent, const std::string& file, const std::
 	tmp_drives.push_back(drive);
 
 	// Don't report errors here, just add the drive to the list.
+	// The drive is added by the user, so it may be woken up.
 	StorageDetector sd;
+	sd.set_allow_wakeup(true);
 	auto fetch_error = sd.fetch_basic_data(tmp_drives, ex_factory, true);  // return its first error
 	if (!silent && !fetch_error) {
 		gsc_executor_error_dialog_show(_("An error occurred while adding the device"), fetch_error.error().message(), this);
@@ -1059,8 +1161,71 @@ bool GscMainWindow::add_virtual_drive(const std::string& file)
 
 
 
+void GscMainWindow::add_virtual_drives(const std::vector<std::string>& sources)
+{
+	std::vector<hz::fs::path> files = StorageDeviceBulkLoader::expand_sources(sources);
+	if (files.empty()) {
+		gui_show_error_dialog(_("Cannot load data file"), _("No matching files found."), this);
+		return;
+	}
+
+	// Load a single file directly, showing the errors immediately.
+	if (files.size() == 1) {
+		add_virtual_drive(hz::fs_path_to_string(files.front()));
+		return;
+	}
+
+	if (!bulk_loader_) {
+		bulk_loader_ = std::make_unique<StorageDeviceBulkLoader>();
+	}
+	if (bulk_loader_->is_running()) {
+		gui_show_warn_dialog(_("Cannot load data files"), _("Other files are still being loaded, please try again later."), this);
+		return;
+	}
+
+	auto errors = std::make_shared<std::vector<std::string>>();
+
+	bulk_loader_->set_batch_callback([this](std::vector<StorageDevicePtr> drives) {
+		for (auto& drive : drives) {
+			drives_.push_back(drive);
+			iconview_->add_entry(drive, false);
+		}
+		iconview_->update_menu_actions();
+	});
+
+	bulk_loader_->set_error_callback([errors](const hz::fs::path& file, const std::string& message) {
+		errors->push_back(hz::fs_path_to_string(file.filename()) + ": " + message);
+	});
+
+	bulk_loader_->set_finished_callback([this, errors](const StorageDeviceBulkLoaderStats& stats) {
+		this->update_status_widgets();
+
+		if (!errors->empty()) {
+			const std::size_t max_shown_errors = 10;
+			std::vector<std::string> shown_errors(errors->begin(),
+					errors->begin() + std::ptrdiff_t(std::min(errors->size(), max_shown_errors)));
+			if (errors->size() > max_shown_errors) {
+				shown_errors.emplace_back("...");
+			}
+			gui_show_error_dialog(_("Cannot load some data files"),
+					Glib::ustring::compose(_("%1 of %2 files could not be loaded (%3 files/s):\n\n%4"),
+							stats.files_failed, stats.files_total,
+							hz::number_to_string_locale(stats.get_files_per_second(), 1, true),
+							hz::string_join(shown_errors, "\n")), this);
+		}
+	});
+
+	bulk_loader_->start(std::move(files));
+}
+
+
+
+
 bool GscMainWindow::testing_active() const
 {
+	if (test_orchestrator_ && test_orchestrator_->is_active()) {
+		return true;
+	}
 	return std::any_of(drives_.cbegin(), drives_.cend(),
 	[](const auto& drive)
 	{
@@ -1082,6 +1247,18 @@ std::shared_ptr<GscInfoWindow> GscMainWindow::show_device_info_window(const Stor
 		return nullptr;
 	}
 
+	// The drive was in standby mode when scanning, so we don't know anything about it yet.
+	// Opening it is an explicit request, so wake it up.
+	if (!drive->get_is_virtual() && drive->get_is_in_standby() && drive->get_basic_output().empty()) {
+		std::shared_ptr<SmartctlExecutorGui> ex(new SmartctlExecutorGui());
+		ex->create_running_dialog(this, Glib::ustring::compose(_("Running {command} on %1..."), drive->get_device_with_type()));
+		auto fetch_status = drive->fetch_basic_data_and_parse(ex);  // run it with GUI support
+		if (!fetch_status) {
+			gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), fetch_status.error().message(), this);
+			return nullptr;
+		}
+	}
+
 	// ask to enable SMART if it's supported but disabled
 	if (!drive->get_is_virtual() && (drive->get_smart_status() == StorageDevice::SmartStatus::Disabled)) {
 
@@ -1114,11 +1291,24 @@ std::shared_ptr<GscInfoWindow> GscMainWindow::show_device_info_window(const Stor
 	// Virtual drives are parsed at load time.
 	// Parse non-virtual, smart-supporting drives here.
 	if (!drive->get_is_virtual() && drive->get_smart_status() != StorageDevice::SmartStatus::Unsupported) {
+		// Track the attribute trends, starting with the history recorded by gsmartcontrol-monitor (if any).
+		if (!drive->get_attribute_trend_tracker()) {
+			drive->set_attribute_trend_tracker(AttributeTrendTracker::create(
+					hz::fs_path_from_string(rconfig::get_data<std::string>("system/attribute_history_dir")),
+					drive->get_model_name(), drive->get_serial_number(), drive->get_device()));
+		}
+
 		std::shared_ptr<SmartctlExecutorGui> ex(new SmartctlExecutorGui());
 		ex->create_running_dialog(this, Glib::ustring::compose(_("Running {command} on %1..."), drive->get_device_with_type()));
-		auto command_status = drive->fetch_full_data_and_parse(ex);  // run it with GUI support
-
-		if (!command_status) {
+		// If the data was fetched before, don't wake up the drive just to show it again, and
+		// refresh only the parts which change often. The Refresh button in the info window
+		// wakes it up and fetches everything.
+		const bool has_full_data = drive->get_full_data_time().has_value();
+		auto command_status = drive->fetch_data_and_parse(
+				has_full_data ? StorageDeviceFetchTier::Standard : StorageDeviceFetchTier::Full,
+				ex, !has_full_data);  // run it with GUI support
+
+		if (!command_status && command_status.error().data() != StorageDeviceError::InStandby) {
 			gsc_executor_error_dialog_show(_("Cannot retrieve SMART data"), command_status.error().message(), this);
 			return nullptr;
 		}
@@ -1191,27 +1381,42 @@ bool GscMainWindow::check_smartctl_version_and_set_format()
 // 		if (!smartctl_def_options.empty())
 // 			smartctl_def_options += " ";
 
-		SmartctlExecutorGui ex;
-		ex.create_running_dialog(this);
-		ex.set_running_msg(_("Checking if smartctl is executable..."));
+		std::string version, version_full;
+
+		// If the binary hasn't changed since the last check, avoid executing it.
+		const auto binary_stamp = smartctl_get_binary_stamp(hz::fs_path_from_string(smartctl_binary));
+		if (auto cached_version = (binary_stamp ? smartctl_version_cache_lookup(*binary_stamp) : std::nullopt)) {
+			version = cached_version->version;
+			version_full = cached_version->version_full;
+			debug_out_dump("app", DBG_FUNC_MSG << "Using cached smartctl version " << version << " for \"" << binary_stamp->path << "\".\n");
 
-		ex.set_command(smartctl_binary, {"-V"});  // --version
+		} else {
+			SmartctlExecutorGui ex;
+			ex.create_running_dialog(this);
+			ex.set_running_msg(_("Checking if smartctl is executable..."));
 
-		if (!ex.execute() || !ex.get_error_msg().empty()) {
-			error_msg = ex.get_error_msg();
-			break;
-		}
+			ex.set_command(smartctl_binary, {"-V"});  // --version
 
-		const std::string output = ex.get_stdout_str();
-		if (output.empty()) {
-			error_msg = _("Smartctl returned an empty output.");
-			break;
-		}
+			if (!ex.execute() || !ex.get_error_msg().empty()) {
+				error_msg = ex.get_error_msg();
+				break;
+			}
 
-		std::string version, version_full;
-		if (!SmartctlVersionParser::parse_version_text(output, version, version_full)) {
-			error_msg = _("Smartctl returned invalid output.");
-			break;
+			const std::string output = ex.get_stdout_str();
+			if (output.empty()) {
+				error_msg = _("Smartctl returned an empty output.");
+				break;
+			}
+
+			if (!SmartctlVersionParser::parse_version_text(output, version, version_full)) {
+				error_msg = _("Smartctl returned invalid output.");
+				break;
+			}
+
+			// Only successful results are cached, so that errors are always shown.
+			if (binary_stamp) {
+				smartctl_version_cache_store(*binary_stamp, {version, version_full});
+			}
 		}
 
 		// Check smartctl runtime version
@@ -1320,11 +1525,15 @@ void GscMainWindow::show_load_virtual_file_chooser()
 				last_dir = hz::fs_path_to_string(hz::fs_path_from_string(files.front()).parent_path());
 			}
 			rconfig::set_data("gui/drive_data_open_save_dir", last_dir);
-			for (const auto& file : files) {
+
+			// file chooser returns selected directories as well, ignore them.
+			files.erase(std::remove_if(files.begin(), files.end(), [](const std::string& file) {
 				std::error_code ec;
-				if (!hz::fs::is_directory(hz::fs_path_from_string(file), ec)) {  // file chooser returns selected directories as well, ignore them.
-					this->add_virtual_drive(file);
-				}
+				return hz::fs::is_directory(hz::fs_path_from_string(file), ec);
+			}), files.end());
+
+			if (!files.empty()) {
+				this->add_virtual_drives(files);
 			}
 			break;
 		}
@@ -1341,6 +1550,166 @@ void GscMainWindow::show_load_virtual_file_chooser()
 
 
 
+void GscMainWindow::run_test_on_all_drives(SelfTest::TestType type)
+{
+	if (test_orchestrator_ && test_orchestrator_->is_active()) {
+		return;
+	}
+
+	// Offer only the drives which can run the test now
+	std::vector<StorageDevicePtr> candidates;
+	for (const auto& drive : drives_) {
+		if (!drive->get_is_virtual() && !drive->get_test_is_active() && SelfTest(drive, type).is_supported()) {
+			candidates.push_back(drive);
+		}
+	}
+	if (candidates.empty()) {
+		/// Translators: %1 is test name
+		gui_show_warn_dialog(Glib::ustring::compose(_("Cannot run %1"), SelfTest::get_test_displayable_name(type)),
+				_("No drive supports this test, or all such drives are busy."), this);
+		return;
+	}
+
+	const auto selected = choose_drives_for_test(*this, candidates, type);
+	if (selected.empty()) {
+		return;
+	}
+
+	// The GUI executors show their dialog only if smartctl takes long to respond.
+	auto ex_factory = std::make_shared<CommandExecutorFactory>(true, this);
+	test_orchestrator_ = std::make_unique<SelfTestOrchestrator>(type,
+			rconfig::get_data<int>("system/self_test_max_per_controller"),
+			[ex_factory]() { return ex_factory->create_executor(CommandExecutorFactory::ExecutorType::Smartctl); });
+
+	for (const auto& drive : selected) {
+		test_orchestrator_->add_drive(drive);
+	}
+
+	if (!test_orchestrator_->is_active()) {
+		/// Translators: %1 is test name
+		gui_show_warn_dialog(Glib::ustring::compose(_("Cannot run %1"), SelfTest::get_test_displayable_name(type)),
+				_("No drive supports this test, or all such drives are busy."), this);
+		test_orchestrator_.reset();
+		return;
+	}
+
+	for (auto action_type : {action_test_all_short, action_test_all_long, action_test_all_conveyance}) {
+		action_map_[action_type]->set_sensitive(false);
+	}
+	action_map_[action_test_all_stop]->set_sensitive(true);
+
+	schedule_test_orchestrator_callback();
+}
+
+
+
+void GscMainWindow::stop_test_on_all_drives()
+{
+	if (!test_orchestrator_ || !test_orchestrator_->is_active()) {
+		return;
+	}
+
+	test_orchestrator_->abort();
+	schedule_test_orchestrator_callback();  // shows the results
+}
+
+
+
+gboolean GscMainWindow::test_orchestrator_callback(void* data)
+{
+	auto* self = static_cast<GscMainWindow*>(data);
+	DBG_ASSERT_RETURN(self, false);
+
+	self->test_orchestrator_source_id_ = 0;  // this run is removed when we return
+
+	if (!self->test_orchestrator_)  // shouldn't happen
+		return FALSE;  // stop
+
+	// The executors iterate the main loop while smartctl is running, so don't allow
+	// aborting in the middle of a tick.
+	self->action_map_[action_test_all_stop]->set_sensitive(false);
+	self->test_orchestrator_->tick(SelfTestOrchestrator::Clock::now());
+	self->action_map_[action_test_all_stop]->set_sensitive(true);
+
+	self->schedule_test_orchestrator_callback();
+	return FALSE;  // this run is done, the next one is scheduled
+}
+
+
+
+void GscMainWindow::schedule_test_orchestrator_callback()
+{
+	if (test_orchestrator_source_id_ != 0) {
+		g_source_remove(test_orchestrator_source_id_);
+		test_orchestrator_source_id_ = 0;
+	}
+
+	const auto next_time = test_orchestrator_->get_next_tick_time();
+	if (!next_time.has_value()) {
+		show_test_orchestrator_results();
+		return;
+	}
+
+	// Wake up only at the next poll, which may be an hour away during long tests.
+	const auto delay = std::max(300ms, std::chrono::duration_cast<std::chrono::milliseconds>(
+			next_time.value() - SelfTestOrchestrator::Clock::now()));
+	test_orchestrator_source_id_ = g_timeout_add(static_cast<guint>(delay.count()), test_orchestrator_callback, this);
+}
+
+
+
+void GscMainWindow::show_test_orchestrator_results()
+{
+	for (auto action_type : {action_test_all_short, action_test_all_long, action_test_all_conveyance}) {
+		action_map_[action_type]->set_sensitive(true);
+	}
+	action_map_[action_test_all_stop]->set_sensitive(false);
+
+	if (!test_orchestrator_)
+		return;
+
+	std::vector<std::string> result_lines;
+	for (const auto& result : test_orchestrator_->get_results()) {
+		std::string result_str;
+		switch (result.state) {
+			case SelfTestOrchestrator::DriveState::Queued:
+			case SelfTestOrchestrator::DriveState::Running:
+				result_str = SelfTestStatusExt::get_displayable_name(SelfTestStatus::InProgress);
+				break;
+			case SelfTestOrchestrator::DriveState::Finished:
+				result_str = SelfTestStatusExt::get_displayable_name(result.status);
+				break;
+			case SelfTestOrchestrator::DriveState::Failed:
+				result_str = Glib::ustring::compose(_("Error: %1"), result.error_message);
+				break;
+			case SelfTestOrchestrator::DriveState::Skipped:
+				result_str = Glib::ustring::compose(_("Skipped: %1"), result.error_message);
+				break;
+			case SelfTestOrchestrator::DriveState::Cancelled:
+				result_str = _("Cancelled");
+				break;
+		}
+		result_lines.push_back(result.drive->get_device_with_type() + ": " + result_str);
+	}
+
+	const auto summary = test_orchestrator_->get_summary();
+	/// Translators: %1 is test name
+	const std::string message = Glib::ustring::compose(_("%1 finished: %2 passed, %3 failed, %4 with warnings, %5 errors, %6 skipped."),
+			SelfTest::get_test_displayable_name(test_orchestrator_->get_test_type()),
+			summary.passed, summary.failed, summary.warnings, summary.errors, summary.skipped);
+	const std::string details = hz::string_join(result_lines, "\n");
+
+	if (summary.failed > 0 || summary.errors > 0) {
+		gui_show_error_dialog(message, details, this);
+	} else if (summary.warnings > 0) {
+		gui_show_warn_dialog(message, details, this);
+	} else {
+		gui_show_info_dialog(message, details, this);
+	}
+}
+
+
+
 void GscMainWindow::quit_requested()
 {
 	// if at least one drive is having a test performed, disallow.
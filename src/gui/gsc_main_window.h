@@ -13,9 +13,12 @@ Copyright:
 #define GSC_MAIN_WINDOW_H
 
 #include <map>
+#include <memory>
 #include <gtkmm.h>
 
 #include "applib/app_builder_widget.h"
+#include "applib/selftest.h"
+#include "applib/selftest_orchestrator.h"
 #include "applib/storage_device.h"
 
 
@@ -24,6 +27,8 @@ class GscMainWindowIconView;  // defined in gsc_main_window_iconview.h
 
 class GscInfoWindow;  // declared in gsc_info_window.h
 
+class StorageDeviceBulkLoader;  // declared in storage_device_bulk_loader.h
+
 
 
 /// The main window.
@@ -74,6 +79,10 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		/// Read smartctl data from file, add it as a virtual drive to icon list
 		bool add_virtual_drive(const std::string& file);
 
+		/// Read smartctl data from files, directories or wildcard patterns, and add them
+		/// as virtual drives to icon list. Multiple files are loaded in background threads.
+		void add_virtual_drives(const std::vector<std::string>& sources);
+
 
 		/// If at least one drive is having a test performed, return true.
 		bool testing_active() const;
@@ -101,6 +110,10 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 			action_add_device,
 			action_load_virtual,
 			action_rescan_devices,
+			action_test_all_short,
+			action_test_all_long,
+			action_test_all_conveyance,
+			action_test_all_stop,
 
 			action_executor_log,
 			action_update_drivedb,
@@ -135,6 +148,14 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 		void show_load_virtual_file_chooser();
 
 
+		/// Run a self-test on the drives which support it, a limited number of drives
+		/// per controller at a time. The user chooses the drives from a list first.
+		void run_test_on_all_drives(SelfTest::TestType type);
+
+		/// Abort the tests started by run_test_on_all_drives()
+		void stop_test_on_all_drives();
+
+
 		/// Check smartctl version and set default parser format accordingly.
 		/// An error dialog is shown if there is an error with smartctl.
 		bool check_smartctl_version_and_set_format();
@@ -171,6 +192,17 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 
 	private:
 
+		/// Timeout callback which drives the tests started by run_test_on_all_drives()
+		static gboolean test_orchestrator_callback(void* data);
+
+		/// Schedule test_orchestrator_callback() for the next orchestrator tick, replacing the scheduled run (if any).
+		/// If all the tests are done, show the results instead.
+		void schedule_test_orchestrator_callback();
+
+		/// Show the results of the tests started by run_test_on_all_drives()
+		void show_test_orchestrator_results();
+
+
 		GscMainWindowIconView* iconview_ = nullptr;  ///< The main icon view
 		std::vector<StorageDevicePtr> drives_;  ///< Scanned drives
 
@@ -186,6 +218,11 @@ class GscMainWindow : public AppBuilderWidget<GscMainWindow, false> {
 
 		bool scanning_ = false;  ///< If the scanning is in process or not
 
+		std::unique_ptr<StorageDeviceBulkLoader> bulk_loader_;  ///< Loads multiple virtual drives in background
+
+		std::unique_ptr<SelfTestOrchestrator> test_orchestrator_;  ///< Tests started by run_test_on_all_drives()
+		guint test_orchestrator_source_id_ = 0;  ///< Scheduled test_orchestrator_callback() run, 0 if none
+
 };
 
 
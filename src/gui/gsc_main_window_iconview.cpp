@@ -254,11 +254,11 @@ void GscMainWindowIconView::decorate_entry(Gtk::TreeModel::Row& row)
 	if (rconfig::get_data<bool>("gui/icons_show_serial_number") && !drive->get_serial_number().empty()) {
 		name += "\n" + Glib::Markup::escape_text(drive->get_serial_number());
 	}
-	StorageProperty scan_time_prop;
+	const StorageProperty* scan_time_prop = nullptr;
 	if (drive->get_is_virtual()) {
-		scan_time_prop = drive->get_property_repository().lookup_property("local_time/asctime");
-		if (!scan_time_prop.empty() && !scan_time_prop.get_value<std::string>().empty()) {
-			name += "\n" + Glib::Markup::escape_text(scan_time_prop.get_value<std::string>());
+		scan_time_prop = drive->get_property_repository().find_property("local_time/asctime");
+		if (scan_time_prop && !scan_time_prop->get_value<std::string>().empty()) {
+			name += "\n" + Glib::Markup::escape_text(scan_time_prop->get_value<std::string>());
 		}
 	}
 
@@ -267,8 +267,8 @@ void GscMainWindowIconView::decorate_entry(Gtk::TreeModel::Row& row)
 	if (drive->get_is_virtual()) {
 		const std::string vfile = drive->get_virtual_filename();
 		tooltip_strs.push_back(Glib::ustring::compose(_("Loaded from: %1"), (vfile.empty() ? (Glib::ustring("[") + C_("name", "empty") + "]") : Glib::Markup::escape_text(vfile))));
-		if (!scan_time_prop.empty() && !scan_time_prop.get_value<std::string>().empty()) {
-			tooltip_strs.push_back(Glib::ustring::compose(_("Scanned on: "), Glib::Markup::escape_text(scan_time_prop.get_value<std::string>())));
+		if (scan_time_prop && !scan_time_prop->get_value<std::string>().empty()) {
+			tooltip_strs.push_back(Glib::ustring::compose(_("Scanned on: "), Glib::Markup::escape_text(scan_time_prop->get_value<std::string>())));
 		}
 	} else {
 		tooltip_strs.push_back(Glib::ustring::compose(_("Device: %1"), "<b>" + Glib::Markup::escape_text(drive->get_device_with_type()) + "</b>"));
@@ -281,8 +281,12 @@ void GscMainWindowIconView::decorate_entry(Gtk::TreeModel::Row& row)
 	if (!drive->get_serial_number().empty()) {
 		tooltip_strs.push_back(Glib::ustring::compose(_("Serial number: %1"), "<b>" + Glib::Markup::escape_text(drive->get_serial_number()) + "</b>"));
 	}
-	tooltip_strs.push_back(Glib::ustring::compose(_("SMART status: %1"),
-			"<b>" + Glib::Markup::escape_text(StorageDevice::get_status_displayable_name(drive->get_smart_status())) + "</b>"));
+	if (drive->get_is_in_standby() && drive->get_basic_output().empty()) {
+		tooltip_strs.push_back(_("The drive is in standby mode. View details to wake it up."));
+	} else {
+		tooltip_strs.push_back(Glib::ustring::compose(_("SMART status: %1"),
+				"<b>" + Glib::Markup::escape_text(StorageDevice::get_status_displayable_name(drive->get_smart_status())) + "</b>"));
+	}
 
 	std::string tooltip_str = hz::string_join(tooltip_strs, '\n');
 
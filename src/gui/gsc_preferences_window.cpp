@@ -21,6 +21,7 @@ Copyright:
 #include "hz/string_sprintf.h"
 #include "rconfig/rconfig.h"
 #include "applib/storage_settings.h"
+#include "applib/smartctl_log_support_cache.h"
 #include "applib/app_gtkmm_tools.h"
 #include "gsc_main_window.h"
 
@@ -382,6 +383,10 @@ void GscPreferencesWindow::import_config()
 	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("show_serial_number_under_icon_check"))
 		check->set_active(icons_show_serial_number);
 
+	bool skip_unsupported_logs = rconfig::get_data<bool>("system/skip_unsupported_logs");
+	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("skip_unsupported_logs_check"))
+		check->set_active(skip_unsupported_logs);
+
 	bool win32_search_smartctl_in_smartmontools = rconfig::get_data<bool>("system/win32_search_smartctl_in_smartmontools");
 	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("search_in_smartmontools_first_check"))
 		check->set_active(win32_search_smartctl_in_smartmontools);
@@ -427,6 +432,13 @@ void GscPreferencesWindow::export_config()
 	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("show_serial_number_under_icon_check"))
 		prefs_config_set("gui/icons_show_serial_number", bool(check->get_active()));
 
+	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("skip_unsupported_logs_check")) {
+		prefs_config_set("system/skip_unsupported_logs", bool(check->get_active()));
+		if (!check->get_active()) {
+			smartctl_log_support_cache_clear();  // probe all the logs again when re-enabled
+		}
+	}
+
 	if (auto* check = this->lookup_widget<Gtk::CheckButton*>("search_in_smartmontools_first_check"))
 		prefs_config_set("system/win32_search_smartctl_in_smartmontools", bool(check->get_active()));
 
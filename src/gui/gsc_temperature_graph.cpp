@@ -0,0 +1,288 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup gsc
+/// \weakgroup gsc
+/// @{
+
+#include <glibmm.h>
+#include <glibmm/i18n.h>
+#include <algorithm>  // std::min, std::max, std::clamp
+#include <chrono>
+#include <cmath>
+
+#include "hz/format_unit.h"  // format_time_length
+#include "hz/string_num.h"  // number_to_string_locale
+#include "gsc_temperature_graph.h"
+
+
+
+namespace {
+
+	/// Space around the plot area, for the labels
+	constexpr int margin_left = 44;
+	constexpr int margin_right = 12;
+	constexpr int margin_top = 8;
+	constexpr int margin_bottom = 24;
+
+	/// The smallest visible time range (seconds)
+	constexpr double min_view_span = 10. * 60.;
+
+	/// Zoom factor of one scroll step
+	constexpr double zoom_step = 1.25;
+
+
+	/// Format the time of a point relative to now
+	std::string format_point_age(double x)
+	{
+		const auto now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+		const auto age = std::chrono::seconds(static_cast<std::int64_t>(std::max(now - x, 0.)));
+		if (age < std::chrono::minutes(1)) {
+			return C_("time", "now");
+		}
+		return Glib::ustring::compose(C_("time", "%1 ago"), hz::format_time_length(age));
+	}
+
+}
+
+
+
+GscTemperatureGraph::GscTemperatureGraph()
+{
+	add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK | Gdk::BUTTON_PRESS_MASK
+			| Gdk::BUTTON_RELEASE_MASK | Gdk::BUTTON1_MOTION_MASK);
+	set_tooltip_text(_("Scroll to zoom, drag to move, double-click to show everything."));
+}
+
+
+
+void GscTemperatureGraph::set_data(std::vector<SeriesPoint> points)
+{
+	data_ = SeriesDownsampler(std::move(points));
+
+	const auto x_range = data_.get_x_range();
+	full_from_ = x_range.has_value() ? x_range->first : 0.;
+	full_to_ = x_range.has_value() ? x_range->second : 0.;
+	if (full_to_ - full_from_ < min_view_span) {
+		const double center = (full_from_ + full_to_) / 2.;
+		full_from_ = center - min_view_span / 2.;
+		full_to_ = center + min_view_span / 2.;
+	}
+
+	reset_view();
+}
+
+
+
+void GscTemperatureGraph::set_limit(std::optional<double> limit)
+{
+	limit_ = limit;
+	queue_draw();
+}
+
+
+
+bool GscTemperatureGraph::has_data() const
+{
+	return !data_.empty();
+}
+
+
+
+bool GscTemperatureGraph::on_draw(const Cairo::RefPtr<Cairo::Context>& cr)
+{
+	const int plot_w = get_plot_width();
+	const int plot_h = get_allocation().get_height() - margin_top - margin_bottom;
+	if (data_.empty() || plot_w < 10 || plot_h < 10) {
+		return true;
+	}
+
+	// Use the theme foreground color, so that the graph is visible in both light and dark themes.
+	const auto style_context = get_style_context();
+	const Gdk::RGBA fg_color = style_context->get_color(style_context->get_state());
+	auto set_fg_color = [&](double alpha) {
+		cr->set_source_rgba(fg_color.get_red(), fg_color.get_green(), fg_color.get_blue(), fg_color.get_alpha() * alpha);
+	};
+
+	// Vertical scale, rounded to 10 degrees
+	const auto y_range = data_.get_y_range(view_from_, view_to_).value_or(data_.get_y_range(full_from_, full_to_).value());
+	const double y_min = std::floor(y_range.first / 10.) * 10.;
+	const double y_max = std::max(std::ceil(y_range.second / 10.) * 10., y_min + 10.);
+
+	auto to_px_x = [&](double x) {
+		return margin_left + (x - view_from_) / (view_to_ - view_from_) * plot_w;
+	};
+	auto to_px_y = [&](double y) {
+		return margin_top + plot_h - (y - y_min) / (y_max - y_min) * plot_h;
+	};
+
+	// Horizontal grid and temperature labels
+	const double grid_step = (y_max - y_min > 60. ? 20. : (y_max - y_min > 20. ? 10. : 5.));
+	cr->set_line_width(1.);
+	for (double y = y_min; y <= y_max; y += grid_step) {
+		const double py = std::round(to_px_y(y)) + 0.5;
+		set_fg_color(0.15);
+		cr->move_to(margin_left, py);
+		cr->line_to(margin_left + plot_w, py);
+		cr->stroke();
+
+		const auto layout = create_pango_layout(Glib::ustring::compose(C_("temperature", "%1° C"), hz::number_to_string_locale(static_cast<int>(y))));
+		int layout_w = 0, layout_h = 0;
+		layout->get_pixel_size(layout_w, layout_h);
+		set_fg_color(1.);
+		cr->move_to(margin_left - 4 - layout_w, py - layout_h / 2.);
+		layout->show_in_cairo_context(cr);
+	}
+
+	// Time labels
+	for (int i = 0; i <= 2; ++i) {
+		const double x = view_from_ + (view_to_ - view_from_) * i / 2.;
+		const auto layout = create_pango_layout(format_point_age(x));
+		int layout_w = 0, layout_h = 0;
+		layout->get_pixel_size(layout_w, layout_h);
+		const double px = std::max(double(margin_left), std::min(to_px_x(x) - layout_w / 2., double(margin_left + plot_w - layout_w)));
+		set_fg_color(1.);
+		cr->move_to(px, margin_top + plot_h + 4);
+		layout->show_in_cairo_context(cr);
+	}
+
+	cr->save();
+	cr->rectangle(margin_left, margin_top, plot_w, plot_h);
+	cr->clip();
+
+	// Range of values in each pixel column, visible when there are many samples per pixel
+	const auto envelope = data_.get_envelope(view_from_, view_to_, static_cast<std::size_t>(plot_w));
+	set_fg_color(0.25);
+	for (std::size_t column = 0; column < envelope.size(); ++column) {
+		if (envelope[column].has_value()) {
+			const double top = to_px_y(envelope[column]->second);
+			cr->rectangle(margin_left + double(column), top, 1., std::max(to_px_y(envelope[column]->first) - top, 1.));
+		}
+	}
+	cr->fill();
+
+	// The line itself
+	const auto line = data_.get_line(view_from_, view_to_, static_cast<std::size_t>(plot_w));
+	set_fg_color(1.);
+	cr->set_line_width(1.5);
+	for (std::size_t i = 0; i < line.size(); ++i) {
+		if (i == 0) {
+			cr->move_to(to_px_x(line[i].x), to_px_y(line[i].y));
+		} else {
+			cr->line_to(to_px_x(line[i].x), to_px_y(line[i].y));
+		}
+	}
+	cr->stroke();
+
+	if (limit_.has_value() && limit_.value() >= y_min && limit_.value() <= y_max) {
+		cr->set_source_rgba(0.85, 0.1, 0.1, 0.8);
+		cr->set_line_width(1.);
+		cr->set_dash(std::vector<double> {4., 3.}, 0.);
+		const double py = std::round(to_px_y(limit_.value())) + 0.5;
+		cr->move_to(margin_left, py);
+		cr->line_to(margin_left + plot_w, py);
+		cr->stroke();
+	}
+
+	cr->restore();
+
+	return true;
+}
+
+
+
+bool GscTemperatureGraph::on_scroll_event(GdkEventScroll* scroll_event)
+{
+	double factor = 1.;
+	if (scroll_event->direction == GDK_SCROLL_UP) {
+		factor = 1. / zoom_step;
+	} else if (scroll_event->direction == GDK_SCROLL_DOWN) {
+		factor = zoom_step;
+	} else if (scroll_event->direction == GDK_SCROLL_SMOOTH && scroll_event->delta_y != 0.) {
+		factor = std::pow(zoom_step, scroll_event->delta_y);
+	} else {
+		return false;
+	}
+
+	// Zoom around the pointer
+	const int plot_w = get_plot_width();
+	const double pos = (plot_w > 0 ? std::clamp((scroll_event->x - margin_left) / plot_w, 0., 1.) : 0.5);
+	const double anchor = view_from_ + (view_to_ - view_from_) * pos;
+	const double span = std::max((view_to_ - view_from_) * factor, min_view_span);
+	set_view(anchor - span * pos, anchor + span * (1. - pos));
+	return true;
+}
+
+
+
+bool GscTemperatureGraph::on_button_press_event(GdkEventButton* button_event)
+{
+	if (button_event->button != 1) {
+		return false;
+	}
+	if (button_event->type == GDK_2BUTTON_PRESS) {
+		drag_start_x_.reset();
+		reset_view();
+		return true;
+	}
+	drag_start_x_ = button_event->x;
+	drag_view_from_ = view_from_;
+	return true;
+}
+
+
+
+bool GscTemperatureGraph::on_button_release_event(GdkEventButton* button_event)
+{
+	if (button_event->button != 1) {
+		return false;
+	}
+	drag_start_x_.reset();
+	return true;
+}
+
+
+
+bool GscTemperatureGraph::on_motion_notify_event(GdkEventMotion* motion_event)
+{
+	const int plot_w = get_plot_width();
+	if (!drag_start_x_.has_value() || plot_w <= 0) {
+		return false;
+	}
+	const double span = view_to_ - view_from_;
+	const double from = drag_view_from_ - (motion_event->x - drag_start_x_.value()) / plot_w * span;
+	set_view(from, from + span);
+	return true;
+}
+
+
+
+void GscTemperatureGraph::reset_view()
+{
+	set_view(full_from_, full_to_);
+}
+
+
+
+void GscTemperatureGraph::set_view(double view_from, double view_to)
+{
+	const double span = std::min(view_to - view_from, full_to_ - full_from_);
+	view_from_ = std::clamp(view_from, full_from_, full_to_ - span);
+	view_to_ = view_from_ + span;
+	queue_draw();
+}
+
+
+
+int GscTemperatureGraph::get_plot_width() const
+{
+	return get_allocation().get_width() - margin_left - margin_right;
+}
+
+
+
+/// @}
@@ -0,0 +1,95 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup gsc
+/// \weakgroup gsc
+/// @{
+
+#ifndef GSC_TEMPERATURE_GRAPH_H
+#define GSC_TEMPERATURE_GRAPH_H
+
+#include <gtkmm.h>
+#include <cairomm/cairomm.h>
+#include <optional>
+#include <vector>
+
+#include "applib/series_downsampler.h"
+
+
+
+/// Temperature history graph.
+/// The data is downsampled to the widget width on each draw, so drawing and zooming
+/// stay fast with millions of samples.
+/// Scroll to zoom, drag to pan, double-click to show everything.
+class GscTemperatureGraph : public Gtk::DrawingArea {
+	public:
+
+		/// Constructor
+		GscTemperatureGraph();
+
+
+		/// Set the data and show all of it.
+		/// \param points Time (seconds since epoch) and temperature (C), sorted by time.
+		void set_data(std::vector<SeriesPoint> points);
+
+
+		/// Set the maximum recommended temperature, shown as a line
+		void set_limit(std::optional<double> limit);
+
+
+		/// Check if there is any data to show
+		[[nodiscard]] bool has_data() const;
+
+
+	protected:
+
+		// Overridden from Gtk::Widget
+		bool on_draw(const Cairo::RefPtr<Cairo::Context>& cr) override;
+
+		// Overridden from Gtk::Widget
+		bool on_scroll_event(GdkEventScroll* scroll_event) override;
+
+		// Overridden from Gtk::Widget
+		bool on_button_press_event(GdkEventButton* button_event) override;
+
+		// Overridden from Gtk::Widget
+		bool on_button_release_event(GdkEventButton* button_event) override;
+
+		// Overridden from Gtk::Widget
+		bool on_motion_notify_event(GdkEventMotion* motion_event) override;
+
+
+	private:
+
+		/// Show all the data
+		void reset_view();
+
+		/// Set the visible time range, keeping it inside the data
+		void set_view(double view_from, double view_to);
+
+		/// Get the width of the plot area
+		[[nodiscard]] int get_plot_width() const;
+
+
+		SeriesDownsampler data_;  ///< Temperature data
+		std::optional<double> limit_;  ///< Maximum recommended temperature
+
+		double full_from_ = 0.;  ///< Start of the time range of all data
+		double full_to_ = 0.;  ///< End of the time range of all data
+		double view_from_ = 0.;  ///< Start of the visible time range
+		double view_to_ = 0.;  ///< End of the visible time range
+
+		std::optional<double> drag_start_x_;  ///< Pointer position where dragging started
+		double drag_view_from_ = 0.;  ///< view_from_ when dragging started
+
+};
+
+
+
+#endif
+
+/// @}
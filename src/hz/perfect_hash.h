@@ -0,0 +1,239 @@
+/******************************************************************************
+License: Zlib
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup hz
+/// \weakgroup hz
+/// @{
+
+#ifndef HZ_PERFECT_HASH_H
+#define HZ_PERFECT_HASH_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+
+
+namespace hz {
+
+
+
+/// Constexpr 64-bit FNV-1a hash of a string. If \c fold_case is true, ASCII letters
+/// are hashed as lowercase, so that strings differing only in case have the same hash.
+/// \c hash can be used to chain several values into one hash.
+constexpr std::uint64_t string_hash_fnv1a(std::string_view s, bool fold_case = false,
+		std::uint64_t hash = 14695981039346656037ULL)
+{
+	for (char c : s) {
+		if (fold_case && c >= 'A' && c <= 'Z') {
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+
+/// Constexpr 64-bit FNV-1a hash of an integer, chained to \c hash.
+constexpr std::uint64_t integer_hash_fnv1a(std::uint64_t value, std::uint64_t hash = 14695981039346656037ULL)
+{
+	for (int i = 0; i < 8; ++i) {
+		hash ^= (value >> (i * 8)) & 0xff;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+
+/// Check if two strings are equal, ignoring the case of ASCII letters. Constexpr and doesn't allocate.
+constexpr bool string_equal_ascii_nocase(std::string_view a, std::string_view b)
+{
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (std::size_t i = 0; i < a.size(); ++i) {
+		char ca = a[i], cb = b[i];
+		if (ca >= 'A' && ca <= 'Z') {
+			ca = static_cast<char>(ca - 'A' + 'a');
+		}
+		if (cb >= 'A' && cb <= 'Z') {
+			cb = static_cast<char>(cb - 'A' + 'a');
+		}
+		if (ca != cb) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+
+/// A perfect hash table mapping up to MaxKeys distinct 64-bit key hashes to values,
+/// built at compile time using the "hash, displace and compress" method: keys are
+/// distributed into small buckets, and each bucket gets a displacement which maps
+/// all its keys to free slots.
+/// A lookup is a bucket read and a slot read, without probing and without allocation.
+/// Only the key hashes are stored, so the caller has to verify the key of the found value.
+template<std::size_t MaxKeys>
+class PerfectHashIndex {
+	public:
+
+		/// Number of slots
+		static constexpr std::size_t table_size = std::bit_ceil(MaxKeys + MaxKeys / 2 + 1);
+
+		/// Number of buckets (about 4 keys per bucket)
+		static constexpr std::size_t num_buckets = MaxKeys / 4 + 1;
+
+
+		/// Add a key hash with its value. Must be called before build().
+		/// Throws std::length_error if there are too many keys (a compile error in constant evaluation).
+		constexpr void insert(std::uint64_t key_hash, std::uint32_t value)
+		{
+			if (size_ >= MaxKeys) {
+				throw std::length_error("PerfectHashIndex: Too many keys.");
+			}
+			hashes_[size_] = key_hash;
+			values_[size_] = value;
+			++size_;
+		}
+
+
+		/// Build the index. Throws std::invalid_argument if the keys are not distinct
+		/// (a compile error in constant evaluation).
+		constexpr void build()
+		{
+			std::array<std::size_t, num_buckets> bucket_sizes {};
+			for (std::size_t i = 0; i < size_; ++i) {
+				++bucket_sizes[get_bucket(hashes_[i])];
+			}
+			std::size_t max_bucket_size = 0;
+			for (auto bucket_size : bucket_sizes) {
+				max_bucket_size = std::max(max_bucket_size, bucket_size);
+			}
+
+			slots_.fill(empty_slot);
+
+			// Place the largest buckets first, while there are many free slots
+			std::array<std::size_t, MaxKeys> bucket_keys {};
+			for (std::size_t bucket_size = max_bucket_size; bucket_size > 0; --bucket_size) {
+				for (std::size_t bucket = 0; bucket < num_buckets; ++bucket) {
+					if (bucket_sizes[bucket] != bucket_size) {
+						continue;
+					}
+					std::size_t num_keys = 0;
+					for (std::size_t i = 0; i < size_; ++i) {
+						if (get_bucket(hashes_[i]) == bucket) {
+							bucket_keys[num_keys++] = i;
+						}
+					}
+					// Equal hashes end up in the same bucket
+					for (std::size_t k = 0; k < num_keys; ++k) {
+						for (std::size_t prev = 0; prev < k; ++prev) {
+							if (hashes_[bucket_keys[k]] == hashes_[bucket_keys[prev]]) {
+								throw std::invalid_argument("PerfectHashIndex: Duplicate key hash.");
+							}
+						}
+					}
+					displacements_[bucket] = find_displacement(bucket_keys, num_keys);
+					for (std::size_t k = 0; k < num_keys; ++k) {
+						slots_[get_slot(hashes_[bucket_keys[k]], displacements_[bucket])] = static_cast<std::uint32_t>(bucket_keys[k]);
+					}
+				}
+			}
+		}
+
+
+		/// Find the value of a key hash.
+		/// \return std::nullopt if the hash is not in the index.
+		[[nodiscard]] constexpr std::optional<std::uint32_t> find(std::uint64_t key_hash) const
+		{
+			const std::uint32_t pos = slots_[get_slot(key_hash, displacements_[get_bucket(key_hash)])];
+			if (pos == empty_slot || hashes_[pos] != key_hash) {
+				return std::nullopt;
+			}
+			return values_[pos];
+		}
+
+
+		/// Get the number of keys
+		[[nodiscard]] constexpr std::size_t size() const
+		{
+			return size_;
+		}
+
+
+	private:
+
+		/// Marks an unused slot
+		static constexpr std::uint32_t empty_slot = 0xffffffff;
+
+
+		/// Get the bucket of a key hash
+		static constexpr std::size_t get_bucket(std::uint64_t key_hash)
+		{
+			return static_cast<std::size_t>((key_hash >> 32) % num_buckets);
+		}
+
+
+		/// Get the slot of a key hash, displaced by \c displacement
+		static constexpr std::size_t get_slot(std::uint64_t key_hash, std::uint32_t displacement)
+		{
+			// splitmix64 finalizer
+			std::uint64_t x = key_hash + 0x9e3779b97f4a7c15ULL * (displacement + 1ULL);
+			x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+			return static_cast<std::size_t>(x & (table_size - 1));
+		}
+
+
+		/// Find a displacement which maps all the keys of a bucket to different free slots
+		constexpr std::uint32_t find_displacement(const std::array<std::size_t, MaxKeys>& bucket_keys, std::size_t num_keys) const
+		{
+			for (std::uint32_t displacement = 0; displacement < 1'000'000; ++displacement) {
+				bool fits = true;
+				for (std::size_t k = 0; k < num_keys && fits; ++k) {
+					const std::size_t slot = get_slot(hashes_[bucket_keys[k]], displacement);
+					fits = (slots_[slot] == empty_slot);
+					for (std::size_t prev = 0; prev < k && fits; ++prev) {
+						fits = (get_slot(hashes_[bucket_keys[prev]], displacement) != slot);
+					}
+				}
+				if (fits) {
+					return displacement;
+				}
+			}
+			throw std::logic_error("PerfectHashIndex: Cannot place a bucket.");
+		}
+
+
+		std::array<std::uint64_t, MaxKeys> hashes_ {};  ///< Key hashes
+		std::array<std::uint32_t, MaxKeys> values_ {};  ///< Values, by key position
+		std::size_t size_ = 0;  ///< Number of keys
+
+		std::array<std::uint32_t, num_buckets> displacements_ {};  ///< Displacement of each bucket
+		std::array<std::uint32_t, table_size> slots_ {};  ///< Key position for each slot, or empty_slot
+
+};
+
+
+
+}  // ns
+
+
+
+#endif
+
+/// @}
@@ -14,6 +14,7 @@ Copyright:
 
 #include <string>
 #include <cctype>  // std::tolower, std::toupper
+#include <cstdint>  // std::uint32_t
 #include <string_view>
 
 
@@ -956,6 +957,71 @@ inline int string_natural_compare(std::string_view a, std::string_view b)
 }
 
 
+
+/// Get a key for natural sort order, so that comparing the keys of two strings with
+/// the < operator gives the same order as string_natural_compare(). Useful when
+/// the same strings are compared many times (e.g. sorting).
+/// Numbers which differ only in leading zeros are ordered by the number of zeros, after
+/// everything else ("pd1" < "pd01" < "pd001" < "pd2"), so that different strings never have equal keys.
+/// The key is terminated, so the keys of several strings can be concatenated to sort
+/// by several fields.
+inline std::string string_natural_sort_key(std::string_view s)
+{
+	// Field terminator sorts before everything, so that shorter strings come first.
+	// Number marker sorts before any character, so that digits come before non-digits.
+	// Characters which clash with these are escaped, preserving their order.
+	constexpr char terminator = '\x00', number_marker = '\x01', escape = '\x02';
+
+	std::string key;
+	key.reserve(s.size() + 8);
+
+	// Leading zero counts of the numbers (big-endian), appended after the rest of the key as a tie-breaker.
+	// Equal keys without them have the same number of numbers, so this part has a fixed size.
+	std::string zero_counts;
+
+	std::size_t i = 0;
+	while (i < s.size()) {
+		if (std::isdigit(static_cast<unsigned char>(s[i]))) {
+			const std::size_t zero_start = i;
+			while (i < s.size() && s[i] == '0') {
+				++i;
+			}
+			const auto zero_count = static_cast<std::uint32_t>(i - zero_start);
+			for (int shift = 24; shift >= 0; shift -= 8) {
+				zero_counts += static_cast<char>((zero_count >> shift) & 0xff);
+			}
+			const std::size_t digit_start = i;
+			while (i < s.size() && std::isdigit(static_cast<unsigned char>(s[i]))) {
+				++i;
+			}
+			// Longer number is greater, so store the number of digits (big-endian) before the digits.
+			const auto digit_count = static_cast<std::uint32_t>(i - digit_start);
+			key += number_marker;
+			for (int shift = 24; shift >= 0; shift -= 8) {
+				key += static_cast<char>((digit_count >> shift) & 0xff);
+			}
+			key.append(s.substr(digit_start, i - digit_start));
+
+		} else {
+			if (static_cast<unsigned char>(s[i]) <= static_cast<unsigned char>(escape)) {
+				key += escape;
+				key += static_cast<char>(s[i] + 1);
+			} else {
+				key += s[i];
+			}
+			++i;
+		}
+	}
+	key += terminator;
+	if (!zero_counts.empty()) {
+		key += zero_counts;
+		key += terminator;
+	}
+
+	return key;
+}
+
+
 }  // ns
 
 
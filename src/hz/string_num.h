@@ -13,6 +13,9 @@ Copyright:
 #define HZ_STRING_NUM_H
 
 #include <string>
+#include <string_view>
+#include <charconv>  // std::from_chars
+#include <system_error>  // std::errc
 #include <sstream>
 #include <iomanip>  // setbase, setprecision, setw
 #include <ios>  // std::fixed, std::internal
@@ -22,6 +25,7 @@ Copyright:
 #include <exception>
 #include <type_traits>
 #include <algorithm>
+#include <cctype>  // std::isxdigit, std::tolower
 
 #include "locale_tools.h"
 
@@ -205,13 +209,271 @@ namespace internal {
 
 
 
-	// Version for integral / floating point types
+	/// isspace() in classic locale
+	constexpr bool char_is_space_classic(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+	}
+
+
+
+	/// Check whether T is parsed through std::stoi() in string_is_numeric_impl_global_locale().
+	template<typename T>
+	constexpr bool string_is_numeric_parses_as_int_v = std::is_same_v<T, char>
+			|| std::is_same_v<T, unsigned char>
+			|| std::is_same_v<T, signed char>
+			|| std::is_same_v<T, wchar_t>
+			|| std::is_same_v<T, char16_t>
+			|| std::is_same_v<T, char32_t>
+			|| std::is_same_v<T, short>
+			|| std::is_same_v<T, int>;
+
+
+
+	/// Version for integral types, same semantics as string_is_numeric_impl_global_locale()
+	/// in classic locale (leading space skipping, "+" / "-" signs, base autodetection,
+	/// "0x" prefix), but without changing the global locale or throwing exceptions.
+	template<typename T>
+	bool string_is_numeric_impl_from_chars_integral(const std::string& s, T& number, bool strict, int base)
+	{
+		if (s.empty() || (strict && char_is_space_classic(s[0])))  // sto* functions skip leading space
+			return false;
+
+		const char* const end = s.data() + s.size();
+		const char* pos = s.data();
+		while (pos != end && char_is_space_classic(*pos)) {
+			++pos;
+		}
+
+		bool negative = false;
+		if (pos != end && (*pos == '-' || *pos == '+')) {
+			negative = (*pos == '-');
+			++pos;
+		}
+
+		// strto* skip the "0x" prefix only if a hex digit follows it.
+		if ((base == 0 || base == 16) && end - pos > 2 && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X')
+				&& std::isxdigit(static_cast<unsigned char>(pos[2])) != 0) {
+			base = 16;
+			pos += 2;
+		} else if (base == 0) {
+			base = (pos != end && *pos == '0') ? 8 : 10;
+		}
+		if (base < 2 || base > 36) {
+			return false;  // std::invalid_argument in sto*
+		}
+
+		unsigned long long magnitude = 0;
+		const auto [ptr, ec] = std::from_chars(pos, end, magnitude, base);
+		if (ec != std::errc()) {
+			return false;  // no digits, or out of range
+		}
+
+		if constexpr(std::is_signed_v<T> || string_is_numeric_parses_as_int_v<T>) {
+			// Signed range check, in the type sto* would use.
+			using Checked = std::conditional_t<string_is_numeric_parses_as_int_v<T>, int, T>;
+			const auto max_magnitude = static_cast<unsigned long long>(std::numeric_limits<Checked>::max()) + (negative ? 1ULL : 0ULL);
+			if (magnitude > max_magnitude) {
+				return false;  // out of range
+			}
+			const auto value = static_cast<Checked>(negative ? (0ULL - magnitude) : magnitude);
+			if (value != static_cast<T>(value)) {
+				return false;  // out of range for smaller type
+			}
+			if (strict && ptr != end) {
+				return false;  // not everything was parsed
+			}
+			number = static_cast<T>(value);
+
+		} else {
+			if (negative) {
+				return false;  // "out of range" for unsigned
+			}
+			using Checked = std::conditional_t<(sizeof(T) <= sizeof(unsigned long)), unsigned long, unsigned long long>;
+			if (magnitude > std::numeric_limits<Checked>::max() || magnitude != static_cast<T>(magnitude)) {
+				return false;  // out of range
+			}
+			if (strict && ptr != end) {
+				return false;  // not everything was parsed
+			}
+			number = static_cast<T>(magnitude);
+		}
+
+		// Non-strict always parses at least one digit here.
+		return true;
+	}
+
+
+
+#if defined __cpp_lib_to_chars
+
+	/// Version for floating point types, same semantics as string_is_numeric_impl_global_locale()
+	/// in classic locale (leading space skipping, "+" / "-" signs, inf / nan, hex floats),
+	/// but without changing the global locale or throwing exceptions.
+	template<typename T>
+	bool string_is_numeric_impl_from_chars_floating(const std::string& s, T& number, bool strict)
+	{
+		if (s.empty() || (strict && char_is_space_classic(s[0])))  // sto* functions skip leading space
+			return false;
+
+		const char* const end = s.data() + s.size();
+		const char* pos = s.data();
+		while (pos != end && char_is_space_classic(*pos)) {
+			++pos;
+		}
+
+		bool negative = false;
+		if (pos != end && (*pos == '-' || *pos == '+')) {
+			negative = (*pos == '-');
+			++pos;
+		}
+		if (pos != end && (*pos == '-' || *pos == '+')) {
+			return false;  // from_chars() would accept the second "-"
+		}
+
+		T value = T();
+		std::from_chars_result result = {pos, std::errc::invalid_argument};
+
+		// strtod() supports hex floats with "0x" prefix
+		if (end - pos > 2 && pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X')) {
+			result = std::from_chars(pos + 2, end, value, std::chars_format::hex);
+		}
+		if (result.ec == std::errc::invalid_argument) {  // not hex, or just "0" followed by "x"
+			result = std::from_chars(pos, end, value, std::chars_format::general);
+		}
+		if (result.ec != std::errc()) {
+			return false;  // no number, or out of range
+		}
+		if (strict && result.ptr != end) {
+			return false;  // not everything was parsed
+		}
+
+		// Non-strict always parses at least one digit here.
+		number = negative ? -value : value;
+		return true;
+	}
+
+#else
+
+	/// Version for floating point types for standard libraries without floating-point
+	/// from_chars(). Parses using a stream imbued with classic locale, so it doesn't
+	/// change the global locale. Hex floats are not supported here.
+	template<typename T>
+	bool string_is_numeric_impl_stream_floating(const std::string& s, T& number, bool strict)
+	{
+		if (s.empty() || (strict && char_is_space_classic(s[0])))  // sto* functions skip leading space
+			return false;
+
+		std::size_t pos = 0;
+		while (pos < s.size() && char_is_space_classic(s[pos])) {
+			++pos;
+		}
+		bool negative = false;
+		if (pos < s.size() && (s[pos] == '-' || s[pos] == '+')) {
+			negative = (s[pos] == '-');
+			++pos;
+		}
+
+		// Streams don't parse inf / nan, handle them the way strtod() does.
+		auto starts_with_nocase = [&s, pos](std::string_view word) {
+			if (s.size() - pos < word.size())
+				return false;
+			for (std::size_t i = 0; i < word.size(); ++i) {
+				if (std::tolower(static_cast<unsigned char>(s[pos + i])) != word[i])
+					return false;
+			}
+			return true;
+		};
+		std::size_t special_size = 0;
+		T special_value = T();
+		if (starts_with_nocase("infinity")) {
+			special_size = 8;
+			special_value = std::numeric_limits<T>::infinity();
+		} else if (starts_with_nocase("inf")) {
+			special_size = 3;
+			special_value = std::numeric_limits<T>::infinity();
+		} else if (starts_with_nocase("nan")) {
+			special_size = 3;
+			special_value = std::numeric_limits<T>::quiet_NaN();
+			if (const std::size_t close = s.find(')', pos + 3); pos + 3 < s.size() && s[pos + 3] == '(' && close != std::string::npos) {
+				special_size = close - pos + 1;  // "nan(chars)"
+			}
+		}
+		if (special_size != 0) {
+			if (strict && pos + special_size != s.size()) {
+				return false;  // not everything was parsed
+			}
+			number = negative ? -special_value : special_value;
+			return true;
+		}
+		// Find the number the way strtod() does, streams consume a dangling exponent ("1e").
+		auto is_digit = [&s](std::size_t p) { return p < s.size() && s[p] >= '0' && s[p] <= '9'; };
+		std::size_t num_end = pos;
+		while (is_digit(num_end)) {
+			++num_end;
+		}
+		const bool has_int_digits = (num_end != pos);
+		if (num_end < s.size() && s[num_end] == '.') {
+			++num_end;
+			while (is_digit(num_end)) {
+				++num_end;
+			}
+		}
+		if (!has_int_digits && num_end - pos < 2) {
+			return false;  // no digits
+		}
+		if (num_end < s.size() && (s[num_end] == 'e' || s[num_end] == 'E')) {
+			std::size_t exp_end = num_end + 1;
+			if (exp_end < s.size() && (s[exp_end] == '-' || s[exp_end] == '+')) {
+				++exp_end;
+			}
+			if (is_digit(exp_end)) {
+				while (is_digit(exp_end)) {
+					++exp_end;
+				}
+				num_end = exp_end;
+			}
+		}
+		if (strict && num_end != s.size()) {
+			return false;  // not everything was parsed
+		}
+
+		std::istringstream iss(s.substr(pos, num_end - pos));
+		iss.imbue(std::locale::classic());
+
+		T value = T();
+		iss >> value;
+		if (iss.fail()) {
+			return false;  // out of range
+		}
+		if (value == T() && s.find_first_of("123456789", pos) < std::min(s.find_first_of("eE", pos), num_end)) {
+			return false;  // underflow, out of range for strtod()
+		}
+
+		number = negative ? -value : value;
+		return true;
+	}
+
+#endif
+
+
+
+	/// Version for integral / floating point types.
+	/// This does not depend on the global locale and is thread-safe.
 	template<typename T>
 	bool string_is_numeric_impl_classic_locale(const std::string& s, T& number, bool strict,  [[maybe_unused]] int base)
 	{
-		// TODO port to std::from_chars().
-		ScopedCLocale loc;
-		return string_is_numeric_impl_global_locale(s, number, strict, base, std::locale::classic());
+		static_assert(std::is_arithmetic_v<T>, "Type T not convertible to a number");
+
+		if constexpr(std::is_integral_v<T>) {
+			return string_is_numeric_impl_from_chars_integral(s, number, strict, base);
+		} else {
+#if defined __cpp_lib_to_chars
+			return string_is_numeric_impl_from_chars_floating(s, number, strict);
+#else
+			return string_is_numeric_impl_stream_floating(s, number, strict);
+#endif
+		}
 	}
 
 
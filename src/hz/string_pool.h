@@ -0,0 +1,168 @@
+/******************************************************************************
+License: Zlib
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup hz
+/// \weakgroup hz
+/// @{
+
+#ifndef HZ_STRING_POOL_H
+#define HZ_STRING_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+
+
+namespace hz {
+
+
+
+namespace internal {
+
+	/// Process-wide pool of interned strings. The strings are reference-counted,
+	/// and are removed from the pool when the last reference is gone.
+	class StringPool {
+		public:
+
+			/// Get the pool instance. It's never destroyed, so that strings in other
+			/// static objects can be released at exit in any order.
+			static StringPool& instance()
+			{
+				static auto* pool = new StringPool();
+				return *pool;
+			}
+
+
+			/// Get a shared string with the same contents as \c s
+			std::shared_ptr<const std::string> intern(std::string_view s)
+			{
+				std::shared_ptr<const std::string> found;
+				{
+					const std::scoped_lock lock(mutex_);
+					if (auto iter = strings_.find(s); iter != strings_.end()) {
+						found = iter->second.second.lock();
+					}
+					if (!found) {
+						// Note: The old entry (if any) is being destroyed in another thread, replace it.
+						// Its deleter checks the pointer, so it won't remove the new entry.
+						strings_.erase(s);
+						found = std::shared_ptr<const std::string>(new std::string(s), [](const std::string* str) {
+							StringPool::instance().remove(str);
+						});
+						strings_.emplace(std::string_view(*found), std::make_pair(found.get(), std::weak_ptr<const std::string>(found)));
+					}
+				}
+				return found;  // if this is the last reference (impossible here), it's released outside the lock.
+			}
+
+
+			/// Get the number of strings in the pool
+			std::size_t size() const
+			{
+				const std::scoped_lock lock(mutex_);
+				return strings_.size();
+			}
+
+
+		private:
+
+			/// Remove a string from the pool and delete it. Called when the last reference is gone.
+			void remove(const std::string* str)
+			{
+				{
+					const std::scoped_lock lock(mutex_);
+					if (auto iter = strings_.find(std::string_view(*str)); iter != strings_.end() && iter->second.first == str) {
+						strings_.erase(iter);
+					}
+				}
+				delete str;
+			}
+
+
+			mutable std::mutex mutex_;  ///< Protects strings_
+
+			/// Key points to the value's string. The raw pointer identifies the entry, since the weak pointer may be expired.
+			std::unordered_map<std::string_view, std::pair<const std::string*, std::weak_ptr<const std::string>>> strings_;
+
+	};
+
+}
+
+
+
+/// An immutable string whose contents are shared between all SharedString objects
+/// with the same contents (interned). Use for strings which are frequently
+/// duplicated, e.g. descriptions of properties of identical drives.
+/// Copying is cheap. Construction from a non-empty string takes a lock, so it's thread-safe.
+class SharedString {
+	public:
+
+		/// Constructor, creates an empty string
+		SharedString() = default;
+
+		/// Constructor
+		explicit SharedString(std::string_view s)
+				: data_(s.empty() ? nullptr : internal::StringPool::instance().intern(s))
+		{ }
+
+
+		/// Get the string
+		[[nodiscard]] const std::string& str() const
+		{
+			static const std::string empty_string;
+			return data_ ? *data_ : empty_string;
+		}
+
+
+		/// Implicit conversion to std::string
+		operator const std::string& () const
+		{
+			return str();
+		}
+
+
+		/// Check if the string is empty
+		[[nodiscard]] bool empty() const
+		{
+			return !data_;
+		}
+
+
+		/// Compare contents. Since the strings are interned, this compares the pointers only.
+		bool operator==(const SharedString& other) const
+		{
+			return data_ == other.data_;
+		}
+
+
+		/// Get the number of unique strings in the process-wide pool
+		[[nodiscard]] static std::size_t get_pool_size()
+		{
+			return internal::StringPool::instance().size();
+		}
+
+
+	private:
+
+		std::shared_ptr<const std::string> data_;  ///< String data, nullptr if empty
+
+};
+
+
+
+}  // ns
+
+
+
+#endif
+
+/// @}
@@ -0,0 +1,118 @@
+/******************************************************************************
+License: BSD Zero Clause License
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup hz_tests
+/// \weakgroup hz_tests
+/// @{
+
+#include "catch2/catch.hpp"
+
+// disable libdebug, we don't link to it
+#undef HZ_USE_LIBDEBUG
+#define HZ_USE_LIBDEBUG 0
+// enable libdebug emulation through std::cerr
+#undef HZ_EMULATE_LIBDEBUG
+#define HZ_EMULATE_LIBDEBUG 1
+
+// The first header should be then one we're testing, to avoid missing
+// header pitfalls.
+#include "hz/perfect_hash.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+
+
+namespace {
+
+	/// Get the hash of (name, number) key
+	constexpr std::uint64_t get_key_hash(std::string_view name, std::uint64_t number)
+	{
+		return hz::integer_hash_fnv1a(number, hz::string_hash_fnv1a(name, true));
+	}
+
+
+	/// Build an index of ("key", 0) ... ("key", N-1) at compile time
+	template<std::size_t N>
+	constexpr hz::PerfectHashIndex<N> create_index()
+	{
+		hz::PerfectHashIndex<N> index;
+		for (std::uint32_t i = 0; i < N; ++i) {
+			index.insert(get_key_hash("key", i), i);
+		}
+		index.build();
+		return index;
+	}
+
+	constexpr auto small_index = create_index<10>();
+	static_assert(small_index.size() == 10);
+	static_assert(small_index.find(get_key_hash("KEY", 3)).value() == 3);
+	static_assert(!small_index.find(get_key_hash("key", 10)).has_value());
+
+}
+
+
+
+TEST_CASE("StringHash", "[hz][perfect_hash]")
+{
+	REQUIRE(hz::string_hash_fnv1a("") == 14695981039346656037ULL);
+	REQUIRE(hz::string_hash_fnv1a("Abc") != hz::string_hash_fnv1a("abc"));
+	REQUIRE(hz::string_hash_fnv1a("Abc", true) == hz::string_hash_fnv1a("abc", true));
+	REQUIRE(hz::string_hash_fnv1a("Abc_1", true) == hz::string_hash_fnv1a("aBC_1", true));
+
+	// Chaining
+	REQUIRE(hz::string_hash_fnv1a("bc", false, hz::string_hash_fnv1a("a")) == hz::string_hash_fnv1a("abc"));
+	REQUIRE(hz::integer_hash_fnv1a(1) != hz::integer_hash_fnv1a(2));
+	REQUIRE(hz::integer_hash_fnv1a(1, hz::string_hash_fnv1a("a")) != hz::integer_hash_fnv1a(1, hz::string_hash_fnv1a("b")));
+
+	REQUIRE(hz::string_equal_ascii_nocase("Raw_Read_Error_Rate", "raw_read_ERROR_rate"));
+	REQUIRE(!hz::string_equal_ascii_nocase("Raw_Read_Error_Rate", "Raw_Read_Error_Rate_"));
+	REQUIRE(!hz::string_equal_ascii_nocase("a_b", "a-b"));
+	REQUIRE(hz::string_equal_ascii_nocase("", ""));
+}
+
+
+
+TEST_CASE("PerfectHashIndex", "[hz][perfect_hash]")
+{
+	const auto index = create_index<500>();
+	REQUIRE(index.size() == 500);
+	for (std::uint32_t i = 0; i < 500; ++i) {
+		auto value = index.find(get_key_hash("Key", i));
+		REQUIRE(value.has_value());
+		REQUIRE(value.value() == i);
+	}
+	for (std::uint32_t i = 500; i < 1000; ++i) {
+		REQUIRE(!index.find(get_key_hash("key", i)).has_value());
+	}
+
+	SECTION("Empty index") {
+		hz::PerfectHashIndex<4> empty;
+		empty.build();
+		REQUIRE(!empty.find(hz::string_hash_fnv1a("key")).has_value());
+	}
+
+	SECTION("Errors") {
+		hz::PerfectHashIndex<2> full;
+		full.insert(1, 1);
+		full.insert(2, 2);
+		REQUIRE_THROWS_AS(full.insert(3, 3), std::length_error);
+
+		hz::PerfectHashIndex<2> duplicate;
+		duplicate.insert(1, 1);
+		duplicate.insert(1, 2);
+		REQUIRE_THROWS_AS(duplicate.build(), std::invalid_argument);
+	}
+}
+
+
+
+
+
+
+/// @}
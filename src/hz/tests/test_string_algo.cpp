@@ -172,6 +172,34 @@ TEST_CASE("StringAlgorithms", "[hz][string]")
 		REQUIRE(string_natural_compare("a1b2c123456789012345", "a1b2c123456789012345") == 0);
 	}
 
+	SECTION("string_natural_sort_key") {
+		using namespace hz;
+
+		// Keys give the same order as string_natural_compare()
+		const std::vector<std::string> strs = {
+			"", "pd", "pd0", "pd00", "pd1", "pd01", "pd001", "pd2", "pd10", "pd11", "pda", "file1.txt", "file10.txt",
+			"file12345678901234567890.txt", "a1b2c3", "a1b2c10", "a10b2", "1test", "atest",
+			"test1", "testa", std::string("a\0b", 3), "a\1b", "a\2b", "a\3b", "a b",
+		};
+		for (const auto& a : strs) {
+			for (const auto& b : strs) {
+				const int cmp = string_natural_compare(a, b);
+				const std::string key_a = string_natural_sort_key(a), key_b = string_natural_sort_key(b);
+				REQUIRE((cmp < 0) == (key_a < key_b));
+				REQUIRE((cmp == 0) == (key_a == key_b));
+			}
+		}
+
+		// Leading zeros only break ties
+		REQUIRE(string_natural_sort_key("pd1") < string_natural_sort_key("pd01"));
+		REQUIRE(string_natural_sort_key("pd01") < string_natural_sort_key("pd001"));
+		REQUIRE(string_natural_sort_key("pd001") < string_natural_sort_key("pd2"));
+
+		// Concatenated keys sort by the first field first
+		REQUIRE(string_natural_sort_key("sda") + string_natural_sort_key("sat") < string_natural_sort_key("sda1") + string_natural_sort_key(""));
+		REQUIRE(string_natural_sort_key("sda") + string_natural_sort_key("sat") > string_natural_sort_key("sda") + string_natural_sort_key(""));
+	}
+
 }
 
 
@@ -22,8 +22,14 @@ Copyright:
 // header pitfalls.
 #include "hz/string_num.h"
 
+#include <atomic>
+#include <clocale>
+#include <cmath>
 #include <limits>
 #include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "hz/main_tools.h"
 
@@ -211,6 +217,191 @@ TEST_CASE("NumericStrings", "[hz][parser]")
 
 
 
+namespace {
+
+	/// Compare floating-point values for equality without -Wfloat-equal.
+	/// NaNs are never equal, as with operator==.
+	template<typename T>
+	bool float_equal(T a, T b)
+	{
+		return !std::isunordered(a, b) && !std::islessgreater(a, b);
+	}
+
+
+	/// Check that from_chars-based nolocale parsing gives the same result as the sto*-based
+	/// one (the global locale is "C" in tests).
+	template<typename T>
+	void check_same_as_locale(const std::string& s, bool strict, int base)
+	{
+		T nolocale_value = T(7), locale_value = T(7);
+		const bool nolocale_status = hz::string_is_numeric_nolocale(s, nolocale_value, strict, base);
+		const bool locale_status = hz::string_is_numeric_locale(s, locale_value, strict, base);
+		INFO("String: \"" << s << "\", strict: " << strict << ", base: " << base);
+		REQUIRE(nolocale_status == locale_status);
+		if constexpr(std::is_floating_point_v<T>) {
+			REQUIRE((float_equal(nolocale_value, locale_value) || (std::isnan(nolocale_value) && std::isnan(locale_value))));
+		} else {
+			REQUIRE(nolocale_value == locale_value);
+		}
+	}
+
+}
+
+
+
+TEST_CASE("NumericStringsFromChars", "[hz][parser]")
+{
+	using namespace hz;
+
+	const std::vector<std::string> int_strings = {
+		"", " ", "0", "00", "-0", "+0", "1", "+1", "-1", "+-1", "--1", " 12", "\t12", "12 ", "12abc", "abc",
+		"010", "08", "0x", "0x1f", "0X1F", "-0x1f", "+0x1f", "0xg", "0x 1", "1e3", "1.5",
+		"127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32769", "65535", "65536",
+		"2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+		"9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+		"18446744073709551615", "18446744073709551616", "99999999999999999999999",
+	};
+
+	for (const auto& str : int_strings) {
+		for (const bool strict : {true, false}) {
+			for (const int base : {0, 8, 10, 16}) {
+				check_same_as_locale<char>(str, strict, base);
+				check_same_as_locale<signed char>(str, strict, base);
+				check_same_as_locale<unsigned char>(str, strict, base);
+				check_same_as_locale<short>(str, strict, base);
+				check_same_as_locale<unsigned short>(str, strict, base);
+				check_same_as_locale<int>(str, strict, base);
+				check_same_as_locale<unsigned int>(str, strict, base);
+				check_same_as_locale<long>(str, strict, base);
+				check_same_as_locale<unsigned long>(str, strict, base);
+				check_same_as_locale<long long>(str, strict, base);
+				check_same_as_locale<unsigned long long>(str, strict, base);
+			}
+		}
+	}
+
+	const std::vector<std::string> float_strings = {
+		"", " ", "0", "-0", "+1.5", "-1.5", "+-1.5", " 1.5", "1.5 ", "1.5x", ".5", "5.", "e5", "1e5", "1E-5", "3.e+4",
+		"1e", "1e+", "inf", "-inf", "INFINITY", "infinit", "nan", "-NaN", "nan(123)", "0x", "0x1p3", "-0X1.8P1", "0xg",
+		"1e400", "-1e400", "1e-400", "123456789012345678901234567890",
+	};
+
+	for (const auto& str : float_strings) {
+		for (const bool strict : {true, false}) {
+			check_same_as_locale<float>(str, strict, 0);
+			check_same_as_locale<double>(str, strict, 0);
+			check_same_as_locale<long double>(str, strict, 0);
+		}
+	}
+
+	const std::vector<std::string> bool_strings = {"", "true", "false", " true", "truex", "1", "0", "2", " 1", "-1"};
+
+	for (const auto& str : bool_strings) {
+		for (const bool strict : {true, false}) {
+			for (const int boolalpha : {0, 1}) {
+				check_same_as_locale<bool>(str, strict, boolalpha);
+			}
+		}
+	}
+}
+
+
+
+TEST_CASE("NumericStringsThreads", "[hz][parser]")
+{
+	// The nolocale functions must not touch the global locale, so they can be used from multiple threads.
+	const std::string initial_locale = std::setlocale(LC_NUMERIC, nullptr);
+	std::atomic<bool> done = false;
+	std::atomic<int> locale_changes = 0;
+
+	// Watch for temporary changes of the global locale while the conversions run
+	std::thread watcher([&]() {
+		while (!done.load()) {
+			const char* current = std::setlocale(LC_NUMERIC, nullptr);
+			if (!current || current != initial_locale) {
+				++locale_changes;
+			}
+		}
+	});
+
+	std::vector<std::thread> threads;
+	std::vector<int> failures(4, 0);
+	for (std::size_t i = 0; i < failures.size(); ++i) {
+		threads.emplace_back([&failures, i]() {
+			for (int j = 0; j < 10000; ++j) {
+				int64_t int_value = 0;
+				float float_value = 0;
+				double double_value = 0;
+				long double long_double_value = 0;
+				const std::string double_str = hz::number_to_string_nolocale(j + 0.5);
+				if (!hz::string_is_numeric_nolocale(std::to_string(j), int_value) || int_value != j
+						|| !hz::string_is_numeric_nolocale("1.5", float_value) || !float_equal(float_value, 1.5f)
+						|| !hz::string_is_numeric_nolocale(double_str, double_value) || !float_equal(double_value, j + 0.5)
+						|| !hz::string_is_numeric_nolocale("-2.25e2", long_double_value) || !float_equal(long_double_value, -225.0L)) {
+					++failures[i];
+				}
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	done = true;
+	watcher.join();
+
+	REQUIRE(failures == std::vector<int>(failures.size(), 0));
+	REQUIRE(locale_changes == 0);
+}
+
+
+
+TEST_CASE("NumericStringsBenchmark", "[.][hz][parser][benchmark]")
+{
+	// Typical values from smartctl output: raw attribute values, LBAs, hours.
+	const std::vector<std::string> strings = {
+		"0", "100", "253", "37", "12345", "4294967295", "0x0032", "281474976710655", "27 (Min/Max 11/59)", "1.33",
+	};
+
+	BENCHMARK("string_is_numeric_nolocale<int64_t>")
+	{
+		int64_t sum = 0;
+		for (const auto& str : strings) {
+			int64_t value = 0;
+			if (hz::string_is_numeric_nolocale(str, value, false)) {
+				sum += value;
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("string_is_numeric_nolocale<double>")
+	{
+		double sum = 0;
+		for (const auto& str : strings) {
+			double value = 0;
+			if (hz::string_is_numeric_nolocale(str, value, false)) {
+				sum += value;
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("string_is_numeric_locale<int64_t> (sto*)")
+	{
+		int64_t sum = 0;
+		for (const auto& str : strings) {
+			int64_t value = 0;
+			if (hz::string_is_numeric_locale(str, value, false)) {
+				sum += value;
+			}
+		}
+		return sum;
+	};
+}
+
+
+
+
 
 
 /// @}
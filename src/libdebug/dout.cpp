@@ -11,6 +11,7 @@ Copyright:
 
 #include <string>
 #include <iosfwd>  // std::ostream definition
+#include <mutex>
 #include <sstream>
 
 #include "dout.h"
@@ -48,16 +49,30 @@ std::ostream& debug_out(debug_level::flag level, const std::string& domain)
 
 
 
+namespace debug_internal {
+
+	std::recursive_mutex& get_debug_output_mutex()
+	{
+		static std::recursive_mutex mutex;
+		return mutex;
+	}
+
+}
+
+
+
 // Start / stop prefix printing. Useful for large dumps
 
 void debug_begin()
 {
+	const std::scoped_lock lock(debug_internal::get_debug_output_mutex());
 	debug_internal::get_debug_state_ref().push_inside_begin();
 }
 
 
 void debug_end()
 {
+	const std::scoped_lock lock(debug_internal::get_debug_output_mutex());
 	debug_internal::get_debug_state_ref().pop_inside_begin();
 	// this is needed because else the contents won't be written until next write.
 	debug_internal::get_debug_state_ref().force_output();
@@ -110,6 +125,7 @@ namespace debug_internal {
 // increase indentation level for all debug levels
 void debug_indent_inc(int by)
 {
+	const std::scoped_lock lock(debug_internal::get_debug_output_mutex());
 	const int curr = debug_internal::get_debug_state_ref().get_indent_level();
 	debug_internal::get_debug_state_ref().set_indent_level(curr + by);
 }
@@ -117,6 +133,7 @@ void debug_indent_inc(int by)
 
 void debug_indent_dec(int by)
 {
+	const std::scoped_lock lock(debug_internal::get_debug_output_mutex());
 	int curr = debug_internal::get_debug_state_ref().get_indent_level();
 	curr -= by;
 	if (curr < 0)
@@ -127,6 +144,7 @@ void debug_indent_dec(int by)
 
 void debug_indent_reset()
 {
+	const std::scoped_lock lock(debug_internal::get_debug_output_mutex());
 	debug_internal::get_debug_state_ref().set_indent_level(0);
 }
 
@@ -16,6 +16,7 @@ Copyright:
 // Note: Sun compiler refuses to compile without <ostream> (iosfwd is not enough).
 // Since every useful operator << is defined in ostream, we include it here anyway.
 #include <ostream>  // std::ostream
+#include <mutex>
 #include <utility>
 
 #include "hz/system_specific.h"  // HZ_FUNC_PRINTF_ISO_CHECK
@@ -30,7 +31,44 @@ std::ostream& debug_out(debug_level::flag level, const std::string& domain);
 
 
 
+namespace debug_internal {
+
+	/// Get the mutex which serializes the debug output of several threads.
+	/// It's recursive, since the output expressions may produce debug output themselves.
+	std::recursive_mutex& get_debug_output_mutex();
+
+
+	/// A libdebug-handled stream which is locked for the lifetime of this object.
+	/// The debug_out_*() macros create it as a temporary, so the stream stays locked
+	/// until the end of the output statement.
+	class LockedDebugOut {
+		public:
+
+			/// Constructor. Locks the output.
+			/// \throw debug_usage_error if invalid domain or level.
+			LockedDebugOut(debug_level::flag level, const std::string& domain)
+					: lock_(get_debug_output_mutex()), os_(debug_out(level, domain))
+			{ }
+
+			/// Get the stream
+			[[nodiscard]] std::ostream& get() const
+			{
+				return os_;
+			}
+
+		private:
+
+			std::unique_lock<std::recursive_mutex> lock_;  ///< Output lock
+			std::ostream& os_;  ///< Debug stream
+
+	};
+
+}
+
+
+
 // These are macros to be able to easily compile-out per-level output.
+// The output is thread-safe.
 
 /// Send an output to debug stream. For example:
 /// \code
@@ -38,23 +76,23 @@ std::ostream& debug_out(debug_level::flag level, const std::string& domain);
 /// debug_out_dump("app", "Error value: " << value << ".\n");
 /// \endcode
 #define debug_out_dump(domain, output) \
-	debug_out(debug_level::dump, domain) << output
+	debug_internal::LockedDebugOut(debug_level::dump, domain).get() << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_info(domain, output) \
-	debug_out(debug_level::info, domain) << output
+	debug_internal::LockedDebugOut(debug_level::info, domain).get() << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_warn(domain, output) \
-	debug_out(debug_level::warn, domain) << output
+	debug_internal::LockedDebugOut(debug_level::warn, domain).get() << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_error(domain, output) \
-	debug_out(debug_level::error, domain) << output
+	debug_internal::LockedDebugOut(debug_level::error, domain).get() << output
 
 /// Send an output to debug stream. \see debug_out_dump().
 #define debug_out_fatal(domain, output) \
-	debug_out(debug_level::fatal, domain) << output
+	debug_internal::LockedDebugOut(debug_level::fatal, domain).get() << output
 
 
 
@@ -0,0 +1,332 @@
+/******************************************************************************
+License: GNU General Public License v3.0 only
+Copyright:
+	(C) 2026 Alexander Shaduri <ashaduri@gmail.com>
+******************************************************************************/
+/// \file
+/// \author Alexander Shaduri
+/// \ingroup gsc
+/// \weakgroup gsc
+/// @{
+
+#include <glibmm.h>
+#include <glib.h>  // g_, G*
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>  // EXIT_*
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libdebug/libdebug.h"  // include full libdebug here (to add domains, etc.)
+#include "rconfig/rconfig.h"
+#include "rconfig/loadsave.h"
+#include "hz/fs.h"
+#include "hz/locale_tools.h"  // locale_c*
+#include "hz/main_tools.h"
+#include "hz/string_algo.h"  // string_split()
+#include "hz/string_num.h"
+#include "build_config.h"  // BuildEnv
+
+#include "applib/command_executor_factory.h"
+#include "applib/drive_monitor.h"
+#include "applib/drive_monitor_file_sink.h"
+#include "applib/gsc_settings.h"
+#include "applib/smartctl_executor.h"  // get_smartctl_binary()
+#include "applib/smartctl_parse_cache.h"
+#include "applib/smartctl_version_cache.h"
+#include "applib/smartctl_version_parser.h"
+#include "applib/storage_detector.h"
+#include "applib/storage_property_descr.h"
+
+
+
+namespace {
+
+
+	/// Set from signal handlers to exit the polling loop
+	volatile std::sig_atomic_t s_stop_requested = 0;
+
+
+	/// SIGINT / SIGTERM handler
+	void stop_signal_handler([[maybe_unused]] int signal)
+	{
+		s_stop_requested = 1;
+	}
+
+
+
+	/// Command-line argument values
+	struct CmdArgs {
+		// Note: Use GLib types here:
+		gint arg_interval = 15*60;  ///< Average interval between polls of each drive, in seconds
+		double arg_jitter = 0.1;  ///< Maximum relative deviation of the interval
+		gchar* arg_output = nullptr;  ///< Output file. If empty, the records are written to stdout.
+		gint64 arg_max_size = 10*1024*1024;  ///< Maximum output file size before rotation
+		gboolean arg_once = FALSE;  ///< If true, poll each drive once and exit
+		gchar* arg_config = nullptr;  ///< Configuration file to use instead of the default ones
+		gchar* arg_history_dir = nullptr;  ///< Attribute history directory, overrides the configuration
+		gboolean arg_wake_up = FALSE;  ///< If true, wake up the drives in standby mode when polling them
+	};
+
+
+
+	/// Parse command-line arguments (fills \c args)
+	inline bool parse_cmdline_args(CmdArgs& args, int& argc, char**& argv)
+	{
+		static const std::vector<GOptionEntry> arg_entries = {
+			{ "interval", 'i', 0, G_OPTION_ARG_INT, &(args.arg_interval),
+					N_("Average interval between polls of each drive, in seconds (default 900)"), "SECONDS" },
+			{ "jitter", 'j', 0, G_OPTION_ARG_DOUBLE, &(args.arg_jitter),
+					N_("Maximum relative deviation of the poll interval, 0 - 1 (default 0.1)"), "FRACTION" },
+			{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &(args.arg_output),
+					N_("Append the results to this file, one JSON object per line. If not specified, standard output is used."), "FILE" },
+			{ "max-size", '\0', 0, G_OPTION_ARG_INT64, &(args.arg_max_size),
+					N_("Rotate the output file to <FILE>.1 when it grows beyond this size in bytes. 0 disables rotation."), "BYTES" },
+			{ "once", '\0', 0, G_OPTION_ARG_NONE, &(args.arg_once),
+					N_("Poll each drive once and exit"), nullptr },
+			{ "config", 'c', 0, G_OPTION_ARG_FILENAME, &(args.arg_config),
+					N_("Load settings from this file instead of the global and user configuration files"), "FILE" },
+			{ "history-dir", '\0', 0, G_OPTION_ARG_FILENAME, &(args.arg_history_dir),
+					N_("Record the attribute history of each drive in this directory"), "DIR" },
+			{ "wake-up", '\0', 0, G_OPTION_ARG_NONE, &(args.arg_wake_up),
+					N_("Wake up the drives in standby mode when polling them. By default, the last data is reported instead."), nullptr },
+			{ nullptr, '\0', 0, G_OPTION_ARG_NONE, nullptr, nullptr, nullptr }
+		};
+
+		GError* error = nullptr;
+		GOptionContext* context = g_option_context_new("- Periodically record the health of all drives using smartmontools");
+
+		// our options
+		g_option_context_add_main_entries(context, arg_entries.data(), nullptr);
+
+		// libdebug options; this will also automatically apply them
+		g_option_context_add_group(context, debug_get_option_group());
+
+		const bool parsed = static_cast<bool>(g_option_context_parse(context, &argc, &argv, &error));
+
+		if (error) {
+			std::string error_text = "\n" + Glib::ustring::compose(_("Error parsing command-line options: %1"), (error->message ? error->message : "invalid error"));
+			error_text += "\n\n";
+			g_error_free(error);
+
+			gchar* help_text = g_option_context_get_help(context, TRUE, nullptr);
+			if (help_text) {
+				error_text += help_text;
+				g_free(help_text);
+			}
+
+			std::cerr << error_text;
+		}
+		g_option_context_free(context);
+
+		return parsed;
+	}
+
+
+
+	/// Load the configuration files. The configuration is never saved.
+	inline void monitor_init_config(const hz::fs::path& config_file)
+	{
+		std::error_code ec;
+		if (!config_file.empty()) {
+			rconfig::load_from_file(config_file);
+
+		} else {
+			// Same files as the GUI uses
+			hz::fs::path global_config_file;
+			if constexpr(BuildEnv::is_kernel_family_windows()) {
+				global_config_file = hz::fs_path_from_string("gsmartcontrol2.conf");  // CWD, installation dir by default.
+			} else {
+				global_config_file = hz::fs_path_from_string(BuildEnv::package_sysconf_dir()) / "gsmartcontrol2.conf";
+			}
+			const hz::fs::path home_config_file = hz::fs_get_user_config_dir() / "gsmartcontrol" / "gsmartcontrol2.conf";
+
+			for (const auto& file : {global_config_file, home_config_file}) {
+				if (hz::fs::exists(file, ec) && hz::fs_path_is_readable(file, ec)) {
+					debug_out_dump("app", DBG_FUNC_MSG << "Loading config file \"" << hz::fs_path_to_string(file) << "\"\n");
+					rconfig::load_from_file(file);
+				}
+			}
+		}
+
+		init_default_settings();  // initialize /default
+
+		StoragePropertyProcessor::set_user_warning_rules(StoragePropertyUserRules::from_config());
+	}
+
+
+
+	/// Check that smartctl is usable and select its output format, same as the GUI does.
+	/// \return An error message, or an empty string on success.
+	inline std::string check_smartctl_version_and_set_format()
+	{
+		const std::string smartctl_binary = hz::fs_path_to_string(get_smartctl_binary());
+		if (smartctl_binary.empty()) {
+			return _("Smartctl binary is not specified in configuration.");
+		}
+
+		std::string version, version_full;
+
+		const auto binary_stamp = smartctl_get_binary_stamp(hz::fs_path_from_string(smartctl_binary));
+		if (auto cached_version = (binary_stamp ? smartctl_version_cache_lookup(*binary_stamp) : std::nullopt)) {
+			version = cached_version->version;
+			version_full = cached_version->version_full;
+
+		} else {
+			SmartctlExecutor ex;
+			ex.set_command(smartctl_binary, {"-V"});  // --version
+
+			if (!ex.execute() || !ex.get_error_msg().empty()) {
+				return ex.get_error_msg();
+			}
+			if (!SmartctlVersionParser::parse_version_text(ex.get_stdout_str(), version, version_full)) {
+				return _("Smartctl returned invalid output.");
+			}
+		}
+
+		if (double version_double = 0; hz::string_is_numeric_nolocale<double>(version, version_double, false)) {
+			if (version_double < SmartctlVersionParser::minimum_req_runtime_version) {
+				return Glib::ustring::compose(_("Smartctl version %1 found, %2 required."),
+						version,
+						hz::number_to_string_nolocale(SmartctlVersionParser::minimum_req_runtime_version));
+			}
+		}
+
+		if (SmartctlVersionParser::check_format_supported(SmartctlOutputFormat::Json, version)) {
+			SmartctlVersionParser::set_default_format(SmartctlOutputFormat::Json);
+		} else {
+			debug_out_warn("app", "Smartctl JSON output format not supported, falling back to Text output format.\n");
+			SmartctlVersionParser::set_default_format(SmartctlOutputFormat::Text);
+		}
+
+		return {};
+	}
+
+
+
+	/// Initialize everything and run the polling loop
+	inline int monitor_main(int argc, char** argv)
+	{
+		hz::locale_c_set("");  // Glib needs the C locale set to system locale for command line args.
+
+		CmdArgs args;
+		if (!parse_cmdline_args(args, argc, argv)) {
+			return EXIT_FAILURE;
+		}
+
+		debug_register_domain("app");
+		debug_register_domain("hz");
+		debug_register_domain("rconfig");
+
+		monitor_init_config(args.arg_config ? hz::fs::path(args.arg_config) : hz::fs::path());
+
+		if (const std::string error_msg = check_smartctl_version_and_set_format(); !error_msg.empty()) {
+			std::cerr << _("There was an error while executing smartctl") << ": " << error_msg << "\n";
+			return EXIT_FAILURE;
+		}
+
+		// Each poll produces a new output (it contains the local time), so caching the parse
+		// results would only keep memory occupied.
+		SmartctlParseCache::set_max_entries(0);
+
+		std::vector<std::string> blacklist_patterns;
+		hz::string_split(rconfig::get_data<std::string>("system/device_blacklist_patterns"), ';', blacklist_patterns, true);
+
+		StorageDetector sd;
+		sd.add_blacklist_patterns(blacklist_patterns);
+		sd.set_allow_wakeup(args.arg_wake_up == TRUE);
+
+		std::vector<StorageDevicePtr> drives;
+		auto ex_factory = std::make_shared<CommandExecutorFactory>(false);
+		if (auto detect_status = sd.detect_and_fetch_basic_data(drives, ex_factory); !detect_status) {
+			std::cerr << detect_status.error().message() << "\n";
+			return EXIT_FAILURE;
+		}
+
+		DriveMonitor monitor(std::chrono::seconds(std::max(args.arg_interval, 1)), args.arg_jitter, std::random_device()(),
+				[ex_factory]() { return ex_factory->create_executor(CommandExecutorFactory::ExecutorType::Smartctl); });
+
+		monitor.set_allow_wakeup(args.arg_wake_up == TRUE);
+
+		const hz::fs::path history_dir = (args.arg_history_dir ? hz::fs::path(args.arg_history_dir)
+				: hz::fs_path_from_string(rconfig::get_data<std::string>("system/attribute_history_dir")));
+		if (!history_dir.empty()) {
+			std::error_code ec;
+			hz::fs::create_directories(history_dir, ec);
+			if (ec) {
+				std::cerr << "Cannot create directory \"" << hz::fs_path_to_string(history_dir) << "\": " << ec.message() << "\n";
+				return EXIT_FAILURE;
+			}
+			monitor.set_history_dir(history_dir);
+			// The drives bootstrap their attribute trends from the same history.
+			rconfig::set_data("system/attribute_history_dir", hz::fs_path_to_string(history_dir));
+		}
+
+		const auto start_time = DriveMonitor::Clock::now();
+		for (const auto& drive : drives) {
+			monitor.add_drive(drive, start_time);
+		}
+		debug_out_info("app", "Monitoring " << monitor.get_drive_count() << " drive(s).\n");
+
+		std::unique_ptr<DriveMonitorFileSink> file_sink;
+		if (args.arg_output) {
+			file_sink = std::make_unique<DriveMonitorFileSink>(hz::fs::path(args.arg_output),
+					static_cast<std::uintmax_t>(std::max<gint64>(args.arg_max_size, 0)));
+		}
+
+		const auto sink = [&file_sink](const DriveMonitorRecord& record) {
+			if (!file_sink) {
+				std::cout << record.to_json_line() << std::endl;
+			} else if (auto ec = file_sink->write(record)) {
+				debug_out_error("app", "Cannot write the record of " << record.device << ": " << ec.message() << "\n");
+			}
+		};
+
+		if (args.arg_once == TRUE) {
+			monitor.poll_due(DriveMonitor::Clock::time_point::max(), sink);  // everything is due
+			return EXIT_SUCCESS;
+		}
+
+		std::signal(SIGINT, &stop_signal_handler);
+		std::signal(SIGTERM, &stop_signal_handler);
+
+		// Sleep in short slices so that the signals are handled promptly.
+		const auto max_sleep = std::chrono::seconds(1);
+		while (s_stop_requested == 0) {
+			const auto now = DriveMonitor::Clock::now();
+			monitor.poll_due(now, sink);
+
+			const auto next_time = monitor.get_next_poll_time().value_or(now + max_sleep);
+			std::this_thread::sleep_for(std::clamp<DriveMonitor::Clock::duration>(next_time - DriveMonitor::Clock::now(),
+					DriveMonitor::Clock::duration::zero(), max_sleep));
+		}
+
+		debug_out_info("app", "Exiting.\n");
+		return EXIT_SUCCESS;
+	}
+
+
+}
+
+
+
+/// Application main function
+int main(int argc, char** argv)
+{
+	return hz::main_exception_wrapper([&argc, &argv]()
+	{
+		return monitor_main(argc, argv);
+	});
+}
+
+
+
+
+
+/// @}